@@ -14,8 +14,14 @@
 
 #include "private/chacha20_ietf_ext.h"
 #include "private/common.h"
+#include "private/implementations.h"
+#include "runtime.h"
 
-static const unsigned char _pad0[16] = { 0 };
+#include "chacha20poly1305_fused.h"
+#include "chacha20poly1305_ref.h"
+
+static const chacha20poly1305_implementation *implementation =
+    &chacha20poly1305_fused_implementation;
 
 int
 crypto_aead_chacha20poly1305_encrypt_detached(unsigned char *c,
@@ -100,31 +106,8 @@ crypto_aead_chacha20poly1305_ietf_encrypt_detached(unsigned char *c,
                                                    const unsigned char *npub,
                                                    const unsigned char *k)
 {
-    crypto_onetimeauth_poly1305_state state;
-    unsigned char                     block0[64U];
-    unsigned char                     slen[8U];
-
     (void) nsec;
-    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
-    crypto_onetimeauth_poly1305_init(&state, block0);
-    sodium_memzero(block0, sizeof block0);
-
-    crypto_onetimeauth_poly1305_update(&state, ad, adlen);
-    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
-
-    crypto_stream_chacha20_ietf_xor_ic(c, m, mlen, npub, 1U, k);
-
-    crypto_onetimeauth_poly1305_update(&state, c, mlen);
-    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
-
-    STORE64_LE(slen, (uint64_t) adlen);
-    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
-
-    STORE64_LE(slen, (uint64_t) mlen);
-    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
-
-    crypto_onetimeauth_poly1305_final(&state, mac);
-    sodium_memzero(&state, sizeof state);
+    implementation->ietf_encrypt_detached(c, mac, m, mlen, ad, adlen, npub, k);
 
     if (maclen_p != NULL) {
         *maclen_p = crypto_aead_chacha20poly1305_ietf_ABYTES;
@@ -254,47 +237,8 @@ crypto_aead_chacha20poly1305_ietf_decrypt_detached(unsigned char *m,
                                                    const unsigned char *npub,
                                                    const unsigned char *k)
 {
-    crypto_onetimeauth_poly1305_state state;
-    unsigned char                     block0[64U];
-    unsigned char                     slen[8U];
-    unsigned char                     computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
-    unsigned long long                mlen;
-    int                               ret;
-
     (void) nsec;
-    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
-    crypto_onetimeauth_poly1305_init(&state, block0);
-    sodium_memzero(block0, sizeof block0);
-
-    crypto_onetimeauth_poly1305_update(&state, ad, adlen);
-    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
-
-    mlen = clen;
-    crypto_onetimeauth_poly1305_update(&state, c, mlen);
-    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
-
-    STORE64_LE(slen, (uint64_t) adlen);
-    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
-
-    STORE64_LE(slen, (uint64_t) mlen);
-    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
-
-    crypto_onetimeauth_poly1305_final(&state, computed_mac);
-    sodium_memzero(&state, sizeof state);
-
-    COMPILER_ASSERT(sizeof computed_mac == 16U);
-    ret = crypto_verify_16(computed_mac, mac);
-    sodium_memzero(computed_mac, sizeof computed_mac);
-    if (m == NULL) {
-        return ret;
-    }
-    if (ret != 0) {
-        memset(m, 0, mlen);
-        return -1;
-    }
-    crypto_stream_chacha20_ietf_xor_ic(m, c, mlen, npub, 1U, k);
-
-    return 0;
+    return implementation->ietf_decrypt_detached(m, c, clen, mac, ad, adlen, npub, k);
 }
 
 int
@@ -327,6 +271,68 @@ crypto_aead_chacha20poly1305_ietf_decrypt(unsigned char *m,
     return ret;
 }
 
+static int
+segments_mlen(const crypto_aead_chacha20poly1305_ietf_segment *segs, size_t nsegs,
+              unsigned long long *mlen_p)
+{
+    unsigned long long mlen = 0ULL;
+    size_t             i;
+
+    for (i = 0U; i < nsegs; i++) {
+        if (segs[i].len > crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX - mlen) {
+            return -1;
+        }
+        mlen += segs[i].len;
+    }
+    *mlen_p = mlen;
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_encryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs,
+                                           size_t nsegs,
+                                           unsigned char *mac,
+                                           unsigned long long *maclen_p,
+                                           const unsigned char *ad,
+                                           unsigned long long adlen,
+                                           const unsigned char *nsec,
+                                           const unsigned char *npub,
+                                           const unsigned char *k)
+{
+    unsigned long long mlen;
+
+    (void) nsec;
+    if (segments_mlen(segs, nsegs, &mlen) != 0) {
+        sodium_misuse();
+    }
+    implementation->ietf_encryptv(segs, nsegs, mlen, mac, ad, adlen, npub, k);
+
+    if (maclen_p != NULL) {
+        *maclen_p = crypto_aead_chacha20poly1305_ietf_ABYTES;
+    }
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_decryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs,
+                                           size_t nsegs,
+                                           unsigned char *nsec,
+                                           const unsigned char *mac,
+                                           const unsigned char *ad,
+                                           unsigned long long adlen,
+                                           const unsigned char *npub,
+                                           const unsigned char *k)
+{
+    unsigned long long mlen;
+
+    (void) nsec;
+    if (segments_mlen(segs, nsegs, &mlen) != 0) {
+        return -1;
+    }
+    return implementation->ietf_decryptv(segs, nsegs, mlen, mac, ad, adlen, npub, k);
+}
+
 size_t
 crypto_aead_chacha20poly1305_ietf_keybytes(void)
 {
@@ -398,3 +404,18 @@ crypto_aead_chacha20poly1305_keygen(unsigned char k[crypto_aead_chacha20poly1305
 {
     randombytes_buf(k, crypto_aead_chacha20poly1305_KEYBYTES);
 }
+
+int
+_crypto_aead_chacha20poly1305_pick_best_implementation(void)
+{
+    implementation = &chacha20poly1305_fused_implementation;
+
+#if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H)
+    /* the two-pass construction runs on the vectorized ChaCha20 kernels */
+    if (sodium_runtime_has_ssse3()) {
+        implementation = &chacha20poly1305_ref_implementation;
+        return 0;
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,459 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_chacha20poly1305.h"
+#include "crypto_verify_16.h"
+#include "utils.h"
+
+#include "private/common.h"
+
+#include "chacha20poly1305_fused.h"
+
+#ifdef HAVE_TI_MODE
+# include "../../crypto_onetimeauth/poly1305/donna/poly1305_donna64.h"
+#else
+# include "../../crypto_onetimeauth/poly1305/donna/poly1305_donna32.h"
+#endif
+
+/*
+ * Single pass over the message for targets without a vector unit: each
+ * 64-byte ChaCha20 block is XORed and absorbed into Poly1305 while it is
+ * still in registers/cache, instead of streaming the whole buffer through
+ * ChaCha20 and then reading it back for Poly1305. The AEAD padding and
+ * length words go straight to poly1305_blocks(), so the leftover buffer
+ * of the generic update path is never used.
+ */
+
+#define QUARTERROUND(a, b, c, d) \
+    a += b;                      \
+    d = ROTL32(d ^ a, 16);       \
+    c += d;                      \
+    b = ROTL32(b ^ c, 12);       \
+    a += b;                      \
+    d = ROTL32(d ^ a, 8);        \
+    c += d;                      \
+    b = ROTL32(b ^ c, 7);
+
+static void
+chacha20_ietf_setup(uint32_t input[16], const unsigned char *npub,
+                    const unsigned char *k)
+{
+    input[0]  = 0x61707865U;
+    input[1]  = 0x3320646eU;
+    input[2]  = 0x79622d32U;
+    input[3]  = 0x6b206574U;
+    input[4]  = LOAD32_LE(k + 0);
+    input[5]  = LOAD32_LE(k + 4);
+    input[6]  = LOAD32_LE(k + 8);
+    input[7]  = LOAD32_LE(k + 12);
+    input[8]  = LOAD32_LE(k + 16);
+    input[9]  = LOAD32_LE(k + 20);
+    input[10] = LOAD32_LE(k + 24);
+    input[11] = LOAD32_LE(k + 28);
+    input[12] = 0U;
+    input[13] = LOAD32_LE(npub + 0);
+    input[14] = LOAD32_LE(npub + 4);
+    input[15] = LOAD32_LE(npub + 8);
+}
+
+/* out = m ^ keystream, or the raw keystream if m is NULL */
+static void
+chacha20_ietf_block(uint32_t input[16], unsigned char out[64],
+                    const unsigned char *m)
+{
+    uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14,
+        x15;
+    int      i;
+
+    x0  = input[0];
+    x1  = input[1];
+    x2  = input[2];
+    x3  = input[3];
+    x4  = input[4];
+    x5  = input[5];
+    x6  = input[6];
+    x7  = input[7];
+    x8  = input[8];
+    x9  = input[9];
+    x10 = input[10];
+    x11 = input[11];
+    x12 = input[12];
+    x13 = input[13];
+    x14 = input[14];
+    x15 = input[15];
+    for (i = 20; i > 0; i -= 2) {
+        QUARTERROUND(x0, x4, x8, x12)
+        QUARTERROUND(x1, x5, x9, x13)
+        QUARTERROUND(x2, x6, x10, x14)
+        QUARTERROUND(x3, x7, x11, x15)
+        QUARTERROUND(x0, x5, x10, x15)
+        QUARTERROUND(x1, x6, x11, x12)
+        QUARTERROUND(x2, x7, x8, x13)
+        QUARTERROUND(x3, x4, x9, x14)
+    }
+    x0 += input[0];
+    x1 += input[1];
+    x2 += input[2];
+    x3 += input[3];
+    x4 += input[4];
+    x5 += input[5];
+    x6 += input[6];
+    x7 += input[7];
+    x8 += input[8];
+    x9 += input[9];
+    x10 += input[10];
+    x11 += input[11];
+    x12 += input[12];
+    x13 += input[13];
+    x14 += input[14];
+    x15 += input[15];
+    input[12]++;
+
+    if (m != NULL) {
+        x0 ^= LOAD32_LE(m + 0);
+        x1 ^= LOAD32_LE(m + 4);
+        x2 ^= LOAD32_LE(m + 8);
+        x3 ^= LOAD32_LE(m + 12);
+        x4 ^= LOAD32_LE(m + 16);
+        x5 ^= LOAD32_LE(m + 20);
+        x6 ^= LOAD32_LE(m + 24);
+        x7 ^= LOAD32_LE(m + 28);
+        x8 ^= LOAD32_LE(m + 32);
+        x9 ^= LOAD32_LE(m + 36);
+        x10 ^= LOAD32_LE(m + 40);
+        x11 ^= LOAD32_LE(m + 44);
+        x12 ^= LOAD32_LE(m + 48);
+        x13 ^= LOAD32_LE(m + 52);
+        x14 ^= LOAD32_LE(m + 56);
+        x15 ^= LOAD32_LE(m + 60);
+    }
+    STORE32_LE(out + 0, x0);
+    STORE32_LE(out + 4, x1);
+    STORE32_LE(out + 8, x2);
+    STORE32_LE(out + 12, x3);
+    STORE32_LE(out + 16, x4);
+    STORE32_LE(out + 20, x5);
+    STORE32_LE(out + 24, x6);
+    STORE32_LE(out + 28, x7);
+    STORE32_LE(out + 32, x8);
+    STORE32_LE(out + 36, x9);
+    STORE32_LE(out + 40, x10);
+    STORE32_LE(out + 44, x11);
+    STORE32_LE(out + 48, x12);
+    STORE32_LE(out + 52, x13);
+    STORE32_LE(out + 56, x14);
+    STORE32_LE(out + 60, x15);
+}
+
+/* absorbs in, zero-padded to a multiple of the Poly1305 block size */
+static void
+poly1305_blocks_pad16(poly1305_state_internal_t *st, const unsigned char *in,
+                      unsigned long long inlen)
+{
+    unsigned char      block[poly1305_block_size];
+    unsigned long long full = inlen & ~(unsigned long long) (poly1305_block_size - 1);
+
+    if (full > 0U) {
+        poly1305_blocks(st, in, full);
+    }
+    if (inlen > full) {
+        memset(block, 0, sizeof block);
+        memcpy(block, in + full, (size_t) (inlen - full));
+        poly1305_blocks(st, block, sizeof block);
+    }
+}
+
+static void
+poly1305_lengths(poly1305_state_internal_t *st, unsigned long long adlen,
+                 unsigned long long mlen)
+{
+    unsigned char slen[poly1305_block_size];
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    STORE64_LE(slen + 8, (uint64_t) mlen);
+    poly1305_blocks(st, slen, sizeof slen);
+}
+
+static void
+aead_init(uint32_t input[16], poly1305_state_internal_t *st,
+          const unsigned char *ad, unsigned long long adlen,
+          const unsigned char *npub, const unsigned char *k)
+{
+    unsigned char block0[64U];
+
+    chacha20_ietf_setup(input, npub, k);
+    chacha20_ietf_block(input, block0, NULL);
+    poly1305_init(st, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    poly1305_blocks_pad16(st, ad, adlen);
+}
+
+static int
+ietf_encrypt_detached(unsigned char *c, unsigned char *mac,
+                      const unsigned char *m, unsigned long long mlen,
+                      const unsigned char *ad, unsigned long long adlen,
+                      const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(64) poly1305_state_internal_t st;
+    uint32_t                                   input[16];
+    unsigned char                              tail[64U];
+    unsigned long long                         i;
+    unsigned long long                         left;
+
+    aead_init(input, &st, ad, adlen, npub, k);
+
+    for (i = 0U; mlen - i >= 64U; i += 64U) {
+        chacha20_ietf_block(input, c + i, m + i);
+        poly1305_blocks(&st, c + i, 64U);
+    }
+    if ((left = mlen - i) > 0U) {
+        memset(tail, 0, sizeof tail);
+        memcpy(tail, m + i, (size_t) left);
+        chacha20_ietf_block(input, tail, tail);
+        memcpy(c + i, tail, (size_t) left);
+        poly1305_blocks_pad16(&st, tail, left);
+        sodium_memzero(tail, sizeof tail);
+    }
+    poly1305_lengths(&st, adlen, mlen);
+    poly1305_finish(&st, mac);
+    sodium_memzero(input, sizeof input);
+
+    return 0;
+}
+
+static int
+ietf_decrypt_detached(unsigned char *m, const unsigned char *c,
+                      unsigned long long clen, const unsigned char *mac,
+                      const unsigned char *ad, unsigned long long adlen,
+                      const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(64) poly1305_state_internal_t st;
+    uint32_t                                   input[16];
+    unsigned char                              tail[64U];
+    unsigned char                              computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned long long                         mlen = clen;
+    unsigned long long                         i;
+    unsigned long long                         left;
+    int                                        ret;
+
+    aead_init(input, &st, ad, adlen, npub, k);
+
+    if (m == NULL) {
+        poly1305_blocks_pad16(&st, c, mlen);
+    } else {
+        /* MAC each block before it is decrypted, so that m == c works */
+        for (i = 0U; mlen - i >= 64U; i += 64U) {
+            poly1305_blocks(&st, c + i, 64U);
+            chacha20_ietf_block(input, m + i, c + i);
+        }
+        if ((left = mlen - i) > 0U) {
+            memset(tail, 0, sizeof tail);
+            memcpy(tail, c + i, (size_t) left);
+            poly1305_blocks_pad16(&st, tail, left);
+            chacha20_ietf_block(input, tail, tail);
+            memcpy(m + i, tail, (size_t) left);
+            sodium_memzero(tail, sizeof tail);
+        }
+    }
+    poly1305_lengths(&st, adlen, mlen);
+    poly1305_finish(&st, computed_mac);
+    sodium_memzero(input, sizeof input);
+
+    COMPILER_ASSERT(sizeof computed_mac == 16U);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        memset(m, 0, mlen);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Scatter-gather: segments need not end on a ChaCha20 or a Poly1305 block
+ * boundary, so the unused keystream of the last block and the partial
+ * Poly1305 block are carried over to the next segment.
+ */
+
+/*
+ * Segments are rarely 16-byte aligned within the message, so the MAC
+ * takes several ChaCha20 blocks per call to amortize the leftover copy.
+ */
+#define SEGMENTS_CHUNK 256U
+
+typedef struct segments_state {
+    CRYPTO_ALIGN(64) poly1305_state_internal_t st;
+    uint32_t                                   input[16];
+    unsigned char                              ks[64U];
+    size_t                                     ks_left;
+} segments_state;
+
+static void
+poly1305_update(poly1305_state_internal_t *st, const unsigned char *m,
+                unsigned long long bytes)
+{
+    unsigned long long want;
+
+    if (st->leftover) {
+        want = poly1305_block_size - st->leftover;
+        if (want > bytes) {
+            want = bytes;
+        }
+        memcpy(st->buffer + st->leftover, m, (size_t) want);
+        bytes -= want;
+        m += want;
+        st->leftover += want;
+        if (st->leftover < poly1305_block_size) {
+            return;
+        }
+        poly1305_blocks(st, st->buffer, poly1305_block_size);
+        st->leftover = 0;
+    }
+    if (bytes >= poly1305_block_size) {
+        want = bytes & ~(unsigned long long) (poly1305_block_size - 1);
+        poly1305_blocks(st, m, want);
+        m += want;
+        bytes -= want;
+    }
+    if (bytes) {
+        memcpy(st->buffer, m, (size_t) bytes);
+        st->leftover = bytes;
+    }
+}
+
+/* XORs with the keystream left over in ks; the MAC sees the ciphertext */
+static size_t
+segments_xor_buffered(segments_state *s, unsigned char *out,
+                      const unsigned char *in, size_t len, int decrypt)
+{
+    const unsigned char *ks = s->ks + sizeof s->ks - s->ks_left;
+    size_t               n = len < s->ks_left ? len : s->ks_left;
+    size_t               i;
+
+    if (decrypt) {
+        poly1305_update(&s->st, in, n);
+    }
+    for (i = 0U; i < n; i++) {
+        out[i] = in[i] ^ ks[i];
+    }
+    if (!decrypt) {
+        poly1305_update(&s->st, out, n);
+    }
+    s->ks_left -= n;
+
+    return n;
+}
+
+static void
+segments_xor(segments_state *s, unsigned char *out, const unsigned char *in,
+             size_t len, int decrypt)
+{
+    size_t n;
+    size_t i;
+
+    if (len == 0U) {
+        return;
+    }
+    n = segments_xor_buffered(s, out, in, len, decrypt);
+    out += n;
+    in += n;
+    len -= n;
+    while (len >= 64U) {
+        n = len < SEGMENTS_CHUNK ? len & ~(size_t) 63U : SEGMENTS_CHUNK;
+        if (decrypt) {
+            poly1305_update(&s->st, in, n);
+        }
+        for (i = 0U; i < n; i += 64U) {
+            chacha20_ietf_block(s->input, out + i, in + i);
+        }
+        if (!decrypt) {
+            poly1305_update(&s->st, out, n);
+        }
+        out += n;
+        in += n;
+        len -= n;
+    }
+    if (len > 0U) {
+        chacha20_ietf_block(s->input, s->ks, NULL);
+        s->ks_left = sizeof s->ks;
+        segments_xor_buffered(s, out, in, len, decrypt);
+    }
+}
+
+static void
+segments_final(segments_state *s, unsigned char mac[16],
+               unsigned long long adlen, unsigned long long mlen)
+{
+    if (s->st.leftover) {
+        memset(s->st.buffer + s->st.leftover, 0,
+               (size_t) (poly1305_block_size - s->st.leftover));
+        poly1305_blocks(&s->st, s->st.buffer, poly1305_block_size);
+        s->st.leftover = 0;
+    }
+    poly1305_lengths(&s->st, adlen, mlen);
+    poly1305_finish(&s->st, mac);
+    sodium_memzero(s, sizeof *s);
+}
+
+static int
+ietf_encryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs, size_t nsegs,
+              unsigned long long mlen, unsigned char *mac,
+              const unsigned char *ad, unsigned long long adlen,
+              const unsigned char *npub, const unsigned char *k)
+{
+    segments_state s;
+    size_t         i;
+
+    aead_init(s.input, &s.st, ad, adlen, npub, k);
+    s.ks_left = 0U;
+    for (i = 0U; i < nsegs; i++) {
+        segments_xor(&s, segs[i].out, segs[i].in, segs[i].len, 0);
+    }
+    segments_final(&s, mac, adlen, mlen);
+
+    return 0;
+}
+
+static int
+ietf_decryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs, size_t nsegs,
+              unsigned long long mlen, const unsigned char *mac,
+              const unsigned char *ad, unsigned long long adlen,
+              const unsigned char *npub, const unsigned char *k)
+{
+    segments_state s;
+    unsigned char  computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    size_t         i;
+    int            ret;
+
+    aead_init(s.input, &s.st, ad, adlen, npub, k);
+    s.ks_left = 0U;
+    for (i = 0U; i < nsegs; i++) {
+        segments_xor(&s, segs[i].out, segs[i].in, segs[i].len, 1);
+    }
+    segments_final(&s, computed_mac, adlen, mlen);
+
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (ret != 0) {
+        for (i = 0U; i < nsegs; i++) {
+            if (segs[i].len > 0U) {
+                memset(segs[i].out, 0, segs[i].len);
+            }
+        }
+        return -1;
+    }
+    return 0;
+}
+
+struct chacha20poly1305_implementation chacha20poly1305_fused_implementation = {
+    SODIUM_C99(.ietf_encrypt_detached =) ietf_encrypt_detached,
+    SODIUM_C99(.ietf_decrypt_detached =) ietf_decrypt_detached,
+    SODIUM_C99(.ietf_encryptv =) ietf_encryptv,
+    SODIUM_C99(.ietf_decryptv =) ietf_decryptv
+};
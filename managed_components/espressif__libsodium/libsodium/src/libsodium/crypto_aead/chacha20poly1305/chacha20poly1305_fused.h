@@ -0,0 +1,8 @@
+#ifndef chacha20poly1305_fused_H
+#define chacha20poly1305_fused_H
+
+#include "implementations.h"
+
+extern struct chacha20poly1305_implementation chacha20poly1305_fused_implementation;
+
+#endif
@@ -0,0 +1,239 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_chacha20poly1305.h"
+#include "crypto_onetimeauth_poly1305.h"
+#include "crypto_stream_chacha20.h"
+#include "crypto_verify_16.h"
+#include "utils.h"
+
+#include "private/common.h"
+
+#include "chacha20poly1305_ref.h"
+
+/*
+ * Two passes over the message: one through the ChaCha20 dispatcher, one
+ * through the Poly1305 dispatcher. Each pass gets whichever vectorized
+ * kernel was picked for its primitive.
+ */
+
+static const unsigned char _pad0[16] = { 0 };
+
+static int
+ietf_encrypt_detached(unsigned char *c, unsigned char *mac,
+                      const unsigned char *m, unsigned long long mlen,
+                      const unsigned char *ad, unsigned long long adlen,
+                      const unsigned char *npub, const unsigned char *k)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     block0[64U];
+    unsigned char                     slen[8U];
+
+    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    crypto_onetimeauth_poly1305_init(&state, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    crypto_onetimeauth_poly1305_update(&state, ad, adlen);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+
+    crypto_stream_chacha20_ietf_xor_ic(c, m, mlen, npub, 1U, k);
+
+    crypto_onetimeauth_poly1305_update(&state, c, mlen);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, mac);
+    sodium_memzero(&state, sizeof state);
+
+    return 0;
+}
+
+static int
+ietf_decrypt_detached(unsigned char *m, const unsigned char *c,
+                      unsigned long long clen, const unsigned char *mac,
+                      const unsigned char *ad, unsigned long long adlen,
+                      const unsigned char *npub, const unsigned char *k)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     block0[64U];
+    unsigned char                     slen[8U];
+    unsigned char                     computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned long long                mlen;
+    int                               ret;
+
+    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    crypto_onetimeauth_poly1305_init(&state, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    crypto_onetimeauth_poly1305_update(&state, ad, adlen);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+
+    mlen = clen;
+    crypto_onetimeauth_poly1305_update(&state, c, mlen);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, computed_mac);
+    sodium_memzero(&state, sizeof state);
+
+    COMPILER_ASSERT(sizeof computed_mac == 16U);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        memset(m, 0, mlen);
+        return -1;
+    }
+    crypto_stream_chacha20_ietf_xor_ic(m, c, mlen, npub, 1U, k);
+
+    return 0;
+}
+
+/*
+ * XORs the keystream starting at message offset *pos. A segment that ends
+ * inside a block leaves that block's keystream in ks for the next one.
+ */
+static void
+segment_xor(unsigned char *out, const unsigned char *in, unsigned long long len,
+            unsigned long long *pos, unsigned char ks[64U],
+            const unsigned char *npub, const unsigned char *k)
+{
+    unsigned long long off = *pos & 63U;
+    unsigned long long n;
+    unsigned long long i;
+
+    if (off != 0U) {
+        n = 64U - off < len ? 64U - off : len;
+        for (i = 0U; i < n; i++) {
+            out[i] = in[i] ^ ks[off + i];
+        }
+        out += n;
+        in += n;
+        len -= n;
+        *pos += n;
+    }
+    if (len == 0U) {
+        return;
+    }
+    crypto_stream_chacha20_ietf_xor_ic(out, in, len, npub,
+                                       (uint32_t) (1U + *pos / 64U), k);
+    *pos += len;
+    if ((*pos & 63U) != 0U) {
+        memset(ks, 0, 64U);
+        crypto_stream_chacha20_ietf_xor_ic(ks, ks, 64U, npub,
+                                           (uint32_t) (1U + *pos / 64U), k);
+    }
+}
+
+static void
+segments_mac_init(crypto_onetimeauth_poly1305_state *state,
+                  const unsigned char *ad, unsigned long long adlen,
+                  const unsigned char *npub, const unsigned char *k)
+{
+    unsigned char block0[64U];
+
+    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    crypto_onetimeauth_poly1305_init(state, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    crypto_onetimeauth_poly1305_update(state, ad, adlen);
+    crypto_onetimeauth_poly1305_update(state, _pad0, (0x10 - adlen) & 0xf);
+}
+
+static void
+segments_mac_final(crypto_onetimeauth_poly1305_state *state, unsigned char *mac,
+                   unsigned long long adlen, unsigned long long mlen)
+{
+    unsigned char slen[8U];
+
+    crypto_onetimeauth_poly1305_update(state, _pad0, (0x10 - mlen) & 0xf);
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(state, slen, sizeof slen);
+
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(state, mac);
+    sodium_memzero(state, sizeof *state);
+}
+
+static int
+ietf_encryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs, size_t nsegs,
+              unsigned long long mlen, unsigned char *mac,
+              const unsigned char *ad, unsigned long long adlen,
+              const unsigned char *npub, const unsigned char *k)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     ks[64U];
+    unsigned long long                pos = 0U;
+    size_t                            i;
+
+    segments_mac_init(&state, ad, adlen, npub, k);
+    for (i = 0U; i < nsegs; i++) {
+        segment_xor(segs[i].out, segs[i].in, segs[i].len, &pos, ks, npub, k);
+        crypto_onetimeauth_poly1305_update(&state, segs[i].out, segs[i].len);
+    }
+    sodium_memzero(ks, sizeof ks);
+    segments_mac_final(&state, mac, adlen, mlen);
+
+    return 0;
+}
+
+static int
+ietf_decryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs, size_t nsegs,
+              unsigned long long mlen, const unsigned char *mac,
+              const unsigned char *ad, unsigned long long adlen,
+              const unsigned char *npub, const unsigned char *k)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     ks[64U];
+    unsigned char                     computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned long long                pos = 0U;
+    size_t                            i;
+    int                               ret;
+
+    segments_mac_init(&state, ad, adlen, npub, k);
+    for (i = 0U; i < nsegs; i++) {
+        crypto_onetimeauth_poly1305_update(&state, segs[i].in, segs[i].len);
+    }
+    segments_mac_final(&state, computed_mac, adlen, mlen);
+
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (ret != 0) {
+        for (i = 0U; i < nsegs; i++) {
+            if (segs[i].len > 0U) {
+                memset(segs[i].out, 0, segs[i].len);
+            }
+        }
+        return -1;
+    }
+    for (i = 0U; i < nsegs; i++) {
+        segment_xor(segs[i].out, segs[i].in, segs[i].len, &pos, ks, npub, k);
+    }
+    sodium_memzero(ks, sizeof ks);
+
+    return 0;
+}
+
+struct chacha20poly1305_implementation chacha20poly1305_ref_implementation = {
+    SODIUM_C99(.ietf_encrypt_detached =) ietf_encrypt_detached,
+    SODIUM_C99(.ietf_decrypt_detached =) ietf_decrypt_detached,
+    SODIUM_C99(.ietf_encryptv =) ietf_encryptv,
+    SODIUM_C99(.ietf_decryptv =) ietf_decryptv
+};
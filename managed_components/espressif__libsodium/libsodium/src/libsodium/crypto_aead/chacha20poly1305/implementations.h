@@ -0,0 +1,28 @@
+#ifndef chacha20poly1305_implementations_H
+#define chacha20poly1305_implementations_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto_aead_chacha20poly1305.h"
+
+typedef struct chacha20poly1305_implementation {
+    int (*ietf_encrypt_detached)(unsigned char *c, unsigned char *mac,
+                                 const unsigned char *m, unsigned long long mlen,
+                                 const unsigned char *ad, unsigned long long adlen,
+                                 const unsigned char *npub, const unsigned char *k);
+    int (*ietf_decrypt_detached)(unsigned char *m, const unsigned char *c,
+                                 unsigned long long clen, const unsigned char *mac,
+                                 const unsigned char *ad, unsigned long long adlen,
+                                 const unsigned char *npub, const unsigned char *k);
+    int (*ietf_encryptv)(const crypto_aead_chacha20poly1305_ietf_segment *segs, size_t nsegs,
+                         unsigned long long mlen, unsigned char *mac,
+                         const unsigned char *ad, unsigned long long adlen,
+                         const unsigned char *npub, const unsigned char *k);
+    int (*ietf_decryptv)(const crypto_aead_chacha20poly1305_ietf_segment *segs, size_t nsegs,
+                         unsigned long long mlen, const unsigned char *mac,
+                         const unsigned char *ad, unsigned long long adlen,
+                         const unsigned char *npub, const unsigned char *k);
+} chacha20poly1305_implementation;
+
+#endif
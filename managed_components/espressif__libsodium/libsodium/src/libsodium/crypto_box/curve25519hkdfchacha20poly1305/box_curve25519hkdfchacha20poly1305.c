@@ -0,0 +1,269 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_chacha20poly1305.h"
+#include "crypto_box_curve25519hkdfchacha20poly1305.h"
+#include "crypto_kdf_hkdf_sha512.h"
+#include "crypto_scalarmult_curve25519.h"
+#include "private/common.h"
+#include "randombytes.h"
+#include "utils.h"
+
+int
+crypto_box_curve25519hkdfchacha20poly1305_keypair(unsigned char *pk,
+                                                  unsigned char *sk)
+{
+    randombytes_buf(sk, crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES);
+
+    return crypto_scalarmult_curve25519_base(pk, sk);
+}
+
+int
+crypto_box_curve25519hkdfchacha20poly1305_beforenm(
+    crypto_box_curve25519hkdfchacha20poly1305_state *state,
+    const unsigned char *pk, const unsigned char *sk)
+{
+    if (crypto_scalarmult_curve25519(state->shared, sk, pk) != 0) {
+        sodium_memzero(state, sizeof *state);
+        return -1;
+    }
+    return 0;
+}
+
+int
+crypto_box_curve25519hkdfchacha20poly1305_derive_key(
+    unsigned char k[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES],
+    const crypto_box_curve25519hkdfchacha20poly1305_state *state,
+    const unsigned char *salt, size_t salt_len,
+    const char *info, size_t info_len)
+{
+    unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES];
+    int           ret;
+
+    crypto_kdf_hkdf_sha512_extract(prk, salt, salt_len,
+                                   state->shared, sizeof state->shared);
+    ret = crypto_kdf_hkdf_sha512_expand(k, crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES,
+                                        info, info_len, prk);
+    sodium_memzero(prk, sizeof prk);
+
+    return ret;
+}
+
+int
+crypto_box_curve25519hkdfchacha20poly1305_resume(
+    crypto_box_curve25519hkdfchacha20poly1305_state *next,
+    const crypto_box_curve25519hkdfchacha20poly1305_state *state,
+    const unsigned char *salt, size_t salt_len,
+    const char *info, size_t info_len)
+{
+    unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES];
+    unsigned char shared[sizeof next->shared];
+    int           ret;
+
+    crypto_kdf_hkdf_sha512_extract(prk, salt, salt_len,
+                                   state->shared, sizeof state->shared);
+    ret = crypto_kdf_hkdf_sha512_expand(shared, sizeof shared, info, info_len, prk);
+    memcpy(next->shared, shared, sizeof shared); /* next may alias state */
+    sodium_memzero(prk, sizeof prk);
+    sodium_memzero(shared, sizeof shared);
+
+    return ret;
+}
+
+int
+crypto_box_curve25519hkdfchacha20poly1305_detached_afternm(
+    unsigned char *c, unsigned char *mac, const unsigned char *m,
+    unsigned long long mlen, const unsigned char *ad, unsigned long long adlen,
+    const unsigned char *n, const unsigned char *k)
+{
+    return crypto_aead_chacha20poly1305_ietf_encrypt_detached(c, mac, NULL, m, mlen,
+                                                              ad, adlen, NULL, n, k);
+}
+
+int
+crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(
+    unsigned char *m, const unsigned char *c, const unsigned char *mac,
+    unsigned long long clen, const unsigned char *ad, unsigned long long adlen,
+    const unsigned char *n, const unsigned char *k)
+{
+    return crypto_aead_chacha20poly1305_ietf_decrypt_detached(m, NULL, c, clen, mac,
+                                                              ad, adlen, n, k);
+}
+
+void
+crypto_box_curve25519hkdfchacha20poly1305_cache_init(
+    crypto_box_curve25519hkdfchacha20poly1305_cache *cache)
+{
+    sodium_memzero(cache, sizeof *cache);
+}
+
+/*
+ * Sessions replace the one with the same identifier, if any, then go to a
+ * free slot, or replace the least recently stored one. A session can be
+ * taken only once: resuming it stores its successor.
+ */
+void
+crypto_box_curve25519hkdfchacha20poly1305_cache_store(
+    crypto_box_curve25519hkdfchacha20poly1305_cache *cache,
+    const unsigned char id[crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES],
+    const crypto_box_curve25519hkdfchacha20poly1305_state *state,
+    const unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES])
+{
+    size_t i;
+    size_t victim = 0U;
+
+    if (++cache->clock == 0U) {
+        crypto_box_curve25519hkdfchacha20poly1305_cache_init(cache);
+        cache->clock = 1U;
+    }
+    for (i = 1U; i < crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS; i++) {
+        if (cache->slots[i].stamp < cache->slots[victim].stamp) {
+            victim = i;
+        }
+    }
+    for (i = 0U; i < crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS; i++) {
+        if (cache->slots[i].stamp != 0U &&
+            sodium_memcmp(cache->slots[i].id, id, sizeof cache->slots[i].id) == 0) {
+            victim = i;
+        }
+    }
+    memcpy(cache->slots[victim].id, id, sizeof cache->slots[victim].id);
+    memcpy(&cache->slots[victim].state, state, sizeof *state);
+    memcpy(cache->slots[victim].peer, peer, sizeof cache->slots[victim].peer);
+    cache->slots[victim].stamp = cache->clock;
+}
+
+/* dst = src if mask is 0xff, unchanged if it is 0 */
+static void
+cache_cmov(unsigned char *dst, const unsigned char *src, size_t len,
+           unsigned char mask)
+{
+    size_t i;
+
+    for (i = 0U; i < len; i++) {
+        dst[i] ^= (unsigned char) ((dst[i] ^ src[i]) & mask);
+    }
+}
+
+/*
+ * Every slot is compared, copied from and wiped through masks, whether it
+ * matches or not, so that the time taken does not tell which slot holds
+ * the identifier, or whether one does.
+ */
+int
+crypto_box_curve25519hkdfchacha20poly1305_cache_take(
+    crypto_box_curve25519hkdfchacha20poly1305_state *state,
+    unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES],
+    crypto_box_curve25519hkdfchacha20poly1305_cache *cache,
+    const unsigned char id[crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES])
+{
+    unsigned char *slot;
+    size_t         i;
+    size_t         j;
+    unsigned int   found = 0U;
+    unsigned int   match;
+    unsigned char  mask;
+
+    for (i = 0U; i < crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS; i++) {
+        match = (unsigned int) (((uint64_t) cache->slots[i].stamp - 1U) >> 63) ^ 1U;
+        match &= (unsigned int) (sodium_memcmp(cache->slots[i].id, id,
+                                               sizeof cache->slots[i].id) + 1);
+        match &= found ^ 1U;
+        found |= match;
+        mask = (unsigned char) -match;
+        cache_cmov(state->shared, cache->slots[i].state.shared,
+                   sizeof state->shared, mask);
+        if (peer != NULL) {
+            cache_cmov(peer, cache->slots[i].peer, sizeof cache->slots[i].peer, mask);
+        }
+        slot = (unsigned char *) &cache->slots[i];
+        for (j = 0U; j < sizeof cache->slots[i]; j++) {
+            slot[j] &= (unsigned char) ~mask;
+        }
+    }
+    return (int) found - 1;
+}
+
+void
+crypto_box_curve25519hkdfchacha20poly1305_cache_forget(
+    crypto_box_curve25519hkdfchacha20poly1305_cache *cache,
+    const unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES])
+{
+    size_t i;
+
+    for (i = 0U; i < crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS; i++) {
+        if (cache->slots[i].stamp != 0U &&
+            (peer == NULL ||
+             sodium_memcmp(cache->slots[i].peer, peer, sizeof cache->slots[i].peer) == 0)) {
+            sodium_memzero(&cache->slots[i], sizeof cache->slots[i]);
+        }
+    }
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_publickeybytes(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_secretkeybytes(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_keybytes(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_noncebytes(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_NONCEBYTES;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_macbytes(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_MACBYTES;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_sessionidbytes(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_peerbytes(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_cacheslots(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_messagebytes_max(void)
+{
+    return crypto_box_curve25519hkdfchacha20poly1305_MESSAGEBYTES_MAX;
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_statebytes(void)
+{
+    return sizeof(crypto_box_curve25519hkdfchacha20poly1305_state);
+}
+
+size_t
+crypto_box_curve25519hkdfchacha20poly1305_cachebytes(void)
+{
+    return sizeof(crypto_box_curve25519hkdfchacha20poly1305_cache);
+}
@@ -637,6 +637,21 @@ ge25519_cmov8_base(ge25519_precomp *t, const int pos, const signed char b)
     ge25519_cmov8(t, base[pos], b);
 }
 
+#ifdef ED25519_COMB_TABLE
+static void
+ge25519_cmov8_base_comb(ge25519_precomp *t, const int pos, const signed char b)
+{
+    static const ge25519_precomp base_comb[32][8] = { /* base_comb[i][j] = 16*(j+1)*256^i*B */
+# ifdef HAVE_TI_MODE
+#  include "fe_51/base_comb.h"
+# else
+#  include "fe_25_5/base_comb.h"
+# endif
+    };
+    ge25519_cmov8(t, base_comb[pos], b);
+}
+#endif
+
 static void
 ge25519_cmov8_cached(ge25519_cached *t, const ge25519_cached cached[8], const signed char b)
 {
@@ -696,6 +711,14 @@ ge25519_tobytes(unsigned char *s, const ge25519_p2 *h)
     s[31] ^= fe25519_isnegative(x) << 7;
 }
 
+static const ge25519_precomp Bi[8] = { /* B,3B,5B,7B,9B,11B,13B,15B */
+#ifdef HAVE_TI_MODE
+# include "fe_51/base2.h"
+#else
+# include "fe_25_5/base2.h"
+#endif
+};
+
 /*
  r = a * A + b * B
  where a = a[0]+256*a[1]+...+256^31 a[31].
@@ -709,13 +732,6 @@ void
 ge25519_double_scalarmult_vartime(ge25519_p2 *r, const unsigned char *a,
                                   const ge25519_p3 *A, const unsigned char *b)
 {
-    static const ge25519_precomp Bi[8] = {
-#ifdef HAVE_TI_MODE
-# include "fe_51/base2.h"
-#else
-# include "fe_25_5/base2.h"
-#endif
-    };
     signed char    aslide[256];
     signed char    bslide[256];
     ge25519_cached Ai[8]; /* A,3A,5A,7A,9A,11A,13A,15A */
@@ -791,6 +807,87 @@ ge25519_double_scalarmult_vartime(ge25519_p2 *r, const unsigned char *a,
     }
 }
 
+/*
+ r = b * B + a[0] * A[0] + ... + a[n-1] * A[n-1]
+ where the scalars are encoded as in ge25519_double_scalarmult_vartime().
+ B is the Ed25519 base point (x,4/5) with x positive.
+
+ Ai and aslide are scratch space for n points: the odd multiples of each
+ A[k] and the signed digits of each a[k]. The doublings are shared by all
+ the points (Straus' method), which is what makes batches cheaper than
+ separate double scalar multiplications.
+
+ Only used for batch signatures verification.
+ */
+
+void
+ge25519_multi_scalarmult_vartime(ge25519_p2 *r, const unsigned char *b,
+                                 const unsigned char (*a)[32], const ge25519_p3 *A,
+                                 size_t n, ge25519_cached (*Ai)[8],
+                                 signed char (*aslide)[256])
+{
+    signed char  bslide[256];
+    ge25519_p1p1 t;
+    ge25519_p3   u;
+    ge25519_p3   A2;
+    size_t       k;
+    int          i, j;
+
+    slide_vartime(bslide, b);
+    for (k = 0; k < n; k++) {
+        slide_vartime(aslide[k], a[k]);
+
+        ge25519_p3_to_cached(&Ai[k][0], &A[k]);
+        ge25519_p3_dbl(&t, &A[k]);
+        ge25519_p1p1_to_p3(&A2, &t);
+        for (j = 1; j < 8; j++) {
+            ge25519_add(&t, &A2, &Ai[k][j - 1]);
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_p3_to_cached(&Ai[k][j], &u);
+        }
+    }
+
+    ge25519_p2_0(r);
+
+    for (i = 255; i >= 0; --i) {
+        if (bslide[i]) {
+            break;
+        }
+        for (k = 0; k < n; k++) {
+            if (aslide[k][i]) {
+                break;
+            }
+        }
+        if (k < n) {
+            break;
+        }
+    }
+
+    for (; i >= 0; --i) {
+        ge25519_p2_dbl(&t, r);
+
+        for (k = 0; k < n; k++) {
+            if (aslide[k][i] > 0) {
+                ge25519_p1p1_to_p3(&u, &t);
+                ge25519_add(&t, &u, &Ai[k][aslide[k][i] / 2]);
+            } else if (aslide[k][i] < 0) {
+                ge25519_p1p1_to_p3(&u, &t);
+                ge25519_sub(&t, &u, &Ai[k][(-aslide[k][i]) / 2]);
+            }
+        }
+
+        if (bslide[i] > 0) {
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_madd(&t, &u, &Bi[bslide[i] / 2]);
+        } else if (bslide[i] < 0) {
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_msub(&t, &u, &Bi[(-bslide[i]) / 2]);
+        }
+
+        ge25519_p1p1_to_p2(r, &t);
+    }
+}
+
 /*
  h = a * p
  where a = a[0]+256*a[1]+...+256^31 a[31]
@@ -900,7 +997,9 @@ ge25519_scalarmult_base(ge25519_p3 *h, const unsigned char *a)
     signed char     e[64];
     signed char     carry;
     ge25519_p1p1    r;
+#ifndef ED25519_COMB_TABLE
     ge25519_p2      s;
+#endif
     ge25519_precomp t;
     int             i;
 
@@ -923,6 +1022,17 @@ ge25519_scalarmult_base(ge25519_p3 *h, const unsigned char *a)
 
     ge25519_p3_0(h);
 
+#ifdef ED25519_COMB_TABLE
+    /* odd digits come pre-multiplied by 16: no doublings */
+    for (i = 0; i < 64; i += 2) {
+        ge25519_cmov8_base_comb(&t, i / 2, e[i + 1]);
+        ge25519_madd(&r, h, &t);
+        ge25519_p1p1_to_p3(h, &r);
+        ge25519_cmov8_base(&t, i / 2, e[i]);
+        ge25519_madd(&r, h, &t);
+        ge25519_p1p1_to_p3(h, &r);
+    }
+#else
     for (i = 1; i < 64; i += 2) {
         ge25519_cmov8_base(&t, i / 2, e[i]);
         ge25519_madd(&r, h, &t);
@@ -943,6 +1053,7 @@ ge25519_scalarmult_base(ge25519_p3 *h, const unsigned char *a)
         ge25519_madd(&r, h, &t);
         ge25519_p1p1_to_p3(h, &r);
     }
+#endif
 }
 
 /* multiply by the order of the main subgroup l = 2^252+27742317777372353535851937790883648493 */
@@ -0,0 +1,1344 @@
+{ /* 0/31 */
+  {
+    { 1412482364088822, 1810590036362821, 923779398567548, 2023841154802081, 355905946953295 },
+    { 89929455382003, 409881867087833, 601740464114195, 1198413365513369, 1353640795548072 },
+    { 1825728698698411, 497946242397168, 105715611816086, 968568072676853, 592999326381074 }
+  },
+  {
+    { 697390239916431, 1979948019919137, 219386298782941, 1322163545375974, 2216896082446062 },
+    { 2243384404640579, 785474317161769, 1966836974893905, 484861779306458, 182878807563947 },
+    { 743917567567859, 870447381138646, 392196079309387, 1786878704882853, 1520161635991866 }
+  },
+  {
+    { 837738163844765, 1888948267748046, 1789290739253972, 345950321621651, 890962267685143 },
+    { 240845230049176, 892862609315587, 742407066185927, 398043635328896, 420093919257918 },
+    { 1764333363430455, 898309455329908, 1381444383468949, 620561614151766, 158377983927494 }
+  },
+  {
+    { 17312075132209, 979788843744677, 871430968010085, 1299656894822779, 1180051671372258 },
+    { 1437746335671579, 1161524116603216, 612164096500525, 996617112698868, 969716318261981 },
+    { 407953783981, 1647278360877740, 584504284208188, 906066565536232, 1341016264992694 }
+  },
+  {
+    { 129625489252573, 1387820520945503, 874186954557962, 211932663503866, 1933613400499820 },
+    { 180546948364949, 2161170911946791, 1670848345551833, 753642680531476, 2190316738651690 },
+    { 286790540720370, 376171092666609, 1535083117539001, 143466475958698, 1595136426572043 }
+  },
+  {
+    { 577289733493044, 1790256014216199, 1797656649279268, 311091238837443, 493980515519392 },
+    { 2025760966125832, 102033327397065, 115646513104586, 1232705905425061, 485822002465270 },
+    { 62004126799683, 1668357417723485, 402010966421038, 827662362499868, 620754241677270 }
+  },
+  {
+    { 1227888687423439, 661378171709698, 160494423168774, 553331170800292, 1308360976872087 },
+    { 1667596759313896, 1586859001230089, 1499039432506846, 1474874425327380, 1579412813166531 },
+    { 1643929373822818, 59659873139317, 1165353313134798, 2003225793255085, 1953102130608543 }
+  },
+  {
+    { 898618711827587, 1314215296781160, 1302503840208753, 1244939174414641, 1698289814254751 },
+    { 1863200156658018, 1022256865883135, 1702323481131932, 1517463390341654, 1993268869301555 },
+    { 1392999845620760, 634309693840701, 815492400002072, 340703897996290, 2038693787178716 }
+  }
+},
+{ /* 1/31 */
+  {
+    { 423177393666002, 81745418621691, 2028971153113313, 476357540333955, 1525930694244524 },
+    { 2111527632783832, 450040158835276, 2024085682500627, 1804656400081649, 1628769314539400 },
+    { 1435691822393684, 1850026012837208, 2218717487026642, 81859254010196, 244808221751742 }
+  },
+  {
+    { 821837003520378, 1758499246064311, 611427618116979, 1826926617406750, 190751450672812 },
+    { 1899219292317099, 301143383160140, 1505423608269154, 262436526053886, 1603944942225467 },
+    { 1428688544729295, 109069749881410, 270830364539996, 1755181768867140, 162349670944771 }
+  },
+  {
+    { 387321772446342, 157157592651549, 1734448286334816, 737995238873311, 2164082093074358 },
+    { 138427770525630, 1006458583514274, 50156603826175, 564841532066850, 1867325910960689 },
+    { 309881142350067, 2106019349943259, 816133263871674, 2018031260992166, 1563425406132832 }
+  },
+  {
+    { 1498799085180043, 1744340656397133, 2064851197592072, 178034001090864, 2145324400616904 },
+    { 2143695105244535, 759647590919964, 1665346117918695, 508167339935601, 1875842900408800 },
+    { 614788980313577, 1501513053451003, 1472055221710495, 1920317897819127, 2208964791748263 }
+  },
+  {
+    { 2150595732685719, 864120654414656, 1640951315905192, 1214130519042771, 456097105512669 },
+    { 1308984279657470, 490762851431257, 1003676583936381, 2193756292296678, 450872048228751 },
+    { 612249867445962, 159208429955777, 563950177277347, 561041393363217, 1270750549218661 }
+  },
+  {
+    { 2055033216205046, 210032758889177, 490891442200825, 1052243367900375, 500299953983352 },
+    { 16580842158665, 1696274359000911, 2124389411830829, 139711129303025, 888869530492522 },
+    { 1827261746419924, 1468053133723229, 425022050209163, 1161272199376693, 589189496874922 }
+  },
+  {
+    { 2005207463235272, 2001528853385595, 1602253387656095, 850080090066646, 123526059515759 },
+    { 2186723082510000, 1171729756607414, 378838991362655, 1322228051184542, 2245735889737124 },
+    { 847469444462207, 318959830531389, 408429171873782, 1661514071773102, 909441091898553 }
+  },
+  {
+    { 2174491994328155, 493557282042709, 1350905374864565, 998113744991988, 496681585664265 },
+    { 1850443852254769, 1964063521171136, 2156578506765080, 119377851781170, 1787528661543958 },
+    { 758760864397232, 1830650226770835, 326981597370189, 1345979301472296, 174985669849506 }
+  }
+},
+{ /* 2/31 */
+  {
+    { 1907837041515237, 898421797873440, 1363421772307007, 1869148099628409, 252053503603382 },
+    { 1983475287633675, 383067298392598, 1529372645239762, 271237723417042, 16306006127885 },
+    { 45902352975738, 1246446699820833, 173320410042641, 1542230462600972, 692910725375140 }
+  },
+  {
+    { 710084928405467, 2105676789486896, 168843193799662, 353334820683649, 1050869817514446 },
+    { 2234556940968142, 508383103687203, 548677296961294, 1801756227307155, 763581134184080 },
+    { 2191680341805656, 1972509245077282, 981795995975654, 852454486043614, 1189735660434765 }
+  },
+  {
+    { 1743977233997800, 1581920097003352, 192244940755923, 2232313400412572, 1420975603500953 },
+    { 394331370968199, 375506683250477, 178987122837126, 1628597680090539, 1981626777721129 },
+    { 1931343025077052, 1393738210614177, 622857924319466, 1123524882306454, 1963513295012502 }
+  },
+  {
+    { 1850504730697909, 2129879659168370, 2011448898092861, 2090154061858281, 1857166627539261 },
+    { 93122640069162, 80390620181922, 904913824687012, 878714325670358, 2009239140681625 },
+    { 1509035496076582, 1583601071466027, 421912810565136, 1678479534084506, 2033502297510813 }
+  },
+  {
+    { 2238137325796934, 1165391281982950, 2048774700033766, 1309041739154703, 952882074105884 },
+    { 648683464284688, 918118399351936, 1745356360731796, 498388366566450, 2218312233818996 },
+    { 520151332809519, 1588829471961614, 2166353389460390, 404024831468766, 1335244071323823 }
+  },
+  {
+    { 276674675630644, 2071299735249834, 367425156502024, 1019665374394195, 1519932762444250 },
+    { 140650035965992, 4102126210825, 1340382612618316, 1431330732152485, 95392378361840 },
+    { 1935180256227856, 250757393177447, 1959439731378182, 1297506762666169, 575184640324100 }
+  },
+  {
+    { 1312014106178185, 1486712601904121, 727281996805526, 1807789883906315, 1294755680282130 },
+    { 1746208083129163, 286040119208595, 923407701729416, 1058134233102422, 2156333962869932 },
+    { 1438068615152094, 34949160848567, 1911746456436447, 1412684293826264, 1046374507505090 }
+  },
+  {
+    { 1493476678908327, 1067355251760666, 2088667670293412, 1347426012722422, 874958688794590 },
+    { 1106398809275628, 1328345218773061, 1782306826891988, 2161245407418976, 674877440657824 },
+    { 1428599160764785, 602821281250279, 1877258833313507, 333285098655770, 740310036947361 }
+  }
+},
+{ /* 3/31 */
+  {
+    { 622985803843745, 1037465406252873, 1045087237459432, 35039786059068, 786748793374779 },
+    { 1081639936085048, 107037096524550, 982783085397386, 1478794236122441, 1973445033407428 },
+    { 1152063960223905, 1495207756023516, 403624329924470, 288757773501508, 634701074033280 }
+  },
+  {
+    { 666083887617405, 673285785424434, 1762910413161601, 912132719741983, 462281505628903 },
+    { 2036807708438173, 343296519154494, 203759671035838, 631607941505392, 1537534416157211 },
+    { 204576686258175, 1916354881141604, 2182213405559566, 836541881049164, 1393662576855498 }
+  },
+  {
+    { 1429326167011008, 1597736985440061, 15497090767177, 1401818346447299, 2008400870233861 },
+    { 1255845370440482, 1941641023944959, 741447215809463, 71123411326285, 958784689852576 },
+    { 1583200791922713, 581155064879634, 776749520692821, 82151283071376, 1733847968592305 }
+  },
+  {
+    { 471657679736049, 36304457446248, 1889807602666694, 571526543144584, 2151183507738315 },
+    { 1320619393211836, 1830783765803799, 733116888584824, 192154761237340, 1836129819319417 },
+    { 216379584390389, 359329711860756, 2220840445637019, 1935487238453911, 314381139238943 }
+  },
+  {
+    { 2134908988986295, 710707389294819, 1681144354786143, 1678261855220080, 2165079891714277 },
+    { 1820833315022596, 1614503197118753, 768314454089893, 439418882707913, 444366931195669 },
+    { 839191618399610, 151822034158330, 65272611705697, 938153274860627, 14360318777459 }
+  },
+  {
+    { 1473478682616257, 1381582770189518, 1909784146543314, 1098186893113858, 993668408613516 },
+    { 866614735832317, 247068397163249, 2137773260671377, 1435769942740467, 835303919685078 },
+    { 364270308207016, 667227739516977, 122427551474936, 957177061876827, 1110258403339423 }
+  },
+  {
+    { 1475819827325245, 1181551732606965, 348788859640155, 217255130824332, 1133565804562478 },
+    { 2004412139637791, 1152281141937617, 644111456763199, 1263546682508663, 1745485513281276 },
+    { 858909692206820, 61057235030988, 1105898533486092, 2202030785898301, 1422234761465688 }
+  },
+  {
+    { 1354120322856557, 1315215183190037, 873849392207479, 969776210885688, 1552605391252884 },
+    { 62769891776663, 1685142666023085, 443051725399699, 1094137944849531, 1786990183014737 },
+    { 758252632702114, 914226082256766, 434171717412081, 779505540917105, 51590353584795 }
+  }
+},
+{ /* 4/31 */
+  {
+    { 1773953341907125, 1826809791300708, 924874532383668, 712490100943736, 748251880846901 },
+    { 1773696272644354, 524584715796245, 2052807431577622, 1474261915840483, 1472344085384396 },
+    { 1048828262296911, 626018299495748, 1536855937015065, 557005099579827, 205000143299648 }
+  },
+  {
+    { 941815577996700, 1930911276112812, 749821254542917, 1967675522206375, 892948220720651 },
+    { 1434849833149473, 1179935727179617, 1288878261580880, 251520331051845, 2174778140013271 },
+    { 39364207708032, 54077643340559, 47072300438335, 484490203728205, 330170579231628 }
+  },
+  {
+    { 1020447780607298, 551245056565558, 1618835409581890, 673850310162293, 354159319190084 },
+    { 199234941368169, 1039878917333290, 1138631272437872, 1506846618426377, 651537961859356 },
+    { 1190283817822151, 29815862110548, 1401771831527381, 1814017508050437, 751331585591881 }
+  },
+  {
+    { 2159866514586362, 1758376548473728, 1635569740383557, 192110938352718, 2023235829583534 },
+    { 605995978939884, 48218004293082, 461040418591673, 316385510440522, 1980476765721118 },
+    { 535848012622913, 543536404720769, 149076814975879, 1567757637416350, 1002851193383852 }
+  },
+  {
+    { 850247344591371, 1642810784021239, 1974409276090170, 1605973976114297, 1350011424543020 },
+    { 1563762061819676, 483704726889726, 378890223689177, 614454628872887, 138207457619482 },
+    { 66796032196982, 83108349878636, 1058512765854606, 355785880766958, 2173660513649027 }
+  },
+  {
+    { 1941123290917747, 65177497691743, 661963569507333, 1172954226263396, 1951085968954154 },
+    { 633834845666480, 1266075508915353, 932911917033228, 2013039593891141, 2014375254042349 },
+    { 1331723279107642, 360406964548232, 602431788387748, 1292398959539176, 347247628588850 }
+  },
+  {
+    { 2170226002806049, 1739335733478471, 1765672611311764, 666860341980082, 542065866111114 },
+    { 928917294762421, 827086505179749, 79913563808991, 1363419744736215, 1159465025606665 },
+    { 245885669910192, 255454579697350, 869246923980317, 823008017430135, 2047987637517532 }
+  },
+  {
+    { 1363748633264621, 134440781639129, 1969460953567930, 687618113673021, 1831662708850446 },
+    { 484597594561270, 1872466346130086, 1773863188829220, 2151270062723810, 574178361260864 },
+    { 1325588019367749, 1763566216507756, 445592400440775, 1009027711126237, 1471076108623188 }
+  }
+},
+{ /* 5/31 */
+  {
+    { 1326059070986772, 1683859889439034, 800400358642626, 1553800812119228, 1435890639134217 },
+    { 10289322871173, 960938633288362, 54790899094325, 355480603420821, 769816521286162 },
+    { 1081752225631401, 201284952113932, 1619339403526661, 1533363030164674, 1727571790703503 }
+  },
+  {
+    { 899735975760499, 1741766716299829, 1742063303545331, 2027626928190420, 2245203856982753 },
+    { 1954377740831254, 964432157821305, 1474491321949063, 395839918315184, 1677872381409569 },
+    { 868012933261061, 1472665613225898, 1744063644616181, 1350305502884983, 2227467074628670 }
+  },
+  {
+    { 1335230745886941, 598728549596672, 722417037613414, 976095242318001, 1349661756105254 },
+    { 165457682597283, 1146916011393707, 790234092480115, 1826324642155959, 1162742112144696 },
+    { 1313383948772993, 1074655824143287, 20040386640896, 305794891855170, 2123092901229151 }
+  },
+  {
+    { 492643442569612, 1013874505344584, 1972732629285783, 1936827407065469, 1830481951704579 },
+    { 1948145815698108, 1342521170841730, 1978080278356424, 1881064851625948, 229238155064023 },
+    { 634737804354539, 422989080575800, 1774993942417585, 688011718282303, 581542014403477 }
+  },
+  {
+    { 265399853542438, 856367096857962, 378771815533299, 1768604592283814, 1437163645108878 },
+    { 565089126521862, 1651981693498760, 1364270015682434, 1021850589179420, 1529046392923632 },
+    { 1683677903016217, 2036167240589310, 262287609979509, 977873833112269, 433284640623898 }
+  },
+  {
+    { 1755760392036140, 2130115351478138, 442625433812754, 2043622709923143, 86495244370338 },
+    { 973803294013993, 865469347514382, 1546238264282843, 1531400184873330, 852951437390016 },
+    { 1425112218383847, 329346717672590, 378517748485393, 1806152114945447, 1211275024279312 }
+  },
+  {
+    { 1968587687914188, 629221916684842, 1429009633828433, 518276827442332, 2012343565772576 },
+    { 1342915774787253, 1592245673934951, 2232778725092237, 861867335158983, 2085695411008232 },
+    { 1629969809602186, 1106234784906336, 863587490378700, 1792807263239898, 1429043938024750 }
+  },
+  {
+    { 1973106012015851, 342123586374596, 833516958919696, 2182197879897069, 1721403407106648 },
+    { 1234205143570590, 574413568977114, 1646424797106159, 300930903818472, 929000726436362 },
+    { 1591076166555979, 849361769125080, 1443799738863429, 166584794343739, 1861773413238536 }
+  }
+},
+{ /* 6/31 */
+  {
+    { 1171837083014025, 264732902278699, 1770010974323604, 266108208353474, 2020794083615322 },
+    { 293218709634113, 1719011489643599, 831619655945737, 1611022286286405, 2006064581746788 },
+    { 762321251771152, 1460210191529427, 2248797163104578, 217468651569622, 63003536153574 }
+  },
+  {
+    { 391588043113892, 2202456919563943, 1617888818929289, 694159965511217, 2143606811138355 },
+    { 2008058364358132, 1051355690609066, 1659991296428347, 1022293360838405, 1042097367448254 },
+    { 719793864170869, 1411477466905009, 1515019021063010, 1483421690183889, 1704042941619334 }
+  },
+  {
+    { 517835973347256, 706523709933216, 1537480429839773, 1483278086593314, 1378968978067758 },
+    { 783163454514521, 1366624508143284, 1863506003869690, 917979662972397, 1583895088313562 },
+    { 1315034452637574, 1172434640681242, 1135533609020364, 253349230877293, 161211572823476 }
+  },
+  {
+    { 407608189412637, 2049444491227494, 342891130347629, 1169428941568801, 848234126951058 },
+    { 1690850439525075, 1667024303418336, 1749847485823236, 736954918508817, 531773443234823 },
+    { 437225545901468, 888271756229202, 903344393515123, 162913205438885, 1475178706291532 }
+  },
+  {
+    { 1455493636488624, 751219268219696, 1525065253586106, 2054680090861517, 1393874745922970 },
+    { 2036122071377878, 537649193830804, 1081885102254542, 1030768092026017, 28673195105264 },
+    { 1910711495320594, 321017884248758, 1651671690842787, 527123817162741, 847944616444202 }
+  },
+  {
+    { 1474221667712465, 816888956654317, 1358088375247374, 1853329794010803, 679495195920834 },
+    { 1163431681760636, 1938797201846954, 401473612016388, 437327642541001, 1477240401828670 },
+    { 70084211861389, 1248863300280704, 1009402227613886, 1445171656255193, 728732085908498 }
+  },
+  {
+    { 617950679184798, 1153392601340918, 502976659155882, 1100510641818701, 618421337595665 },
+    { 1088702065079191, 907323729407776, 1527188956642328, 1091012131984810, 763978074893835 },
+    { 1481950048975238, 97096668186528, 429204027887699, 1510003697018425, 2114825823462494 }
+  },
+  {
+    { 1440929316705148, 1633730452330828, 1405404753609489, 1406118623302575, 309924733037947 },
+    { 656250768022145, 564144318086388, 48310283291479, 2142014283110632, 1641981030879013 },
+    { 809017030155597, 1831934834657405, 58189812416765, 1517873507099267, 889681994437792 }
+  }
+},
+{ /* 7/31 */
+  {
+    { 1179642228804668, 1418657644034850, 675683856213334, 596096446428822, 1170437361620647 },
+    { 1511564286472767, 2184358636968286, 1412906036411316, 89284351539568, 352068421522218 },
+    { 1907217462504765, 679044428705663, 1371479879514675, 1420793148384765, 190685345044087 }
+  },
+  {
+    { 1276705999322783, 1661230352625442, 1205734973860699, 784019563379976, 1449546143149561 },
+    { 637296935955637, 450944727568131, 645072163640910, 309713610901635, 311189073223217 },
+    { 2213525665395526, 146358659614731, 1573034916169973, 1131167148341295, 1194403623212224 }
+  },
+  {
+    { 2105305689409187, 1932040296635725, 307501795091619, 1653053081843051, 1246676406522367 },
+    { 782790693528855, 1519731603158914, 2028140081496226, 1275020033363837, 2056444369633135 },
+    { 1916484225176, 1896106466807315, 1279953155660650, 1725386140841619, 757101416534772 }
+  },
+  {
+    { 2133488547373098, 633134528408434, 1652284377802153, 2035540453530543, 489273649398225 },
+    { 2051614458366870, 728789063070456, 282245488169187, 2178894003553741, 1855341936085133 },
+    { 655928016394658, 1087485647128905, 1281789693328119, 2088439151211398, 1863153332596984 }
+  },
+  {
+    { 210017655980803, 1811183847825904, 1323101412046938, 1360571080713195, 1716626899554003 },
+    { 716543727419056, 2051592790034539, 1445865707531046, 863515409408522, 1102874443417899 },
+    { 1790273650925445, 2180187262630477, 28219260774301, 1951582862584504, 1059160821201578 }
+  },
+  {
+    { 857134543659225, 571584078624683, 457976954128720, 480578452053593, 1695118712507850 },
+    { 1455060305288896, 1678698521692147, 955042089053421, 482480751768889, 972076543638923 },
+    { 95538772778706, 1914880923031197, 417513632407841, 1767845086605839, 832379724270193 }
+  },
+  {
+    { 1456443406045738, 1909385161475434, 816382632051404, 1426587922914898, 2166890266198132 },
+    { 629341497594299, 294953389516334, 1800301282775361, 2224016821184931, 924802345871186 },
+    { 393110820654303, 662371396172458, 1370237312917823, 2034119121136113, 904928937827 }
+  },
+  {
+    { 1257344135899307, 524694436287172, 1637109398723535, 1801319038042246, 2082644998926031 },
+    { 571822557710951, 195833865463720, 1444687327784978, 1429898638089182, 1938057576257967 },
+    { 189274223123103, 2188109173279445, 1461570511269332, 151886143484743, 1557837550414982 }
+  }
+},
+{ /* 8/31 */
+  {
+    { 875483311206750, 1070293195031859, 1281389774974538, 2234860500431395, 778685125379289 },
+    { 61535391329516, 448636217346295, 2080976424777490, 1693183775735280, 1282728854739106 },
+    { 2191861413872447, 1998107865473216, 135161483760725, 1133778951112075, 2177808149908975 }
+  },
+  {
+    { 1355285592679618, 964532200162205, 606767307684972, 180576224889129, 482463910553398 },
+    { 2220808064153177, 176691452047504, 762781849533969, 944930357489006, 1534273731293129 },
+    { 449706520184472, 2214233011551797, 684523848529734, 431843026966950, 1758835924810462 }
+  },
+  {
+    { 1617166089281207, 448710947316786, 2017034644293574, 1886691422085664, 123642336720311 },
+    { 1161442465661288, 21003748063787, 385827624308176, 2122110448433305, 916494441542470 },
+    { 1239614751060180, 254449956067847, 1915952567259905, 391989559805324, 853553448301328 }
+  },
+  {
+    { 1381495390544381, 584763141985101, 879705032985300, 313362758653765, 2037973653370615 },
+    { 1890742306105773, 171853555874878, 1636487436566592, 1018479096469591, 1049093089544630 },
+    { 762375715838646, 553562190209386, 1146347552263484, 824188464596685, 1830942666102590 }
+  },
+  {
+    { 1348374701112873, 1701900740509234, 1150531280942293, 552979832224709, 2204826476892035 },
+    { 1319775590492097, 1988327190606602, 107465387635729, 1267108314610850, 411829441129739 },
+    { 2119092558617159, 1045482671389213, 690197889240825, 471826136635342, 1637923217880356 }
+  },
+  {
+    { 2181081937454965, 1121830291087960, 580779417614728, 873036455797166, 2225668708158200 },
+    { 1807266836472778, 637966070791859, 1481226202132566, 371464048684432, 580205417661681 },
+    { 1193994157146400, 1628108083694642, 1021885296427132, 816068909639879, 2088480068848711 }
+  },
+  {
+    { 1673050054377651, 1765054067091528, 711173592194582, 87474058367652, 1699131689883902 },
+    { 928818711922426, 838829706546979, 504639790201676, 1254264560292085, 35053452202780 },
+    { 2229241184614921, 2107352800266199, 77312115078922, 2151892262530718, 947910914861383 }
+  },
+  {
+    { 1528297312537716, 2187935649407647, 715931603706163, 903221378972329, 1577434241618945 },
+    { 816944747089363, 1889295505677179, 1061560556919768, 681907473170465, 1031466762565130 },
+    { 1385713524190245, 153942078459639, 747467190641094, 1446053675113471, 429215290527338 }
+  }
+},
+{ /* 9/31 */
+  {
+    { 1684548552982170, 260880483365080, 2151565475089601, 2240257948464080, 105534272702509 },
+    { 759532983145199, 1041506031166509, 2098906843949927, 2024575413813287, 1129901033077001 },
+    { 2245889758290233, 1304556815701186, 1427348922813143, 221464961710041, 2149077757654506 }
+  },
+  {
+    { 1200977971745538, 679604753110803, 118640303903686, 13161284424804, 1017048311556209 },
+    { 518289544308872, 2210328310178151, 992468182848569, 1632583101328401, 88660873565255 },
+    { 1190992926530423, 1046016291129455, 1934369009614752, 958221374199446, 762751542850234 }
+  },
+  {
+    { 1196600994744564, 1547369290503378, 2035231477477616, 1257032246257935, 477213736067146 },
+    { 1209177241620207, 898929391359607, 808801284537394, 1245342740956132, 272014677526521 },
+    { 1316355169784636, 2159471323343549, 195437001734225, 1784725127680235, 23628188515854 }
+  },
+  {
+    { 1782397857084708, 48095726564004, 1468513199329122, 1169924369129606, 1452708652401532 },
+    { 2163087320072509, 199316101406292, 1846431193137861, 204046193177858, 1779620820558944 },
+    { 246845927125542, 475207520380026, 1495857355234583, 1332907410765356, 1137190823002655 }
+  },
+  {
+    { 402770419372181, 879148936024281, 171152161387778, 1521258543891684, 1016650524881308 },
+    { 116038458993258, 608632312109909, 1178551838069391, 1820997430699396, 949215725963241 },
+    { 122249525311324, 1126352422834922, 929325077009082, 782368628240853, 94217591211022 }
+  },
+  {
+    { 739195792604578, 770122614286754, 302802129599792, 1502244105829111, 1773114045409669 },
+    { 459035525733650, 770535776464013, 252174834449567, 2131746448577589, 954066860320410 },
+    { 156241863414061, 496518516536107, 402847929676013, 1139792271454333, 1977247161507402 }
+  },
+  {
+    { 211523957170473, 1644670408070226, 756431515781898, 949873124601275, 36660463549794 },
+    { 529214503061057, 257079294506787, 2191069624568715, 1061830060574110, 2065600952844923 },
+    { 1855056967762827, 1495181328549832, 966278130514841, 758391654071223, 467588501531856 }
+  },
+  {
+    { 185100610527958, 1954148435588968, 1712385658617173, 471993490740154, 681838917243490 },
+    { 313435187549042, 1956277154208437, 1365239857368542, 1348897712723582, 126454872238337 },
+    { 1439947543028469, 885225692302481, 1285222886469976, 1588398795428018, 1298691185892088 }
+  }
+},
+{ /* 10/31 */
+  {
+    { 464451590840864, 1631117916585970, 1763058100245834, 2213037729836095, 1396521499150134 },
+    { 1708891979933193, 193606038525586, 1981223293240314, 1300147684220123, 1415690962041537 },
+    { 296206175452724, 658879322369119, 97943562265366, 1761747874053347, 665498744562262 }
+  },
+  {
+    { 1200760264207189, 52939066426767, 1927960174691145, 1569518880089323, 1152309979337507 },
+    { 38546390495599, 61816108201901, 1929402325321447, 2162999785972298, 837806219901868 },
+    { 2038947849479643, 237162323211423, 2065816839891168, 419806183479203, 384865548997533 }
+  },
+  {
+    { 1152764853239608, 30290046791954, 1601380253073466, 898105377854964, 1583948862629235 },
+    { 128932575450262, 2176238657569348, 500334689254643, 1958172022248342, 1015981788056542 },
+    { 1558193059260245, 1778073808602536, 402624851529717, 66752783641769, 824353727713740 }
+  },
+  {
+    { 1987770197713503, 751549594590657, 1878974480372933, 520288146790215, 146577641784525 },
+    { 1870148064878802, 1722962699461314, 2148888862361842, 1498958478808291, 1078521514059403 },
+    { 1021194340773145, 2214506742467645, 1946787888944335, 2047968106648641, 1821857137920583 }
+  },
+  {
+    { 520345345283734, 993525428347841, 830705726342297, 1401316007351696, 272642075430152 },
+    { 313411658320980, 1569700568290857, 1364146655651272, 1389399851157765, 1363175910566070 },
+    { 540709883326476, 664748033877723, 77460650157458, 1882229467398241, 1217186023704288 }
+  },
+  {
+    { 1148904473568401, 40634531148500, 608217842239622, 896886146116791, 1793557015614071 },
+    { 1636905029336861, 770793125827227, 1336171461860292, 201993548186316, 114272157082495 },
+    { 738867948290551, 1113067062951318, 2239418068162676, 2235388618772922, 321946428440080 }
+  },
+  {
+    { 255478373377161, 1965300287234723, 1455241861966706, 106226761267792, 104783220638674 },
+    { 682770171818581, 1445373742074242, 2010927294009799, 933580777601529, 1898007959060472 },
+    { 1141974899967420, 1197500508248512, 1725264994009043, 1639228663875285, 1766256613674282 }
+  },
+  {
+    { 1473307785816396, 2183888493524504, 1340430334743973, 620286732260876, 718894511556160 },
+    { 355530883651858, 1186819460918536, 2022594105067760, 38939679101912, 518229550986997 },
+    { 200438687964996, 1579389594103736, 1144999901302662, 1292188560016150, 1342060233269448 }
+  }
+},
+{ /* 11/31 */
+  {
+    { 831848399557275, 2203944328508070, 1205773492199750, 696100069920808, 1258775953756160 },
+    { 1536600197637719, 735192130338721, 1949638657621950, 1215398877067309, 196061350744259 },
+    { 801855642469056, 1726062700700587, 1064722548099106, 1128997468587175, 1368420390253860 }
+  },
+  {
+    { 1095027470911861, 1309452919940954, 165563932177558, 1165431755382480, 1895316643922204 },
+    { 717156719298230, 1955979138243696, 2199791266029467, 1058002839738406, 1449532534254269 },
+    { 2142749866659158, 1962490102531981, 1691447155265793, 1827079035266074, 3803331638058 }
+  },
+  {
+    { 1104482724596124, 121997531441, 635349471659539, 1384857237573085, 1805272655273783 },
+    { 478069199145280, 1141170740207616, 940257554984262, 897591638444270, 1814438392415312 },
+    { 399619403797256, 1517816986720610, 1503473770785461, 1650204761619743, 2016574488970872 }
+  },
+  {
+    { 1452497321657782, 1539338328736177, 1904958092028386, 1587402592924884, 2189645592400953 },
+    { 1830872026784925, 1623034384028758, 2186083484441019, 1970420851072046, 64231867033146 },
+    { 481460971838645, 495603062939192, 2081146895236470, 971761350637757, 742727604094484 }
+  },
+  {
+    { 209124997731951, 1270184737939192, 1511404974611241, 375249799211988, 1530607726935532 },
+    { 1012073874592193, 42790166525331, 496669786240166, 100229188104254, 1649037173883968 },
+    { 2048665788177445, 1408893800498572, 1918636993246022, 317961445367427, 656800592778138 }
+  },
+  {
+    { 170551136248788, 943103623278344, 1291301021890213, 94515389766570, 1860925285740835 },
+    { 175176261947926, 1399800407330296, 982465035605378, 221509495410385, 2155496689521389 },
+    { 269878912827170, 1290670313639785, 2170448731381563, 1730590899024060, 665688666929019 }
+  },
+  {
+    { 1580177441875156, 254258483925768, 682989882894099, 1061310370544481, 596660656376680 },
+    { 496813734622430, 1096113151371306, 1283642582170893, 1567992629237510, 344025372990045 },
+    { 1957905575869340, 963138800079095, 1346185076450932, 33814819376238, 1624717058267694 }
+  },
+  {
+    { 1661216359883315, 1198665005326425, 1223676681611594, 881743418686048, 635325796191538 },
+    { 610180487982555, 1103087737610894, 1696274700114993, 1767466185217554, 250915004216473 },
+    { 1196599610725063, 2100294611545468, 412113633351820, 925880965367657, 519930913383517 }
+  }
+},
+{ /* 12/31 */
+  {
+    { 1941100238292788, 1530763972357988, 689917761100876, 517834246099702, 1016501476684148 },
+    { 1361281020450455, 1270489161609055, 2229166815777130, 478093075579488, 1028298658754112 },
+    { 402477551873128, 1206353712079331, 1931900782149571, 353151698548753, 227661813611943 }
+  },
+  {
+    { 790360882582618, 1193039775906918, 457074437270605, 1880772252763311, 1647664574467171 },
+    { 1267345491545277, 1040955582161709, 944602568432597, 589216616145824, 2176282068300736 },
+    { 1801318854301087, 529217444026518, 41439150499132, 1819497139150034, 1914318279506430 }
+  },
+  {
+    { 1401592520352142, 2119290268348413, 1662789932544495, 1461053630461698, 1761023449047587 },
+    { 114244238715052, 1711673966360604, 27096215850346, 649231795386780, 1751566257090632 },
+    { 1892648843913435, 1079776332626104, 1111039290977790, 1827479485396386, 859677304170245 }
+  },
+  {
+    { 1955745180210476, 1703319703537271, 2019166049085294, 1111446728934944, 1621319325065514 },
+    { 1631515565881337, 74820660423111, 1234156086642234, 902000684785159, 479946197517415 },
+    { 1700391063795585, 361747633083750, 1216968456947850, 1993842710713264, 601267006969711 }
+  },
+  {
+    { 1335348453199749, 440896739279346, 991468498763434, 1958567111536423, 1194502970771976 },
+    { 421687194725601, 1452210447909774, 1972718778338361, 2245279220138677, 197097958178703 },
+    { 1656217138482787, 491628805607466, 1679451179466805, 970181505842258, 1534105889461948 }
+  },
+  {
+    { 1051919605857270, 437958703079032, 943831089706606, 69819660973933, 1445811115388040 },
+    { 1953169811593624, 587935880863229, 808215721544276, 1172930642871056, 933712923663396 },
+    { 1160289603260459, 1956223108351205, 1733312353955470, 208731931777063, 2163609865075088 }
+  },
+  {
+    { 353960863214443, 267136175486224, 1655039766011589, 100906939435905, 1606429966007504 },
+    { 1668322680159809, 1164890095728715, 2146980235097167, 1096904483609062, 290681949797038 },
+    { 1142834714776341, 85770505106288, 713866520631433, 440023537352050, 178697006218663 }
+  },
+  {
+    { 1815823837273367, 310953977328321, 1539789395052837, 1395950066391658, 1631063017998021 },
+    { 866175525108893, 724819292219605, 2068366674175907, 2097483603288131, 549017403202089 },
+    { 534961844628464, 1393583055120721, 1748351260324708, 1375538226727024, 2193309623120304 }
+  }
+},
+{ /* 13/31 */
+  {
+    { 2219813055094868, 1499254289481425, 764148091645989, 790564725975557, 2174498914560537 },
+    { 787174142558441, 290213816892411, 217164218175754, 1829516411753589, 1841606552724103 },
+    { 1346839273131020, 1947175237418499, 2130499171815608, 841760904333801, 793011313347544 }
+  },
+  {
+    { 453885616355922, 1931337763813344, 1867986078235466, 963301853857219, 951744845930641 },
+    { 1638299625437402, 933125827264344, 1274558365788714, 1878405715151006, 1891383856643984 },
+    { 548016394257586, 1770170736821935, 883041007523403, 1244492123782548, 1874837894534970 }
+  },
+  {
+    { 70945323518187, 1460279620768174, 1656136902347806, 1063047643279494, 95490716967124 },
+    { 1603429813077590, 1647330982585325, 847233104774912, 784486507741078, 513088596765826 },
+    { 1585044732618145, 79674660750176, 2047172033863331, 558016866726219, 1811700039750197 }
+  },
+  {
+    { 1980868732324310, 208050273598170, 1500353534094478, 1977074025846907, 686785408890947 },
+    { 651709082505144, 1321036933983907, 1168392824733552, 893454319309249, 367099342904064 },
+    { 1977199595236300, 927859862391871, 2045825765550850, 1189431662969386, 451125616133550 }
+  },
+  {
+    { 1981177153373343, 1776706813610008, 704834493083627, 2113399644330230, 364175990188877 },
+    { 2013159093575690, 134013672952691, 219590094356753, 1935987407298499, 2018410453134649 },
+    { 1473984112024647, 2212143402178000, 1913009700964560, 489799262080055, 1390546130501803 }
+  },
+  {
+    { 1444538190324287, 44700923154239, 1483385825107722, 732704435299560, 1841400996159655 },
+    { 113833143783930, 517123070721070, 942959239637170, 1594788400320543, 181248812170436 },
+    { 781495195344331, 819872919567170, 2058369589741763, 131552040816437, 1143952030551876 }
+  },
+  {
+    { 1632591054957810, 1584029964350608, 1679919371947982, 1160578263030985, 320556257845570 },
+    { 1541799253522024, 1022364869435484, 1285406421903341, 449471132701656, 2242535465576863 },
+    { 118276417181988, 2048136038162801, 1736078553924029, 677257986431580, 711847529279284 }
+  },
+  {
+    { 1322932513703416, 348483708721842, 625435238632922, 1647316986471087, 1495874784707614 },
+    { 1382315411654289, 1155328561290128, 746170398588834, 1242063022588681, 1283807594473873 },
+    { 889518489432828, 1216748566987677, 2027061052060458, 268044074097160, 1539610510772867 }
+  }
+},
+{ /* 14/31 */
+  {
+    { 177691828723780, 1283094434250488, 1065039300161912, 1977830055676077, 423980805911273 },
+    { 748747339297832, 1135609155306207, 1823617401704634, 2112890298604997, 1132880422123891 },
+    { 2176454779743876, 931093459142961, 2244697379845986, 723779257225747, 962795008037376 }
+  },
+  {
+    { 1861517597691605, 1772481620932890, 377676625275392, 454027945773073, 2107910124630171 },
+    { 1912837811596353, 1062706188835521, 151816288759714, 1928975341682546, 1204168782841137 },
+    { 683279446283480, 2167544438614321, 1975855992985379, 780955320484514, 780910621778643 }
+  },
+  {
+    { 434558441289919, 1927951543046986, 247887434587243, 1241163995738961, 526331455331708 },
+    { 1703744445643093, 2206438520188924, 1360590793044037, 2093233444244748, 605362476106795 },
+    { 1074884828909420, 432905047961772, 1185537826254838, 52144045776742, 1826277929133963 }
+  },
+  {
+    { 2156715047802986, 1276772803921323, 128433708852190, 1960794365816569, 428584705572025 },
+    { 1180853732303989, 373577860927933, 170608019599358, 101879149800615, 226385074242609 },
+    { 1862177374063425, 1873700738552432, 308885709393483, 2100622082080360, 1104535253282502 }
+  },
+  {
+    { 1459840872562735, 421582154826229, 2220646689506683, 1208894292386914, 2152820272048462 },
+    { 1679349250090669, 2002629885813715, 2159329725118112, 1827787758857312, 351765134384947 },
+    { 1565335522994081, 54406341126738, 599331788389250, 1486039135212823, 940991227185565 }
+  },
+  {
+    { 1597264402054136, 1749721095022851, 1211432053366671, 1390398927836990, 1030072339730422 },
+    { 2146657684344428, 426155031380951, 1700774487052680, 2241243783258638, 801862184492916 },
+    { 225800753248600, 1001289196776939, 1570695157447337, 474142387326152, 1860241406570283 }
+  },
+  {
+    { 1052973111938531, 571717070295127, 662638871434015, 487194242940400, 563864123356551 },
+    { 313768325663018, 1096387612893633, 232711817872390, 926931708861688, 2208373716341324 },
+    { 823857549390635, 2207592640971793, 1855512257490888, 1911413747439725, 1853809846918105 }
+  },
+  {
+    { 2036109024667906, 788786007664495, 529185570326229, 1970818175728285, 716638820776172 },
+    { 1691119362383073, 1374233162940119, 1499830893630563, 2225901026600973, 949304629739203 },
+    { 695616701038646, 20368455765111, 619664083096696, 723635083382804, 1023760209767255 }
+  }
+},
+{ /* 15/31 */
+  {
+    { 1895408474337392, 1335954976788533, 985141721217292, 126921816462693, 1461766309882915 },
+    { 1770583362798948, 2134249174371107, 1845225536958177, 623900187867507, 1068565274816080 },
+    { 1291953286798969, 2102679466898679, 1596002078575263, 1387588817990761, 2143444637427225 }
+  },
+  {
+    { 520696289105719, 665438838768697, 1731727230740743, 2247887220248582, 2143609474706149 },
+    { 1493094934626749, 1179627985066790, 395613897622098, 353090108066162, 1901192209543475 },
+    { 923819152192005, 1415712944791087, 1125410698033067, 788009900900011, 869993295869018 }
+  },
+  {
+    { 204956829392967, 809094375604991, 1507634607850626, 191005950079242, 567228983531913 },
+    { 283196041868811, 1147008544955674, 10027312539148, 1481998462876797, 693990283152694 },
+    { 1757819380032415, 1458259160758992, 404747119062789, 1242483165113555, 1521264843142355 }
+  },
+  {
+    { 1177246463904127, 236633799581924, 76678394799500, 1550430756969068, 92809245758469 },
+    { 2205646414116132, 1924280510925419, 2153130381296311, 1685372119895441, 1251264911209213 },
+    { 1519155588261854, 483899768651806, 1235345257217886, 467640517750393, 1224438957323827 }
+  },
+  {
+    { 1246208485680505, 596853707740558, 164605439945753, 825810788485280, 831805919056410 },
+    { 599003802691435, 876671109601912, 1297741729017769, 22078932608097, 214763902213405 },
+    { 2045656886162419, 2245569838876242, 1361334406977685, 1370170063372453, 1784586163491838 }
+  },
+  {
+    { 737891874041407, 199889941827640, 720930115890536, 1153163677723625, 379353551150416 },
+    { 52463875264865, 1027608038151042, 1805698129344579, 3415274007095, 896582555813622 },
+    { 1021578499394252, 2003506226907156, 1906928204664703, 617432881327189, 487770381544088 }
+  },
+  {
+    { 1808240492311676, 683215352347115, 534275688826885, 532862053072503, 1665651319154875 },
+    { 520415614422942, 2212224482950458, 350858843094642, 1799526358920016, 1790044102967755 },
+    { 956648481954026, 2096247164218896, 1027480742584033, 928233599700570, 2122240338574709 }
+  },
+  {
+    { 629205712253447, 696219141060254, 2240941577462355, 167573388134812, 430353727713638 },
+    { 126346605636302, 787953954157654, 1019044033937394, 2068877580663841, 1651025896417965 },
+    { 948811544154236, 95827271348811, 971972540788513, 1752656910961976, 1577613288465037 }
+  }
+},
+{ /* 16/31 */
+  {
+    { 1370912655100576, 28079262268111, 1535348789227131, 2242808749632369, 809642652295670 },
+    { 635991163691045, 570696406791013, 1609311709579718, 2034994939683182, 109989835041421 },
+    { 2128769772677977, 2142654242576520, 2016094652496998, 2132031230853467, 725434888027655 }
+  },
+  {
+    { 2135073895739904, 1220642636112600, 1493509767807811, 1591839321329741, 1420071562059335 },
+    { 174203991396502, 770330841919696, 114371198672236, 1881281468795601, 79711356135445 },
+    { 1420603492551010, 679640550295814, 1617533903828801, 780154362635607, 1319780020899258 }
+  },
+  {
+    { 1443775398367956, 342649786021856, 491131145750945, 1161286236132679, 93221155048400 },
+    { 1685268313866105, 1091225057981324, 34738159867818, 1271578597078582, 933514586691351 },
+    { 194815921686333, 1256736762545940, 1408742447743650, 304562218341097, 2021464306176092 }
+  },
+  {
+    { 507963256544514, 472375505174555, 779257878153691, 1179390009947662, 709717330654464 },
+    { 960423152600264, 1015052059094369, 2084933873716193, 291273183388512, 2172369805610215 },
+    { 440075250919582, 694825884103652, 2159700403414911, 116894270435230, 1425927073727904 }
+  },
+  {
+    { 1064910415642974, 843807375901846, 1657172039814805, 2189460887246834, 1354043476687700 },
+    { 338355685925370, 1209957286868136, 2053636093096173, 1439317061430810, 795252190234667 },
+    { 1262675707031055, 1219816744922490, 519257628155087, 1497570437960201, 1372594887264798 }
+  },
+  {
+    { 1063725449602752, 943900907578118, 1225723797770692, 1930871244203904, 445682144726228 },
+    { 962494844837664, 508979718880083, 157427748727256, 2183002842632564, 1716275464667336 },
+    { 1933555860608921, 1275569655188916, 234812135397482, 96042287368239, 386392083574324 }
+  },
+  {
+    { 579973362868757, 1613196187629395, 143763356623236, 2090271503443449, 1893990359510416 },
+    { 1067678167743074, 178288898625733, 2088017980569773, 352652372368412, 720689178534569 },
+    { 1681588555670186, 980191207008201, 2154581399538671, 540872424183046, 1943954489289499 }
+  },
+  {
+    { 111282977120126, 1990957989315238, 417960004432922, 1082016561159722, 1325118659202749 },
+    { 1473525133658734, 34732346162721, 1029920254545173, 1228101358414801, 152805623267113 },
+    { 183359648873960, 382111728086623, 1969766109298473, 2071169946252387, 242935538497060 }
+  }
+},
+{ /* 17/31 */
+  {
+    { 2216608521812979, 1133671267609171, 1886801270451833, 693723450681229, 2177664326279079 },
+    { 1217176410618852, 1156758041567635, 584945597615208, 401700658526440, 188718999318719 },
+    { 2233307833752057, 720411965215730, 1519169695491573, 1249545629073374, 42274079495163 }
+  },
+  {
+    { 1028220431149045, 1318628129209811, 867598555050648, 391516159010623, 618793687544686 },
+    { 785648940778980, 1566075695368470, 2205885851017647, 372501423919883, 2042694981038794 },
+    { 354305362086679, 1512134460741612, 359672307646707, 182487842123724, 70434142068276 }
+  },
+  {
+    { 1024824838093574, 182044951578079, 539066115399189, 1963658167580139, 888614446782442 },
+    { 1693757839885659, 836292189541753, 950751758815067, 982651358735092, 221102476905845 },
+    { 46706548238824, 1986500518838735, 2027136585204085, 1143580830274421, 237034819567290 }
+  },
+  {
+    { 1210457740468652, 2215903401275260, 1545855048122212, 1560256833448838, 235678314205821 },
+    { 1677629762901748, 541583930343398, 1383717393793391, 951594759624156, 166785376717098 },
+    { 1032532177573683, 1507169914894481, 893954872249259, 1464210961075811, 2248024514969267 }
+  },
+  {
+    { 2215196432839229, 1453988298479780, 911159768469061, 1417180860727486, 1916001465630095 },
+    { 266073750133030, 1063660218646657, 2001496173067453, 1054570510340478, 1787320193554613 },
+    { 1593076635649167, 613414152324278, 1398118686752976, 1550186634066418, 2024312475795755 }
+  },
+  {
+    { 1611115816843085, 1564686497935112, 379643685080005, 291591976378398, 1070282314438177 },
+    { 20428272805067, 344278789324198, 839609851549831, 358979365865884, 847000176814724 },
+    { 1370619542022553, 13593976629245, 670888839522668, 29909561835083, 1113994299778657 }
+  },
+  {
+    { 210667856729798, 832581000901195, 979195344857408, 761623507948939, 102316955504785 },
+    { 743880451641798, 738115538583549, 1701458888198429, 1737802518950586, 1702048374090090 },
+    { 1653806661942935, 798938977173667, 1204504651898865, 2012775328403335, 959133953735021 }
+  },
+  {
+    { 1056291284182974, 186371978807430, 666572176305850, 2221533064225315, 1302577527793701 },
+    { 484740628192045, 1747162484279003, 1958227960728501, 2029226260228924, 1872489756569532 },
+    { 2246982488380161, 704048527252770, 449031029656446, 2000971659049725, 1830758195793359 }
+  }
+},
+{ /* 18/31 */
+  {
+    { 477207916553285, 1488064260202941, 1661453866463954, 1141228074051855, 672072650786576 },
+    { 2069770607401591, 1225367702112866, 1538953132048656, 2188401482212846, 128593173278991 },
+    { 916404312971536, 1000014350915647, 1498754584389763, 67530592482209, 1667646385756724 }
+  },
+  {
+    { 810369747020183, 2237618141036509, 30441627290829, 396142955464533, 62356642942044 },
+    { 1586711819320142, 815259294495906, 1356055059989454, 14254368880198, 988334017759084 },
+    { 498205650210982, 2029447832739442, 1287708517665602, 2063154761502015, 592549403529808 }
+  },
+  {
+    { 1466752538541859, 2035538193320560, 138132610685025, 1256421706559322, 180051141994433 },
+    { 346572978148656, 361056717169822, 29214517564329, 1186024799767424, 308874981183664 },
+    { 1297525937307453, 1360474818962172, 1057976529132470, 481516036122456, 1284896343639676 }
+  },
+  {
+    { 394133855270478, 1022205784206132, 404819328296271, 1746214054851431, 801232833816448 },
+    { 1273141653286537, 600137967440787, 1108281665285822, 1607794127357251, 276080397056360 },
+    { 1625278703177771, 652272403287866, 1130860155562117, 1467718191751280, 170296377586353 }
+  },
+  {
+    { 1002349488419280, 981103429321237, 1398184721429428, 1349462663749659, 1811127006517843 },
+    { 590619446413372, 1231475507877741, 1102722867835777, 1502259606006997, 1928305723681151 },
+    { 1577778325058339, 2215369962281551, 1331723269758849, 1939632256423674, 52886968354553 }
+  },
+  {
+    { 477277816347755, 1888615867921889, 44593588327886, 839924021249032, 1005736290727363 },
+    { 429588372211149, 588893739892884, 1104635921931672, 713807697140284, 993807113279127 },
+    { 1035587952296453, 772571610990610, 1703146381743864, 447715678256778, 1714287687955168 }
+  },
+  {
+    { 134507668377148, 240967146617558, 971317535064000, 2019271157069067, 1502539203059821 },
+    { 750961823664047, 2079840268263426, 1582320466692507, 586009665713156, 1009573205681089 },
+    { 1328811798417377, 1232170334974369, 1723370191641238, 2166559558468187, 1898556240276951 }
+  },
+  {
+    { 1386180360119611, 1021274801195911, 1729880193705624, 2228606406348098, 1592392117444361 },
+    { 1689247777141059, 1987892221330336, 2238604025082286, 2061272829606697, 166862139432161 },
+    { 419731549689034, 1989626747750813, 1591278351630992, 1092786235861584, 177178675215960 }
+  }
+},
+{ /* 19/31 */
+  {
+    { 1185838263017961, 1658025814770644, 412614687917606, 2015508295646823, 715217716364667 },
+    { 1481646966443338, 466715278381335, 1774539570883972, 288554375125960, 1219982066342679 },
+    { 1569664128884381, 407663338845983, 2002256010544711, 671085899312035, 984282527793076 }
+  },
+  {
+    { 322516746875165, 79424149775986, 290872190809355, 923053834242184, 852824612935969 },
+    { 1837729354575368, 1806927222817205, 772071460769486, 1075261054203712, 272300877743610 },
+    { 946711433665760, 2239987349934557, 803861660898522, 2156551410386926, 1502787654920122 }
+  },
+  {
+    { 1002763931894790, 2216555692070697, 1092592077852813, 2095372815347837, 831620519830306 },
+    { 933979342100663, 1447579579388357, 744931334263945, 1922902624484262, 1957904221232842 },
+    { 2050669866355306, 2190774465449013, 2058969733807763, 270320273862327, 1870514939355617 }
+  },
+  {
+    { 1975814150439887, 898075979342335, 1261444197722907, 508629827289513, 1552966352555280 },
+    { 652257990405769, 2146188399812219, 991910114432277, 1441046103324288, 269464123586741 },
+    { 1633514016507671, 758793436105214, 1666766843388618, 1223902548045585, 233185566290059 }
+  },
+  {
+    { 117175990536680, 205242142019633, 1624416971413677, 563819279426049, 1423562576573628 },
+    { 1832224409155062, 1433153761769974, 2221777649495288, 403216383897423, 1835854244426528 },
+    { 2039348563488973, 248927546652694, 729506739622176, 397171022735714, 1644628056647629 }
+  },
+  {
+    { 282843384358242, 819262945764986, 1435968129823677, 594097030236782, 2123224284522922 },
+    { 922213134544802, 1558729975805415, 545733826452503, 1871955716617573, 1112039957894281 },
+    { 1869384197190792, 1569592234203114, 2196362163965849, 1717386471659459, 39685498183014 }
+  },
+  {
+    { 1421109370612225, 24542237345030, 1620731107586927, 264254102429506, 1357365806509466 },
+    { 131935548103652, 101931348851158, 1207001294934204, 367655431725731, 1256859454639685 },
+    { 985026127753438, 120648499984234, 3776067837201, 1121956503069595, 1317952564469757 }
+  },
+  {
+    { 339460334668018, 1004239686397252, 1203428024902644, 1634973881827916, 77943558028425 },
+    { 19371390465932, 184228893567174, 1200073564252783, 688999569396420, 535206532329522 },
+    { 1781496335107774, 734939096367772, 1979958937781877, 860043149833798, 2198713547814584 }
+  }
+},
+{ /* 20/31 */
+  {
+    { 997854281022512, 371412096455343, 385221936050652, 1659016544729114, 609442868038809 },
+    { 283947992808316, 906854516558219, 2004968339980078, 682646947000673, 252088188293511 },
+    { 1619428378651736, 1579845830028655, 3625310117685, 170605089295866, 1149673757755609 }
+  },
+  {
+    { 1431189333362745, 270437001637520, 1841157954619917, 132664511521572, 105906730937715 },
+    { 1519560400510514, 757016839193621, 962011066300527, 1331491453807482, 366291408709403 },
+    { 437646608465794, 2094793895484999, 1468162389698058, 248477625893392, 1999708435919408 }
+  },
+  {
+    { 151762711386453, 1479291836708385, 28706304084431, 693677176641407, 1695373042660191 },
+    { 1082895706686204, 1560404104136121, 13895968573391, 1567209158255015, 940533344707601 },
+    { 11430723322929, 1391830113841252, 1337273140327877, 418617211527096, 2156223821909844 }
+  },
+  {
+    { 2057796043232663, 11608799675559, 1596783085458033, 1729533403820748, 911191922916278 },
+    { 1223062248495683, 1630657229329984, 493822228052059, 1371287517681447, 1729125662506463 },
+    { 43999776827657, 989331901442862, 147120313740048, 495021300047603, 2007031690017476 }
+  },
+  {
+    { 166834800897826, 1397178447208358, 1512008134852982, 1267945553334007, 639821707720737 },
+    { 65710973169109, 1680768177148666, 1133523754569866, 2202997497332408, 1347205872907513 },
+    { 1308871835809784, 2116706717414875, 56029465436904, 467188187972025, 1826981082270550 }
+  },
+  {
+    { 1956939819397260, 1563769450095983, 1153022458216287, 176747536292706, 223633771534996 },
+    { 2218297806122503, 133016207658508, 881158740655112, 1061346067421084, 2078729038976858 },
+    { 277297371046776, 1016671322777094, 1912173712739697, 1941234701885292, 1286651577841525 }
+  },
+  {
+    { 428801425089691, 761018381922151, 982093819501259, 710728397015565, 1856525231801054 },
+    { 1012626817547322, 1612612958334034, 1065746063212436, 1593166025781229, 1733591622804967 },
+    { 634704084825404, 2129536576841980, 1242863233687290, 1573321106629022, 128474589505663 }
+  },
+  {
+    { 129496500081800, 1790297098324227, 1302842166366374, 1122296729486616, 917050154500647 },
+    { 2209800470133809, 1185162704121958, 1319971255383218, 1371435139486267, 1231465623037748 },
+    { 627678063257079, 716314893721428, 1223825394014331, 504272345435927, 1599415310067837 }
+  }
+},
+{ /* 21/31 */
+  {
+    { 1912748982362695, 1220789150721713, 704177718050401, 723618635926708, 1539793845278548 },
+    { 797199596391742, 1640579499587252, 2249382671495029, 1509816099416416, 1287100489183999 },
+    { 2120957025321772, 1416788979770990, 1248163529640000, 1057479098339217, 1345904049070916 }
+  },
+  {
+    { 1020723204932740, 925702577219623, 993238884888760, 1734688533140183, 2122148469059677 },
+    { 91831374297454, 1526227336126975, 1355766749788798, 604694865815954, 179753894501239 },
+    { 1672839208916523, 1716495024680343, 1707076061183264, 765180466790910, 2017432747304428 }
+  },
+  {
+    { 162252707744707, 1593372837632109, 419105697539909, 1656407715094130, 112109013318476 },
+    { 1845211281712630, 314796716337139, 1084733734214267, 2030481699162822, 408225771371226 },
+    { 192171151121229, 1275967732855104, 1864584199775891, 1693406950762857, 451756333138903 }
+  },
+  {
+    { 1612422054090644, 2236845889213344, 111947795252003, 1594023725720587, 709352663553385 },
+    { 223618880166307, 2227771290802404, 11281894918949, 2094951662727146, 841799884322096 },
+    { 1485832258557624, 680071864680695, 1288498699771584, 258483455916573, 1782424270254224 }
+  },
+  {
+    { 647490509851052, 2148582833270036, 2054273108926092, 313943912817170, 1518458853723030 },
+    { 1894112062784127, 1572664741529768, 192687866894783, 1178316066106795, 1208441649045751 },
+    { 1953522143805027, 882595907666496, 958109305864079, 1523427692628869, 1741273556819203 }
+  },
+  {
+    { 2177453523879316, 1467829313324954, 1578609310805206, 994852944077857, 1948868370865273 },
+    { 1572831344762996, 512136862546134, 1301968357947975, 107109430993572, 579378548975220 },
+    { 2160967413246114, 497546389595616, 235866284515227, 1209326819476215, 385381334474653 }
+  },
+  {
+    { 542288404046276, 1674021500357050, 1716132449579059, 599992304591102, 1525214981711194 },
+    { 1670695238902619, 2242739208774836, 1995667789637381, 2142826736425494, 36512784261153 },
+    { 2143663924692386, 1851559468934078, 1845266597269129, 477022990956902, 2179267609261901 }
+  },
+  {
+    { 1958983221377553, 2178877734404748, 1849996731612977, 1835657059247969, 2041180109654311 },
+    { 506164232017347, 1310600048415123, 805017935693660, 858678127951771, 552614740457634 },
+    { 724524272708234, 661221141789934, 1298795839460575, 1322772218421097, 837427426454482 }
+  }
+},
+{ /* 22/31 */
+  {
+    { 1638260469631934, 1786040878698661, 906589425735481, 1583514814511733, 161900944868234 },
+    { 821091239344879, 1029728218242611, 1785130220912361, 134891303686179, 1146812607647243 },
+    { 960395712488566, 1090263312831733, 1493488072165035, 718337273853885, 140550395520083 }
+  },
+  {
+    { 582009322268611, 1462939149444616, 1699035707213512, 1260336843200283, 22744545971108 },
+    { 66233320680397, 481500577921291, 1593046392900201, 1567890828749600, 494668490181439 },
+    { 447501697246828, 643764017641830, 598739660833153, 477276555234445, 722964385617133 }
+  },
+  {
+    { 1468688697571051, 679132917145459, 729559654398033, 216030070311676, 1572642054261960 },
+    { 1240274286914554, 1067294500855911, 1808099303249661, 2078686383903322, 1106012145326576 },
+    { 601523810297856, 895074627148937, 773977692709653, 1905383167427875, 1540507530397039 }
+  },
+  {
+    { 399548058429350, 1239727848347326, 910155210437028, 460253616151978, 1473384781489285 },
+    { 649661364881903, 490692502811334, 1079509849353758, 1289782120135506, 536543674034462 },
+    { 1148448246837183, 1915539016170074, 727268432049334, 838952046766961, 1100979659516489 }
+  },
+  {
+    { 549684439104063, 1308243333207399, 849363374624769, 650751688271388, 1782136170508092 },
+    { 2061989082911795, 1479591773633681, 978076246857124, 838517167558357, 354474530763849 },
+    { 1354449553272043, 1085110494903468, 2224048655022783, 1932600057639272, 200912869737304 }
+  },
+  {
+    { 768379161979195, 698528958407689, 1384131174334607, 573310211564337, 5045987379232 },
+    { 1737002989059736, 802467700141916, 1002869782075529, 704293791948409, 2201857958628929 },
+    { 1328818899805024, 1356396048253838, 60665341223248, 1567700157316511, 290562887661571 }
+  },
+  {
+    { 2083771618977947, 1607978129046189, 1586868936731179, 268756465778504, 2196980677006700 },
+    { 286239024641757, 487000093964479, 1365236543743062, 952492668921998, 305066005571225 },
+    { 1179288489475667, 394266093483806, 2023843107238627, 906600297586329, 1987935808498095 }
+  },
+  {
+    { 2190648163527070, 1182302286459911, 1698709705179966, 606253946341655, 512030280417032 },
+    { 348777384482283, 2016426622766719, 1222199716068557, 1918283401506759, 2245473746651968 },
+    { 1766029976663583, 578113072554872, 1407762358462124, 1251410333318914, 1519685697291309 }
+  }
+},
+{ /* 23/31 */
+  {
+    { 1595188599035679, 1464526558278044, 1898228983618218, 1360237543176202, 561355623244020 },
+    { 1624984233972943, 1175602927768556, 2008613229958363, 860666473258130, 8855064843107 },
+    { 427225699371050, 88989906931284, 374954954790275, 1891881595245671, 72849256625193 }
+  },
+  {
+    { 84040170431047, 1931214780001053, 1443891068193482, 1666635094108942, 143074570822442 },
+    { 1665011381698399, 1378754749747507, 487038326296225, 1599334628314079, 304382055379555 },
+    { 487618024041635, 1610635862259296, 1930277174961405, 2060246530132043, 471988063294585 }
+  },
+  {
+    { 2223680929791699, 3895789171725, 2223372744379625, 329958323306502, 1157672051964720 },
+    { 701077051295997, 1498973766670763, 965619022184082, 600210618912150, 946632765773793 },
+    { 1191620799152162, 584262428445493, 1654487633336816, 80589900150873, 1778885798645876 }
+  },
+  {
+    { 1025432551730846, 1648743746278575, 16684771081519, 347896520603035, 1136469383570497 },
+    { 1553077072086479, 778919053728455, 581206537360082, 2100029769810002, 192766048046100 },
+    { 437947250844137, 170970937295705, 294909197597269, 2210849722009323, 1802271999575202 }
+  },
+  {
+    { 201073881439011, 931718652949941, 973211343795092, 1530254508436787, 2236389510678133 },
+    { 1726185346943403, 2193387419422952, 1890097848201710, 1860939486991039, 469851139316624 },
+    { 1718640585909930, 289464657861405, 256448940553760, 1840710967168708, 1367355358576031 }
+  },
+  {
+    { 845231506816104, 1497801914137387, 179661962670609, 2145415545771871, 1633953832787249 },
+    { 2166294423799637, 1610366344712604, 1808984605923163, 1918368870787446, 953302106671412 },
+    { 1855071951306216, 234835319416374, 608676288546844, 311106921331784, 1424607004261872 }
+  },
+  {
+    { 875790924532156, 356110076454187, 625984861031329, 898713331800149, 1867577233264451 },
+    { 1031287607922522, 452313692528250, 2184482840358932, 653471947427836, 1295546328991203 },
+    { 865238419718368, 2167660602098967, 849033435333870, 1879862001988212, 2194604163295964 }
+  },
+  {
+    { 345774063281888, 1248680369566159, 993767719430878, 632344407656797, 494002909476340 },
+    { 525302074276141, 241111491449954, 1218402302345939, 567375174674023, 525859655102473 },
+    { 1262037831799441, 1761445988918060, 1818282615037362, 643977010061831, 1670449776207217 }
+  }
+},
+{ /* 24/31 */
+  {
+    { 2143318224651032, 733385627315851, 254705425241603, 246670488543148, 1442295963272082 },
+    { 1951027410316907, 776338288529184, 1414670155467203, 355995586863836, 1209606780078452 },
+    { 2200224066087308, 1167051805827953, 161446888552827, 1516422365939770, 1942535836845300 }
+  },
+  {
+    { 1230426392539272, 997104644926831, 1053774819732819, 2147764348670691, 1676514761128454 },
+    { 668289581572433, 277229536066558, 512862571267843, 1966556713706538, 794475628136672 },
+    { 1628314393858778, 1997743320994668, 1561201521750924, 1869590045554733, 1810714681142288 }
+  },
+  {
+    { 1675422916543613, 420608931102229, 507417335369419, 640362125760162, 547806107918848 },
+    { 177854791944349, 1181810088365991, 667731284331731, 2129076819445302, 821127077179399 },
+    { 1484872832783728, 72255685107270, 1098972476164964, 1732914770170238, 145186792002379 }
+  },
+  {
+    { 1372652207334635, 280088467298730, 1519487391303038, 6992513325161, 640671581341508 },
+    { 1683583627473543, 470109912280877, 1910006662061487, 346619407103075, 53117372144724 },
+    { 156581553787681, 307978851206907, 1451582278870485, 442722234791876, 662472042575165 }
+  },
+  {
+    { 2082652078388962, 493846157816801, 43960882916728, 111049106953707, 118614369521774 },
+    { 614940244711006, 1241836004262404, 149137396399876, 870877804496097, 2195700460595074 },
+    { 1712668510139487, 784271226274642, 827073136956465, 1001465329762964, 1662630974562798 }
+  },
+  {
+    { 818080711416948, 1360095872859392, 283891848994117, 834642121756558, 787978368976316 },
+    { 652575947450972, 2107702224275112, 718520440691947, 141932352843721, 172644594071659 },
+    { 1509857525874286, 1496970584948645, 399828714647739, 1863753979948441, 2149707660031809 }
+  },
+  {
+    { 700395318544234, 1093768336629146, 1768906295222690, 2025477905414216, 743793294293786 },
+    { 1893066183933410, 836260013095430, 2186488905733469, 211412087780179, 1358659880821660 },
+    { 1951144383031056, 1085048452592587, 499199223423315, 2055889411465929, 698006601614245 }
+  },
+  {
+    { 700816495675260, 1165569165048171, 2172597164236109, 1071655796287173, 140828680192945 },
+    { 1932164408348001, 314265512109288, 1717210254999343, 1391381349870857, 1425970078148568 },
+    { 1862104717906915, 1752261107932084, 1874923294613947, 1008681858018398, 628821150989939 }
+  }
+},
+{ /* 25/31 */
+  {
+    { 944214205150673, 113579352686446, 1305491360151613, 710549772492770, 1508433893219248 },
+    { 181463710138863, 324899312232426, 748437826404564, 1442893546327651, 882055388832311 },
+    { 99837384801727, 2128746966172064, 1728087272474317, 1660968164341303, 2094478837305487 }
+  },
+  {
+    { 1045092786794937, 922156857253434, 571265958550934, 1028247394751676, 400144133024675 },
+    { 556217026906589, 2242519046221962, 731336075742219, 560401179364011, 169768611612000 },
+    { 1350540322092981, 428507123444697, 863081413402232, 950089447398951, 118865435494230 }
+  },
+  {
+    { 1863120758931548, 363455748508989, 294830767865354, 1329441793127641, 1244078294695462 },
+    { 182272565770359, 734294835564241, 1742364616598960, 2088189023592845, 952744900119070 },
+    { 317239144147936, 1378693805440304, 1613995646839215, 1790616997152168, 1664744641804674 }
+  },
+  {
+    { 910278956134402, 894183083609573, 830213734772943, 1343060696486484, 611721765217825 },
+    { 664779139067617, 1109839789271330, 140453904417500, 1571861604864808, 1784338148265262 },
+    { 220994375354681, 1633125608855915, 2233079832150828, 144297568151940, 217868145580028 }
+  },
+  {
+    { 2185253522527409, 1722061079589371, 929518249744037, 221372430121949, 1175414668689858 },
+    { 1891204165383711, 1628768707650559, 563598116936137, 1060040405961115, 1250875073838129 },
+    { 579681536856473, 1962714631533051, 518559321779053, 971489356480100, 509262501560864 }
+  },
+  {
+    { 1528432877912367, 135699980342021, 780855157188914, 1744928736206446, 1837149863417515 },
+    { 1673313678131884, 345643119065179, 43736965486584, 1315834285030270, 2054079925795780 },
+    { 1612827416827303, 1149821613065205, 1844912308905994, 429769677786205, 1866058244678788 }
+  },
+  {
+    { 1087967203355487, 1504313118437159, 1271975234407042, 2125305808015759, 1278369242007838 },
+    { 820369788540377, 503902269054747, 1799301074563172, 1789926653723236, 316108959484144 },
+    { 2109491846902798, 1459244188614787, 1145316246074802, 537401043713173, 2076110035136585 }
+  },
+  {
+    { 291256384752389, 1431181693384326, 1492922137755707, 301469885232977, 1110919820832195 },
+    { 916743892302278, 663940551107639, 723671180823208, 1605702843269381, 586953762179027 },
+    { 641798503068060, 129975789967638, 2167736719761015, 31631641435626, 350785183214734 }
+  }
+},
+{ /* 26/31 */
+  {
+    { 1051236049852089, 838236098838683, 1401529863477899, 819561906490618, 1695547314615010 },
+    { 906923277717385, 1205267497856625, 1482990850447715, 814292408880760, 1285504246425383 },
+    { 342012360452061, 1887029215668228, 1155449753977691, 310762800506541, 1868750527042639 }
+  },
+  {
+    { 446777329491613, 1182111476573108, 361578732926394, 969051558291558, 551871149504900 },
+    { 1502211512267751, 522814637298393, 2125300438723032, 2018782704272556, 1170472673030354 },
+    { 883746203814773, 276737323512287, 2229390196673160, 2155663378443822, 635390057802745 }
+  },
+  {
+    { 840689961188280, 666855865921493, 2236632145763388, 553161305644429, 770093598280661 },
+    { 1845357083269366, 283024454100284, 1261058990950787, 83148423763794, 1614274061088985 },
+    { 1649953183870355, 2176771717569818, 1233096109604549, 1152511702037810, 560573824644263 }
+  },
+  {
+    { 1027653299140521, 430869933716354, 39439958469758, 1392853852430383, 1280424544026220 },
+    { 1374992270629118, 886701324738892, 997915444084346, 1696807732220344, 949943622938188 },
+    { 380965098906693, 835788132761480, 2232989119976139, 2205277179143298, 1175904351372329 }
+  },
+  {
+    { 1276840412816828, 519369712833844, 2136012615148104, 180094089822217, 1217611106137227 },
+    { 584819573993171, 924094872480204, 796197507715680, 731723549536055, 1969026109607883 },
+    { 2073239372536943, 30649016949678, 644492521678981, 305840627193069, 109901429265295 }
+  },
+  {
+    { 1192657509706017, 254094871160624, 304298342555628, 57611730819281, 1820864150951983 },
+    { 636107730675348, 185072076823130, 2101052688617099, 1881041993651043, 1584751668557586 },
+    { 1002466072624564, 1231676492638173, 1795061881446222, 564780581799518, 2025621015597595 }
+  },
+  {
+    { 1115844988064971, 1502804280456612, 1751381457602880, 166909719550833, 1630322347022899 },
+    { 355092532084366, 1733818571083951, 265012342377874, 819197490530921, 144646279720813 },
+    { 374714050779396, 405289438859672, 1963133877676048, 2112584561135192, 1143185401022561 }
+  },
+  {
+    { 1926650836092769, 1141267952622767, 1136176853749112, 2038056869767014, 1320936551384977 },
+    { 1594911994296225, 1802592071832, 643263241942676, 120105560381493, 1062009661984977 },
+    { 283489509389185, 614480115735096, 278795579529276, 1166609138076060, 1715497286463476 }
+  }
+},
+{ /* 27/31 */
+  {
+    { 708933751359100, 2107676482823116, 1657279889267301, 1609984394439769, 1082526754413784 },
+    { 1606753372548095, 1940797730019702, 2170465741030982, 557319246680918, 1999867966032864 },
+    { 1823622181083017, 408967151178094, 2033143529389867, 2209724434343478, 918118538477317 }
+  },
+  {
+    { 590468521603508, 1888183319191452, 1440689086131057, 1677336684221251, 1925080943820196 },
+    { 1585117306142537, 1612495744818187, 2023976907380213, 2224019669007289, 182352658157013 },
+    { 463491021439363, 1750609461077078, 1169967881279297, 474253519600450, 901070375860211 }
+  },
+  {
+    { 1234176672107405, 1118156106770039, 1401308706374344, 49246839018891, 129899069235955 },
+    { 2148892609267637, 156091090159501, 219195676377608, 1764671763402282, 1450853793183865 },
+    { 288029433804634, 1918327772711516, 1858109617364668, 1548745667412753, 1635036158704975 }
+  },
+  {
+    { 1915560744141480, 968144533182421, 1684794323668365, 813038486884416, 485174716721005 },
+    { 396318558702260, 1083473990827737, 904833535607248, 1965475057496774, 806903729265008 },
+    { 131383425958682, 1726194406199626, 1195125520329959, 1269440178344704, 1934708138886976 }
+  },
+  {
+    { 2185121667669569, 1115206785572251, 704158439711004, 2133851508118048, 1251130304627637 },
+    { 309139531546063, 2049522628380760, 1821330378737221, 2189050579333957, 379745028034240 },
+    { 1895230235031468, 1896812472261458, 768470747222158, 1996242383935516, 1420798451369434 }
+  },
+  {
+    { 1579856931436900, 195251954153981, 616268009970342, 1688893962924789, 2116170079089324 },
+    { 1336195493856024, 616151775822139, 132656637077528, 800859950704494, 523331976590323 },
+    { 556211501812000, 449190026847667, 2036295767110360, 128995208617458, 1118467502984960 }
+  },
+  {
+    { 1146590809115000, 1820230761045333, 438948341893375, 844036154978819, 278417404664415 },
+    { 1098861443862149, 1056118674042928, 602217524379356, 1351672530126771, 1647296273265328 },
+    { 1878982227582804, 1431346083601994, 1534977024077189, 2155113334662581, 1782950372830762 }
+  },
+  {
+    { 352512930664620, 200908289136568, 978667112601609, 2118488738947709, 52678658272637 },
+    { 194062342816527, 1511332321457621, 529868032979417, 655355508011806, 156865380492922 },
+    { 1390885694073460, 1816639772663275, 1066627353945560, 1454561122724455, 848860562366790 }
+  }
+},
+{ /* 28/31 */
+  {
+    { 432661147328404, 1458149898387512, 1783966662497693, 1338383483986408, 1938129546538183 },
+    { 1362667331125037, 555463793483067, 2233240717963474, 1482036091634425, 897559387782686 },
+    { 40033251972751, 73885946378640, 1935473366247146, 1461619709267546, 1211799649582059 }
+  },
+  {
+    { 49425255395021, 2184860938031359, 21532237643300, 1704804667098003, 1911735781256473 },
+    { 746857581688692, 2121876522621080, 578602395071792, 691986710522145, 2051278946864590 },
+    { 2217303387266656, 2227853943602075, 1384266551040407, 847818056628355, 1874126181291960 }
+  },
+  {
+    { 511808424110958, 95001800636962, 793507020418793, 1893958852943479, 1490859261541415 },
+    { 724572331868085, 321008899798181, 315092682951313, 1732195053250012, 1362839778971948 },
+    { 247688480299164, 1512873113726713, 1351630747308477, 937439467136054, 1030677695284257 }
+  },
+  {
+    { 995506859453010, 174069429422226, 370685091406527, 2040657700179410, 1450858492090282 },
+    { 1421908854362862, 161715173892682, 1729749930861440, 1836384830865689, 48949287445656 },
+    { 1636572211186580, 2000987144770729, 1893417472062746, 196779160527558, 1557344243161357 }
+  },
+  {
+    { 58206435040451, 1647962485872619, 571343575850786, 2192050419207498, 1818655878772515 },
+    { 1990326951571735, 39942429932174, 1220931917762756, 1377401564086862, 638375379383762 },
+    { 1024434193686880, 2242250021719251, 564307645117404, 690001361734624, 239056809198959 }
+  },
+  {
+    { 1465308832663009, 1832715868509754, 1560251908961280, 1684888211341315, 1618372056987552 },
+    { 209420286242178, 1876428619982435, 524425257737618, 1202135167308774, 1054762770895410 },
+    { 1877409538331051, 337692456674055, 879114692044355, 2186377676371749, 1343387843321657 }
+  },
+  {
+    { 1417716756510978, 2121969005742830, 1652467606544375, 446235034197272, 1024151721460437 },
+    { 1890392837498603, 1272921445931038, 1342905285585414, 1707354168475339, 909422283336391 },
+    { 535664786267626, 858000264335400, 1392803193793530, 460772165692459, 1244185301942167 }
+  },
+  {
+    { 1495731174651295, 280947107652162, 2156800382632015, 1987445924091844, 1196317565653296 },
+    { 2250306499911260, 1939747202154883, 1217632366505406, 177514286663808, 968879985948762 },
+    { 483117633444291, 1721449975252800, 2014677970681898, 2079902425951169, 117285229800651 }
+  }
+},
+{ /* 29/31 */
+  {
+    { 1271231670673207, 572836852528616, 143342018841698, 770528850757884, 250108126336533 },
+    { 721508221232856, 1746185362187777, 649848024809540, 1643484536323064, 1179347009186690 },
+    { 722866669050453, 648025000876863, 272387785321835, 1191578896340587, 133025146298323 }
+  },
+  {
+    { 82857304500618, 1554338034359360, 760468202446199, 93034647782207, 688719719651552 },
+    { 2178219113942829, 1024549486604539, 1632802890914011, 1790174780762258, 1653222380589718 },
+    { 2128452325542740, 952454207454828, 1516099560539414, 1362377470631451, 1181280467630705 }
+  },
+  {
+    { 1234316951156125, 523003930516900, 786537036458099, 587803232898987, 1645722164542235 },
+    { 1626105811055763, 1108425817222319, 1368577262542202, 1305824653124397, 1291284997707495 },
+    { 894237486099210, 1516039905189318, 1740044048087400, 593444525063043, 2109764897178862 }
+  },
+  {
+    { 1482109974932762, 1512691293799179, 1056618842237051, 1669766513116243, 1645628848588889 },
+    { 1373561144490400, 1204823121475578, 1535466087890943, 1654057093724213, 1457988383716911 },
+    { 134048702591674, 1512942576919112, 1666722043826583, 1830910766776036, 90483195207340 }
+  },
+  {
+    { 242638196481708, 1432383122970499, 1373327814736372, 1764585753875764, 464067108961610 },
+    { 1510449339451312, 916047817203617, 516663857623252, 1445637979382315, 1580153534770815 },
+    { 914153294895020, 1485178337004016, 1172992438642136, 742396957515979, 1460451697085215 }
+  },
+  {
+    { 629876504002066, 875797994426523, 1680974550469384, 379692973243407, 2080467460645230 },
+    { 1041541771776987, 410986020624753, 1173847847203529, 1599676982141034, 684152561028988 },
+    { 1084836891982052, 405373371974756, 392292573225522, 1228291428535054, 196706224397467 }
+  },
+  {
+    { 2181085219797589, 186467806208455, 1398091257339580, 1543623638852333, 24079936812708 },
+    { 919366765858854, 1265998847343319, 1239257288722888, 846012957753740, 594713398434214 },
+    { 1451708073273912, 640663458576442, 472967005176057, 1940369909273489, 1650816055376110 }
+  },
+  {
+    { 604257425371268, 1647914007806880, 1178627125851434, 1025033951888023, 1528786153297882 },
+    { 1271992142776406, 306128060193141, 1814967755510541, 1676050795259182, 1038924484586542 },
+    { 1406590024268518, 1220852036090080, 364949301397175, 1654716393716139, 143122595639438 }
+  }
+},
+{ /* 30/31 */
+  {
+    { 1941635877650350, 41136794015779, 802548087270427, 553714331402352, 386035892408446 },
+    { 1253759950575250, 1509487323905258, 578311512025850, 212916427969408, 1753384794452412 },
+    { 1415499622184076, 11739232724558, 1448526577403933, 77973485783393, 148463223858677 }
+  },
+  {
+    { 311441914860102, 648657507285395, 2021653799300721, 1829986640373467, 1684057546885166 },
+    { 1304756256783871, 1600981150400111, 901595917857192, 242747876317930, 1279035873929757 },
+    { 531432570362576, 1071513573823369, 449672118652203, 98547521251379, 260579416510065 }
+  },
+  {
+    { 2098297300858722, 1637995723173513, 2132191683177015, 592134746032938, 1044637126699087 },
+    { 861603135516889, 972543469096648, 1889740426619698, 70421560213036, 2102944079771845 },
+    { 607038018090674, 1768950085932612, 1176147243379098, 1239851308662055, 1164850159859507 }
+  },
+  {
+    { 50302027267574, 423806012475259, 1179614475371999, 273291038306754, 1591101869035053 },
+    { 2041024517366388, 906640306630802, 1870667933915535, 1018654973521110, 670144050027407 },
+    { 67986117053250, 143032219413988, 187059126532888, 1606721935579222, 2108737133289470 }
+  },
+  {
+    { 1710358734492362, 700744440434795, 97008718346940, 1206596703084633, 1537007452608631 },
+    { 1222422916724904, 1472245300303381, 1263783142962994, 1924355287951999, 1022145560776167 },
+    { 63942543002426, 322070337950512, 1601643046070686, 1223905889282175, 1741111665223434 }
+  },
+  {
+    { 608607226436064, 1177142915116464, 893340840255623, 1733521080031483, 935074982514089 },
+    { 812295789681636, 324775898964235, 2192210973050135, 1489710278245695, 1388601324428403 },
+    { 731527977617797, 464892677638406, 850380242165564, 1707297435867315, 797914062581028 }
+  },
+  {
+    { 2200385186612531, 1578280621009878, 1080513122912467, 1819075993402942, 1445221323523098 },
+    { 2229646033936081, 1942975612354649, 213884528061573, 951329811597823, 1522941440963823 },
+    { 1808087344592199, 1917986815291197, 1736625562156353, 1691009053422774, 699554104203468 }
+  },
+  {
+    { 51064528108022, 111517112206598, 1559429527589512, 2124275860379685, 1685170275648173 },
+    { 545023831723124, 1093783076745175, 1713278174184402, 137023744208400, 408433093622657 },
+    { 567087552892581, 1562927351866469, 299640978917608, 868196882482839, 81953139898216 }
+  }
+},
+{ /* 31/31 */
+  {
+    { 1650059244213943, 1415687339027798, 1500141786956787, 2204874486713657, 1294277876097258 },
+    { 137033802346169, 2184552721577514, 539064280617532, 2076540099477398, 2066610116555437 },
+    { 1247200432261975, 265507035905438, 1620404126253617, 117362009527087, 1746435297969059 }
+  },
+  {
+    { 1068629703061668, 984762690851450, 1229949103789232, 2110232841828031, 1092532788851750 },
+    { 837136640501665, 1043670615489504, 2155335349713680, 1236566668693657, 1494720534426543 },
+    { 1306097687903586, 1372543655508231, 1658076721821581, 2200003583698537, 780636112677937 }
+  },
+  {
+    { 814536290823781, 63061116467332, 804840198178091, 8292666531281, 2073254466378785 },
+    { 722478309804879, 1188829196206039, 1185414523406556, 1657025426781102, 1841660092890563 },
+    { 479894784370716, 1925880613677947, 2183487522494884, 625094381313712, 854845126872293 }
+  },
+  {
+    { 817093479351430, 1836962122101804, 919916971324812, 476742058422480, 1520644895959803 },
+    { 694018530392140, 2181664308275944, 1008881841276548, 1869175821107034, 1331662548691003 },
+    { 1207982418891449, 1577854720087533, 2009037012572541, 1476807775109585, 764858983320152 }
+  },
+  {
+    { 292623621294190, 1087309087737456, 321655784028745, 859400146466929, 313265906579808 },
+    { 140152580198083, 1925625273063552, 465551876178050, 1812104517839551, 1575877311322463 },
+    { 1960514462005953, 1030291725190195, 357278058611993, 503261352420903, 409647200988996 }
+  },
+  {
+    { 1640564024541742, 1198304966395870, 1372955845260038, 236154098509699, 1964015174577550 },
+    { 1885636610741691, 1508783391782587, 1311104907831964, 1427543553470043, 1292851863616546 },
+    { 1832104727099167, 996069167520846, 1100729754186688, 1771584084767106, 2117261745027080 }
+  },
+  {
+    { 1199122074926019, 270259320717536, 397875262207323, 868065793065420, 1432109594857766 },
+    { 2179220822379819, 1000095666499659, 49992398096602, 1767660763649070, 328419317743688 },
+    { 1875633950147766, 1109790076082089, 897660652998513, 1428078707156757, 908826481148722 }
+  },
+  {
+    { 382218292636378, 253308433944437, 874541765087370, 2016974307899051, 1468999769476078 },
+    { 550413608250370, 875252643681210, 2041453659475649, 2067699249466175, 837158492223667 },
+    { 2013224690617610, 881120726963113, 2087874148443678, 930634847072563, 2100154549645766 }
+  }
+}
@@ -1,16 +1,22 @@
 
 #include <limits.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "crypto_hash_sha512.h"
 #include "crypto_sign_ed25519.h"
 #include "crypto_verify_32.h"
+#include "randombytes.h"
 #include "sign_ed25519_ref10.h"
 #include "private/common.h"
 #include "private/ed25519_ref10.h"
 #include "utils.h"
 
+#ifndef ED25519_VERIFY_BATCH_CHUNK
+# define ED25519_VERIFY_BATCH_CHUNK 8U
+#endif
+
 int
 _crypto_sign_ed25519_verify_detached(const unsigned char *sig,
                                      const unsigned char *m,
@@ -65,6 +71,179 @@ crypto_sign_ed25519_verify_detached(const unsigned char *sig,
     return _crypto_sign_ed25519_verify_detached(sig, m, mlen, pk, 0);
 }
 
+static int
+_crypto_sign_ed25519_verify_each(int *valid, const unsigned char * const *sigs,
+                                 const unsigned char * const *ms,
+                                 const unsigned long long *mlens,
+                                 const unsigned char * const *pks, size_t n)
+{
+    size_t i;
+    int    ret = 0;
+    int    ok;
+
+    for (i = 0; i < n; i++) {
+        ok = _crypto_sign_ed25519_verify_detached(sigs[i], ms[i], mlens[i],
+                                                  pks[i], 0) == 0;
+        if (valid != NULL) {
+            valid[i] = ok;
+        } else if (!ok) {
+            return -1;
+        }
+        ret |= ok - 1;
+    }
+    return ret;
+}
+
+#ifndef ED25519_COMPAT
+/*
+ * Batch verification checks a random linear combination of the verification
+ * equations of up to ED25519_VERIFY_BATCH_CHUNK signatures with a single
+ * multi-scalar multiplication:
+ *
+ *   (sum z_i s_i) B + sum (z_i h_i) (-A_i) + sum z_i (-R_i) = 0
+ *
+ * with random, non-zero, 128-bit z_i. If it does not hold, every signature
+ * of the chunk is verified on its own to tell the bad ones apart.
+ *
+ * Encodings are checked exactly as crypto_sign_ed25519_verify_detached()
+ * does, but the combination is not exactly the same check. A_i and R_i may
+ * carry a small-order component, which is not rejected: a signature made by
+ * the owner of the secret key with R_i shifted by a point T of order 2^k
+ * only satisfies the combination up to z_i T (z_i h_i T for A_i). It is
+ * rejected when verified on its own, but accepted here whenever that
+ * multiple of T is zero, with a probability of about 2^-k: 1/2 for a point
+ * of order 2. The weights are drawn in full for that reason: with odd
+ * weights, any two signatures shifted by the point of order 2 would cancel
+ * out every time. Without the secret key, no signature can be made that the
+ * combination accepts.
+ */
+
+typedef struct ed25519_batch_scratch {
+    ge25519_p3     points[2 * ED25519_VERIFY_BATCH_CHUNK];
+    unsigned char  scalars[2 * ED25519_VERIFY_BATCH_CHUNK][32];
+    ge25519_cached tables[2 * ED25519_VERIFY_BATCH_CHUNK][8];
+    signed char    slides[2 * ED25519_VERIFY_BATCH_CHUNK][256];
+} ed25519_batch_scratch;
+
+static int
+_crypto_sign_ed25519_verify_chunk(ed25519_batch_scratch *scratch, int *valid,
+                                  const unsigned char * const *sigs,
+                                  const unsigned char * const *ms,
+                                  const unsigned long long *mlens,
+                                  const unsigned char * const *pks, size_t n)
+{
+    crypto_hash_sha512_state hs;
+    unsigned char            h[64];
+    unsigned char            z[32];
+    unsigned char            b[32];
+    unsigned char            check[32];
+    int                      ok[ED25519_VERIFY_BATCH_CHUNK];
+    ge25519_p2               P;
+    size_t                   i;
+    size_t                   np = 0;
+    size_t                   last = 0;
+    int                      ret = 0;
+
+    memset(b, 0, sizeof b);
+    memset(z, 0, sizeof z);
+    for (i = 0; i < n; i++) {
+        ok[i] = sc25519_is_canonical(sigs[i] + 32) != 0 &&
+                ge25519_has_small_order(sigs[i]) == 0 &&
+                ge25519_is_canonical(sigs[i]) != 0 &&
+                ge25519_is_canonical(pks[i]) != 0 &&
+                ge25519_has_small_order(pks[i]) == 0 &&
+                ge25519_frombytes_negate_vartime(&scratch->points[np], pks[i]) == 0 &&
+                ge25519_frombytes_negate_vartime(&scratch->points[np + 1], sigs[i]) == 0;
+        if (!ok[i]) {
+            if (valid == NULL) {
+                return -1;
+            }
+            ret = -1;
+            continue;
+        }
+        _crypto_sign_ed25519_ref10_hinit(&hs, 0);
+        crypto_hash_sha512_update(&hs, sigs[i], 32);
+        crypto_hash_sha512_update(&hs, pks[i], 32);
+        crypto_hash_sha512_update(&hs, ms[i], mlens[i]);
+        crypto_hash_sha512_final(&hs, h);
+        sc25519_reduce(h);
+
+        do {
+            randombytes_buf(z, 16);
+        } while (sodium_is_zero(z, 16));
+        sc25519_mul(scratch->scalars[np], z, h);
+        memcpy(scratch->scalars[np + 1], z, 32);
+        sc25519_muladd(b, z, sigs[i] + 32, b);
+        np += 2;
+        last = i;
+    }
+    if (np == 2) {
+        ok[last] = _crypto_sign_ed25519_verify_detached(sigs[last], ms[last],
+                                                        mlens[last], pks[last],
+                                                        0) == 0;
+        ret |= ok[last] - 1;
+    } else if (np > 2) {
+        ge25519_multi_scalarmult_vartime(&P, b,
+                                         (const unsigned char (*)[32]) scratch->scalars,
+                                         scratch->points, np, scratch->tables,
+                                         scratch->slides);
+        ge25519_tobytes(check, &P);
+        if (check[0] != 1 || !sodium_is_zero(check + 1, 31)) {
+            if (valid == NULL) {
+                return -1;
+            }
+            for (i = 0; i < n; i++) {
+                if (ok[i]) {
+                    ok[i] = _crypto_sign_ed25519_verify_detached(sigs[i], ms[i],
+                                                                 mlens[i], pks[i],
+                                                                 0) == 0;
+                    ret |= ok[i] - 1;
+                }
+            }
+        }
+    }
+    if (valid != NULL) {
+        memcpy(valid, ok, n * sizeof ok[0]);
+    }
+    return ret;
+}
+#endif
+
+int
+crypto_sign_ed25519_verify_batch(int *valid, const unsigned char * const *sigs,
+                                 const unsigned char * const *ms,
+                                 const unsigned long long *mlens,
+                                 const unsigned char * const *pks, size_t n)
+{
+#ifdef ED25519_COMPAT
+    return _crypto_sign_ed25519_verify_each(valid, sigs, ms, mlens, pks, n);
+#else
+    ed25519_batch_scratch *scratch;
+    size_t                 i;
+    size_t                 c;
+    int                    ret = 0;
+
+    ACQUIRE_FENCE;
+    if (n < 2U ||
+        (scratch = (ed25519_batch_scratch *) malloc(sizeof *scratch)) == NULL) {
+        return _crypto_sign_ed25519_verify_each(valid, sigs, ms, mlens, pks, n);
+    }
+    for (i = 0; i < n; i += c) {
+        c = n - i < ED25519_VERIFY_BATCH_CHUNK ? n - i : ED25519_VERIFY_BATCH_CHUNK;
+        ret |= _crypto_sign_ed25519_verify_chunk(scratch,
+                                                 valid == NULL ? NULL : valid + i,
+                                                 sigs + i, ms + i, mlens + i,
+                                                 pks + i, c);
+        if (ret != 0 && valid == NULL) {
+            break;
+        }
+    }
+    free(scratch);
+
+    return ret;
+#endif
+}
+
 int
 crypto_sign_ed25519_open(unsigned char *m, unsigned long long *mlen_p,
                          const unsigned char *sm, unsigned long long smlen,
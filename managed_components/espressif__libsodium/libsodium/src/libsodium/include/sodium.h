@@ -60,6 +60,7 @@
 #include "sodium/utils.h"
 
 #ifndef SODIUM_LIBRARY_MINIMAL
+#include "sodium/crypto_box_curve25519hkdfchacha20poly1305.h"
 #include "sodium/crypto_box_curve25519xchacha20poly1305.h"
 #include "sodium/crypto_core_ed25519.h"
 #include "sodium/crypto_core_ristretto255.h"
@@ -85,6 +85,42 @@ int crypto_aead_chacha20poly1305_ietf_decrypt_detached(unsigned char *m,
                                                        const unsigned char *k)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
 
+/*
+ * Scatter-gather variants: the message is the concatenation of nsegs
+ * segments, each read from `in` and written to `out` (out == in is allowed,
+ * other overlaps are not). The keystream and the MAC run across segment
+ * boundaries, so the result is the same as the detached API applied to the
+ * flattened message. On verification failure, every `out` is zeroed.
+ */
+typedef struct crypto_aead_chacha20poly1305_ietf_segment {
+    unsigned char       *out;
+    const unsigned char *in;
+    size_t               len;
+} crypto_aead_chacha20poly1305_ietf_segment;
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_encryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs,
+                                               size_t nsegs,
+                                               unsigned char *mac,
+                                               unsigned long long *maclen_p,
+                                               const unsigned char *ad,
+                                               unsigned long long adlen,
+                                               const unsigned char *nsec,
+                                               const unsigned char *npub,
+                                               const unsigned char *k)
+            __attribute__ ((nonnull(3, 8, 9)));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_decryptv(const crypto_aead_chacha20poly1305_ietf_segment *segs,
+                                               size_t nsegs,
+                                               unsigned char *nsec,
+                                               const unsigned char *mac,
+                                               const unsigned char *ad,
+                                               unsigned long long adlen,
+                                               const unsigned char *npub,
+                                               const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(4, 7, 8)));
+
 SODIUM_EXPORT
 void crypto_aead_chacha20poly1305_ietf_keygen(unsigned char k[crypto_aead_chacha20poly1305_ietf_KEYBYTES])
             __attribute__ ((nonnull));
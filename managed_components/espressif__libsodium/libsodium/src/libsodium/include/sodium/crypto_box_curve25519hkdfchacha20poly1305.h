@@ -0,0 +1,167 @@
+#ifndef crypto_box_curve25519hkdfchacha20poly1305_H
+#define crypto_box_curve25519hkdfchacha20poly1305_H
+
+/*
+ * X25519 key exchange, HKDF-SHA512 key derivation and ChaCha20-Poly1305
+ * (IETF) encryption, as used by HomeKit pair-verify and pair-resume.
+ *
+ * _beforenm() computes the X25519 shared secret once and keeps it in a
+ * state, from which any number of keys can then be derived with
+ * _derive_key() for different salts and infos. _resume() derives the
+ * shared secret of a follow-up session from a previous one, with no
+ * scalar multiplication; previous states can be kept in a fixed-size
+ * session cache, looked up by a session identifier chosen by the caller
+ * (with randombytes_buf()) before the state is derived from it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "crypto_aead_chacha20poly1305.h"
+#include "crypto_scalarmult_curve25519.h"
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+#define crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES 32U
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_publickeybytes(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES 32U
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_secretkeybytes(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES \
+    crypto_aead_chacha20poly1305_ietf_KEYBYTES
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_keybytes(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_NONCEBYTES \
+    crypto_aead_chacha20poly1305_ietf_NPUBBYTES
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_noncebytes(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_MACBYTES \
+    crypto_aead_chacha20poly1305_ietf_ABYTES
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_macbytes(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES 8U
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_sessionidbytes(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES 32U
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_peerbytes(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS 8U
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_cacheslots(void);
+
+#define crypto_box_curve25519hkdfchacha20poly1305_MESSAGEBYTES_MAX \
+    crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_messagebytes_max(void);
+
+typedef struct crypto_box_curve25519hkdfchacha20poly1305_state {
+    unsigned char shared[crypto_scalarmult_curve25519_BYTES];
+} crypto_box_curve25519hkdfchacha20poly1305_state;
+
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_statebytes(void);
+
+typedef struct crypto_box_curve25519hkdfchacha20poly1305_cache {
+    struct {
+        crypto_box_curve25519hkdfchacha20poly1305_state state;
+        unsigned char id[crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES];
+        unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES];
+        uint32_t      stamp; /* 0 for a free slot */
+    } slots[crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS];
+    uint32_t clock;
+} crypto_box_curve25519hkdfchacha20poly1305_cache;
+
+SODIUM_EXPORT
+size_t crypto_box_curve25519hkdfchacha20poly1305_cachebytes(void);
+
+SODIUM_EXPORT
+int crypto_box_curve25519hkdfchacha20poly1305_keypair(unsigned char *pk,
+                                                      unsigned char *sk)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_box_curve25519hkdfchacha20poly1305_beforenm(crypto_box_curve25519hkdfchacha20poly1305_state *state,
+                                                       const unsigned char *pk,
+                                                       const unsigned char *sk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_box_curve25519hkdfchacha20poly1305_derive_key(unsigned char k[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES],
+                                                         const crypto_box_curve25519hkdfchacha20poly1305_state *state,
+                                                         const unsigned char *salt, size_t salt_len,
+                                                         const char *info, size_t info_len)
+            __attribute__ ((nonnull(1, 2)));
+
+SODIUM_EXPORT
+int crypto_box_curve25519hkdfchacha20poly1305_resume(crypto_box_curve25519hkdfchacha20poly1305_state *next,
+                                                     const crypto_box_curve25519hkdfchacha20poly1305_state *state,
+                                                     const unsigned char *salt, size_t salt_len,
+                                                     const char *info, size_t info_len)
+            __attribute__ ((nonnull(1, 2)));
+
+SODIUM_EXPORT
+int crypto_box_curve25519hkdfchacha20poly1305_detached_afternm(unsigned char *c,
+                                                               unsigned char *mac,
+                                                               const unsigned char *m,
+                                                               unsigned long long mlen,
+                                                               const unsigned char *ad,
+                                                               unsigned long long adlen,
+                                                               const unsigned char *n,
+                                                               const unsigned char *k)
+            __attribute__ ((nonnull(1, 2, 7, 8)));
+
+SODIUM_EXPORT
+int crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(unsigned char *m,
+                                                                    const unsigned char *c,
+                                                                    const unsigned char *mac,
+                                                                    unsigned long long clen,
+                                                                    const unsigned char *ad,
+                                                                    unsigned long long adlen,
+                                                                    const unsigned char *n,
+                                                                    const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(2, 3, 7, 8)));
+
+/* -- Session cache -- */
+
+SODIUM_EXPORT
+void crypto_box_curve25519hkdfchacha20poly1305_cache_init(crypto_box_curve25519hkdfchacha20poly1305_cache *cache)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_box_curve25519hkdfchacha20poly1305_cache_store(crypto_box_curve25519hkdfchacha20poly1305_cache *cache,
+                                                           const unsigned char id[crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES],
+                                                           const crypto_box_curve25519hkdfchacha20poly1305_state *state,
+                                                           const unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_box_curve25519hkdfchacha20poly1305_cache_take(crypto_box_curve25519hkdfchacha20poly1305_state *state,
+                                                         unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES],
+                                                         crypto_box_curve25519hkdfchacha20poly1305_cache *cache,
+                                                         const unsigned char id[crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES])
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 4)));
+
+/* peer == NULL forgets every session */
+SODIUM_EXPORT
+void crypto_box_curve25519hkdfchacha20poly1305_cache_forget(crypto_box_curve25519hkdfchacha20poly1305_cache *cache,
+                                                            const unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES])
+            __attribute__ ((nonnull(1)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
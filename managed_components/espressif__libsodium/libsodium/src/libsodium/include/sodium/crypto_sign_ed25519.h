@@ -66,6 +66,15 @@ int crypto_sign_ed25519_verify_detached(const unsigned char *sig,
                                         const unsigned char *pk)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 4)));
 
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_batch(int *valid,
+                                     const unsigned char * const *sigs,
+                                     const unsigned char * const *ms,
+                                     const unsigned long long *mlens,
+                                     const unsigned char * const *pks,
+                                     size_t n)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(2, 3, 4, 5)));
+
 SODIUM_EXPORT
 int crypto_sign_ed25519_keypair(unsigned char *pk, unsigned char *sk)
             __attribute__ ((nonnull));
@@ -97,6 +97,12 @@ void ge25519_double_scalarmult_vartime(ge25519_p2 *r, const unsigned char *a,
                                        const ge25519_p3 *A,
                                        const unsigned char *b);
 
+void ge25519_multi_scalarmult_vartime(ge25519_p2 *r, const unsigned char *b,
+                                      const unsigned char (*a)[32],
+                                      const ge25519_p3 *A, size_t n,
+                                      ge25519_cached (*Ai)[8],
+                                      signed char (*aslide)[256]);
+
 void ge25519_scalarmult(ge25519_p3 *h, const unsigned char *a,
                         const ge25519_p3 *p);
 
@@ -9,5 +9,6 @@ int _crypto_stream_chacha20_pick_best_implementation(void);
 int _crypto_stream_salsa20_pick_best_implementation(void);
 int _crypto_aead_aegis128l_pick_best_implementation(void);
 int _crypto_aead_aegis256_pick_best_implementation(void);
+int _crypto_aead_chacha20poly1305_pick_best_implementation(void);
 
 #endif
@@ -0,0 +1,160 @@
+#define TEST_NAME "aead_chacha20poly13053"
+#include "cmptest.h"
+
+#define MAX_MLEN 1000U
+#define MAX_SEGS 12U
+
+static const size_t mlens[] = { 0U, 1U, 15U, 16U, 17U, 63U, 64U, 65U,
+                                127U, 128U, 129U, 200U, 1000U };
+static const size_t adlens[] = { 0U, 2U, 13U };
+
+static uint32_t lcg_state = 0x12345678U;
+
+static uint32_t
+lcg(void)
+{
+    lcg_state = lcg_state * 1103515245U + 12345U;
+    return lcg_state >> 8;
+}
+
+/* cuts [0, mlen) into segments; pattern 0 is a single segment */
+static size_t
+split(crypto_aead_chacha20poly1305_ietf_segment *segs, unsigned char *out,
+      const unsigned char *in, size_t mlen, unsigned int pattern)
+{
+    size_t nsegs = 0U;
+    size_t pos = 0U;
+    size_t len;
+
+    while (pos < mlen || nsegs == 0U) {
+        if (nsegs == MAX_SEGS - 1U || pattern == 0U) {
+            len = mlen - pos;
+        } else if (pattern == 1U) {
+            len = lcg() % 3U; /* includes empty segments */
+            if (len > mlen - pos) {
+                len = mlen - pos;
+            }
+        } else {
+            len = lcg() % (mlen - pos + 1U);
+        }
+        segs[nsegs].out = len > 0U ? out + pos : NULL;
+        segs[nsegs].in = len > 0U ? in + pos : NULL;
+        segs[nsegs].len = len;
+        nsegs++;
+        pos += len;
+    }
+    return nsegs;
+}
+
+static int
+is_zero(const unsigned char *p, size_t len)
+{
+    size_t i;
+
+    for (i = 0U; i < len; i++) {
+        if (p[i] != 0U) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void
+tv(void)
+{
+    crypto_aead_chacha20poly1305_ietf_segment segs[MAX_SEGS];
+    unsigned char                            *key;
+    unsigned char                            *nonce;
+    unsigned char                            *ad;
+    unsigned char                            *m;
+    unsigned char                            *c;
+    unsigned char                            *out;
+    unsigned char                             mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned char                             macv[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned long long                        maclen;
+    size_t                                    i, j, mlen, adlen, nsegs;
+    unsigned int                              pattern, round;
+    unsigned int                              checks = 0U;
+
+    key = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    nonce = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    ad = (unsigned char *) sodium_malloc(13U);
+    m = (unsigned char *) sodium_malloc(MAX_MLEN);
+    c = (unsigned char *) sodium_malloc(MAX_MLEN);
+    out = (unsigned char *) sodium_malloc(MAX_MLEN);
+    randombytes_buf(key, crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    randombytes_buf(nonce, crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    randombytes_buf(ad, 13U);
+    randombytes_buf(m, MAX_MLEN);
+
+    for (i = 0U; i < sizeof mlens / sizeof mlens[0]; i++) {
+        mlen = mlens[i];
+        for (j = 0U; j < sizeof adlens / sizeof adlens[0]; j++) {
+            adlen = adlens[j];
+            crypto_aead_chacha20poly1305_ietf_encrypt_detached(c, mac, NULL, m, mlen,
+                                                               ad, adlen, NULL,
+                                                               nonce, key);
+            for (pattern = 0U; pattern < 3U; pattern++) {
+                for (round = 0U; round < (pattern == 0U ? 1U : 8U); round++) {
+                    /* out of place */
+                    nsegs = split(segs, out, m, mlen, pattern);
+                    maclen = 0U;
+                    crypto_aead_chacha20poly1305_ietf_encryptv(segs, nsegs, macv, &maclen,
+                                                               ad, adlen, NULL,
+                                                               nonce, key);
+                    assert(maclen == crypto_aead_chacha20poly1305_ietf_ABYTES);
+                    if (memcmp(out, c, mlen) != 0 || memcmp(macv, mac, sizeof mac) != 0) {
+                        printf("encryptv: mlen=%u adlen=%u pattern=%u\n",
+                               (unsigned int) mlen, (unsigned int) adlen, pattern);
+                    }
+                    /* in place, through a different cut */
+                    memcpy(out, m, mlen);
+                    nsegs = split(segs, out, out, mlen, pattern);
+                    crypto_aead_chacha20poly1305_ietf_encryptv(segs, nsegs, macv, NULL,
+                                                               ad, adlen, NULL,
+                                                               nonce, key);
+                    if (memcmp(out, c, mlen) != 0 || memcmp(macv, mac, sizeof mac) != 0) {
+                        printf("encryptv in place: mlen=%u adlen=%u pattern=%u\n",
+                               (unsigned int) mlen, (unsigned int) adlen, pattern);
+                    }
+                    nsegs = split(segs, out, out, mlen, pattern);
+                    if (crypto_aead_chacha20poly1305_ietf_decryptv(segs, nsegs, NULL, mac,
+                                                                   ad, adlen, nonce,
+                                                                   key) != 0 ||
+                        memcmp(out, m, mlen) != 0) {
+                        printf("decryptv in place: mlen=%u adlen=%u pattern=%u\n",
+                               (unsigned int) mlen, (unsigned int) adlen, pattern);
+                    }
+                    checks++;
+                }
+            }
+            /* a forged tag must be rejected and wipe every output */
+            nsegs = split(segs, out, c, mlen, 2U);
+            memset(out, 0xaa, mlen);
+            mac[0] ^= 1U;
+            if (crypto_aead_chacha20poly1305_ietf_decryptv(segs, nsegs, NULL, mac,
+                                                           ad, adlen, nonce, key) != -1 ||
+                !is_zero(out, mlen)) {
+                printf("decryptv forgery: mlen=%u adlen=%u\n",
+                       (unsigned int) mlen, (unsigned int) adlen);
+            }
+        }
+    }
+    assert(checks == (sizeof mlens / sizeof mlens[0]) * (sizeof adlens / sizeof adlens[0]) * 17U);
+
+    sodium_free(out);
+    sodium_free(c);
+    sodium_free(m);
+    sodium_free(ad);
+    sodium_free(nonce);
+    sodium_free(key);
+}
+
+int
+main(void)
+{
+    tv();
+    printf("OK\n");
+
+    return 0;
+}
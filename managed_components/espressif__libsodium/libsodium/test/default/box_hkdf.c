@@ -0,0 +1,214 @@
+#define TEST_NAME "box_hkdf"
+#include "cmptest.h"
+
+#define SLOTS crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS
+
+static const char salt[] = "Pair-Verify-Encrypt-Salt";
+static const char info[] = "Pair-Verify-Encrypt-Info";
+static const char resume_info[] = "Pair-Resume-Shared-Secret-Info";
+
+/* an X25519 point of order 8 */
+static const unsigned char small_order[32] = {
+    0xe0, 0xeb, 0x7a, 0x7c, 0x3b, 0x41, 0xb8, 0xae, 0x16, 0x56, 0xe3,
+    0xfa, 0xf1, 0x9f, 0xc4, 0x6a, 0xda, 0x09, 0x8d, 0xeb, 0x9c, 0x32,
+    0xb1, 0xfd, 0x86, 0x62, 0x05, 0x16, 0x5f, 0x49, 0xb8, 0x00
+};
+
+static void
+tv_session(void)
+{
+    crypto_box_curve25519hkdfchacha20poly1305_state alice;
+    crypto_box_curve25519hkdfchacha20poly1305_state bob;
+    unsigned char alice_pk[crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES];
+    unsigned char alice_sk[crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES];
+    unsigned char bob_pk[crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES];
+    unsigned char bob_sk[crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES];
+    unsigned char shared[crypto_scalarmult_curve25519_BYTES];
+    unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES];
+    unsigned char k[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+    unsigned char k2[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+    unsigned char n[crypto_box_curve25519hkdfchacha20poly1305_NONCEBYTES];
+    unsigned char mac[crypto_box_curve25519hkdfchacha20poly1305_MACBYTES];
+    unsigned char m[100];
+    unsigned char c[100];
+    unsigned char m2[100];
+
+    crypto_box_curve25519hkdfchacha20poly1305_keypair(alice_pk, alice_sk);
+    crypto_box_curve25519hkdfchacha20poly1305_keypair(bob_pk, bob_sk);
+    if (crypto_box_curve25519hkdfchacha20poly1305_beforenm(&alice, bob_pk, alice_sk) != 0 ||
+        crypto_box_curve25519hkdfchacha20poly1305_beforenm(&bob, alice_pk, bob_sk) != 0) {
+        printf("beforenm() failed\n");
+    }
+    if (memcmp(&alice, &bob, sizeof alice) != 0) {
+        printf("beforenm() shared secrets differ\n");
+    }
+    if (crypto_box_curve25519hkdfchacha20poly1305_beforenm(&alice, small_order, alice_sk) != -1) {
+        printf("beforenm() accepted a small order point\n");
+    }
+
+    /* derive_key() is HKDF-SHA512 over the X25519 shared secret */
+    if (crypto_scalarmult_curve25519(shared, alice_sk, bob_pk) != 0) {
+        printf("crypto_scalarmult_curve25519() failed\n");
+    }
+    crypto_kdf_hkdf_sha512_extract(prk, (const unsigned char *) salt, strlen(salt),
+                                   shared, sizeof shared);
+    crypto_kdf_hkdf_sha512_expand(k2, sizeof k2, info, strlen(info), prk);
+    crypto_box_curve25519hkdfchacha20poly1305_derive_key(k, &bob, (const unsigned char *) salt,
+                                                         strlen(salt), info, strlen(info));
+    if (memcmp(k, k2, sizeof k) != 0) {
+        printf("derive_key() does not match HKDF-SHA512\n");
+    }
+
+    /* detached encryption is ChaCha20-Poly1305-IETF */
+    randombytes_buf(m, sizeof m);
+    randombytes_buf(n, sizeof n);
+    crypto_box_curve25519hkdfchacha20poly1305_detached_afternm(c, mac, m, sizeof m,
+                                                               NULL, 0U, n, k);
+    if (crypto_aead_chacha20poly1305_ietf_decrypt_detached(m2, NULL, c, sizeof c, mac,
+                                                           NULL, 0U, n, k) != 0 ||
+        memcmp(m, m2, sizeof m) != 0) {
+        printf("detached_afternm() is not ChaCha20-Poly1305-IETF\n");
+    }
+    memset(m2, 0, sizeof m2);
+    if (crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(m2, c, mac, sizeof c,
+                                                                        NULL, 0U, n, k) != 0 ||
+        memcmp(m, m2, sizeof m) != 0) {
+        printf("open_detached_afternm() failed\n");
+    }
+    c[sizeof c - 1] ^= 1;
+    if (crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(m2, c, mac, sizeof c,
+                                                                        NULL, 0U, n, k) != -1) {
+        printf("open_detached_afternm() accepted a forgery\n");
+    }
+    c[sizeof c - 1] ^= 1;
+    /* an empty message is an authentication tag */
+    crypto_box_curve25519hkdfchacha20poly1305_detached_afternm(c, mac, NULL, 0U,
+                                                               NULL, 0U, n, k);
+    if (crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(NULL, c, mac, 0U,
+                                                                        NULL, 0U, n, k) != 0) {
+        printf("open_detached_afternm() rejected an empty message\n");
+    }
+
+    /* both sides resume to the same secret, which is not the previous one */
+    if (crypto_box_curve25519hkdfchacha20poly1305_resume(&alice, &bob, n, sizeof n,
+                                                         resume_info, strlen(resume_info)) != 0 ||
+        crypto_box_curve25519hkdfchacha20poly1305_resume(&bob, &bob, n, sizeof n,
+                                                         resume_info, strlen(resume_info)) != 0) {
+        printf("resume() failed\n");
+    }
+    if (memcmp(&alice, &bob, sizeof alice) != 0) {
+        printf("resume() shared secrets differ\n");
+    }
+    if (memcmp(alice.shared, shared, sizeof shared) == 0) {
+        printf("resume() did not change the shared secret\n");
+    }
+}
+
+static void
+tv_cache(void)
+{
+    crypto_box_curve25519hkdfchacha20poly1305_cache *cache;
+    crypto_box_curve25519hkdfchacha20poly1305_state  states[SLOTS + 1];
+    crypto_box_curve25519hkdfchacha20poly1305_state  state;
+    unsigned char ids[SLOTS + 1][crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES];
+    unsigned char peers[SLOTS + 1][crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES];
+    unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES];
+    size_t        i;
+
+    cache = (crypto_box_curve25519hkdfchacha20poly1305_cache *)
+        sodium_malloc(crypto_box_curve25519hkdfchacha20poly1305_cachebytes());
+    crypto_box_curve25519hkdfchacha20poly1305_cache_init(cache);
+    for (i = 0; i < SLOTS + 1; i++) {
+        randombytes_buf(states[i].shared, sizeof states[i].shared);
+        randombytes_buf(peers[i], sizeof peers[i]);
+        randombytes_buf(ids[i], sizeof ids[i]);
+    }
+
+    /* one more session than there are slots: the oldest one is evicted */
+    for (i = 0; i < SLOTS + 1; i++) {
+        crypto_box_curve25519hkdfchacha20poly1305_cache_store(cache, ids[i], &states[i], peers[i]);
+    }
+    if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, peer, cache, ids[0]) != -1) {
+        printf("cache_take() found an evicted session\n");
+    }
+    for (i = 1; i < SLOTS + 1; i++) {
+        if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, peer, cache, ids[i]) != 0) {
+            printf("cache_take() did not find session %u\n", (unsigned int) i);
+            continue;
+        }
+        if (memcmp(&state, &states[i], sizeof state) != 0 ||
+            memcmp(peer, peers[i], sizeof peer) != 0) {
+            printf("cache_take() returned the wrong session for %u\n", (unsigned int) i);
+        }
+    }
+    /* sessions can be resumed only once */
+    if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, peer, cache, ids[1]) != -1) {
+        printf("cache_take() returned the same session twice\n");
+    }
+
+    /* taken slots are free again, and nothing is evicted */
+    for (i = 0; i < SLOTS; i++) {
+        crypto_box_curve25519hkdfchacha20poly1305_cache_store(cache, ids[i], &states[i],
+                                                              peers[i % 2]);
+    }
+    /* storing a session again replaces it */
+    crypto_box_curve25519hkdfchacha20poly1305_cache_store(cache, ids[1], &states[SLOTS],
+                                                          peers[1]);
+    if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, NULL, cache, ids[1]) != 0 ||
+        memcmp(&state, &states[SLOTS], sizeof state) != 0 ||
+        crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, NULL, cache, ids[1]) != -1) {
+        printf("cache_store() did not replace a session with the same identifier\n");
+    }
+    crypto_box_curve25519hkdfchacha20poly1305_cache_store(cache, ids[1], &states[1], peers[1]);
+    if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, NULL, cache, ids[0]) != 0 ||
+        memcmp(&state, &states[0], sizeof state) != 0) {
+        printf("cache_take() did not find the first session\n");
+    }
+    crypto_box_curve25519hkdfchacha20poly1305_cache_forget(cache, peers[0]);
+    for (i = 1; i < SLOTS; i++) {
+        if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, peer, cache, ids[i]) !=
+            (i % 2 == 0 ? -1 : 0)) {
+            printf("cache_forget() did not forget session %u alone\n", (unsigned int) i);
+        }
+    }
+    crypto_box_curve25519hkdfchacha20poly1305_cache_store(cache, ids[0], &states[0], peers[0]);
+    crypto_box_curve25519hkdfchacha20poly1305_cache_forget(cache, NULL);
+    if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, peer, cache, ids[0]) != -1) {
+        printf("cache_forget(NULL) did not forget every session\n");
+    }
+    sodium_free(cache);
+}
+
+int
+main(void)
+{
+    tv_session();
+    tv_cache();
+
+    assert(crypto_box_curve25519hkdfchacha20poly1305_publickeybytes() ==
+           crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_secretkeybytes() ==
+           crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_keybytes() ==
+           crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_noncebytes() ==
+           crypto_box_curve25519hkdfchacha20poly1305_NONCEBYTES);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_macbytes() ==
+           crypto_box_curve25519hkdfchacha20poly1305_MACBYTES);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_sessionidbytes() ==
+           crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_peerbytes() ==
+           crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_cacheslots() ==
+           crypto_box_curve25519hkdfchacha20poly1305_CACHESLOTS);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_messagebytes_max() ==
+           crypto_box_curve25519hkdfchacha20poly1305_MESSAGEBYTES_MAX);
+    assert(crypto_box_curve25519hkdfchacha20poly1305_statebytes() ==
+           sizeof(crypto_box_curve25519hkdfchacha20poly1305_state));
+    assert(crypto_box_curve25519hkdfchacha20poly1305_cachebytes() ==
+           sizeof(crypto_box_curve25519hkdfchacha20poly1305_cache));
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#define TEST_NAME "sign2"
+#include "cmptest.h"
+
+#define MAX_SIGS 70U
+#define MLEN     100U
+
+static unsigned char  pk[MAX_SIGS][crypto_sign_ed25519_PUBLICKEYBYTES];
+static unsigned char  sk[MAX_SIGS][crypto_sign_ed25519_SECRETKEYBYTES];
+static unsigned char  sig[MAX_SIGS][crypto_sign_ed25519_BYTES];
+static unsigned char  m[MAX_SIGS][MLEN];
+
+static const unsigned char *sigs[MAX_SIGS];
+static const unsigned char *ms[MAX_SIGS];
+static const unsigned char *pks[MAX_SIGS];
+static unsigned long long   mlens[MAX_SIGS];
+
+/* the order of the main subgroup */
+static const unsigned char L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
+    0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+/* a point of order 4 */
+static const unsigned char small_order[32] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/* y = p - 1, the point of order 2 */
+static const unsigned char order_2[32] = {
+    0xec, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f
+};
+
+/* y = p + 1, a non-canonical encoding of a point of order 1 */
+static const unsigned char non_canonical[32] = {
+    0xee, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f
+};
+
+static void
+check(const char *what, size_t n)
+{
+    int    valid[MAX_SIGS];
+    int    expected;
+    int    all = 1;
+    int    ret;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        valid[i] = -1;
+    }
+    ret = crypto_sign_ed25519_verify_batch(valid, sigs, ms, mlens, pks, n);
+    for (i = 0; i < n; i++) {
+        expected = crypto_sign_ed25519_verify_detached(sigs[i], ms[i], mlens[i],
+                                                       pks[i]) == 0;
+        if (valid[i] != expected) {
+            printf("%s: n=%u, signature %u: %d instead of %d\n", what,
+                   (unsigned int) n, (unsigned int) i, valid[i], expected);
+        }
+        all &= expected;
+    }
+    if (ret != (all ? 0 : -1)) {
+        printf("%s: n=%u: returned %d\n", what, (unsigned int) n, ret);
+    }
+    if (crypto_sign_ed25519_verify_batch(NULL, sigs, ms, mlens, pks, n) != ret) {
+        printf("%s: n=%u: different result without valid[]\n", what,
+               (unsigned int) n);
+    }
+}
+
+/*
+ * Signs with R shifted by the point of order 2, as only the owner of the
+ * secret scalar a can: verified on its own, such a signature is rejected
+ */
+static void
+sign_shifted(unsigned char *sig_, const unsigned char *a,
+             const unsigned char *A, const unsigned char *m_, size_t mlen)
+{
+    crypto_hash_sha512_state hs;
+    unsigned char            r[crypto_core_ed25519_SCALARBYTES];
+    unsigned char            h[crypto_hash_sha512_BYTES];
+    unsigned char            ha[crypto_core_ed25519_SCALARBYTES];
+
+    crypto_core_ed25519_scalar_random(r);
+    crypto_scalarmult_ed25519_base_noclamp(sig_, r);
+    crypto_core_ed25519_add(sig_, sig_, order_2);
+    crypto_hash_sha512_init(&hs);
+    crypto_hash_sha512_update(&hs, sig_, 32);
+    crypto_hash_sha512_update(&hs, A, 32);
+    crypto_hash_sha512_update(&hs, m_, mlen);
+    crypto_hash_sha512_final(&hs, h);
+    crypto_core_ed25519_scalar_reduce(ha, h);
+    crypto_core_ed25519_scalar_mul(ha, ha, a);
+    crypto_core_ed25519_scalar_add(sig_ + 32, r, ha);
+}
+
+static void
+reset(void)
+{
+    size_t i;
+
+    for (i = 0; i < MAX_SIGS; i++) {
+        sigs[i] = sig[i];
+        ms[i] = m[i];
+        pks[i] = pk[i];
+        mlens[i] = (unsigned long long) ((i + 50U) % MLEN);
+    }
+}
+
+int
+main(void)
+{
+    static const size_t sizes[] = { 0U, 1U, 2U, 3U, 7U, 8U, 9U, 16U, 17U, 64U, MAX_SIGS };
+    unsigned char       bad_s[crypto_sign_ed25519_BYTES];
+    unsigned char       bad_r[crypto_sign_ed25519_BYTES];
+    unsigned char       shifted[2][crypto_sign_ed25519_BYTES];
+    unsigned char       a[crypto_core_ed25519_SCALARBYTES];
+    unsigned char       A[crypto_core_ed25519_BYTES];
+    int                 valid[2];
+    size_t              i, j;
+    unsigned int        carry;
+    unsigned int        rejected;
+
+    for (i = 0; i < MAX_SIGS; i++) {
+        crypto_sign_ed25519_keypair(pk[i], sk[i]);
+        randombytes_buf(m[i], MLEN);
+        crypto_sign_ed25519_detached(sig[i], NULL, m[i], (unsigned long long) ((i + 50U) % MLEN),
+                                     sk[i]);
+    }
+    reset();
+    for (j = 0; j < sizeof sizes / sizeof sizes[0]; j++) {
+        check("valid", sizes[j]);
+    }
+
+    /* a wrong message alone, at the start, the end and in several chunks */
+    m[0][0] ^= 1;
+    check("message", 1);
+    check("message", 9);
+    m[8][0] ^= 1;
+    m[MAX_SIGS - 1][0] ^= 1;
+    for (j = 0; j < sizeof sizes / sizeof sizes[0]; j++) {
+        check("messages", sizes[j]);
+    }
+    m[0][0] ^= 1;
+    m[8][0] ^= 1;
+    m[MAX_SIGS - 1][0] ^= 1;
+
+    /* someone else's key */
+    pks[5] = pk[6];
+    check("key", 16);
+    reset();
+
+    /* s + L is the same scalar, but not in canonical form */
+    memcpy(bad_s, sig[3], sizeof bad_s);
+    carry = 0U;
+    for (i = 0; i < 32; i++) {
+        carry += (unsigned int) bad_s[32 + i] + L[i];
+        bad_s[32 + i] = (unsigned char) carry;
+        carry >>= 8;
+    }
+    sigs[3] = bad_s;
+    check("non-canonical s", 16);
+    reset();
+
+    /* R and the public key must be canonical and not of small order */
+    memcpy(bad_r, sig[4], sizeof bad_r);
+    memcpy(bad_r, small_order, 32);
+    sigs[4] = bad_r;
+    pks[10] = small_order;
+    pks[11] = non_canonical;
+    check("encodings", 16);
+    memcpy(bad_r, non_canonical, 32);
+    check("encodings", 16);
+    reset();
+
+    /* only invalid signatures */
+    for (i = 0; i < 16; i++) {
+        pks[i] = small_order;
+    }
+    check("all invalid", 16);
+    reset();
+
+    /*
+     * two signatures with R shifted by the point of order 2: rejected one by
+     * one, they cancel out in the combination when the sum of their weights
+     * is even, which odd weights always made it
+     */
+    crypto_core_ed25519_scalar_random(a);
+    crypto_scalarmult_ed25519_base_noclamp(A, a);
+    rejected = 0U;
+    for (j = 0; j < 32; j++) {
+        for (i = 0; i < 2; i++) {
+            sign_shifted(shifted[i], a, A, m[i], MLEN);
+            sigs[i] = shifted[i];
+            pks[i] = A;
+            mlens[i] = MLEN;
+            if (crypto_sign_ed25519_verify_detached(sigs[i], ms[i], mlens[i],
+                                                    pks[i]) == 0) {
+                printf("shifted R: accepted on its own\n");
+            }
+        }
+        if (crypto_sign_ed25519_verify_batch(valid, sigs, ms, mlens, pks, 2) != 0) {
+            rejected += valid[0] == 0 && valid[1] == 0;
+        }
+    }
+    if (rejected == 0U) {
+        printf("shifted R: always accepted by the combination\n");
+    }
+    reset();
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/*
+ * Prints base_comb.h for the field representation it is built for
+ * (fe_51 with -DHAVE_TI_MODE, fe_25_5 otherwise):
+ *
+ *   base_comb[i][j] = 16 * base[i][j] = 16*(j+1)*256^i*B
+ *
+ * Points are derived from base.h by doubling and written in the same
+ * canonical (y+x, y-x, 2dxy) form. As a check of that derivation, 256 * base[i]
+ * must reproduce base[i+1] exactly before anything is printed.
+ */
+#include "ed25519_ref10.c"
+
+#include <stdio.h>
+
+static const ge25519_precomp base[32][8] = {
+#ifdef HAVE_TI_MODE
+# include "fe_51/base.h"
+#else
+# include "fe_25_5/base.h"
+#endif
+};
+
+static void fe25519_canonical(fe25519 f)
+{
+    unsigned char s[32];
+
+    fe25519_tobytes(s, f);
+    fe25519_frombytes(f, s);
+}
+
+/* out = 2^k * in, k >= 1 */
+static void precomp_dbl_k(ge25519_precomp *out, const ge25519_precomp *in, int k)
+{
+    ge25519_p2   s;
+    ge25519_p1p1 r;
+    ge25519_p3   h;
+
+    /* (y+x, y-x) -> (X:Y:Z) = (2x:2y:2) */
+    fe25519_sub(s.X, in->yplusx, in->yminusx);
+    fe25519_add(s.Y, in->yplusx, in->yminusx);
+    fe25519_1(s.Z);
+    fe25519_add(s.Z, s.Z, s.Z);
+    for (int i = 0; i < k; i++) {
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+    }
+    ge25519_p1p1_to_p3(&h, &r);
+    ge25519_p3_to_precomp(out, &h);
+    fe25519_canonical(out->yplusx);
+    fe25519_canonical(out->yminusx);
+    fe25519_canonical(out->xy2d);
+}
+
+static void print_fe(const fe25519 f, const char *sep)
+{
+    printf("    { ");
+    for (size_t i = 0; i < sizeof(fe25519) / sizeof f[0]; i++) {
+#ifdef HAVE_TI_MODE
+        printf("%s%llu", i ? ", " : "", (unsigned long long) f[i]);
+#else
+        printf("%s%d", i ? ", " : "", (int) f[i]);
+#endif
+    }
+    printf(" }%s\n", sep);
+}
+
+int main(void)
+{
+    ge25519_precomp t;
+
+    for (int i = 0; i < 31; i++) {
+        for (int j = 0; j < 8; j++) {
+            precomp_dbl_k(&t, &base[i][j], 8);
+            if (memcmp(&t, &base[i + 1][j], sizeof t) != 0) {
+                fprintf(stderr, "256 * base[%d][%d] != base[%d][%d]\n", i, j, i + 1, j);
+                return 1;
+            }
+        }
+    }
+    for (int i = 0; i < 32; i++) {
+        printf("{ /* %d/31 */\n", i);
+        for (int j = 0; j < 8; j++) {
+            precomp_dbl_k(&t, &base[i][j], 4);
+            printf("  {\n");
+            print_fe(t.yplusx, ",");
+            print_fe(t.yminusx, ",");
+            print_fe(t.xy2d, "");
+            printf("  }%s\n", j < 7 ? "," : "");
+        }
+        printf("}%s\n", i < 31 ? "," : "");
+    }
+    return 0;
+}
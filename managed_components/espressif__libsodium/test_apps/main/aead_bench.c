@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/*
+ * Cycles/byte of the ChaCha20-Poly1305 IETF AEAD, two-pass reference
+ * construction vs. the fused single-pass kernel, for HAP-sized frames;
+ * then a header + body + trailer response encrypted after flattening it
+ * into one buffer vs. encrypted straight from its parts with _encryptv().
+ *
+ * Built into the test app (TEST_CASE in test_sodium.c) and on Linux by
+ * ../host_bench/Makefile, where it provides main().
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sodium.h"
+#include "chacha20poly1305_fused.h"
+#include "chacha20poly1305_ref.h"
+
+#if defined(ESP_PLATFORM)
+#include "esp_cpu.h"
+#define BENCH_UNIT "cycles/B"
+typedef uint32_t bench_ticks_t;
+static inline bench_ticks_t bench_now(void)
+{
+    return (bench_ticks_t) esp_cpu_get_cycle_count();
+}
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles/B"
+typedef uint64_t bench_ticks_t;
+static inline bench_ticks_t bench_now(void)
+{
+    return __rdtsc();
+}
+#else
+#include <time.h>
+#define BENCH_UNIT "ns/B"
+typedef uint64_t bench_ticks_t;
+static inline bench_ticks_t bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000U + (uint64_t) ts.tv_nsec;
+}
+#endif
+
+#define BENCH_BYTES_PER_RUN (64 * 1024)
+#define BENCH_RUNS          5
+
+static const size_t s_frame_sizes[] = { 64, 1024, 16384 };
+
+static const struct {
+    const char *name;
+    const chacha20poly1305_implementation *impl;
+} s_impls[] = {
+    { "ref", &chacha20poly1305_ref_implementation },
+    { "fused", &chacha20poly1305_fused_implementation },
+};
+
+/* best of BENCH_RUNS, in hundredths of a unit per byte */
+static unsigned bench_frame(const chacha20poly1305_implementation *impl, int decrypt,
+                            unsigned char *m, unsigned char *c, size_t len,
+                            const unsigned char *mac, const unsigned char *ad, size_t adlen,
+                            const unsigned char *npub, const unsigned char *k)
+{
+    const size_t iters = len < BENCH_BYTES_PER_RUN ? BENCH_BYTES_PER_RUN / len : 1;
+    unsigned char tag[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned best = ~0U;
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        bench_ticks_t start = bench_now();
+
+        for (size_t i = 0; i < iters; i++) {
+            if (decrypt) {
+                impl->ietf_decrypt_detached(m, c, len, mac, ad, adlen, npub, k);
+            } else {
+                impl->ietf_encrypt_detached(c, tag, m, len, ad, adlen, npub, k);
+            }
+        }
+        bench_ticks_t elapsed = bench_now() - start;
+        unsigned cpb = (unsigned) ((unsigned long long) elapsed * 100U / (iters * len));
+        if (cpb < best) {
+            best = cpb;
+        }
+    }
+    return best;
+}
+
+/* best of BENCH_RUNS, in hundredths of a unit per byte of response */
+static unsigned bench_response(int flatten, const crypto_aead_chacha20poly1305_ietf_segment *parts,
+                               size_t nparts, size_t len, unsigned char *tx,
+                               const unsigned char *npub, const unsigned char *k)
+{
+    const size_t iters = len < BENCH_BYTES_PER_RUN ? BENCH_BYTES_PER_RUN / len : 1;
+    crypto_aead_chacha20poly1305_ietf_segment segs[3];
+    unsigned char tag[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned best = ~0U;
+    size_t off = 0;
+
+    for (size_t p = 0; p < nparts; p++) {
+        segs[p].out = tx + off;
+        segs[p].in = parts[p].in;
+        segs[p].len = parts[p].len;
+        off += parts[p].len;
+    }
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        bench_ticks_t start = bench_now();
+
+        for (size_t i = 0; i < iters; i++) {
+            if (flatten) {
+                for (size_t p = 0; p < nparts; p++) {
+                    memcpy(segs[p].out, segs[p].in, segs[p].len);
+                }
+                crypto_aead_chacha20poly1305_ietf_encrypt_detached(tx, tag, NULL, tx, len,
+                                                                   NULL, 0, NULL, npub, k);
+            } else {
+                crypto_aead_chacha20poly1305_ietf_encryptv(segs, nparts, tag, NULL,
+                                                           NULL, 0, NULL, npub, k);
+            }
+        }
+        bench_ticks_t elapsed = bench_now() - start;
+        unsigned cpb = (unsigned) ((unsigned long long) elapsed * 100U / (iters * len));
+        if (cpb < best) {
+            best = cpb;
+        }
+    }
+    return best;
+}
+
+int aead_chacha20poly1305_bench(void)
+{
+    const size_t max_len = s_frame_sizes[sizeof s_frame_sizes / sizeof s_frame_sizes[0] - 1];
+    unsigned char k[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char npub[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char ad[2]; /* HAP frames authenticate their 2-byte length */
+    unsigned char mac[2][crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned char *m = malloc(max_len);
+    unsigned char *c = malloc(max_len);
+    unsigned char *c2 = malloc(max_len);
+    int ret = 0;
+
+    if (sodium_init() < 0 || m == NULL || c == NULL || c2 == NULL) {
+        ret = -1;
+        goto done;
+    }
+    randombytes_buf(k, sizeof k);
+    randombytes_buf(npub, sizeof npub);
+    randombytes_buf(m, max_len);
+
+    printf("%-6s %-6s %8s %8s\n", "frame", "impl", "enc", "dec");
+    for (size_t f = 0; f < sizeof s_frame_sizes / sizeof s_frame_sizes[0]; f++) {
+        const size_t len = s_frame_sizes[f];
+
+        ad[0] = (unsigned char) (len & 0xff);
+        ad[1] = (unsigned char) (len >> 8);
+
+        /* both kernels must agree before their speed means anything */
+        s_impls[0].impl->ietf_encrypt_detached(c, mac[0], m, len, ad, sizeof ad, npub, k);
+        s_impls[1].impl->ietf_encrypt_detached(c2, mac[1], m, len, ad, sizeof ad, npub, k);
+        if (memcmp(c, c2, len) != 0 || memcmp(mac[0], mac[1], sizeof mac[0]) != 0 ||
+                s_impls[1].impl->ietf_decrypt_detached(c2, c, len, mac[0], ad, sizeof ad, npub, k) != 0 ||
+                memcmp(c2, m, len) != 0) {
+            printf("%zu B: fused and ref implementations disagree\n", len);
+            ret = -1;
+            goto done;
+        }
+        for (size_t i = 0; i < sizeof s_impls / sizeof s_impls[0]; i++) {
+            unsigned enc = bench_frame(s_impls[i].impl, 0, m, c2, len, mac[0], ad, sizeof ad, npub, k);
+            unsigned dec = bench_frame(s_impls[i].impl, 1, c2, c, len, mac[0], ad, sizeof ad, npub, k);
+
+            printf("%-6zu %-6s %5u.%02u %5u.%02u %s\n", len, s_impls[i].name,
+                   enc / 100, enc % 100, dec / 100, dec % 100, BENCH_UNIT);
+        }
+    }
+
+    static const char header[] = "HTTP/1.1 200 OK\r\nContent-Type: application/hap+json\r\n"
+                                 "Transfer-Encoding: chunked\r\n\r\n";
+    static const char trailer[] = "\r\n0\r\n\r\n";
+
+    printf("%-6s %8s %8s\n", "body", "flatten", "encryptv");
+    for (size_t f = 0; f < sizeof s_frame_sizes / sizeof s_frame_sizes[0]; f++) {
+        if (s_frame_sizes[f] < sizeof header + sizeof trailer) {
+            continue;
+        }
+        const size_t body_len = s_frame_sizes[f] - (sizeof header - 1) - (sizeof trailer - 1);
+        const crypto_aead_chacha20poly1305_ietf_segment parts[3] = {
+            { NULL, (const unsigned char *) header, sizeof header - 1 },
+            { NULL, m, body_len },
+            { NULL, (const unsigned char *) trailer, sizeof trailer - 1 },
+        };
+        unsigned flat = bench_response(1, parts, 3, s_frame_sizes[f], c, npub, k);
+        unsigned vec = bench_response(0, parts, 3, s_frame_sizes[f], c2, npub, k);
+        if (memcmp(c, c2, s_frame_sizes[f]) != 0) {
+            printf("%zu B: encryptv and flattened encryption disagree\n", s_frame_sizes[f]);
+            ret = -1;
+            goto done;
+        }
+        printf("%-6zu %5u.%02u %5u.%02u %s\n", body_len,
+               flat / 100, flat % 100, vec / 100, vec % 100, BENCH_UNIT);
+    }
+
+done:
+    free(c2);
+    free(c);
+    free(m);
+    return ret;
+}
+
+#if !defined(ESP_PLATFORM)
+int main(void)
+{
+    return aead_chacha20poly1305_bench() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
@@ -0,0 +1,366 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/*
+ * Accessory CPU time per reconnect handshake, in microseconds: a full
+ * HomeKit pair-verify (X25519, HKDF-SHA512, Ed25519 sign and verify,
+ * ChaCha20-Poly1305) against a pair-resume from the session cache of
+ * crypto_box_curve25519hkdfchacha20poly1305 (HKDF-SHA512 and Poly1305 tags
+ * only). The controller side runs in between and is not timed.
+ *
+ * On Linux, ../host_bench/Makefile links session_bench for that.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sodium.h"
+
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+static inline uint64_t bench_now_us(void)
+{
+    return (uint64_t) esp_timer_get_time();
+}
+#else
+#include <time.h>
+static inline uint64_t bench_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000U + (uint64_t) ts.tv_nsec / 1000U;
+}
+#endif
+
+#define BENCH_HANDSHAKES 20
+#define BENCH_RUNS       3
+
+#define ID_LEN     36  /* pairing identifiers are UUID strings */
+#define TLV_LEN    (ID_LEN + crypto_sign_ed25519_BYTES + 4)
+#define INFO(s)    (s), (sizeof (s) - 1)
+#define SALT(s)    (const unsigned char *) (s), (sizeof (s) - 1)
+
+typedef crypto_box_curve25519hkdfchacha20poly1305_state session_state_t;
+
+static const unsigned char s_nonce_m2[12] = "\0\0\0\0PV-Msg02";
+static const unsigned char s_nonce_m3[12] = "\0\0\0\0PV-Msg03";
+static const unsigned char s_nonce_r1[12] = "\0\0\0\0PR-Msg01";
+static const unsigned char s_nonce_r2[12] = "\0\0\0\0PR-Msg02";
+
+typedef struct {
+    unsigned char id[ID_LEN];
+    unsigned char ltpk[crypto_sign_ed25519_PUBLICKEYBYTES];
+    unsigned char ltsk[crypto_sign_ed25519_SECRETKEYBYTES];
+} peer_t;
+
+typedef struct {
+    peer_t accessory;
+    peer_t controller;
+    crypto_box_curve25519hkdfchacha20poly1305_cache cache;
+
+    /* what goes over the air */
+    unsigned char acc_eph_pk[crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES];
+    unsigned char ctl_eph_pk[crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES];
+    unsigned char m2[TLV_LEN];
+    unsigned char m2_mac[crypto_box_curve25519hkdfchacha20poly1305_MACBYTES];
+    unsigned char m3[TLV_LEN];
+    unsigned char m3_mac[crypto_box_curve25519hkdfchacha20poly1305_MACBYTES];
+    unsigned char session_id[crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES];
+    unsigned char tag[crypto_box_curve25519hkdfchacha20poly1305_MACBYTES];
+
+    /* controller */
+    unsigned char ctl_eph_sk[crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES];
+    session_state_t ctl_state;
+
+    /* the session keys both sides end up with */
+    unsigned char acc_read_key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+    unsigned char ctl_write_key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+} session_bench_t;
+
+/* sign and encrypt (eph_pk || id || peer_eph_pk) as the M2/M3 sub-TLV */
+static int pv_seal(unsigned char *c, unsigned char *mac, const peer_t *self, const unsigned char *eph_pk,
+                   const unsigned char *peer_eph_pk, const unsigned char *nonce, const unsigned char *key)
+{
+    unsigned char info[2 * crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES + ID_LEN];
+    unsigned char tlv[TLV_LEN] = { 0 };
+
+    memcpy(info, eph_pk, 32);
+    memcpy(info + 32, self->id, ID_LEN);
+    memcpy(info + 32 + ID_LEN, peer_eph_pk, 32);
+    memcpy(tlv, self->id, ID_LEN);
+    if (crypto_sign_ed25519_detached(tlv + ID_LEN, NULL, info, sizeof info, self->ltsk) != 0) {
+        return -1;
+    }
+    return crypto_box_curve25519hkdfchacha20poly1305_detached_afternm(c, mac, tlv, sizeof tlv, NULL, 0, nonce, key);
+}
+
+static int pv_open(const unsigned char *c, const unsigned char *mac, const peer_t *peer, const unsigned char *peer_eph_pk,
+                   const unsigned char *eph_pk, const unsigned char *nonce, const unsigned char *key)
+{
+    unsigned char info[2 * crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES + ID_LEN];
+    unsigned char tlv[TLV_LEN];
+
+    if (crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(tlv, c, mac, sizeof tlv, NULL, 0, nonce, key) != 0 ||
+            memcmp(tlv, peer->id, ID_LEN) != 0) {
+        return -1;
+    }
+    memcpy(info, peer_eph_pk, 32);
+    memcpy(info + 32, peer->id, ID_LEN);
+    memcpy(info + 32 + ID_LEN, eph_pk, 32);
+    return crypto_sign_ed25519_verify_detached(tlv + ID_LEN, info, sizeof info, peer->ltpk);
+}
+
+static int control_keys(unsigned char *read_key, unsigned char *write_key, const session_state_t *state)
+{
+    if (crypto_box_curve25519hkdfchacha20poly1305_derive_key(read_key, state, SALT("Control-Salt"),
+            INFO("Control-Read-Encryption-Key")) != 0) {
+        return -1;
+    }
+    return crypto_box_curve25519hkdfchacha20poly1305_derive_key(write_key, state, SALT("Control-Salt"),
+            INFO("Control-Write-Encryption-Key"));
+}
+
+static int ctl_control_keys(session_bench_t *b)
+{
+    unsigned char read_key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+
+    /* the controller writes with the key the accessory reads with */
+    return crypto_box_curve25519hkdfchacha20poly1305_derive_key(b->ctl_write_key, &b->ctl_state, SALT("Control-Salt"),
+            INFO("Control-Read-Encryption-Key")) != 0 ||
+           crypto_box_curve25519hkdfchacha20poly1305_derive_key(read_key, &b->ctl_state, SALT("Control-Salt"),
+                   INFO("Control-Write-Encryption-Key")) != 0 ? -1 : 0;
+}
+
+/* M1 -> M2: ephemeral key, shared secret, signed and encrypted proof */
+static int acc_verify_m2(session_bench_t *b, session_state_t *state, unsigned char *acc_eph_sk)
+{
+    unsigned char key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+
+    if (crypto_box_curve25519hkdfchacha20poly1305_keypair(b->acc_eph_pk, acc_eph_sk) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_beforenm(state, b->ctl_eph_pk, acc_eph_sk) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_derive_key(key, state, SALT("Pair-Verify-Encrypt-Salt"),
+                    INFO("Pair-Verify-Encrypt-Info")) != 0) {
+        return -1;
+    }
+    return pv_seal(b->m2, b->m2_mac, &b->accessory, b->acc_eph_pk, b->ctl_eph_pk, s_nonce_m2, key);
+}
+
+static int ctl_verify_m3(session_bench_t *b)
+{
+    unsigned char key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+
+    if (crypto_box_curve25519hkdfchacha20poly1305_beforenm(&b->ctl_state, b->acc_eph_pk, b->ctl_eph_sk) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_derive_key(key, &b->ctl_state, SALT("Pair-Verify-Encrypt-Salt"),
+                    INFO("Pair-Verify-Encrypt-Info")) != 0 ||
+            pv_open(b->m2, b->m2_mac, &b->accessory, b->acc_eph_pk, b->ctl_eph_pk, s_nonce_m2, key) != 0) {
+        return -1;
+    }
+    return pv_seal(b->m3, b->m3_mac, &b->controller, b->ctl_eph_pk, b->acc_eph_pk, s_nonce_m3, key);
+}
+
+/* M3 -> M4: check the controller's proof, derive the session keys, keep the session */
+static int acc_verify_m4(session_bench_t *b, const session_state_t *state)
+{
+    unsigned char key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+    unsigned char write_key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+
+    if (crypto_box_curve25519hkdfchacha20poly1305_derive_key(key, state, SALT("Pair-Verify-Encrypt-Salt"),
+            INFO("Pair-Verify-Encrypt-Info")) != 0 ||
+            pv_open(b->m3, b->m3_mac, &b->controller, b->ctl_eph_pk, b->acc_eph_pk, s_nonce_m3, key) != 0 ||
+            control_keys(b->acc_read_key, write_key, state) != 0) {
+        return -1;
+    }
+    randombytes_buf(b->session_id, sizeof b->session_id);
+    crypto_box_curve25519hkdfchacha20poly1305_cache_store(&b->cache, b->session_id, state, b->controller.ltpk);
+    return 0;
+}
+
+/* salt = controller ephemeral public key || session identifier */
+static void resume_salt(unsigned char *salt, const session_bench_t *b)
+{
+    memcpy(salt, b->ctl_eph_pk, sizeof b->ctl_eph_pk);
+    memcpy(salt + sizeof b->ctl_eph_pk, b->session_id, sizeof b->session_id);
+}
+
+#define RESUME_SALT_LEN (crypto_box_curve25519hkdfchacha20poly1305_PUBLICKEYBYTES + \
+                         crypto_box_curve25519hkdfchacha20poly1305_SESSIONIDBYTES)
+
+static int ctl_resume_r1(session_bench_t *b)
+{
+    unsigned char salt[RESUME_SALT_LEN];
+    unsigned char key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+
+    if (crypto_box_curve25519hkdfchacha20poly1305_keypair(b->ctl_eph_pk, b->ctl_eph_sk) != 0) {
+        return -1;
+    }
+    resume_salt(salt, b);
+    if (crypto_box_curve25519hkdfchacha20poly1305_derive_key(key, &b->ctl_state, salt, sizeof salt,
+            INFO("Pair-Resume-Request-Info")) != 0) {
+        return -1;
+    }
+    return crypto_box_curve25519hkdfchacha20poly1305_detached_afternm(b->tag, b->tag, NULL, 0, NULL, 0, s_nonce_r1, key);
+}
+
+/* R1 -> R2: no scalar multiplication, no signature */
+static int acc_resume_r2(session_bench_t *b)
+{
+    session_state_t state;
+    unsigned char peer[crypto_box_curve25519hkdfchacha20poly1305_PEERBYTES];
+    unsigned char salt[RESUME_SALT_LEN];
+    unsigned char key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+    unsigned char write_key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+
+    if (crypto_box_curve25519hkdfchacha20poly1305_cache_take(&state, peer, &b->cache, b->session_id) != 0) {
+        return -1;
+    }
+    resume_salt(salt, b);
+    if (crypto_box_curve25519hkdfchacha20poly1305_derive_key(key, &state, salt, sizeof salt,
+            INFO("Pair-Resume-Request-Info")) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(NULL, b->tag, b->tag, 0, NULL, 0,
+                    s_nonce_r1, key) != 0) {
+        return -1;
+    }
+    randombytes_buf(b->session_id, sizeof b->session_id);
+    resume_salt(salt, b);
+    if (crypto_box_curve25519hkdfchacha20poly1305_derive_key(key, &state, salt, sizeof salt,
+            INFO("Pair-Resume-Response-Info")) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_detached_afternm(b->tag, b->tag, NULL, 0, NULL, 0,
+                    s_nonce_r2, key) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_resume(&state, &state, salt, sizeof salt,
+                    INFO("Pair-Resume-Shared-Secret-Info")) != 0 ||
+            control_keys(b->acc_read_key, write_key, &state) != 0) {
+        return -1;
+    }
+    crypto_box_curve25519hkdfchacha20poly1305_cache_store(&b->cache, b->session_id, &state, peer);
+    return 0;
+}
+
+static int ctl_resume_done(session_bench_t *b)
+{
+    unsigned char salt[RESUME_SALT_LEN];
+    unsigned char key[crypto_box_curve25519hkdfchacha20poly1305_KEYBYTES];
+
+    resume_salt(salt, b);
+    if (crypto_box_curve25519hkdfchacha20poly1305_derive_key(key, &b->ctl_state, salt, sizeof salt,
+            INFO("Pair-Resume-Response-Info")) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_open_detached_afternm(NULL, b->tag, b->tag, 0, NULL, 0,
+                    s_nonce_r2, key) != 0 ||
+            crypto_box_curve25519hkdfchacha20poly1305_resume(&b->ctl_state, &b->ctl_state, salt, sizeof salt,
+                    INFO("Pair-Resume-Shared-Secret-Info")) != 0) {
+        return -1;
+    }
+    return ctl_control_keys(b);
+}
+
+/* accessory microseconds of one handshake, or 0 on failure */
+static uint64_t handshake(session_bench_t *b, int resume)
+{
+    session_state_t state;
+    unsigned char acc_eph_sk[crypto_box_curve25519hkdfchacha20poly1305_SECRETKEYBYTES];
+    uint64_t start, elapsed;
+
+    if (resume) {
+        if (ctl_resume_r1(b) != 0) {
+            return 0;
+        }
+        start = bench_now_us();
+        if (acc_resume_r2(b) != 0) {
+            return 0;
+        }
+        elapsed = bench_now_us() - start;
+        if (ctl_resume_done(b) != 0) {
+            return 0;
+        }
+    } else {
+        if (crypto_box_curve25519hkdfchacha20poly1305_keypair(b->ctl_eph_pk, b->ctl_eph_sk) != 0) {
+            return 0;
+        }
+        start = bench_now_us();
+        if (acc_verify_m2(b, &state, acc_eph_sk) != 0) {
+            return 0;
+        }
+        elapsed = bench_now_us() - start;
+        if (ctl_verify_m3(b) != 0) {
+            return 0;
+        }
+        start = bench_now_us();
+        if (acc_verify_m4(b, &state) != 0) {
+            return 0;
+        }
+        elapsed += bench_now_us() - start;
+        if (ctl_control_keys(b) != 0) {
+            return 0;
+        }
+    }
+    /* both sides must agree on the session keys */
+    if (sodium_memcmp(b->acc_read_key, b->ctl_write_key, sizeof b->acc_read_key) != 0) {
+        return 0;
+    }
+    return elapsed > 0 ? elapsed : 1;
+}
+
+/* best of BENCH_RUNS, in hundredths of a microsecond per handshake */
+static unsigned long bench_handshake(session_bench_t *b, int resume)
+{
+    unsigned long best = 0;
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        uint64_t total = 0;
+
+        for (int i = 0; i < BENCH_HANDSHAKES; i++) {
+            uint64_t us = handshake(b, resume);
+
+            if (us == 0) {
+                return 0;
+            }
+            total += us;
+        }
+        unsigned long per = (unsigned long) (total * 100U / BENCH_HANDSHAKES);
+        if (best == 0 || per < best) {
+            best = per;
+        }
+    }
+    return best;
+}
+
+int session_bench(void)
+{
+    session_bench_t *b = calloc(1, sizeof *b);
+    unsigned long full, resume;
+    int ret = -1;
+
+    if (sodium_init() < 0 || b == NULL) {
+        free(b);
+        return -1;
+    }
+    memcpy(b->accessory.id, "A1:B2:C3:D4:E5:F6", sizeof "A1:B2:C3:D4:E5:F6" - 1);
+    memcpy(b->controller.id, "8C3E1C6A-4F0B-4D2E-9E57-2B1A5C7D9E01", ID_LEN);
+    crypto_sign_ed25519_keypair(b->accessory.ltpk, b->accessory.ltsk);
+    crypto_sign_ed25519_keypair(b->controller.ltpk, b->controller.ltsk);
+    crypto_box_curve25519hkdfchacha20poly1305_cache_init(&b->cache);
+
+    /* a first pair-verify fills the cache; resuming needs it */
+    if ((full = bench_handshake(b, 0)) == 0 || (resume = bench_handshake(b, 1)) == 0) {
+        printf("handshake failed\n");
+        goto done;
+    }
+    printf("%-12s %10s\n", "handshake", "us");
+    printf("%-12s %7lu.%02lu\n", "pair-verify", full / 100, full % 100);
+    printf("%-12s %7lu.%02lu\n", "pair-resume", resume / 100, resume % 100);
+    ret = 0;
+
+done:
+    sodium_memzero(b, sizeof *b);
+    free(b);
+    return ret;
+}
+
+#if !defined(ESP_PLATFORM)
+int main(void)
+{
+    return session_bench() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
@@ -0,0 +1,247 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/*
+ * Operations/s of the fixed-base scalar multiplications behind pairing:
+ * Ed25519 keypair and signature, X25519 public key. Verification does not
+ * use the base-point table and is listed for reference.
+ *
+ * Then signatures/s of crypto_sign_ed25519_verify_batch() for batches of
+ * 1, 4, 16 and 64, against crypto_sign_ed25519_verify_detached() in a loop.
+ *
+ * The table used by ge25519_scalarmult_base() is chosen at build time
+ * (CONFIG_LIBSODIUM_ED25519_COMB_TABLE), so compare two builds. On Linux,
+ * ../host_bench/Makefile links sign_bench and sign_bench_comb for that.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "sodium.h"
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#include "esp_timer.h"
+static inline uint64_t bench_now_us(void)
+{
+    return (uint64_t) esp_timer_get_time();
+}
+#else
+#include <time.h>
+static inline uint64_t bench_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000U + (uint64_t) ts.tv_nsec / 1000U;
+}
+#endif
+
+#if defined(CONFIG_LIBSODIUM_ED25519_COMB_TABLE) || defined(ED25519_COMB_TABLE)
+#define BENCH_TABLE "comb"
+#else
+#define BENCH_TABLE "base"
+#endif
+
+#define BENCH_MIN_US 500000U
+#define BENCH_RUNS   3
+
+enum { OP_KEYPAIR, OP_SIGN, OP_X25519, OP_VERIFY };
+
+static const char *const s_op_names[] = { "ed25519 keypair", "ed25519 sign", "x25519 base", "ed25519 verify" };
+
+static struct {
+    unsigned char seed[crypto_sign_ed25519_SEEDBYTES];
+    unsigned char pk[crypto_sign_ed25519_PUBLICKEYBYTES];
+    unsigned char sk[crypto_sign_ed25519_SECRETKEYBYTES];
+    unsigned char sig[crypto_sign_ed25519_BYTES];
+    unsigned char m[100]; /* about the size of a pair-verify sub-TLV */
+    unsigned char x25519_sk[crypto_scalarmult_curve25519_SCALARBYTES];
+    unsigned char x25519_pk[crypto_scalarmult_curve25519_BYTES];
+} s_bench;
+
+static int bench_op(int op)
+{
+    switch (op) {
+    case OP_KEYPAIR:
+        return crypto_sign_ed25519_seed_keypair(s_bench.pk, s_bench.sk, s_bench.seed);
+    case OP_SIGN:
+        return crypto_sign_ed25519_detached(s_bench.sig, NULL, s_bench.m, sizeof s_bench.m, s_bench.sk);
+    case OP_X25519:
+        return crypto_scalarmult_curve25519_base(s_bench.x25519_pk, s_bench.x25519_sk);
+    default:
+        return crypto_sign_ed25519_verify_detached(s_bench.sig, s_bench.m, sizeof s_bench.m, s_bench.pk);
+    }
+}
+
+/* best of BENCH_RUNS, in hundredths of an operation per second */
+static unsigned long bench_ops(int op)
+{
+    unsigned long best = 0;
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        const uint64_t start = bench_now_us();
+        uint64_t elapsed;
+        unsigned long n = 0;
+
+        do {
+            if (bench_op(op) != 0) {
+                return 0;
+            }
+            n++;
+            elapsed = bench_now_us() - start;
+        } while (elapsed < BENCH_MIN_US);
+
+        unsigned long ops = (unsigned long) ((unsigned long long) n * 100000000U / elapsed);
+        if (ops > best) {
+            best = ops;
+        }
+    }
+    return best;
+}
+
+int sign_bench(void)
+{
+    unsigned char x25519_pk[crypto_scalarmult_curve25519_BYTES];
+
+    if (sodium_init() < 0) {
+        return -1;
+    }
+    randombytes_buf(s_bench.seed, sizeof s_bench.seed);
+    randombytes_buf(s_bench.m, sizeof s_bench.m);
+    randombytes_buf(s_bench.x25519_sk, sizeof s_bench.x25519_sk);
+
+    /* verification and the X25519 ladder do not use the table: they check its points */
+    if (crypto_sign_ed25519_seed_keypair(s_bench.pk, s_bench.sk, s_bench.seed) != 0 ||
+            crypto_sign_ed25519_detached(s_bench.sig, NULL, s_bench.m, sizeof s_bench.m, s_bench.sk) != 0 ||
+            crypto_sign_ed25519_verify_detached(s_bench.sig, s_bench.m, sizeof s_bench.m, s_bench.pk) != 0 ||
+            crypto_scalarmult_curve25519_base(s_bench.x25519_pk, s_bench.x25519_sk) != 0 ||
+            crypto_scalarmult_curve25519(x25519_pk, s_bench.x25519_sk, (const unsigned char[32]) { 9 }) != 0 ||
+            sodium_memcmp(x25519_pk, s_bench.x25519_pk, sizeof x25519_pk) != 0) {
+        printf("%s table: fixed-base results are wrong\n", BENCH_TABLE);
+        return -1;
+    }
+
+    printf("%-16s %10s (%s table)\n", "op", "ops/s", BENCH_TABLE);
+    for (int op = OP_KEYPAIR; op <= OP_VERIFY; op++) {
+        unsigned long ops = bench_ops(op);
+
+        if (ops == 0) {
+            return -1;
+        }
+        printf("%-16s %7lu.%02lu\n", s_op_names[op], ops / 100, ops % 100);
+    }
+    return 0;
+}
+
+#define BATCH_MAX 64
+
+static const size_t s_batch_sizes[] = { 1, 4, 16, BATCH_MAX };
+
+typedef struct {
+    unsigned char pk[BATCH_MAX][crypto_sign_ed25519_PUBLICKEYBYTES];
+    unsigned char sig[BATCH_MAX][crypto_sign_ed25519_BYTES];
+    unsigned char m[BATCH_MAX][100];
+    const unsigned char *pks[BATCH_MAX];
+    const unsigned char *sigs[BATCH_MAX];
+    const unsigned char *ms[BATCH_MAX];
+    unsigned long long mlens[BATCH_MAX];
+    int valid[BATCH_MAX];
+} batch_bench_t;
+
+/* best of BENCH_RUNS, in hundredths of a signature per second */
+static unsigned long bench_verify(batch_bench_t *b, size_t n, int batch)
+{
+    unsigned long best = 0;
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        const uint64_t start = bench_now_us();
+        uint64_t elapsed;
+        unsigned long sigs = 0;
+
+        do {
+            if (batch) {
+                if (crypto_sign_ed25519_verify_batch(b->valid, b->sigs, b->ms, b->mlens, b->pks, n) != 0) {
+                    return 0;
+                }
+            } else {
+                for (size_t i = 0; i < n; i++) {
+                    if (crypto_sign_ed25519_verify_detached(b->sigs[i], b->ms[i], b->mlens[i], b->pks[i]) != 0) {
+                        return 0;
+                    }
+                }
+            }
+            sigs += n;
+            elapsed = bench_now_us() - start;
+        } while (elapsed < BENCH_MIN_US);
+
+        unsigned long rate = (unsigned long) ((unsigned long long) sigs * 100000000U / elapsed);
+        if (rate > best) {
+            best = rate;
+        }
+    }
+    return best;
+}
+
+int sign_verify_batch_bench(void)
+{
+    batch_bench_t *b = calloc(1, sizeof *b);
+    unsigned char sk[crypto_sign_ed25519_SECRETKEYBYTES];
+    int ret = 0;
+
+    if (sodium_init() < 0 || b == NULL) {
+        free(b);
+        return -1;
+    }
+    for (size_t i = 0; i < BATCH_MAX; i++) {
+        randombytes_buf(b->m[i], sizeof b->m[i]);
+        crypto_sign_ed25519_keypair(b->pk[i], sk);
+        crypto_sign_ed25519_detached(b->sig[i], NULL, b->m[i], sizeof b->m[i], sk);
+        b->pks[i] = b->pk[i];
+        b->sigs[i] = b->sig[i];
+        b->ms[i] = b->m[i];
+        b->mlens[i] = sizeof b->m[i];
+    }
+    sodium_memzero(sk, sizeof sk);
+
+    /* a bad signature must be found, and found alone */
+    b->m[BATCH_MAX / 2][0] ^= 1;
+    if (crypto_sign_ed25519_verify_batch(b->valid, b->sigs, b->ms, b->mlens, b->pks, BATCH_MAX) != -1) {
+        ret = -1;
+    }
+    for (size_t i = 0; i < BATCH_MAX; i++) {
+        if (b->valid[i] != (i != BATCH_MAX / 2)) {
+            ret = -1;
+        }
+    }
+    b->m[BATCH_MAX / 2][0] ^= 1;
+    if (ret != 0) {
+        printf("batch verification does not tell the bad signature apart\n");
+        goto done;
+    }
+
+    printf("%-6s %10s %10s sigs/s\n", "batch", "loop", "batch");
+    for (size_t s = 0; s < sizeof s_batch_sizes / sizeof s_batch_sizes[0]; s++) {
+        const size_t n = s_batch_sizes[s];
+        unsigned long loop = bench_verify(b, n, 0);
+        unsigned long batch = bench_verify(b, n, 1);
+
+        if (loop == 0 || batch == 0) {
+            ret = -1;
+            goto done;
+        }
+        printf("%-6zu %7lu.%02lu %7lu.%02lu\n", n, loop / 100, loop % 100, batch / 100, batch % 100);
+    }
+
+done:
+    free(b);
+    return ret;
+}
+
+#if !defined(ESP_PLATFORM)
+int main(void)
+{
+    return sign_bench() == 0 && sign_verify_batch_bench() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
@@ -32,12 +32,44 @@
 LIBSODIUM_TEST(aead_aegis128l)
 LIBSODIUM_TEST(aead_aegis256)
 LIBSODIUM_TEST(aead_chacha20poly1305)
+LIBSODIUM_TEST(aead_chacha20poly13053)
 LIBSODIUM_TEST(chacha20)
 LIBSODIUM_TEST(box)
 LIBSODIUM_TEST(box2)
+LIBSODIUM_TEST(box_hkdf)
 LIBSODIUM_TEST(ed25519_convert)
 LIBSODIUM_TEST(hash)
 LIBSODIUM_TEST(sign)
+LIBSODIUM_TEST(sign2)
+
+// Benchmarks, in a group of their own: run them from the menu with [bench], CI runs the [libsodium] group only
+extern int aead_chacha20poly1305_bench(void);
+
+TEST_CASE("chacha20poly1305 ietf cycles/byte", "[bench]")
+{
+    TEST_ASSERT_EQUAL(0, aead_chacha20poly1305_bench());
+}
+
+extern int sign_bench(void);
+
+TEST_CASE("ed25519 sign and keypair ops/s", "[bench]")
+{
+    TEST_ASSERT_EQUAL(0, sign_bench());
+}
+
+extern int sign_verify_batch_bench(void);
+
+TEST_CASE("ed25519 batch verification sigs/s", "[bench]")
+{
+    TEST_ASSERT_EQUAL(0, sign_verify_batch_bench());
+}
+
+extern int session_bench(void);
+
+TEST_CASE("pair-verify and pair-resume handshake us", "[bench]")
+{
+    TEST_ASSERT_EQUAL(0, session_bench());
+}
 
 
 TEST_CASE("sha256 sanity check", "[libsodium]")
@@ -10,6 +10,7 @@
 extern "C" {
 #endif
 
+#include "sdkconfig.h"
 #include <esp_netif.h>
 
 #define MDNS_TYPE_A                 0x0001
@@ -109,9 +110,92 @@ typedef struct mdns_result_s {
     mdns_ip_addr_t *addr;                   /*!< linked list of IP addresses found */
 } mdns_result_t;
 
+/**
+ * @brief   Counters of answers the responder did not send
+ */
+typedef struct {
+    uint32_t known_answer;                  /*!< listed by the querier as a known answer with at least half of its TTL */
+    uint32_t duplicate;                     /*!< already scheduled on the interface in response to the same question */
+    uint32_t rate_limited;                  /*!< multicast on the interface less than a second ago */
+} mdns_suppression_stats_t;
+
+/**
+ * @brief   Counters of the record cache
+ */
+typedef struct {
+    uint32_t entries;                       /*!< records currently cached */
+    uint32_t hits;                          /*!< queries answered from the cache */
+    uint32_t misses;                        /*!< queries sent to the network */
+    uint32_t expired;                       /*!< records removed after their TTL expired */
+    uint32_t evicted;                       /*!< records removed to make room for new ones */
+    uint32_t refresh_queries;               /*!< queries sent to refresh records before they expire */
+} mdns_cache_stats_t;
+
+#define MDNS_STATS_LATENCY_BUCKETS  10      /*!< latency histogram buckets: < 8 us, < 16 us, ... < 2048 us, >= 2048 us */
+
+/**
+ * @brief   Packet counters of an interface and IP protocol
+ */
+typedef struct {
+    uint32_t rx_packets;                    /*!< packets received and parsed */
+    uint32_t rx_bytes;                      /*!< bytes of the received packets (mDNS payload) */
+    uint32_t rx_dropped;                    /*!< packets dropped before parsing, because the action could not be queued */
+    uint32_t rx_shed;                       /*!< queries dropped before parsing, because the mDNS task was behind (see CONFIG_MDNS_RX_QUEUE_LEN) */
+    uint32_t tx_packets;                    /*!< packets passed to the network */
+    uint32_t tx_bytes;                      /*!< bytes of the sent packets (mDNS payload) */
+    uint32_t tx_failed;                     /*!< packets the network refused, because the interface was down or out of memory */
+} mdns_netif_stats_t;
+
+/**
+ * @brief   Counters of the mDNS engine
+ */
+typedef struct {
+    mdns_netif_stats_t netif[CONFIG_MDNS_MAX_INTERFACES][MDNS_IP_PROTOCOL_MAX]; /*!< indexed like the interfaces of mDNS:
+                                                                                     predefined first, then the registered ones */
+    uint32_t action_queue_max;              /*!< high-water mark of the actions waiting for the mDNS task */
+    uint32_t tx_queue_max;                  /*!< high-water mark of the packets scheduled for sending */
+    uint32_t alloc_failed;                  /*!< failed memory allocations */
+    uint32_t probe_conflicts;               /*!< names lost while probing (a new name was chosen) */
+    uint32_t reprobes;                      /*!< conflicts with already announced records (probing was restarted) */
+    uint32_t parse_us[MDNS_STATS_LATENCY_BUCKETS];  /*!< histogram of the time spent parsing (and answering) a received packet */
+    uint32_t answer_us[MDNS_STATS_LATENCY_BUCKETS]; /*!< histogram of the time spent assembling and sending a scheduled packet */
+} mdns_stats_t;
+
 typedef void (*mdns_query_notify_t)(mdns_search_once_t *search);
 typedef void (*mdns_browse_notify_t)(mdns_result_t *result);
 
+/**
+ * @brief   Kind of a browse event
+ */
+typedef enum {
+    MDNS_BROWSE_ADDED,                      /*!< the result was found */
+    MDNS_BROWSE_UPDATED,                    /*!< some of its fields changed */
+    MDNS_BROWSE_REMOVED,                    /*!< the result expired or its host said goodbye, it is freed after the event */
+} mdns_browse_event_t;
+
+/**
+ * @brief   Fields of a browse result changed since the previous event
+ */
+typedef enum {
+    MDNS_BROWSE_CHANGED_SRV  = 1 << 0,      /*!< hostname or port */
+    MDNS_BROWSE_CHANGED_TXT  = 1 << 1,      /*!< TXT items */
+    MDNS_BROWSE_CHANGED_ADDR = 1 << 2,      /*!< an address was added */
+    MDNS_BROWSE_CHANGED_TTL  = 1 << 3,      /*!< TTL */
+} mdns_browse_changed_t;
+
+/**
+ * @brief   Callback of a delta browse
+ *
+ * Called from the mDNS task for each result which changed. The result stays at the same address from the added
+ * to the removed event, so its address can be used as a handle, but it must not be modified or freed.
+ *
+ * @param event    Added, updated or removed
+ * @param result   The result (its `next` field is not meaningful)
+ * @param changed  Bit mask of mdns_browse_changed_t, the fields known at the added event
+ * @param arg      User argument given to mdns_browse_delta_new()
+ */
+typedef void (*mdns_browse_delta_notify_t)(mdns_browse_event_t event, const mdns_result_t *result, uint32_t changed, void *arg);
+
 /**
  * @brief  Initialize mDNS on given interface
  *
@@ -909,6 +993,21 @@ esp_err_t mdns_netif_action(esp_netif_t *esp_netif, mdns_event_actions_t event_a
  */
 mdns_browse_t *mdns_browse_new(const char *service, const char *proto, mdns_browse_notify_t notifier);
 
+/**
+ * @brief   Browse mDNS for a service `_service._proto`, notifying only the changes of the results.
+ *
+ * Unlike mdns_browse_new(), the callback is called once per change of a result, with the changed fields,
+ * and not for records which are only refreshed. The browse is stopped with mdns_browse_delete().
+ *
+ * @param service  Pointer to the `_service` which will be browsed.
+ * @param proto    Pointer to the `_proto` which will be browsed.
+ * @param notifier The callback which will be called when a result is added, updated or removed.
+ * @param arg      User argument passed to the callback.
+ * @return mdns_browse_t pointer to new browse object if initiated successfully.
+ *         NULL otherwise.
+ */
+mdns_browse_t *mdns_browse_delta_new(const char *service, const char *proto, mdns_browse_delta_notify_t notifier, void *arg);
+
 /**
  * @brief   Stop the `_service._proto` browse.
  * @param service  Pointer to the `_service` which will be browsed.
@@ -920,6 +1019,50 @@ mdns_browse_t *mdns_browse_new(const char *service, const char *proto, mdns_brow
  */
 esp_err_t mdns_browse_delete(const char *service, const char *proto);
 
+/**
+ * @brief   Get the number of answers suppressed since mDNS was initialized
+ *
+ * Answers are not sent if the querier already knows them (RFC 6762 section 7.1), if they are already
+ * scheduled in response to the same question from another querier (section 7.3) or if they were
+ * multicast on the interface within the last second (section 6). Responses to probes are never suppressed.
+ *
+ * @param stats    Pointer to the counters to fill in
+ * @return
+ *     - ESP_OK                 success
+ *     - ESP_ERR_INVALID_ARG    stats is NULL
+ *     - ESP_ERR_INVALID_STATE  mDNS is not running
+ */
+esp_err_t mdns_suppression_stats_get(mdns_suppression_stats_t *stats);
+
+/**
+ * @brief   Get the counters of the record cache
+ *
+ * Records of all received responses are cached until their TTL expires (RFC 6762 section 5.2, 10),
+ * blocking `mdns_query*()` calls answered from the cache return immediately, without waiting for the timeout.
+ * The hit rate is `hits / (hits + misses)`.
+ *
+ * @param stats    Pointer to the counters to fill in
+ * @return
+ *     - ESP_OK                 success
+ *     - ESP_ERR_INVALID_ARG    stats is NULL
+ *     - ESP_ERR_INVALID_STATE  mDNS is not running
+ */
+esp_err_t mdns_cache_stats_get(mdns_cache_stats_t *stats);
+
+/**
+ * @brief   Get the counters of the mDNS engine since mDNS was initialized
+ *
+ * Bucket `i` of the latency histograms counts the durations below `8 << i` microseconds
+ * (the last one counts all the longer ones).
+ *
+ * @param stats    Pointer to the counters to fill in
+ * @return
+ *     - ESP_OK                 success
+ *     - ESP_ERR_INVALID_ARG    stats is NULL
+ *     - ESP_ERR_INVALID_STATE  mDNS is not running
+ */
+esp_err_t mdns_stats_get(mdns_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,7 +5,9 @@
  */
 
 #include <string.h>
+#include <ctype.h>
 #include <sys/param.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -21,11 +23,10 @@
 
 static void _mdns_browse_item_free(mdns_browse_t *browse);
 static esp_err_t _mdns_send_browse_action(mdns_action_type_t type, mdns_browse_t *browse);
-static esp_err_t _mdns_sync_browse_action(mdns_action_type_t type, mdns_browse_sync_t *browse_sync);
-static void _mdns_browse_sync(mdns_browse_sync_t *browse_sync);
+static esp_err_t _mdns_sync_browse_action(mdns_action_type_t type, mdns_browse_t *browse);
+static void _mdns_browse_sync(mdns_browse_t *browse);
 static void _mdns_browse_finish(mdns_browse_t *browse);
 static void _mdns_browse_add(mdns_browse_t *browse);
-static void _mdns_browse_send(mdns_browse_t *browse, mdns_if_t interface);
 
 #if CONFIG_ETH_ENABLED && CONFIG_MDNS_PREDEF_NETIF_ETH
 #include "esp_eth.h"
@@ -58,26 +59,46 @@ static const char *MDNS_SUB_STR = "_sub";
 
 mdns_server_t *_mdns_server = NULL;
 static mdns_host_item_t *_mdns_host_list = NULL;
+static mdns_host_item_t *_mdns_host_table[MDNS_LOOKUP_HASH_BUCKETS];
 static mdns_host_item_t _mdns_self_host;
+static mdns_str_t *_mdns_strings = NULL;
+static uint32_t _mdns_names_generation = 1;     // changes with the hostname and the default instance, see mdns_service_wire_t
 
 static const char *TAG = "mdns";
 
 static volatile TaskHandle_t _mdns_service_task_handle = NULL;
 static SemaphoreHandle_t _mdns_service_semaphore = NULL;
-
+static mdns_action_t _mdns_timer_action = { .type = ACTION_TIMER };
+static mdns_action_t _mdns_action_pool[MDNS_ACTION_POOL_SIZE];
+static _Atomic uint32_t _mdns_action_pool_used[(MDNS_ACTION_POOL_SIZE + 31) / 32];
+static _Atomic uint32_t _mdns_action_pool_in_use;
+static _Atomic uint32_t _mdns_action_pool_in_use_max;
+static _Atomic uint32_t _mdns_action_pool_allocated;
+static _Atomic uint32_t _mdns_action_pool_exhausted;
+static _Atomic uint32_t _mdns_stats_alloc_failures;
+static _Atomic uint32_t _mdns_stats_rx_dropped[MDNS_MAX_INTERFACES][MDNS_IP_PROTOCOL_MAX];
+static _Atomic uint32_t _mdns_rx_batched;      // packets of the batches in the RX lane besides the first of each
+static volatile bool _mdns_timer_action_queued = false;
+static int16_t _mdns_probe_all_jitter = -1;     // random delay shared by the probes of all PCBs, -1 if each picks its own
+
+static void _mdns_timer_arm(void);
+static void _mdns_timer_run(void);
+static void _mdns_cache_add_record(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, mdns_name_t *name, uint16_t type,
+                                   bool flush, uint32_t ttl, const uint8_t *packet, size_t packet_len,
+                                   const uint8_t *rdata, uint16_t rdata_len, mdns_parse_arena_t *arena);
+static void _mdns_cache_remove_pcb(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol);
 static void _mdns_search_finish_done(void);
 static mdns_search_once_t *_mdns_search_find_from(mdns_search_once_t *search, mdns_name_t *name, uint16_t type, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol);
 static mdns_browse_t *_mdns_browse_find_from(mdns_browse_t *b, mdns_name_t *name, uint16_t type, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol);
 static void _mdns_browse_result_add_srv(mdns_browse_t *browse, const char *hostname, const char *instance, const char *service, const char *proto,
-                                        uint16_t port, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl, mdns_browse_sync_t *out_sync_browse);
+                                        uint16_t port, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl);
 static void _mdns_browse_result_add_ip(mdns_browse_t *browse, const char *hostname, esp_ip_addr_t *ip,
-                                       mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl, mdns_browse_sync_t *out_sync_browse);
+                                       mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl);
 static void _mdns_browse_result_add_txt(mdns_browse_t *browse,  const char *instance, const char *service, const char *proto,
-                                        mdns_txt_item_t *txt, uint8_t *txt_value_len, size_t txt_count, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol,
-                                        uint32_t ttl, mdns_browse_sync_t *out_sync_browse);
+                                        const uint8_t *data, size_t len, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol,
+                                        uint32_t ttl);
 #ifdef MDNS_ENABLE_DEBUG
 static void debug_printf_browse_result(mdns_result_t *r_t, mdns_browse_t *b_t);
-static void debug_printf_browse_result_all(mdns_result_t *r_t);
 #endif // MDNS_ENABLE_DEBUG
 static void _mdns_search_result_add_ip(mdns_search_once_t *search, const char *hostname, esp_ip_addr_t *ip,
                                        mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl);
@@ -89,6 +110,8 @@ static void _mdns_search_result_add_txt(mdns_search_once_t *search, mdns_txt_ite
 static mdns_result_t *_mdns_search_result_add_ptr(mdns_search_once_t *search, const char *instance,
         const char *service_type, const char *proto, mdns_if_t tcpip_if,
         mdns_ip_protocol_t ip_protocol, uint32_t ttl);
+static mdns_result_t *_mdns_search_result_get_instance(mdns_search_once_t *search, const mdns_name_t *instance,
+        mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl);
 static bool _mdns_append_host_list_in_services(mdns_out_answer_t **destination, mdns_srv_item_t *services[], size_t services_len, bool flush, bool bye);
 static bool _mdns_append_host_list(mdns_out_answer_t **destination, bool flush, bool bye);
 static void _mdns_remap_self_service_hostname(const char *old_hostname, const char *new_hostname);
@@ -226,6 +249,100 @@ static inline bool _str_null_or_empty(const char *str)
     return (str == NULL || *str == 0);
 }
 
+/**
+ * @brief  lowers the ASCII capital letters in a word of a name, leaving the other bytes as they are
+ *
+ * The letters are found on the low seven bits of each byte, so that no carry crosses into the next byte,
+ * bytes with the top bit set (UTF-8 sequences) are no letters, as for strcasecmp().
+ */
+static inline size_t _mdns_word_lower(size_t word)
+{
+    const size_t ones = (size_t) -1 / 0xFF;
+    size_t low = word & (ones * 0x7F);
+    size_t upper = (low + ones * (0x80 - 'A')) & ~(low + ones * (0x80 - 'Z' - 1)) & ~word & (ones * 0x80);
+    return word | (upper >> 2);
+}
+
+/**
+ * @brief  compares two names of the given length, ignoring the case of ASCII letters, a word at a time
+ */
+static bool _mdns_label_equal(const char *a, const char *b, size_t len)
+{
+    size_t i = 0;
+    // labels in a packet are not aligned, memcpy() compiles to the loads the target can do
+    for (; i + sizeof(size_t) <= len; i += sizeof(size_t)) {
+        size_t wa, wb;
+        memcpy(&wa, a + i, sizeof(wa));
+        memcpy(&wb, b + i, sizeof(wb));
+        if (wa != wb && _mdns_word_lower(wa) != _mdns_word_lower(wb)) {
+            return false;
+        }
+    }
+    if (sizeof(size_t) > sizeof(uint32_t) && i + sizeof(uint32_t) <= len) {
+        uint32_t wa, wb;
+        memcpy(&wa, a + i, sizeof(wa));
+        memcpy(&wb, b + i, sizeof(wb));
+        if (wa != wb && _mdns_word_lower(wa) != _mdns_word_lower(wb)) {
+            return false;
+        }
+        i += sizeof(uint32_t);
+    }
+    for (; i < len; i++) {
+        if (a[i] != b[i] && _mdns_word_lower((uint8_t)a[i]) != _mdns_word_lower((uint8_t)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  compares two names ignoring the case of ASCII letters, like !strcasecmp()
+ */
+static bool _mdns_str_equal(const char *a, const char *b)
+{
+    // names mostly differ in their first bytes already, these are compared one by one
+    for (size_t i = 0; i < sizeof(size_t); i++) {
+        if (a[i] != b[i] && _mdns_word_lower((uint8_t)a[i]) != _mdns_word_lower((uint8_t)b[i])) {
+            return false;
+        }
+        if (!a[i]) {
+            return true;
+        }
+    }
+    a += sizeof(size_t);
+    b += sizeof(size_t);
+    size_t len = strlen(a);
+    return strnlen(b, len + 1) == len && _mdns_label_equal(a, b, len);
+}
+
+/**
+ * @brief  returns the length of a label read from a packet as a string, up to a zero byte in it
+ */
+static inline uint8_t _mdns_label_len(const uint8_t *data, uint8_t len)
+{
+    const size_t ones = (size_t) -1 / 0xFF;
+    uint8_t i = 0;
+    for (; i + sizeof(size_t) <= len; i += sizeof(size_t)) {
+        size_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if ((word - ones) & ~word & (ones * 0x80)) {
+            break;
+        }
+    }
+    while (i < len && data[i]) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief  checks whether a label read from a packet is the given (lower case) name
+ */
+static inline bool _mdns_label_is(const mdns_label_t *label, const char *name, size_t len)
+{
+    return label->len == len && _mdns_label_equal((const char *)label->data, name, len);
+}
+
 /*
  * @brief  Appends/increments a number to name/instance in case of collision
  * */
@@ -250,14 +367,14 @@ static char *_mdns_mangle_name(char *in)
         //need to add -2 to string
         ret = malloc(strlen(in) + 3);
         if (ret == NULL) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             return NULL;
         }
         sprintf(ret, "%s-2", in);
     } else {
         ret = malloc(strlen(in) + 2); //one extra byte in case 9-10 or 99-100 etc
         if (ret == NULL) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             return NULL;
         }
         strcpy(ret, in);
@@ -274,8 +391,106 @@ static bool _mdns_service_match(const mdns_service_t *srv, const char *service,
     if (!service || !proto || !srv->hostname) {
         return false;
     }
-    return !strcasecmp(srv->service, service) && !strcasecmp(srv->proto, proto) &&
-           (_str_null_or_empty(hostname) || !strcasecmp(srv->hostname, hostname));
+    return _mdns_str_equal(srv->service, service) && _mdns_str_equal(srv->proto, proto) &&
+           (_str_null_or_empty(hostname) || _mdns_str_equal(srv->hostname, hostname));
+}
+
+/**
+ * @brief  Case-insensitive FNV-1a hash of up to three name components
+ *
+ * Components are separated by a zero byte, so that "a"+"bc" and "ab"+"c" hash differently.
+ * Missing components (NULL) hash as empty strings.
+ */
+static uint16_t _mdns_name_hash(const char *a, const char *b, const char *c)
+{
+    const char *parts[] = { a, b, c };
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < ARRAY_SIZE(parts); i++) {
+        const char *p = parts[i];
+        for (; p && *p; p++) {
+            hash ^= (uint8_t)tolower((unsigned char)*p);
+            hash *= 16777619U;
+        }
+        hash *= 16777619U;
+    }
+    return (uint16_t)(hash % MDNS_LOOKUP_HASH_BUCKETS);
+}
+
+static uint16_t _mdns_srv_index_bucket(const mdns_service_t *srv, mdns_srv_index_t index)
+{
+    if (index == MDNS_SRV_INDEX_TYPE) {
+        return _mdns_name_hash(srv->service, srv->proto, NULL);
+    }
+    return _mdns_name_hash(srv->instance ? srv->instance : "", srv->service, srv->proto);
+}
+
+/**
+ * @brief  Links the service item to the lookup bucket of the given index
+ *
+ * Buckets are kept sorted from the newest to the oldest service, which is the order
+ * of the service list, so the first match in a bucket is the first match in the list.
+ */
+static void _mdns_srv_index_link(mdns_srv_item_t *item, mdns_srv_index_t index)
+{
+    item->hash_bucket[index] = _mdns_srv_index_bucket(item->service, index);
+    mdns_srv_item_t **slot = &_mdns_server->service_index[index][item->hash_bucket[index]];
+    while (*slot && (*slot)->seq > item->seq) {
+        slot = &(*slot)->hash_next[index];
+    }
+    item->hash_next[index] = *slot;
+    *slot = item;
+}
+
+static void _mdns_srv_index_unlink(mdns_srv_item_t *item, mdns_srv_index_t index)
+{
+    mdns_srv_item_t **slot = &_mdns_server->service_index[index][item->hash_bucket[index]];
+    while (*slot) {
+        if (*slot == item) {
+            *slot = item->hash_next[index];
+            item->hash_next[index] = NULL;
+            return;
+        }
+        slot = &(*slot)->hash_next[index];
+    }
+}
+
+/**
+ * @brief  Adds a new service item to the service list and to the lookup tables
+ */
+static void _mdns_srv_item_attach(mdns_srv_item_t *item)
+{
+    item->seq = ++_mdns_server->service_seq;
+    item->next = _mdns_server->services;
+    _mdns_server->services = item;
+    for (int i = 0; i < MDNS_SRV_INDEX_MAX; i++) {
+        _mdns_srv_index_link(item, i);
+    }
+}
+
+/**
+ * @brief  Removes the service item from the service list and from the lookup tables
+ */
+static void _mdns_srv_item_detach(mdns_srv_item_t *item)
+{
+    mdns_srv_item_t **slot = &_mdns_server->services;
+    while (*slot && *slot != item) {
+        slot = &(*slot)->next;
+    }
+    if (*slot) {
+        *slot = item->next;
+    }
+    for (int i = 0; i < MDNS_SRV_INDEX_MAX; i++) {
+        _mdns_srv_index_unlink(item, i);
+    }
+}
+
+/**
+ * @brief  Moves the service item to the right instance bucket after its instance name has changed
+ */
+static void _mdns_srv_item_reindex_instance(mdns_srv_item_t *item)
+{
+    _mdns_srv_index_unlink(item, MDNS_SRV_INDEX_INSTANCE);
+    _mdns_srv_index_link(item, MDNS_SRV_INDEX_INSTANCE);
 }
 
 /**
@@ -289,49 +504,63 @@ static bool _mdns_service_match(const mdns_service_t *srv, const char *service,
  */
 static mdns_srv_item_t *_mdns_get_service_item(const char *service, const char *proto, const char *hostname)
 {
-    mdns_srv_item_t *s = _mdns_server->services;
+    if (!service || !proto) {
+        return NULL;
+    }
+    mdns_srv_item_t *s = _mdns_server->service_index[MDNS_SRV_INDEX_TYPE][_mdns_name_hash(service, proto, NULL)];
     while (s) {
         if (_mdns_service_match(s->service, service, proto, hostname)) {
             return s;
         }
-        s = s->next;
+        s = s->hash_next[MDNS_SRV_INDEX_TYPE];
     }
     return NULL;
 }
 
 static mdns_srv_item_t *_mdns_get_service_item_subtype(const char *subtype, const char *service, const char *proto)
 {
-    mdns_srv_item_t *s = _mdns_server->services;
+    if (!service || !proto) {
+        return NULL;
+    }
+    mdns_srv_item_t *s = _mdns_server->service_index[MDNS_SRV_INDEX_TYPE][_mdns_name_hash(service, proto, NULL)];
     while (s) {
         if (_mdns_service_match(s->service, service, proto, NULL)) {
             mdns_subtype_t *subtype_item = s->service->subtype;
             while (subtype_item) {
-                if (!strcasecmp(subtype_item->subtype, subtype)) {
+                if (_mdns_str_equal(subtype_item->subtype, subtype)) {
                     return s;
                 }
                 subtype_item = subtype_item->next;
             }
         }
-        s = s->next;
+        s = s->hash_next[MDNS_SRV_INDEX_TYPE];
     }
     return NULL;
 }
 
-static mdns_host_item_t *mdns_get_host_item(const char *hostname)
+/**
+ * @brief  finds delegated host by its name
+ */
+static mdns_host_item_t *_mdns_find_delegated_host(const char *hostname)
 {
-    if (hostname == NULL || strcasecmp(hostname, _mdns_server->hostname) == 0) {
-        return &_mdns_self_host;
-    }
-    mdns_host_item_t *host = _mdns_host_list;
+    mdns_host_item_t *host = _mdns_host_table[_mdns_name_hash(hostname, NULL, NULL)];
     while (host != NULL) {
-        if (strcasecmp(host->hostname, hostname) == 0) {
+        if (_mdns_str_equal(host->hostname, hostname)) {
             return host;
         }
-        host = host->next;
+        host = host->hash_next;
     }
     return NULL;
 }
 
+static mdns_host_item_t *mdns_get_host_item(const char *hostname)
+{
+    if (hostname == NULL || _mdns_str_equal(hostname, _mdns_server->hostname)) {
+        return &_mdns_self_host;
+    }
+    return _mdns_find_delegated_host(hostname);
+}
+
 static bool _mdns_can_add_more_services(void)
 {
     mdns_srv_item_t *s = _mdns_server->services;
@@ -347,25 +576,240 @@ static bool _mdns_can_add_more_services(void)
     return true;
 }
 
+/**
+ * @brief  Take an action from the pool, or from heap if all pooled actions are pending
+ *
+ * Actions are posted from the API, networking and timer tasks, so the pool is a bitmap of used slots
+ * claimed with compare-and-swap, without taking a lock.
+ */
+static mdns_action_t *_mdns_action_alloc(void)
+{
+    for (size_t w = 0; w < ARRAY_SIZE(_mdns_action_pool_used); w++) {
+        uint32_t slots = MIN(MDNS_ACTION_POOL_SIZE - w * 32, 32);
+        uint32_t mask = slots == 32 ? UINT32_MAX : (1UL << slots) - 1;
+        uint32_t used = atomic_load(&_mdns_action_pool_used[w]);
+        uint32_t free_slots;
+        while ((free_slots = ~used & mask) != 0) {
+            uint32_t bit = free_slots & (~free_slots + 1);
+            if (atomic_compare_exchange_weak(&_mdns_action_pool_used[w], &used, used | bit)) {
+                uint32_t in_use = atomic_fetch_add(&_mdns_action_pool_in_use, 1) + 1;
+                uint32_t in_use_max = atomic_load(&_mdns_action_pool_in_use_max);
+                while (in_use > in_use_max && !atomic_compare_exchange_weak(&_mdns_action_pool_in_use_max, &in_use_max, in_use)) {
+                }
+                atomic_fetch_add(&_mdns_action_pool_allocated, 1);
+                return &_mdns_action_pool[w * 32 + __builtin_ctz(bit)];
+            }
+        }
+    }
+    atomic_fetch_add(&_mdns_action_pool_exhausted, 1);
+    return (mdns_action_t *)malloc(sizeof(mdns_action_t));
+}
+
+/**
+ * @brief  Return the action to the pool (or to heap)
+ */
+static void _mdns_action_release(mdns_action_t *action)
+{
+    if (action >= _mdns_action_pool && action < _mdns_action_pool + MDNS_ACTION_POOL_SIZE) {
+        size_t slot = action - _mdns_action_pool;
+        atomic_fetch_sub(&_mdns_action_pool_in_use, 1);
+        atomic_fetch_and(&_mdns_action_pool_used[slot / 32], ~(1UL << (slot % 32)));
+        return;
+    }
+    free(action);
+}
+
+/**
+ * @brief  Queue an action to a lane of the service thread
+ *
+ * @return true if queued, false if the lane is full
+ */
+static bool _mdns_action_post(mdns_lane_t lane, mdns_action_t *action)
+{
+    if (xQueueSend(_mdns_server->lanes[lane], &action, (TickType_t)0) != pdPASS) {
+        return false;
+    }
+    xSemaphoreGive(_mdns_server->lanes_pending);
+    return true;
+}
+
+/**
+ * @brief  Take the action to execute next from the lanes
+ *
+ * Takes from the first lane with actions waiting, unless another waiting lane has been passed over
+ * MDNS_LANE_PASS_MAX times, which is served instead. So an RX flood cannot hold up API calls or the timer
+ * for more than one packet, and neither can the API and the timer hold up received packets for long.
+ *
+ * @return the action, or NULL if no action is waiting
+ */
+static mdns_action_t *_mdns_action_take(void)
+{
+    bool waiting[MDNS_LANE_MAX];
+    mdns_lane_t lane = MDNS_LANE_MAX;
+    for (mdns_lane_t i = 0; i < MDNS_LANE_MAX; i++) {
+        waiting[i] = uxQueueMessagesWaiting(_mdns_server->lanes[i]) > 0;
+        if (waiting[i] && (lane == MDNS_LANE_MAX || _mdns_server->lane_passed[i] >= MDNS_LANE_PASS_MAX)) {
+            lane = i;
+        }
+    }
+    if (lane == MDNS_LANE_MAX) {
+        return NULL;
+    }
+    for (mdns_lane_t i = 0; i < MDNS_LANE_MAX; i++) {
+        if (waiting[i] && i != lane && _mdns_server->lane_passed[i] < UINT8_MAX) {
+            _mdns_server->lane_passed[i]++;
+        }
+    }
+    _mdns_server->lane_passed[lane] = 0;
+    mdns_action_t *action = NULL;
+    if (xQueueReceive(_mdns_server->lanes[lane], &action, 0) != pdTRUE) {
+        return NULL;
+    }
+    return action;
+}
+
+void _mdns_get_action_pool_stats(mdns_action_pool_stats_t *stats)
+{
+    stats->slots = MDNS_ACTION_POOL_SIZE;
+    stats->in_use = atomic_load(&_mdns_action_pool_in_use);
+    stats->in_use_max = atomic_load(&_mdns_action_pool_in_use_max);
+    stats->allocated = atomic_load(&_mdns_action_pool_allocated);
+    stats->pool_exhausted = atomic_load(&_mdns_action_pool_exhausted);
+}
+
+void _mdns_stats_alloc_failed(void)
+{
+    atomic_fetch_add(&_mdns_stats_alloc_failures, 1);
+}
+
+/**
+ * @brief  Count a received packet the networking layer drops, because it could not be queued
+ */
+static void _mdns_stats_rx_drop(const mdns_rx_packet_t *packet)
+{
+    if (packet->tcpip_if < MDNS_MAX_INTERFACES && packet->ip_protocol < MDNS_IP_PROTOCOL_MAX) {
+        atomic_fetch_add(&_mdns_stats_rx_dropped[packet->tcpip_if][packet->ip_protocol], 1);
+    }
+}
+
+/**
+ * @brief  Get the counters of an interface, interfaces beyond CONFIG_MDNS_MAX_INTERFACES are not reported
+ */
+static mdns_netif_stats_t *_mdns_stats_netif(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+{
+    static mdns_netif_stats_t unreported;
+    if (tcpip_if >= CONFIG_MDNS_MAX_INTERFACES) {
+        return &unreported;
+    }
+    return &_mdns_server->stats.netif[tcpip_if][ip_protocol];
+}
+
+/**
+ * @brief  Count the time elapsed since start in a latency histogram
+ */
+static void _mdns_stats_latency(uint32_t histogram[MDNS_STATS_LATENCY_BUCKETS], int64_t start)
+{
+    uint64_t us = esp_timer_get_time() - start;
+    size_t bucket = 0;
+    for (us >>= 3; us && bucket < MDNS_STATS_LATENCY_BUCKETS - 1; us >>= 1) {
+        bucket++;
+    }
+    histogram[bucket]++;
+}
+
+/**
+ * @brief  Received packets pending to the server, the actions in the RX lane and the other packets of their batches
+ */
+static uint32_t _mdns_rx_pending(void)
+{
+    return uxQueueMessagesWaiting(_mdns_server->lanes[MDNS_LANE_RX]) + atomic_load(&_mdns_rx_batched);
+}
+
 esp_err_t _mdns_send_rx_action(mdns_rx_packet_t *packet)
 {
     mdns_action_t *action = NULL;
 
-    action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    if (_mdns_rx_pending() >= MDNS_RX_QUEUE_LEN) {
+        _mdns_stats_rx_drop(packet);
+        return ESP_ERR_NO_MEM;
+    }
+    action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
+        _mdns_stats_rx_drop(packet);
         return ESP_ERR_NO_MEM;
     }
 
     action->type = ACTION_RX_HANDLE;
     action->data.rx_handle.packet = packet;
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
-        free(action);
+    if (!_mdns_action_post(MDNS_LANE_RX, action)) {
+        _mdns_action_release(action);
+        _mdns_stats_rx_drop(packet);
         return ESP_ERR_NO_MEM;
     }
     return ESP_OK;
 }
 
+/**
+ * @brief  Queue RX packets (linked list) as one action
+ *
+ * Only as many packets as MDNS_RX_QUEUE_LEN leaves room for are queued, the others are dropped.
+ */
+esp_err_t _mdns_send_rx_batch_action(mdns_rx_packet_t *packets)
+{
+    mdns_action_t *action = NULL;
+    uint32_t pending = _mdns_rx_pending();
+    uint32_t room = pending < MDNS_RX_QUEUE_LEN ? MDNS_RX_QUEUE_LEN - pending : 0;
+    uint32_t count = 1;
+    mdns_rx_packet_t *last = packets;
+    while (last->next && count < room) {
+        last = last->next;
+        count++;
+    }
+    if (room && last->next) {
+        mdns_rx_packet_t *dropped = last->next;
+        last->next = NULL;
+        while (dropped) {
+            mdns_rx_packet_t *next = dropped->next;
+            _mdns_stats_rx_drop(dropped);
+            _mdns_packet_free(dropped);
+            dropped = next;
+        }
+    }
+
+    action = room ? _mdns_action_alloc() : NULL;
+    if (action) {
+        action->type = ACTION_RX_BATCH_HANDLE;
+        action->data.rx_handle.packet = packets;
+        atomic_fetch_add(&_mdns_rx_batched, count - 1);
+        if (_mdns_action_post(MDNS_LANE_RX, action)) {
+            return ESP_OK;
+        }
+        atomic_fetch_sub(&_mdns_rx_batched, count - 1);
+        _mdns_action_release(action);
+    } else if (room) {
+        MDNS_MALLOC_FAILED;
+    }
+    for (mdns_rx_packet_t *packet = packets; packet; packet = packet->next) {
+        _mdns_stats_rx_drop(packet);
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+/**
+ * @brief  Takes the packets of a batch out of the pending ones, as the server takes the batch
+ */
+static void _mdns_rx_batch_taken(const mdns_rx_packet_t *packets)
+{
+    uint32_t count = 0;
+    for (const mdns_rx_packet_t *packet = packets; packet; packet = packet->next) {
+        count++;
+    }
+    if (count) {
+        atomic_fetch_sub(&_mdns_rx_batched, count - 1);
+    }
+}
+
 static const char *_mdns_get_default_instance_name(void)
 {
     if (_mdns_server && !_str_null_or_empty(_mdns_server->instance)) {
@@ -399,7 +843,7 @@ static bool _mdns_instance_name_match(const char *lhs, const char *rhs)
     if (rhs == NULL) {
         rhs = _mdns_get_default_instance_name();
     }
-    return !strcasecmp(lhs, rhs);
+    return _mdns_str_equal(lhs, rhs);
 }
 
 static bool _mdns_service_match_instance(const mdns_service_t *srv, const char *instance, const char *service,
@@ -411,41 +855,97 @@ static bool _mdns_service_match_instance(const mdns_service_t *srv, const char *
     }
     // instance==NULL -> _mdns_instance_name_match() will check the default instance
     // hostname==NULL -> matches if instance, service and proto matches
-    return !strcasecmp(srv->service, service) && _mdns_instance_name_match(srv->instance, instance) &&
-           !strcasecmp(srv->proto, proto) && (_str_null_or_empty(hostname) || !strcasecmp(srv->hostname, hostname));
+    return _mdns_str_equal(srv->service, service) && _mdns_instance_name_match(srv->instance, instance) &&
+           _mdns_str_equal(srv->proto, proto) && (_str_null_or_empty(hostname) || _mdns_str_equal(srv->hostname, hostname));
+}
+
+static mdns_srv_item_t *_mdns_get_service_item_instance_bucket(uint16_t bucket, const char *instance, const char *service,
+        const char *proto, const char *hostname)
+{
+    mdns_srv_item_t *s = _mdns_server->service_index[MDNS_SRV_INDEX_INSTANCE][bucket];
+    while (s) {
+        if (_mdns_service_match_instance(s->service, instance, service, proto, hostname)) {
+            return s;
+        }
+        s = s->hash_next[MDNS_SRV_INDEX_INSTANCE];
+    }
+    return NULL;
 }
 
 static mdns_srv_item_t *_mdns_get_service_item_instance(const char *instance, const char *service, const char *proto,
         const char *hostname)
 {
-    mdns_srv_item_t *s = _mdns_server->services;
-    while (s) {
-        if (instance) {
-            if (_mdns_service_match_instance(s->service, instance, service, proto, hostname)) {
-                return s;
-            }
-        } else {
-            if (_mdns_service_match(s->service, service, proto, hostname)) {
-                return s;
+    if (!instance) {
+        return _mdns_get_service_item(service, proto, hostname);
+    }
+    if (!service || !proto) {
+        return NULL;
+    }
+    // services with an explicit instance name are indexed under that name
+    uint16_t bucket = _mdns_name_hash(instance, service, proto);
+    mdns_srv_item_t *found = _mdns_get_service_item_instance_bucket(bucket, instance, service, proto, hostname);
+    // services without one are indexed under an empty name and match the default instance
+    const char *default_instance = _mdns_get_default_instance_name();
+    if (default_instance && _mdns_str_equal(instance, default_instance)) {
+        uint16_t default_bucket = _mdns_name_hash("", service, proto);
+        if (default_bucket != bucket) {
+            mdns_srv_item_t *s = _mdns_get_service_item_instance_bucket(default_bucket, instance, service, proto, hostname);
+            if (s && (!found || s->seq > found->seq)) {
+                found = s;
             }
         }
-        s = s->next;
     }
-    return NULL;
+    return found;
+}
+
+/**
+ * @brief  appends a label read from a packet to a name, truncating it like strlcat()
+ */
+static void _mdns_label_append(char *dst, size_t size, const mdns_label_t *label)
+{
+    size_t used = strlen(dst);
+    size_t len = label->len < size - 1 - used ? label->len : size - 1 - used;
+    memcpy(dst + used, label->data, len);
+    dst[used + len] = 0;
+}
+
+/**
+ * @brief  copies a part of the name read by _mdns_read_fqdn() to where it belongs
+ *
+ * @param  name         the name read, which keeps the first part itself if labels were merged into it
+ * @param  labels       labels of the parts
+ * @param  part         index of the part
+ * @param  dst          host, service, proto or domain of the name
+ */
+static void _mdns_name_copy_part(mdns_name_t *name, const mdns_name_labels_t *labels, uint8_t part, char *dst)
+{
+    if (part == 0 && labels->host_merged) {
+        if (dst != name->host) {
+            strcpy(dst, name->host);
+            name->host[0] = 0;
+        }
+        return;
+    }
+    memcpy(dst, labels->parts[part].data, labels->parts[part].len);
+    dst[labels->parts[part].len] = 0;
 }
 
 /**
  * @brief  reads MDNS FQDN into mdns_name_t structure
  *         FQDN is in format: [hostname.|[instance.]_service._proto.]local.
  *
+ * The labels of the parts are not copied, their place in the packet is noted in labels, to be compared in place
+ * or copied into the name once it is known which part they are (see _mdns_name_copy_part()).
+ * Only labels merged into the first part are written to the host of the name.
+ *
  * @param  packet       MDNS packet
  * @param  start        Starting point of FQDN
  * @param  name         mdns_name_t structure to populate
- * @param  buf          temporary char buffer
+ * @param  labels       labels of the parts read so far
  *
  * @return the address after the parsed FQDN in the packet or NULL on error
  */
-static const uint8_t *_mdns_read_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, char *buf, size_t packet_len)
+static const uint8_t *_mdns_read_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, mdns_name_labels_t *labels, size_t packet_len)
 {
     size_t index = 0;
     const uint8_t *packet_end = packet + packet_len;
@@ -459,29 +959,29 @@ static const uint8_t *_mdns_read_fqdn(const uint8_t *packet, const uint8_t *star
                 //length can not be more than 63
                 return NULL;
             }
-            uint8_t i;
-            for (i = 0; i < len; i++) {
-                if (start + index >= packet_end) {
-                    return NULL;
-                }
-                buf[i] = start[index++];
+            if (len > packet_end - (start + index)) {
+                return NULL;
             }
-            buf[len] = '\0';
-            if (name->parts == 1 && buf[0] != '_'
-                    && (strcasecmp(buf, MDNS_DEFAULT_DOMAIN) != 0)
-                    && (strcasecmp(buf, "arpa") != 0)
+            mdns_label_t label = { .data = start + index, .len = _mdns_label_len(start + index, len) };
+            index += len;
+            if (name->parts == 1 && !(label.len && label.data[0] == '_')
+                    && !_mdns_label_is(&label, "local", 5)
+                    && !_mdns_label_is(&label, "arpa", 4)
 #ifndef CONFIG_MDNS_RESPOND_REVERSE_QUERIES
-                    && (strcasecmp(buf, "ip6") != 0)
-                    && (strcasecmp(buf, "in-addr") != 0)
+                    && !_mdns_label_is(&label, "ip6", 3)
+                    && !_mdns_label_is(&label, "in-addr", 7)
 #endif
                ) {
+                if (!labels->host_merged) {
+                    _mdns_name_copy_part(name, labels, 0, name->host);
+                    labels->host_merged = true;
+                }
                 strlcat(name->host, ".", sizeof(name->host));
-                strlcat(name->host, buf, sizeof(name->host));
-            } else if (strcasecmp(buf, MDNS_SUB_STR) == 0) {
+                _mdns_label_append(name->host, sizeof(name->host), &label);
+            } else if (_mdns_label_is(&label, "_sub", 4)) {
                 name->sub = 1;
             } else if (!name->invalid) {
-                char *mdns_name_ptrs[] = {name->host, name->service, name->proto, name->domain};
-                memcpy(mdns_name_ptrs[name->parts++], buf, len + 1);
+                labels->parts[name->parts++] = label;
             }
         } else {
             size_t address = (((uint16_t)len & 0x3F) << 8) | start[index++];
@@ -489,7 +989,7 @@ static const uint8_t *_mdns_read_fqdn(const uint8_t *packet, const uint8_t *star
                 //reference address can not be after where we are
                 return NULL;
             }
-            if (_mdns_read_fqdn(packet, packet + address, name, buf, packet_len)) {
+            if (_mdns_read_fqdn(packet, packet + address, name, labels, packet_len)) {
                 return start + index;
             }
             return NULL;
@@ -647,39 +1147,8 @@ static inline uint8_t _mdns_append_string(uint8_t *packet, uint16_t *index, cons
     return len + 1;
 }
 
-/**
- * @brief  appends one TXT record ("key=value" or "key")
- *
- * @param  packet       MDNS packet
- * @param  index        offset in the packet
- * @param  txt          one txt record
- *
- * @return length of added data: length of the added txt value + 1 on success
- *         0  if data won't fit the packet
- *         -1 if invalid TXT entry
- */
-static inline int append_one_txt_record_entry(uint8_t *packet, uint16_t *index, mdns_txt_linked_item_t *txt)
-{
-    if (txt == NULL || txt->key == NULL) {
-        return -1;
-    }
-    size_t key_len = strlen(txt->key);
-    size_t len = key_len + txt->value_len + (txt->value ? 1 : 0);
-    if ((*index + len + 1) >= MDNS_MAX_PACKET_SIZE) {
-        return 0;
-    }
-    _mdns_append_u8(packet, index, len);
-    memcpy(packet + *index, txt->key, key_len);
-    if (txt->value) {
-        packet[*index + key_len] = '=';
-        memcpy(packet + *index + key_len + 1, txt->value, txt->value_len);
-    }
-    *index += len;
-    return len + 1;
-}
-
-#ifdef CONFIG_MDNS_RESPOND_REVERSE_QUERIES
-static inline int append_single_str(uint8_t *packet, uint16_t *index, const char *str, int len)
+#ifdef CONFIG_MDNS_RESPOND_REVERSE_QUERIES
+static inline int append_single_str(uint8_t *packet, uint16_t *index, const char *str, int len)
 {
     if ((*index + len + 1) >= MDNS_MAX_PACKET_SIZE) {
         return 0;
@@ -732,80 +1201,334 @@ static uint16_t append_fqdn_dots(uint8_t *packet, uint16_t *index, const char *n
 }
 #endif /* CONFIG_MDNS_RESPOND_REVERSE_QUERIES */
 
+static mdns_name_dict_t s_name_dict;
+
 /**
- * @brief  appends FQDN to a packet, incrementing the index and
- *         compressing the output if previous occurrence of the string (or part of it) has been found
+ * @brief  checks whether the FQDN at the location is the one we are looking for:
+ *         same first label and the name reads back with the same parts (case-insensitive)
+ */
+static bool _mdns_fqdn_matches(const uint8_t *packet, const uint8_t *location, const char *strings[], uint8_t count, size_t packet_len)
+{
+    mdns_name_t name;
+    mdns_name_labels_t labels;
+    uint8_t len = strlen(strings[0]);
+    if (location[0] != len || memcmp(location + 1, strings[0], len)) {
+        return false;
+    }
+    name.parts = 0;
+    name.sub = 0;
+    name.invalid = false;
+    name.host[0] = 0;
+    labels.host_merged = false;
+    if (!_mdns_read_fqdn(packet, location, &name, &labels, packet_len) || name.parts != count) {
+        return false;
+    }
+    // the parts are compared in the packet, unless labels were merged into the first one
+    for (uint8_t i = 0; i < count; i++) {
+        if (i == 0 && labels.host_merged) {
+            if (!_mdns_str_equal(strings[0], name.host)) {
+                return false;
+            }
+        } else if (!_mdns_label_is(&labels.parts[i], strings[i], strlen(strings[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  searches the packet for a previous occurrence of the FQDN by reading back every candidate
  *
  * @param  packet       MDNS packet
- * @param  index        offset in the packet
+ * @param  index        offset in the packet (end of the data written so far)
  * @param  strings      string array containing the parts of the FQDN
  * @param  count        number of strings in the array
  *
- * @return length of added data: 0 on error or length on success
+ * @return offset of the occurrence or 0 if not found
  */
-static uint16_t _mdns_append_fqdn(uint8_t *packet, uint16_t *index, const char *strings[], uint8_t count, size_t packet_len)
+static uint16_t _mdns_fqdn_scan(const uint8_t *packet, uint16_t index, const char *strings[], uint8_t count, size_t packet_len)
 {
-    if (!count) {
-        //empty string so terminate
-        return _mdns_append_u8(packet, index, 0);
-    }
-    mdns_name_t name;
-    static char buf[MDNS_NAME_BUF_LEN];
     uint8_t len = strlen(strings[0]);
     //try to find first the string length in the packet (if it exists)
-    uint8_t *len_location = (uint8_t *)memchr(packet, (char)len, *index);
+    const uint8_t *len_location = memchr(packet, (char)len, index);
     while (len_location) {
-        //check if the string after len_location is the string that we are looking for
-        if (memcmp(len_location + 1, strings[0], len)) { //not continuing with our string
-search_next:
-            //try and find the length byte further in the packet
-            len_location = (uint8_t *)memchr(len_location + 1, (char)len, *index - (len_location + 1 - packet));
-            continue;
+        if (_mdns_fqdn_matches(packet, len_location, strings, count, packet_len)) {
+            return len_location - packet;
         }
-        //seems that we might have found the string that we are looking for
-        //read the destination into name and compare
-        name.parts = 0;
-        name.sub = 0;
-        name.invalid = false;
-        name.host[0] = 0;
-        name.service[0] = 0;
-        name.proto[0] = 0;
-        name.domain[0] = 0;
-        const uint8_t *content = _mdns_read_fqdn(packet, len_location, &name, buf, packet_len);
-        if (!content) {
-            //not a readable fqdn?
-            goto search_next; // could be our unfinished fqdn, continue searching
-        }
-        if (name.parts == count) {
-            uint8_t i;
-            for (i = 0; i < count; i++) {
-                if (strcasecmp(strings[i], (const char *)&name + (i * (MDNS_NAME_BUF_LEN)))) {
-                    //not our string! let's search more
-                    goto search_next;
-                }
+        //try and find the length byte further in the packet
+        len_location = memchr(len_location + 1, (char)len, index - (len_location + 1 - packet));
+    }
+    return 0;
+}
+
+static inline uint8_t _mdns_name_dict_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : (uint8_t)c;
+}
+
+static inline bool _mdns_name_dict_label_is(const char *label, size_t len, const char *name, size_t name_len)
+{
+    return len == name_len && _mdns_label_equal(label, name, len);
+}
+
+/**
+ * @brief  hashes a label and notes how _mdns_read_fqdn() treats it
+ *
+ * The hash only needs to tell the labels of a packet apart, the entries are verified against the packet anyway.
+ */
+static void _mdns_name_dict_label(const char *label, mdns_name_dict_label_t *out)
+{
+    size_t len = strlen(label);
+    uint32_t h = len;
+    if (len) {
+        h = h * 31 + _mdns_name_dict_lower(label[0]);
+        h = h * 31 + _mdns_name_dict_lower(label[len / 2]);
+        h = h * 31 + _mdns_name_dict_lower(label[len - 2 + (len == 1)]);
+        h = h * 31 + _mdns_name_dict_lower(label[len - 1]);
+    }
+    out->hash = h;
+    out->flags = 0;
+    if (len == 0 || len > 63 || memchr(label, '.', len)) {
+        out->flags |= MDNS_NAME_DICT_LABEL_IRREGULAR;
+    }
+    if (label[0] == '_') {
+        if (_mdns_name_dict_label_is(label, len, "_sub", 4)) {
+            out->flags |= MDNS_NAME_DICT_LABEL_SUB;
+        }
+    } else if (!_mdns_name_dict_label_is(label, len, "local", 5) && !_mdns_name_dict_label_is(label, len, "arpa", 4)
+#ifndef CONFIG_MDNS_RESPOND_REVERSE_QUERIES
+               && !_mdns_name_dict_label_is(label, len, "ip6", 3) && !_mdns_name_dict_label_is(label, len, "in-addr", 7)
+#endif
+              ) {
+        out->flags |= MDNS_NAME_DICT_LABEL_MERGES;
+    }
+}
+
+/**
+ * @brief  computes the hash of the FQDN parts as _mdns_read_fqdn() would read them back
+ *         and classifies the FQDN the way _mdns_fqdn_scan() would treat it
+ *
+ * A name is only found by the search if it reads back with the same parts, so names with more than 4 labels,
+ * with a "_sub" label or with a second label that is merged into the host part are never compressed.
+ */
+static mdns_name_dict_class_t _mdns_name_dict_key(const mdns_name_dict_label_t *labels, uint8_t count, uint32_t *hash)
+{
+    mdns_name_dict_class_t ret = count > 4 ? MDNS_NAME_DICT_NEVER : MDNS_NAME_DICT_MATCHABLE;
+    uint32_t h = 2166136261U;
+    uint8_t parts = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t flags = labels[i].flags;
+        if (flags & MDNS_NAME_DICT_LABEL_IRREGULAR) {
+            ret = MDNS_NAME_DICT_IRREGULAR;
+        }
+        if (parts == 1 && (flags & MDNS_NAME_DICT_LABEL_MERGES)) {
+            if (ret == MDNS_NAME_DICT_MATCHABLE) {
+                ret = MDNS_NAME_DICT_NEVER;
             }
-            //we actually have found the string
-            break;
+            h = (h ^ '.') * 16777619U;
+        } else if (flags & MDNS_NAME_DICT_LABEL_SUB) {
+            if (ret == MDNS_NAME_DICT_MATCHABLE) {
+                ret = MDNS_NAME_DICT_NEVER;
+            }
+            continue;
+        } else if (parts < 4) {
+            h *= 16777619U;
+            parts++;
         } else {
-            goto search_next;
+            continue;
+        }
+        h = (h ^ labels[i].hash) * 16777619U;
+    }
+    *hash = h;
+    return ret;
+}
+
+/**
+ * @brief  starts a new compression dictionary for the packet
+ */
+static void _mdns_name_dict_reset(const uint8_t *packet)
+{
+    s_name_dict.packet = packet;
+    s_name_dict.overflow = false;
+    s_name_dict.count = 0;
+    memset(s_name_dict.buckets, MDNS_NAME_DICT_NONE, sizeof(s_name_dict.buckets));
+}
+
+/**
+ * @brief  finds the first occurrence of the FQDN in the packet
+ *
+ * @return offset of the occurrence or 0 if not found
+ */
+static uint16_t _mdns_name_dict_find(const uint8_t *packet, uint16_t index, const char *strings[], uint8_t count, size_t packet_len,
+                                     mdns_name_dict_class_t name_class, uint32_t hash)
+{
+    if (name_class == MDNS_NAME_DICT_NEVER) {
+        return 0;
+    }
+    if (name_class == MDNS_NAME_DICT_IRREGULAR || s_name_dict.overflow) {
+        return _mdns_fqdn_scan(packet, index, strings, count, packet_len);
+    }
+    uint16_t found = 0;
+    for (uint8_t e = s_name_dict.buckets[hash % MDNS_NAME_DICT_BUCKETS]; e != MDNS_NAME_DICT_NONE; e = s_name_dict.entries[e].next) {
+        uint16_t offset = s_name_dict.entries[e].offset;
+        if (s_name_dict.entries[e].hash == hash && (!found || offset < found) &&
+                _mdns_fqdn_matches(packet, packet + offset, strings, count, packet_len)) {
+            found = offset;
         }
     }
+    return found;
+}
+
+/**
+ * @brief  remembers the FQDN written out in full at the offset
+ */
+static void _mdns_name_dict_add(uint16_t offset, uint32_t hash)
+{
+    if (s_name_dict.count == MDNS_NAME_DICT_ENTRIES) {
+        s_name_dict.overflow = true;
+        return;
+    }
+    uint8_t e = s_name_dict.count++;
+    uint8_t *bucket = &s_name_dict.buckets[hash % MDNS_NAME_DICT_BUCKETS];
+    s_name_dict.entries[e].hash = hash;
+    s_name_dict.entries[e].offset = offset;
+    s_name_dict.entries[e].next = *bucket;
+    *bucket = e;
+}
+
+/**
+ * @brief  forgets the names written at or after the offset, when a record is taken back out of the packet
+ *
+ * Entries are added in the order the names are written, so the names of the record are the newest ones.
+ */
+static void _mdns_name_dict_truncate(uint16_t offset)
+{
+    while (s_name_dict.count && s_name_dict.entries[s_name_dict.count - 1].offset >= offset) {
+        uint8_t e = --s_name_dict.count;
+        s_name_dict.buckets[s_name_dict.entries[e].hash % MDNS_NAME_DICT_BUCKETS] = s_name_dict.entries[e].next;
+    }
+}
+
+/**
+ * @brief  appends FQDN to a packet (see _mdns_append_fqdn()), with the labels hashed by the caller
+ */
+static uint16_t _mdns_append_fqdn_labels(uint8_t *packet, uint16_t *index, const char *strings[], const mdns_name_dict_label_t *labels,
+                                         uint8_t count, size_t packet_len)
+{
+    if (!count) {
+        //empty string so terminate
+        return _mdns_append_u8(packet, index, 0);
+    }
+    uint32_t hash = 0;
+    mdns_name_dict_class_t name_class = labels ? _mdns_name_dict_key(labels, count, &hash) : MDNS_NAME_DICT_IRREGULAR;
+    uint16_t offset = _mdns_name_dict_find(packet, *index, strings, count, packet_len, name_class, hash);
     //string is not yet in the packet, so let's add it
-    if (!len_location) {
+    if (!offset) {
+        uint16_t label_offset = *index;
+        if (!strings[0][0]) {
+            //an empty label terminates the names written so far, which are not remembered yet
+            s_name_dict.overflow = true;
+        }
         uint8_t written = _mdns_append_string(packet, index, strings[0]);
         if (!written) {
             return 0;
         }
         //run the same for the other strings in the name
-        return written + _mdns_append_fqdn(packet, index, &strings[1], count - 1, packet_len);
+        uint16_t rest = _mdns_append_fqdn_labels(packet, index, &strings[1], labels ? &labels[1] : NULL, count - 1, packet_len);
+        if (rest && labels) {
+            _mdns_name_dict_add(label_offset, hash);
+        }
+        return written + rest;
     }
 
     //we have found the string so let's insert a pointer to it instead
-    uint16_t offset = len_location - packet;
     offset |= MDNS_NAME_REF;
     return _mdns_append_u16(packet, index, offset);
 }
 
+/**
+ * @brief  appends FQDN to a packet, incrementing the index and
+ *         compressing the output if previous occurrence of the string (or part of it) has been found
+ *
+ * Previous occurrences are looked up in the compression dictionary of the packet,
+ * which is started over whenever a different packet buffer is used or by _mdns_name_dict_reset().
+ * Encoded names are not cached per service: how much of a name is written out depends on the
+ * names already in the packet, and in a response most of them point back to the question.
+ * The keys of the labels of a service are kept though, see _mdns_service_wire().
+ *
+ * @param  packet       MDNS packet
+ * @param  index        offset in the packet
+ * @param  strings      string array containing the parts of the FQDN
+ * @param  count        number of strings in the array
+ *
+ * @return length of added data: 0 on error or length on success
+ */
+static uint16_t _mdns_append_fqdn(uint8_t *packet, uint16_t *index, const char *strings[], uint8_t count, size_t packet_len)
+{
+    mdns_name_dict_label_t labels[MDNS_NAME_DICT_LABELS];
+    if (s_name_dict.packet != packet) {
+        _mdns_name_dict_reset(packet);
+    }
+    if (count > MDNS_NAME_DICT_LABELS) {
+        //not expected to happen, leave the packet to the search
+        s_name_dict.overflow = true;
+        return _mdns_append_fqdn_labels(packet, index, strings, NULL, count, packet_len);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        _mdns_name_dict_label(strings[i], &labels[i]);
+    }
+    return _mdns_append_fqdn_labels(packet, index, strings, labels, count, packet_len);
+}
+
+/**
+ * @brief  appends FQDN to a packet (see _mdns_append_fqdn()), with the labels keyed in advance
+ */
+static uint16_t _mdns_append_fqdn_keyed(uint8_t *packet, uint16_t *index, const char *strings[], const mdns_name_dict_label_t *labels,
+                                        uint8_t count, size_t packet_len)
+{
+    if (s_name_dict.packet != packet) {
+        _mdns_name_dict_reset(packet);
+    }
+    return _mdns_append_fqdn_labels(packet, index, strings, labels, count, packet_len);
+}
+
+/**
+ * @brief  notes that the hostname or the default instance changed, which the records of all services may use
+ */
+static void _mdns_names_changed(void)
+{
+    if (++_mdns_names_generation == 0) {
+        _mdns_names_generation = 1;
+    }
+}
+
+/**
+ * @brief  gets the parts of the records of the service which are the same in every packet, encoding them if stale
+ *
+ * Keys not matching the names (a change which was not noted) would only make the names miss the compression,
+ * as the entries of the dictionary are verified against the packet.
+ */
+static const mdns_service_wire_t *_mdns_service_wire(mdns_service_t *service)
+{
+    mdns_service_wire_t *wire = &service->wire;
+    if (wire->generation == _mdns_names_generation) {
+        return wire;
+    }
+    const char *instance = _mdns_get_service_instance_name(service);
+    const char *host = service->hostname ? service->hostname : _mdns_server->hostname;
+    _mdns_name_dict_label(instance ? instance : "", &wire->name[0]);
+    _mdns_name_dict_label(service->service, &wire->name[1]);
+    _mdns_name_dict_label(service->proto, &wire->name[2]);
+    _mdns_name_dict_label(MDNS_DEFAULT_DOMAIN, &wire->name[3]);
+    _mdns_name_dict_label(host ? host : "", &wire->host[0]);
+    wire->host[1] = wire->name[3];
+    _mdns_set_u16(wire->srv, 0, service->priority);
+    _mdns_set_u16(wire->srv, 2, service->weight);
+    _mdns_set_u16(wire->srv, 4, service->port);
+    wire->generation = _mdns_names_generation;
+    return wire;
+}
+
 /**
  * @brief  appends PTR record for service to a packet, incrementing the index
  *
@@ -813,10 +1536,12 @@ search_next:
  * @param  index        offset in the packet
  * @param  server       the server that is hosting the service
  * @param  service      the service to add record for
+ * @param  keys         keys of the instance, service, proto and domain labels, NULL to key them here
  *
  * @return length of added data: 0 on error or length on success
  */
-static uint16_t _mdns_append_ptr_record(uint8_t *packet, uint16_t *index, const char *instance, const char *service, const char *proto, bool flush, bool bye)
+static uint16_t _mdns_append_ptr_record(uint8_t *packet, uint16_t *index, const char *instance, const char *service, const char *proto,
+                                        const mdns_name_dict_label_t *keys, bool flush, bool bye)
 {
     const char *str[4];
     uint16_t record_length = 0;
@@ -831,7 +1556,11 @@ static uint16_t _mdns_append_ptr_record(uint8_t *packet, uint16_t *index, const
     str[2] = proto;
     str[3] = MDNS_DEFAULT_DOMAIN;
 
-    part_length = _mdns_append_fqdn(packet, index, str + 1, 3, MDNS_MAX_PACKET_SIZE);
+    if (keys) {
+        part_length = _mdns_append_fqdn_keyed(packet, index, str + 1, keys + 1, 3, MDNS_MAX_PACKET_SIZE);
+    } else {
+        part_length = _mdns_append_fqdn(packet, index, str + 1, 3, MDNS_MAX_PACKET_SIZE);
+    }
     if (!part_length) {
         return 0;
     }
@@ -844,7 +1573,11 @@ static uint16_t _mdns_append_ptr_record(uint8_t *packet, uint16_t *index, const
     record_length += part_length;
 
     uint16_t data_len_location = *index - 2;
-    part_length = _mdns_append_fqdn(packet, index, str, 4, MDNS_MAX_PACKET_SIZE);
+    if (keys) {
+        part_length = _mdns_append_fqdn_keyed(packet, index, str, keys, 4, MDNS_MAX_PACKET_SIZE);
+    } else {
+        part_length = _mdns_append_fqdn(packet, index, str, 4, MDNS_MAX_PACKET_SIZE);
+    }
     if (!part_length) {
         return 0;
     }
@@ -861,13 +1594,14 @@ static uint16_t _mdns_append_ptr_record(uint8_t *packet, uint16_t *index, const
  * @param  instance     the service instance name
  * @param  subtype      the service subtype
  * @param  proto        the service protocol
+ * @param  keys         keys of the instance, service, proto and domain labels
  * @param  flush        whether to set the flush flag
  * @param  bye          whether to set the bye flag
  *
  * @return length of added data: 0 on error or length on success
  */
 static uint16_t _mdns_append_subtype_ptr_record(uint8_t *packet, uint16_t *index, const char *instance,
-        const char *subtype, const char *service, const char *proto, bool flush,
+        const char *subtype, const char *service, const char *proto, const mdns_name_dict_label_t *keys, bool flush,
         bool bye)
 {
     const char *subtype_str[5] = {subtype, MDNS_SUB_STR, service, proto, MDNS_DEFAULT_DOMAIN};
@@ -892,7 +1626,7 @@ static uint16_t _mdns_append_subtype_ptr_record(uint8_t *packet, uint16_t *index
     record_length += part_length;
 
     uint16_t data_len_location = *index - 2;
-    part_length = _mdns_append_fqdn(packet, index, instance_str, ARRAY_SIZE(instance_str), MDNS_MAX_PACKET_SIZE);
+    part_length = _mdns_append_fqdn_keyed(packet, index, instance_str, keys, ARRAY_SIZE(instance_str), MDNS_MAX_PACKET_SIZE);
     if (!part_length) {
         return 0;
     }
@@ -942,7 +1676,7 @@ static uint16_t _mdns_append_sdptr_record(uint8_t *packet, uint16_t *index, mdns
     record_length += part_length;
 
     uint16_t data_len_location = *index - 2;
-    part_length = _mdns_append_fqdn(packet, index, str, 3, MDNS_MAX_PACKET_SIZE);
+    part_length = _mdns_append_fqdn_keyed(packet, index, str, _mdns_service_wire(service)->name + 1, 3, MDNS_MAX_PACKET_SIZE);
     if (!part_length) {
         return 0;
     }
@@ -980,7 +1714,8 @@ static uint16_t _mdns_append_txt_record(uint8_t *packet, uint16_t *index, mdns_s
         return 0;
     }
 
-    part_length = _mdns_append_fqdn(packet, index, str, 4, MDNS_MAX_PACKET_SIZE);
+    const mdns_service_wire_t *wire = _mdns_service_wire(service);
+    part_length = _mdns_append_fqdn_keyed(packet, index, str, wire->name, 4, MDNS_MAX_PACKET_SIZE);
     if (!part_length) {
         return 0;
     }
@@ -993,23 +1728,17 @@ static uint16_t _mdns_append_txt_record(uint8_t *packet, uint16_t *index, mdns_s
     record_length += part_length;
 
     uint16_t data_len_location = *index - 2;
-    uint16_t data_len = 0;
-
-    mdns_txt_linked_item_t *txt = service->txt;
-    while (txt) {
-        int l = append_one_txt_record_entry(packet, index, txt);
-        if (l > 0) {
-            data_len += l;
-        } else if (l == 0) { // TXT entry won't fit into the mdns packet
-            return 0;
-        }
-        txt = txt->next;
+    // the TXT data of a service is kept as it goes on the wire, a single empty string if there are no items
+    uint16_t data_len = service->txt ? service->txt_len : 1;
+    if ((*index + data_len) >= MDNS_MAX_PACKET_SIZE) {
+        return 0;
     }
-    if (!data_len) {
-        data_len = 1;
+    if (service->txt) {
+        memcpy(packet + *index, service->txt, data_len);
+    } else {
         packet[*index] = 0;
-        *index = *index + 1;
     }
+    *index += data_len;
     _mdns_set_u16(packet, data_len_location, data_len);
     record_length += data_len;
     return record_length;
@@ -1044,7 +1773,8 @@ static uint16_t _mdns_append_srv_record(uint8_t *packet, uint16_t *index, mdns_s
         return 0;
     }
 
-    part_length = _mdns_append_fqdn(packet, index, str, 4, MDNS_MAX_PACKET_SIZE);
+    const mdns_service_wire_t *wire = _mdns_service_wire(service);
+    part_length = _mdns_append_fqdn_keyed(packet, index, str, wire->name, 4, MDNS_MAX_PACKET_SIZE);
     if (!part_length) {
         return 0;
     }
@@ -1058,13 +1788,11 @@ static uint16_t _mdns_append_srv_record(uint8_t *packet, uint16_t *index, mdns_s
 
     uint16_t data_len_location = *index - 2;
 
-    part_length = 0;
-    part_length += _mdns_append_u16(packet, index, service->priority);
-    part_length += _mdns_append_u16(packet, index, service->weight);
-    part_length += _mdns_append_u16(packet, index, service->port);
-    if (part_length != 6) {
+    if ((*index + sizeof(wire->srv)) >= MDNS_MAX_PACKET_SIZE) {
         return 0;
     }
+    memcpy(packet + *index, wire->srv, sizeof(wire->srv));
+    *index += sizeof(wire->srv);
 
     if (service->hostname) {
         str[0] = service->hostname;
@@ -1077,7 +1805,7 @@ static uint16_t _mdns_append_srv_record(uint8_t *packet, uint16_t *index, mdns_s
         return 0;
     }
 
-    part_length = _mdns_append_fqdn(packet, index, str, 2, MDNS_MAX_PACKET_SIZE);
+    part_length = _mdns_append_fqdn_keyed(packet, index, str, wire->host, 2, MDNS_MAX_PACKET_SIZE);
     if (!part_length) {
         return 0;
     }
@@ -1347,9 +2075,10 @@ static uint8_t _mdns_append_service_ptr_answers(uint8_t *packet, uint16_t *index
         bool bye)
 {
     uint8_t appended_answers = 0;
+    const mdns_service_wire_t *wire = _mdns_service_wire(service);
 
     if (_mdns_append_ptr_record(packet, index, _mdns_get_service_instance_name(service), service->service,
-                                service->proto, flush, bye) <= 0) {
+                                service->proto, wire->name, flush, bye) <= 0) {
         return appended_answers;
     }
     appended_answers++;
@@ -1358,7 +2087,7 @@ static uint8_t _mdns_append_service_ptr_answers(uint8_t *packet, uint16_t *index
     while (subtype) {
         appended_answers +=
             (_mdns_append_subtype_ptr_record(packet, index, _mdns_get_service_instance_name(service), subtype->subtype,
-                                             service->service, service->proto, flush, bye) > 0);
+                                             service->service, service->proto, wire->name, flush, bye) > 0);
         subtype = subtype->next;
     }
 
@@ -1398,7 +2127,7 @@ static uint8_t _mdns_append_answer(uint8_t *packet, uint16_t *index, mdns_out_an
         } else {
             return _mdns_append_ptr_record(packet, index,
                                            answer->custom_instance, answer->custom_service, answer->custom_proto,
-                                           answer->flush, answer->bye) > 0;
+                                           NULL, answer->flush, answer->bye) > 0;
         }
     } else if (answer->type == MDNS_TYPE_SRV) {
         return _mdns_append_srv_record(packet, index, answer->service, answer->flush, answer->bye) > 0;
@@ -1479,126 +2208,331 @@ static uint8_t _mdns_append_answer(uint8_t *packet, uint16_t *index, mdns_out_an
 }
 
 /**
- * @brief  sends a packet
+ * @brief  checks whether a record that did not fit into a packet fits into an empty one,
+ *         or is not written at all (e.g. the address of an interface that is down)
  *
- * @param  p       the packet
+ * The record is written to a static buffer, packets are only encoded on the mdns task.
  */
-static void _mdns_dispatch_tx_packet(mdns_tx_packet_t *p)
+static bool _mdns_answer_fits_empty_packet(mdns_out_answer_t *answer, mdns_if_t tcpip_if)
 {
-    static uint8_t packet[MDNS_MAX_PACKET_SIZE];
+    static uint8_t scratch[MDNS_MAX_PACKET_SIZE];
+    mdns_name_dict_t dict = s_name_dict;
     uint16_t index = MDNS_HEAD_LEN;
-    memset(packet, 0, MDNS_HEAD_LEN);
-    mdns_out_question_t *q;
-    mdns_out_answer_t *a;
-    uint8_t count;
+    bool fits = _mdns_append_answer(scratch, &index, answer, tcpip_if) > 0;
+    s_name_dict = dict;
+    return fits;
+}
+
+/**
+ * @brief  checks whether the record differs between the interfaces (the addresses of this host)
+ */
+static inline bool _mdns_answer_is_per_if(const mdns_out_answer_t *answer)
+{
+    return (answer->type == MDNS_TYPE_A || answer->type == MDNS_TYPE_AAAA) && answer->host == &_mdns_self_host;
+}
 
-    _mdns_set_u16(packet, MDNS_HEAD_FLAGS_OFFSET, p->flags);
-    _mdns_set_u16(packet, MDNS_HEAD_ID_OFFSET, p->id);
+/**
+ * @brief  starts a new packet, the first one carries the questions
+ *
+ * @param  scratch  memory to write the packet to, NULL to write it into a buffer of the networking layer
+ *
+ * @return false if out of memory
+ */
+static bool _mdns_tx_encoder_start(mdns_tx_encoder_t *e, mdns_tx_packet_t *p, uint8_t *scratch)
+{
+    uint8_t count = 0;
+    e->buf = NULL;
+    e->packet = scratch;
+    if (!scratch) {
+        e->buf = _mdns_udp_pcb_alloc(&e->packet);
+        if (!e->buf) {
+            return false;
+        }
+    }
+    e->index = MDNS_HEAD_LEN;
+    memset(e->counts, 0, sizeof(e->counts));
+    memset(e->packet, 0, MDNS_HEAD_LEN);
+    _mdns_name_dict_reset(e->packet);
+    _mdns_set_u16(e->packet, MDNS_HEAD_ID_OFFSET, p->id);
 
-    count = 0;
-    q = p->questions;
-    while (q) {
-        if (_mdns_append_question(packet, &index, q)) {
+    while (e->question) {
+        if (_mdns_append_question(e->packet, &e->index, e->question)) {
             count++;
         }
-        q = q->next;
+        e->question = e->question->next;
     }
-    _mdns_set_u16(packet, MDNS_HEAD_QUESTIONS_OFFSET, count);
+    _mdns_set_u16(e->packet, MDNS_HEAD_QUESTIONS_OFFSET, count);
+    return true;
+}
 
-    count = 0;
-    a = p->answers;
-    while (a) {
-        count += _mdns_append_answer(packet, &index, a, p->tcpip_if);
-        a = a->next;
+/**
+ * @brief  writes the records to the packet until it's full
+ *
+ * @param  shared   stop at the first record that differs between the interfaces
+ *
+ * @return true if the packet is full and the records continue in the next one
+ */
+static bool _mdns_tx_encoder_append(mdns_tx_encoder_t *e, mdns_tx_packet_t *p, mdns_if_t tcpip_if, bool shared)
+{
+    mdns_out_answer_t *sections[] = { p->answers, p->servers, p->additional };
+
+    for (;;) {
+        while (!e->answer && e->section < 2) {
+            e->answer = sections[++e->section];
+        }
+        if (!e->answer || (shared && _mdns_answer_is_per_if(e->answer))) {
+            return false;
+        }
+        uint16_t start = e->index;
+        uint8_t count = _mdns_append_answer(e->packet, &e->index, e->answer, tcpip_if);
+        if (count) {
+            e->counts[e->section] += count;
+        } else {
+            e->index = start;
+            _mdns_name_dict_truncate(start);
+            if (start > MDNS_HEAD_LEN && _mdns_answer_fits_empty_packet(e->answer, tcpip_if)) {
+                return true;
+            }
+        }
+        e->answer = e->answer->next;
     }
-    _mdns_set_u16(packet, MDNS_HEAD_ANSWERS_OFFSET, count);
+}
 
-    count = 0;
-    a = p->servers;
-    while (a) {
-        count += _mdns_append_answer(packet, &index, a, p->tcpip_if);
-        a = a->next;
+/**
+ * @brief  writes the record counts and flags to the header
+ */
+static void _mdns_tx_encoder_finish(mdns_tx_encoder_t *e, mdns_tx_packet_t *p, bool full)
+{
+    static const uint16_t count_offsets[] = { MDNS_HEAD_ANSWERS_OFFSET, MDNS_HEAD_SERVERS_OFFSET, MDNS_HEAD_ADDITIONAL_OFFSET };
+    uint16_t flags = p->flags;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        _mdns_set_u16(e->packet, count_offsets[i], e->counts[i]);
     }
-    _mdns_set_u16(packet, MDNS_HEAD_SERVERS_OFFSET, count);
+    if (full && !(flags & MDNS_FLAGS_QUERY_REPSONSE)) {
+        flags |= MDNS_FLAGS_TRUNCATED;
+    }
+    _mdns_set_u16(e->packet, MDNS_HEAD_FLAGS_OFFSET, flags);
+}
 
-    count = 0;
-    a = p->additional;
-    while (a) {
-        count += _mdns_append_answer(packet, &index, a, p->tcpip_if);
-        a = a->next;
+/**
+ * @brief  copies the packet written so far into a buffer of the networking layer
+ *
+ * @return false if out of memory
+ */
+static bool _mdns_tx_encoder_copy(mdns_tx_encoder_t *copy, const mdns_tx_encoder_t *e)
+{
+    *copy = *e;
+    copy->buf = _mdns_udp_pcb_alloc(&copy->packet);
+    if (!copy->buf) {
+        return false;
     }
-    _mdns_set_u16(packet, MDNS_HEAD_ADDITIONAL_OFFSET, count);
+    memcpy(copy->packet, e->packet, e->index);
+    return true;
+}
 
+/**
+ * @brief  hands the finished packet over to the networking layer, which owns the buffer from then on
+ */
+static void _mdns_tx_encoder_send(mdns_tx_encoder_t *e, mdns_tx_packet_t *p, mdns_tx_packet_t *dst, bool full)
+{
 #ifdef MDNS_ENABLE_DEBUG
-    _mdns_dbg_printf("\nTX[%lu][%lu]: ", (unsigned long)p->tcpip_if, (unsigned long)p->ip_protocol);
+    _mdns_dbg_printf("\nTX[%lu][%lu]: ", (unsigned long)dst->tcpip_if, (unsigned long)dst->ip_protocol);
 #ifdef CONFIG_LWIP_IPV4
-    if (p->dst.type == ESP_IPADDR_TYPE_V4) {
-        _mdns_dbg_printf("To: " IPSTR ":%u, ", IP2STR(&p->dst.u_addr.ip4), p->port);
+    if (dst->dst.type == ESP_IPADDR_TYPE_V4) {
+        _mdns_dbg_printf("To: " IPSTR ":%u, ", IP2STR(&dst->dst.u_addr.ip4), dst->port);
     }
 #endif
 #ifdef CONFIG_LWIP_IPV6
-    if (p->dst.type == ESP_IPADDR_TYPE_V6) {
-        _mdns_dbg_printf("To: " IPV6STR ":%u, ", IPV62STR(p->dst.u_addr.ip6), p->port);
+    if (dst->dst.type == ESP_IPADDR_TYPE_V6) {
+        _mdns_dbg_printf("To: " IPV6STR ":%u, ", IPV62STR(dst->dst.u_addr.ip6), dst->port);
     }
 #endif
-    mdns_debug_packet(packet, index);
+    mdns_debug_packet(e->packet, e->index);
 #endif
 
-    _mdns_udp_pcb_write(p->tcpip_if, p->ip_protocol, &p->dst, p->port, packet, index);
+    mdns_netif_stats_t *stats = _mdns_stats_netif(dst->tcpip_if, dst->ip_protocol);
+    if (_mdns_udp_pcb_send(dst->tcpip_if, dst->ip_protocol, &dst->dst, dst->port, e->buf, e->index)) {
+        stats->tx_packets++;
+        stats->tx_bytes += e->index;
+    } else {
+        stats->tx_failed++;
+    }
+    if (full) {
+        _mdns_server->coalesced.continued++;
+        if (!(p->flags & MDNS_FLAGS_QUERY_REPSONSE)) {
+            _mdns_server->coalesced.truncated++;
+        }
+    }
 }
 
 /**
- * @brief  frees a packet
- *
- * @param  packet       the packet
+ * @brief  writes the remaining records for the interface of the destination and sends them
  */
-static void _mdns_free_tx_packet(mdns_tx_packet_t *packet)
+static void _mdns_tx_encoder_complete(mdns_tx_encoder_t *e, mdns_tx_packet_t *p, mdns_tx_packet_t *dst)
 {
-    if (!packet) {
-        return;
-    }
-    mdns_out_question_t *q = packet->questions;
-    while (q) {
-        mdns_out_question_t *next = q->next;
-        if (q->own_dynamic_memory) {
-            free((char *)q->host);
-            free((char *)q->service);
-            free((char *)q->proto);
-            free((char *)q->domain);
-        }
-        free(q);
-        q = next;
-    }
-    queueFree(mdns_out_answer_t, packet->answers);
-    queueFree(mdns_out_answer_t, packet->servers);
-    queueFree(mdns_out_answer_t, packet->additional);
-    free(packet);
+    bool full;
+    do {
+        full = _mdns_tx_encoder_append(e, p, dst->tcpip_if, false);
+        _mdns_tx_encoder_finish(e, p, full);
+        _mdns_tx_encoder_send(e, p, dst, full);
+    } while (full && _mdns_tx_encoder_start(e, p, NULL));
 }
 
 /**
- * @brief  schedules a packet to be sent after given milliseconds
+ * @brief  sends the records of a packet to several destinations
  *
- * @param  packet       the packet
- * @param  ms_after     number of milliseconds after which the packet should be dispatched
+ * The packet is serialized straight into the buffer of the networking layer, which sends it without a copy.
+ * Records that do not fit continue in further packets, which carry no questions. A query announces
+ * that more of its known answers follow with the TC bit (RFC 6762 section 7.2), responses never set it (section 18.5).
+ *
+ * Only the addresses of this host differ between the interfaces. With several destinations the packets
+ * are written once to scratch memory, up to the first of the addresses, and copied for each destination,
+ * which writes the rest on its own.
+ *
+ * @param  p       the packet
+ * @param  dests   packets giving the interface, protocol, address and port of each destination
+ * @param  len     number of destinations
  */
-static void _mdns_schedule_tx_packet(mdns_tx_packet_t *packet, uint32_t ms_after)
+static void _mdns_encode_tx_packet_to(mdns_tx_packet_t *p, mdns_tx_packet_t *dests[], size_t len)
 {
-    if (!packet) {
-        return;
+    mdns_tx_encoder_t e;
+    mdns_tx_encoder_t copy;
+    uint8_t *scratch = NULL;
+
+    if (len > 1) {
+        scratch = (uint8_t *)malloc(MDNS_MAX_PACKET_SIZE);
+        if (!scratch) {
+            MDNS_MALLOC_FAILED;
+        }
     }
-    packet->send_at = (xTaskGetTickCount() * portTICK_PERIOD_MS) + ms_after;
-    packet->next = NULL;
-    if (!_mdns_server->tx_queue_head || _mdns_server->tx_queue_head->send_at > packet->send_at) {
-        packet->next = _mdns_server->tx_queue_head;
-        _mdns_server->tx_queue_head = packet;
+    if (!scratch) {
+        for (size_t i = 0; i < len; i++) {
+            e = (mdns_tx_encoder_t) {
+                .question = p->questions, .answer = p->answers
+            };
+            if (_mdns_tx_encoder_start(&e, p, NULL)) {
+                _mdns_tx_encoder_complete(&e, p, dests[i]);
+            }
+        }
         return;
     }
-    mdns_tx_packet_t *q = _mdns_server->tx_queue_head;
+
+    e = (mdns_tx_encoder_t) {
+        .question = p->questions, .answer = p->answers
+    };
+    for (;;) {
+        _mdns_tx_encoder_start(&e, p, scratch);
+        bool full = _mdns_tx_encoder_append(&e, p, dests[0]->tcpip_if, true);
+        if (!full && e.answer) {
+            break;
+        }
+        _mdns_tx_encoder_finish(&e, p, full);
+        for (size_t i = 0; i < len; i++) {
+            if (_mdns_tx_encoder_copy(&copy, &e)) {
+                _mdns_tx_encoder_send(&copy, p, dests[i], full);
+            }
+        }
+        _mdns_server->coalesced.fanned_out += len - 1;
+        if (!full) {
+            free(scratch);
+            return;
+        }
+    }
+
+    mdns_name_dict_t dict = s_name_dict;
+    for (size_t i = 0; i < len; i++) {
+        if (_mdns_tx_encoder_copy(&copy, &e)) {
+            s_name_dict = dict;
+            s_name_dict.packet = copy.packet;
+            _mdns_tx_encoder_complete(&copy, p, dests[i]);
+        }
+    }
+    _mdns_server->coalesced.fanned_out += len - 1;
+    free(scratch);
+}
+
+/**
+ * @brief  sends the records of a packet to several destinations, see _mdns_encode_tx_packet_to()
+ */
+static void _mdns_dispatch_tx_packet_to(mdns_tx_packet_t *p, mdns_tx_packet_t *dests[], size_t len)
+{
+    int64_t start = esp_timer_get_time();
+    _mdns_encode_tx_packet_to(p, dests, len);
+    _mdns_stats_latency(_mdns_server->stats.answer_us, start);
+}
+
+/**
+ * @brief  sends a packet
+ *
+ * @param  p       the packet
+ */
+static void _mdns_dispatch_tx_packet(mdns_tx_packet_t *p)
+{
+    _mdns_dispatch_tx_packet_to(p, &p, 1);
+}
+
+/**
+ * @brief  frees a packet
+ *
+ * @param  packet       the packet
+ */
+static void _mdns_free_tx_packet(mdns_tx_packet_t *packet)
+{
+    if (!packet) {
+        return;
+    }
+    mdns_out_question_t *q = packet->questions;
+    while (q) {
+        mdns_out_question_t *next = q->next;
+        if (q->own_dynamic_memory) {
+            free((char *)q->host);
+            free((char *)q->service);
+            free((char *)q->proto);
+            free((char *)q->domain);
+        }
+        free(q);
+        q = next;
+    }
+    queueFree(mdns_out_answer_t, packet->answers);
+    queueFree(mdns_out_answer_t, packet->servers);
+    queueFree(mdns_out_answer_t, packet->additional);
+    free(packet);
+}
+
+/**
+ * @brief  schedules a packet to be sent after given milliseconds
+ *
+ * @param  packet       the packet
+ * @param  ms_after     number of milliseconds after which the packet should be dispatched
+ */
+static void _mdns_schedule_tx_packet(mdns_tx_packet_t *packet, uint32_t ms_after)
+{
+    if (!packet) {
+        return;
+    }
+    packet->send_at = (xTaskGetTickCount() * portTICK_PERIOD_MS) + ms_after;
+    packet->next = NULL;
+    if (!_mdns_server->tx_queue_head || _mdns_server->tx_queue_head->send_at > packet->send_at) {
+        packet->next = _mdns_server->tx_queue_head;
+        _mdns_server->tx_queue_head = packet;
+        _mdns_timer_arm();
+        return;
+    }
+    mdns_tx_packet_t *q = _mdns_server->tx_queue_head;
+    uint32_t queued = 2;
     while (q->next && q->next->send_at <= packet->send_at) {
         q = q->next;
+        queued++;
     }
     packet->next = q->next;
     q->next = packet;
+    for (q = packet->next; q; q = q->next) {
+        queued++;
+    }
+    if (queued > _mdns_server->stats.tx_queue_max) {
+        _mdns_server->stats.tx_queue_max = queued;
+    }
 }
 
 /**
@@ -1665,7 +2599,7 @@ static mdns_tx_packet_t *_mdns_get_next_pcb_packet(mdns_if_t tcpip_if, mdns_ip_p
  */
 static void _mdns_remove_scheduled_answer(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint16_t type, mdns_srv_item_t *service)
 {
-    mdns_srv_item_t s = {NULL, NULL};
+    mdns_srv_item_t s = { .service = NULL };
     if (!service) {
         service = &s;
     }
@@ -1703,7 +2637,7 @@ static void _mdns_dealloc_answer(mdns_out_answer_t **destination, uint16_t type,
     if (!d) {
         return;
     }
-    mdns_srv_item_t s = {NULL, NULL};
+    mdns_srv_item_t s = { .service = NULL };
     if (!service) {
         service = &s;
     }
@@ -1739,13 +2673,15 @@ static bool _mdns_alloc_answer(mdns_out_answer_t **destination, uint16_t type, m
 
     mdns_out_answer_t *a = (mdns_out_answer_t *)malloc(sizeof(mdns_out_answer_t));
     if (!a) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return false;
     }
     a->type = type;
     a->service = service;
     a->host = host;
+    a->custom_instance = NULL;
     a->custom_service = NULL;
+    a->custom_proto = NULL;
     a->bye = bye;
     a->flush = flush;
     a->next = NULL;
@@ -1760,7 +2696,7 @@ static mdns_tx_packet_t *_mdns_alloc_packet_default(mdns_if_t tcpip_if, mdns_ip_
 {
     mdns_tx_packet_t *packet = (mdns_tx_packet_t *)malloc(sizeof(mdns_tx_packet_t));
     if (!packet) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return NULL;
     }
     memset((uint8_t *)packet, 0, sizeof(mdns_tx_packet_t));
@@ -1838,7 +2774,7 @@ static bool _mdns_service_match_ptr_question(const mdns_service_t *service, cons
     if (question->sub) {
         mdns_subtype_t *subtype = service->subtype;
         while (subtype) {
-            if (!strcasecmp(subtype->subtype, question->host)) {
+            if (_mdns_str_equal(subtype->subtype, question->host)) {
                 return true;
             }
             subtype = subtype->next;
@@ -1846,13 +2782,175 @@ static bool _mdns_service_match_ptr_question(const mdns_service_t *service, cons
         return false;
     }
     if (question->host) {
-        if (strcasecmp(_mdns_get_service_instance_name(service), question->host) != 0) {
+        if (!_mdns_str_equal(_mdns_get_service_instance_name(service), question->host)) {
             return false;
         }
     }
     return true;
 }
 
+/**
+ * @brief  Checks whether a known answer of the querier still has at least half of the TTL we would answer with,
+ *         which suppresses our answer (RFC 6762 section 7.1)
+ */
+static bool _mdns_known_answer_is_fresh(uint16_t type, uint32_t ttl)
+{
+    uint32_t full_ttl;
+    switch (type) {
+    case MDNS_TYPE_PTR:
+    case MDNS_TYPE_SDPTR:
+        full_ttl = MDNS_ANSWER_PTR_TTL;
+        break;
+    case MDNS_TYPE_TXT:
+        full_ttl = MDNS_ANSWER_TXT_TTL;
+        break;
+    case MDNS_TYPE_SRV:
+        full_ttl = MDNS_ANSWER_SRV_TTL;
+        break;
+    case MDNS_TYPE_AAAA:
+        full_ttl = MDNS_ANSWER_AAAA_TTL;
+        break;
+    default:
+        full_ttl = MDNS_ANSWER_A_TTL;
+        break;
+    }
+    return ttl >= full_ttl / 2;
+}
+
+/**
+ * @brief  Finds the entry of a record multicast on the interface, or the entry to be replaced by it
+ */
+static mdns_multicast_record_t *_mdns_multicast_record_get(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol,
+        const mdns_out_answer_t *answer, bool *found)
+{
+    for (size_t i = 0; i < MDNS_MULTICAST_RECORDS; i++) {
+        mdns_multicast_record_t *r = &_mdns_server->multicast_records[i];
+        if (r->type == answer->type && r->service == answer->service && r->host == answer->host
+                && r->tcpip_if == tcpip_if && r->ip_protocol == ip_protocol) {
+            *found = true;
+            return r;
+        }
+    }
+    *found = false;
+    mdns_multicast_record_t *r = &_mdns_server->multicast_records[_mdns_server->multicast_records_next];
+    _mdns_server->multicast_records_next = (_mdns_server->multicast_records_next + 1) % MDNS_MULTICAST_RECORDS;
+    return r;
+}
+
+/**
+ * @brief  Forgets the records multicast for a service or host which is being freed,
+ *         so that another one allocated at its address is not suppressed
+ */
+static void _mdns_forget_multicast_records(const mdns_service_t *service, const mdns_host_item_t *host)
+{
+    for (size_t i = 0; i < MDNS_MULTICAST_RECORDS; i++) {
+        mdns_multicast_record_t *r = &_mdns_server->multicast_records[i];
+        if ((service && r->service == service) || (host && r->host == host)) {
+            r->type = 0;
+            r->service = NULL;
+            r->host = NULL;
+        }
+    }
+}
+
+/**
+ * @brief  Removes answers of a multicast response which are already scheduled on the interface
+ *         in response to the same question from another querier (RFC 6762 section 7.3),
+ *         or which were multicast there less than a second ago (section 6); remembers the others
+ *
+ * @param  packet       the response
+ * @param  send_at      time the response is going to be sent at
+ */
+static void _mdns_suppress_multicast_answers(mdns_tx_packet_t *packet, uint32_t send_at)
+{
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    mdns_out_answer_t **a = &packet->answers;
+    while (*a) {
+        bool found;
+        mdns_multicast_record_t *r = _mdns_multicast_record_get(packet->tcpip_if, packet->ip_protocol, *a, &found);
+        int32_t since = (int32_t)(now - r->sent_at);
+        if (found && since < MDNS_MULTICAST_INTERVAL_MS) {
+            if (since < 0) {
+                _mdns_server->suppressed.duplicate++;
+            } else {
+                _mdns_server->suppressed.rate_limited++;
+            }
+            mdns_out_answer_t *d = *a;
+            *a = d->next;
+            free(d);
+            continue;
+        }
+        r->sent_at = send_at;
+        r->type = (*a)->type;
+        r->service = (*a)->service;
+        r->host = (*a)->host;
+        r->tcpip_if = packet->tcpip_if;
+        r->ip_protocol = packet->ip_protocol;
+        a = &(*a)->next;
+    }
+}
+
+/**
+ * @brief  Finds a multicast response scheduled on the interface, which the shared answers of a new response can join
+ *
+ * The answers are sent when that response is due, so it must be due within the delay allowed for shared answers.
+ */
+static mdns_tx_packet_t *_mdns_find_coalescable_packet(mdns_tx_packet_t *packet, uint32_t now)
+{
+    if (packet->questions || _mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].state != PCB_RUNNING) {
+        return NULL;
+    }
+    mdns_tx_packet_t *q = _mdns_server->tx_queue_head;
+    while (q) {
+        int32_t due_in = (int32_t)(q->send_at - now);
+        if (due_in > MDNS_TX_COALESCE_MAX_MS) {
+            break;
+        }
+        if (due_in >= MDNS_TX_COALESCE_MIN_MS && q->tcpip_if == packet->tcpip_if && q->ip_protocol == packet->ip_protocol
+                && !q->questions && q->flags == packet->flags && q->distributed == packet->distributed
+                && q->port == packet->port && !memcmp(&q->dst, &packet->dst, sizeof(esp_ip_addr_t))) {
+            return q;
+        }
+        q = q->next;
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Moves the records to the end of the destination list, dropping those already in it
+ */
+static void _mdns_merge_answers(mdns_out_answer_t **destination, mdns_out_answer_t *answers)
+{
+    while (answers) {
+        mdns_out_answer_t *a = answers;
+        answers = a->next;
+        a->next = NULL;
+        mdns_out_answer_t **d = destination;
+        while (*d && !((*d)->type == a->type && (*d)->service == a->service && (*d)->host == a->host
+                       && !(*d)->custom_service && !a->custom_service)) {
+            d = &(*d)->next;
+        }
+        if (*d) {
+            free(a);
+        } else {
+            *d = a;
+        }
+    }
+}
+
+/**
+ * @brief  Sends the answers of a response with another response scheduled on the interface, frees the response
+ */
+static void _mdns_merge_tx_packet(mdns_tx_packet_t *destination, mdns_tx_packet_t *packet)
+{
+    _mdns_merge_answers(&destination->answers, packet->answers);
+    _mdns_merge_answers(&destination->servers, packet->servers);
+    _mdns_merge_answers(&destination->additional, packet->additional);
+    packet->answers = packet->servers = packet->additional = NULL;
+    _mdns_free_tx_packet(packet);
+    _mdns_server->coalesced.merged++;
+}
+
 /**
  * @brief  Create answer packet to questions from parsed packet
  */
@@ -1885,26 +2983,29 @@ static void _mdns_create_answer_from_parsed_packet(mdns_parsed_packet_t *parsed_
                 out_record_nums++;
             }
         } else if (q->service && q->proto) {
-            mdns_srv_item_t *service = _mdns_server->services;
+            // only services of the questioned type can match, walk just their lookup bucket
+            mdns_srv_item_t *service = _mdns_server->service_index[MDNS_SRV_INDEX_TYPE][_mdns_name_hash(q->service, q->proto, NULL)];
             while (service) {
                 if (_mdns_service_match_ptr_question(service->service, q)) {
                     mdns_parsed_record_t *r = parsed_packet->records;
                     bool is_record_exist = false;
                     while (r) {
                         if (service->service->instance && r->host) {
-                            if (_mdns_service_match_instance(service->service, r->host, r->service, r->proto, NULL) && r->ttl > (MDNS_ANSWER_PTR_TTL / 2)) {
+                            if (_mdns_service_match_instance(service->service, r->host, r->service, r->proto, NULL) && _mdns_known_answer_is_fresh(MDNS_TYPE_PTR, r->ttl)) {
                                 is_record_exist = true;
                                 break;
                             }
                         } else if (!service->service->instance && !r->host) {
-                            if (_mdns_service_match(service->service, r->service, r->proto, NULL) && r->ttl > (MDNS_ANSWER_PTR_TTL / 2)) {
+                            if (_mdns_service_match(service->service, r->service, r->proto, NULL) && _mdns_known_answer_is_fresh(MDNS_TYPE_PTR, r->ttl)) {
                                 is_record_exist = true;
                                 break;
                             }
                         }
                         r = r->next;
                     }
-                    if (!is_record_exist) {
+                    if (is_record_exist) {
+                        _mdns_server->suppressed.known_answer++;
+                    } else {
                         if (!_mdns_create_answer_from_service(packet, service->service, q, shared, send_flush)) {
                             _mdns_free_tx_packet(packet);
                             return;
@@ -1913,7 +3014,7 @@ static void _mdns_create_answer_from_parsed_packet(mdns_parsed_packet_t *parsed_
                         }
                     }
                 }
-                service = service->next;
+                service = service->hash_next[MDNS_SRV_INDEX_TYPE];
             }
         } else if (q->type == MDNS_TYPE_A || q->type == MDNS_TYPE_AAAA) {
             if (!_mdns_create_answer_from_hostname(packet, q->host, send_flush)) {
@@ -1954,23 +3055,26 @@ static void _mdns_create_answer_from_parsed_packet(mdns_parsed_packet_t *parsed_
                 )) {
             mdns_out_question_t *out_question = malloc(sizeof(mdns_out_question_t));
             if (out_question == NULL) {
-                HOOK_MALLOC_FAILED;
+                MDNS_MALLOC_FAILED;
                 _mdns_free_tx_packet(packet);
                 return;
             }
             out_question->type = q->type;
             out_question->unicast = q->unicast;
-            out_question->host = q->host;
-            q->host = NULL;
-            out_question->service = q->service;
-            q->service = NULL;
-            out_question->proto = q->proto;
-            q->proto = NULL;
-            out_question->domain = q->domain;
-            q->domain = NULL;
+            // the parsed question lives in the parser arena, the packet needs its own copy
+            out_question->host = q->host ? strdup(q->host) : NULL;
+            out_question->service = q->service ? strdup(q->service) : NULL;
+            out_question->proto = q->proto ? strdup(q->proto) : NULL;
+            out_question->domain = q->domain ? strdup(q->domain) : NULL;
             out_question->next = NULL;
             out_question->own_dynamic_memory = true;
             queueToEnd(mdns_out_question_t, packet->questions, out_question);
+            if ((q->host && !out_question->host) || (q->service && !out_question->service)
+                    || (q->proto && !out_question->proto) || (q->domain && !out_question->domain)) {
+                MDNS_MALLOC_FAILED;
+                _mdns_free_tx_packet(packet);
+                return;
+            }
         }
         if (q->unicast) {
             unicast = true;
@@ -1987,8 +3091,24 @@ static void _mdns_create_answer_from_parsed_packet(mdns_parsed_packet_t *parsed_
     }
 
     static uint8_t share_step = 0;
-    if (shared) {
-        _mdns_schedule_tx_packet(packet, 25 + (share_step * 25));
+    uint32_t delay = shared ? 25 + (share_step * 25) : 0;
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    uint32_t send_at = now + delay;
+    mdns_tx_packet_t *scheduled = shared ? _mdns_find_coalescable_packet(packet, now) : NULL;
+    if (scheduled) {
+        send_at = scheduled->send_at;
+    }
+    if (!unicast && send_flush && !parsed_packet->probe) {
+        _mdns_suppress_multicast_answers(packet, send_at);
+        if (!packet->answers) {
+            _mdns_free_tx_packet(packet);
+            return;
+        }
+    }
+    if (scheduled) {
+        _mdns_merge_tx_packet(scheduled, packet);
+    } else if (shared) {
+        _mdns_schedule_tx_packet(packet, delay);
         share_step = (share_step + 1) & 0x03;
     } else {
         _mdns_dispatch_tx_packet(packet);
@@ -2065,7 +3185,7 @@ static bool _mdns_append_host_question(mdns_out_question_t **questions, const ch
 {
     mdns_out_question_t *q = (mdns_out_question_t *)malloc(sizeof(mdns_out_question_t));
     if (!q) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return false;
     }
     q->next = NULL;
@@ -2113,7 +3233,7 @@ static mdns_tx_packet_t *_mdns_create_probe_packet(mdns_if_t tcpip_if, mdns_ip_p
     for (i = 0; i < len; i++) {
         mdns_out_question_t *q = (mdns_out_question_t *)malloc(sizeof(mdns_out_question_t));
         if (!q) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             _mdns_free_tx_packet(packet);
             return NULL;
         }
@@ -2204,6 +3324,14 @@ static mdns_tx_packet_t *_mdns_create_announce_from_probe(mdns_tx_packet_t *prob
                 _mdns_free_tx_packet(packet);
                 return NULL;
             }
+        }
+        s = s->next;
+    }
+
+    // addresses last, so that the service records are the same on all interfaces up to them
+    s = probe->servers;
+    while (s) {
+        if (s->type == MDNS_TYPE_SRV) {
             mdns_host_item_t *host = mdns_get_host_item(s->service->hostname);
             if (!_mdns_alloc_answer(&packet->answers, MDNS_TYPE_A, NULL, host, true, false)
                     || !_mdns_alloc_answer(&packet->answers, MDNS_TYPE_AAAA, NULL, host, true, false)) {
@@ -2224,25 +3352,37 @@ static mdns_tx_packet_t *_mdns_create_announce_from_probe(mdns_tx_packet_t *prob
 }
 
 /**
- * @brief  Send by for particular services on particular PCB
+ * @brief  Create bye packet for particular services on particular PCB
  */
-static void _mdns_pcb_send_bye(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, mdns_srv_item_t **services, size_t len, bool include_ip)
+static mdns_tx_packet_t *_mdns_create_bye_packet(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, mdns_srv_item_t **services, size_t len, bool include_ip)
 {
     mdns_tx_packet_t *packet = _mdns_alloc_packet_default(tcpip_if, ip_protocol);
     if (!packet) {
-        return;
+        return NULL;
     }
     packet->flags = MDNS_FLAGS_QR_AUTHORITATIVE;
     size_t i;
     for (i = 0; i < len; i++) {
         if (!_mdns_alloc_answer(&packet->answers, MDNS_TYPE_PTR, services[i]->service, NULL, true, true)) {
             _mdns_free_tx_packet(packet);
-            return;
+            return NULL;
         }
     }
     if (include_ip) {
         _mdns_append_host_list_in_services(&packet->answers, services, len, true, true);
     }
+    return packet;
+}
+
+/**
+ * @brief  Send by for particular services on particular PCB
+ */
+static void _mdns_pcb_send_bye(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, mdns_srv_item_t **services, size_t len, bool include_ip)
+{
+    mdns_tx_packet_t *packet = _mdns_create_bye_packet(tcpip_if, ip_protocol, services, len, include_ip);
+    if (!packet) {
+        return;
+    }
     _mdns_dispatch_tx_packet(packet);
     _mdns_free_tx_packet(packet);
 }
@@ -2262,7 +3402,7 @@ static void _mdns_init_pcb_probe_new_service(mdns_if_t tcpip_if, mdns_ip_protoco
     if (services_final_len) {
         _services = (mdns_srv_item_t **)malloc(sizeof(mdns_srv_item_t *) * services_final_len);
         if (!_services) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             return;
         }
 
@@ -2295,7 +3435,8 @@ static void _mdns_init_pcb_probe_new_service(mdns_if_t tcpip_if, mdns_ip_protoco
     pcb->probe_services = _services;
     pcb->probe_services_len = services_final_len;
     pcb->probe_running = true;
-    _mdns_schedule_tx_packet(packet, ((pcb->failed_probes > 5) ? 1000 : 120) + (esp_random() & 0x7F));
+    uint32_t jitter = _mdns_probe_all_jitter < 0 ? (esp_random() & 0x7F) : (uint32_t)_mdns_probe_all_jitter;
+    _mdns_schedule_tx_packet(packet, ((pcb->failed_probes > 5) ? 1000 : 120) + jitter);
     pcb->state = PCB_PROBE_1;
 }
 
@@ -2374,13 +3515,26 @@ static void _mdns_send_bye(mdns_srv_item_t **services, size_t len, bool include_
         return;
     }
 
+    mdns_tx_packet_t *dests[MDNS_MAX_INTERFACES * MDNS_IP_PROTOCOL_MAX];
+    size_t count = 0;
     for (i = 0; i < MDNS_MAX_INTERFACES; i++) {
         for (j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
             if (mdns_is_netif_ready(i, j) && _mdns_server->interfaces[i].pcbs[j].state == PCB_RUNNING) {
-                _mdns_pcb_send_bye((mdns_if_t)i, (mdns_ip_protocol_t)j, services, len, include_ip);
+                // the records are the same on all PCBs, the others only give the destination
+                mdns_tx_packet_t *packet = count ? _mdns_alloc_packet_default((mdns_if_t)i, (mdns_ip_protocol_t)j)
+                                           : _mdns_create_bye_packet((mdns_if_t)i, (mdns_ip_protocol_t)j, services, len, include_ip);
+                if (packet) {
+                    dests[count++] = packet;
+                }
             }
         }
     }
+    if (count) {
+        _mdns_dispatch_tx_packet_to(dests[0], dests, count);
+    }
+    for (i = 0; i < count; i++) {
+        _mdns_free_tx_packet(dests[i]);
+    }
 }
 
 /**
@@ -2428,10 +3582,13 @@ static void _mdns_announce_pcb(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protoco
 
 /**
  * @brief  Send probe on all active PCBs
+ *
+ * The PCBs wait for the same random delay, so that their probes are sent, and encoded, together.
  */
 static void _mdns_probe_all_pcbs(mdns_srv_item_t **services, size_t len, bool probe_ip, bool clear_old_probe)
 {
     uint8_t i, j;
+    _mdns_probe_all_jitter = esp_random() & 0x7F;
     for (i = 0; i < MDNS_MAX_INTERFACES; i++) {
         for (j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
             if (mdns_is_netif_ready(i, j)) {
@@ -2446,6 +3603,7 @@ static void _mdns_probe_all_pcbs(mdns_srv_item_t **services, size_t len, bool pr
             }
         }
     }
+    _mdns_probe_all_jitter = -1;
 }
 
 /**
@@ -2568,118 +3726,273 @@ static void _mdns_restart_all_pcbs(void)
 
 
 /**
- * @brief  creates/allocates new text item list
- * @param  num_items     service number of txt items or 0
- * @param  txt           service txt items array or NULL
+ * @brief  Returns the shared copy of a string, adding it to the string table if not there yet
+ *
+ * @param  str           the string, truncated to MDNS_NAME_BUF_LEN - 1 characters
  *
- * @return pointer to the linked txt item list or NULL
+ * @return the shared copy, to be released by _mdns_str_release(), or NULL if out of memory
  */
-static mdns_txt_linked_item_t *_mdns_allocate_txt(size_t num_items, mdns_txt_item_t txt[])
+static const char *_mdns_str_intern(const char *str)
 {
-    mdns_txt_linked_item_t *new_txt = NULL;
-    size_t i = 0;
-    if (num_items) {
-        for (i = 0; i < num_items; i++) {
-            mdns_txt_linked_item_t *new_item = (mdns_txt_linked_item_t *)malloc(sizeof(mdns_txt_linked_item_t));
-            if (!new_item) {
-                HOOK_MALLOC_FAILED;
-                break;
-            }
-            new_item->key = strdup(txt[i].key);
-            if (!new_item->key) {
-                free(new_item);
-                break;
-            }
-            new_item->value = strdup(txt[i].value);
-            if (!new_item->value) {
-                free((char *)new_item->key);
-                free(new_item);
-                break;
-            }
-            new_item->value_len = strlen(new_item->value);
-            new_item->next = new_txt;
-            new_txt = new_item;
+    size_t len = strnlen(str, MDNS_NAME_BUF_LEN - 1);
+    mdns_str_t *s = _mdns_strings;
+    while (s) {
+        if (!strncmp(s->str, str, len) && !s->str[len] && s->refs < UINT16_MAX) {
+            s->refs++;
+            return s->str;
         }
+        s = s->next;
+    }
+    s = (mdns_str_t *)malloc(sizeof(mdns_str_t) + len + 1);
+    if (!s) {
+        MDNS_MALLOC_FAILED;
+        return NULL;
     }
-    return new_txt;
+    memcpy(s->str, str, len);
+    s->str[len] = 0;
+    s->refs = 1;
+    s->next = _mdns_strings;
+    _mdns_strings = s;
+    return s->str;
 }
 
 /**
- * @brief Deallocate the txt linked list
- * @param txt pointer to the txt pointer to free, noop if txt==NULL
+ * @brief  Drops a reference to a shared string, freeing it with the last one
+ *
+ * @param  str           the shared copy returned by _mdns_str_intern(), noop if NULL
  */
-static void _mdns_free_linked_txt(mdns_txt_linked_item_t *txt)
+static void _mdns_str_release(const char *str)
 {
-    mdns_txt_linked_item_t *t;
-    while (txt) {
-        t = txt;
-        txt = txt->next;
-        free((char *)t->value);
-        free((char *)t->key);
-        free(t);
+    mdns_str_t **s = &_mdns_strings;
+    if (!str) {
+        return;
+    }
+    while (*s && (*s)->str != str) {
+        s = &(*s)->next;
+    }
+    if (*s && !--(*s)->refs) {
+        mdns_str_t *unused = *s;
+        *s = unused->next;
+        free(unused);
     }
 }
 
 /**
- * @brief  creates/allocates new service
- * @param  service       service type
- * @param  proto         service proto
- * @param  hostname      service hostname
- * @param  port          service port
- * @param  instance      service instance
- * @param  num_items     service number of txt items or 0
- * @param  txt           service txt items array or NULL
+ * @brief  Length of a TXT item ("key=value" or "key") on the wire, without its length byte
+ */
+static inline size_t _mdns_txt_item_len(const char *key, const char *value, size_t value_len)
+{
+    return strlen(key) + (value ? value_len + 1 : 0);
+}
+
+/**
+ * @brief  Writes a TXT item prefixed by its length
  *
- * @return pointer to the service or NULL on error
+ * @return the end of the written item
  */
-static mdns_service_t *_mdns_create_service(const char *service, const char *proto, const char *hostname,
-        uint16_t port, const char *instance, size_t num_items,
-        mdns_txt_item_t txt[])
+static uint8_t *_mdns_txt_item_write(uint8_t *out, const char *key, const char *value, uint8_t value_len)
 {
-    mdns_service_t *s = (mdns_service_t *)calloc(1, sizeof(mdns_service_t));
-    if (!s) {
-        HOOK_MALLOC_FAILED;
-        return NULL;
+    size_t key_len = strlen(key);
+    *out++ = _mdns_txt_item_len(key, value, value_len);
+    memcpy(out, key, key_len);
+    out += key_len;
+    if (value) {
+        *out++ = '=';
+        memcpy(out, value, value_len);
+        out += value_len;
     }
+    return out;
+}
 
-    mdns_txt_linked_item_t *new_txt = _mdns_allocate_txt(num_items, txt);
-    if (num_items && new_txt == NULL) {
-        goto fail;
+/**
+ * @brief  Finds a TXT item by its key
+ *
+ * @return offset of the length byte of the item or -1 if not found
+ */
+static int _mdns_txt_item_find(const uint8_t *txt, uint16_t txt_len, const char *key)
+{
+    size_t key_len = strlen(key);
+    uint16_t i = 0;
+    while (i < txt_len) {
+        uint8_t len = txt[i];
+        if (len >= key_len && !memcmp(txt + i + 1, key, key_len) && (len == key_len || txt[i + 1 + key_len] == '=')) {
+            return i;
+        }
+        i += 1 + len;
     }
+    return -1;
+}
 
-    s->priority = 0;
-    s->weight = 0;
-    s->instance = instance ? strndup(instance, MDNS_NAME_BUF_LEN - 1) : NULL;
-    s->txt = new_txt;
-    s->port = port;
-    s->subtype = NULL;
-
-    if (hostname) {
-        s->hostname = strndup(hostname, MDNS_NAME_BUF_LEN - 1);
-        if (!s->hostname) {
-            goto fail;
+/**
+ * @brief  creates the TXT data of a service from its items, encoded as it goes on the wire
+ *
+ * The items are written last first, the order they have always been sent in.
+ *
+ * @param  num_items     service number of txt items or 0
+ * @param  txt           service txt items array or NULL
+ * @param  txt_data      the created data, NULL without items
+ * @param  txt_len       length of the created data
+ *
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if an item is too long or the items do not fit a packet
+ *     - ESP_ERR_NO_MEM memory error
+ */
+static esp_err_t _mdns_allocate_txt(size_t num_items, mdns_txt_item_t txt[], uint8_t **txt_data, uint16_t *txt_len)
+{
+    size_t len = 0;
+    *txt_data = NULL;
+    *txt_len = 0;
+    for (size_t i = 0; i < num_items; i++) {
+        size_t item_len = _mdns_txt_item_len(txt[i].key, txt[i].value, txt[i].value ? strlen(txt[i].value) : 0);
+        if (item_len > UINT8_MAX) {
+            ESP_LOGE(TAG, "TXT item %s is too long", txt[i].key);
+            return ESP_ERR_INVALID_ARG;
         }
-    } else {
-        s->hostname = NULL;
+        len += 1 + item_len;
     }
-
-    s->service = strndup(service, MDNS_NAME_BUF_LEN - 1);
-    if (!s->service) {
+    if (!len) {
+        return ESP_OK;
+    }
+    if (len >= MDNS_MAX_PACKET_SIZE) {
+        ESP_LOGE(TAG, "TXT items do not fit a packet");
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t *data = (uint8_t *)malloc(len);
+    if (!data) {
+        MDNS_MALLOC_FAILED;
+        return ESP_ERR_NO_MEM;
+    }
+    uint8_t *out = data + len;
+    for (size_t i = 0; i < num_items; i++) {
+        size_t value_len = txt[i].value ? strlen(txt[i].value) : 0;
+        out -= 1 + _mdns_txt_item_len(txt[i].key, txt[i].value, value_len);
+        _mdns_txt_item_write(out, txt[i].key, txt[i].value, value_len);
+    }
+    *txt_data = data;
+    *txt_len = len;
+    return ESP_OK;
+}
+
+/**
+ * @brief  Sets a TXT item of a service, replacing the item with the same key or adding it first
+ *
+ * @param  service       the service
+ * @param  key           key of the item
+ * @param  value         value of the item or NULL for an item without a value
+ * @param  value_len     length of the value
+ *
+ * @return
+ *     - ESP_OK on success
+ *     - ESP_ERR_INVALID_ARG if the item or the TXT data get too long
+ *     - ESP_ERR_NO_MEM memory error
+ */
+static esp_err_t _mdns_txt_item_set(mdns_service_t *service, const char *key, const char *value, uint8_t value_len)
+{
+    size_t item_len = _mdns_txt_item_len(key, value, value_len);
+    if (item_len > UINT8_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int at = service->txt ? _mdns_txt_item_find(service->txt, service->txt_len, key) : -1;
+    size_t replaced_len = at < 0 ? 0 : 1 + service->txt[at];
+    size_t len = service->txt_len - replaced_len + 1 + item_len;
+    if (len >= MDNS_MAX_PACKET_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (at < 0) {
+        at = 0;
+    }
+    uint8_t *txt = (uint8_t *)malloc(len);
+    if (!txt) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (service->txt) {
+        memcpy(txt, service->txt, at);
+    }
+    uint8_t *end = _mdns_txt_item_write(txt + at, key, value, value_len);
+    if (service->txt) {
+        memcpy(end, service->txt + at + replaced_len, service->txt_len - at - replaced_len);
+    }
+    free(service->txt);
+    service->txt = txt;
+    service->txt_len = len;
+    return ESP_OK;
+}
+
+/**
+ * @brief  Removes a TXT item of a service, noop if the service does not have it
+ */
+static void _mdns_txt_item_remove(mdns_service_t *service, const char *key)
+{
+    int at = service->txt ? _mdns_txt_item_find(service->txt, service->txt_len, key) : -1;
+    if (at < 0) {
+        return;
+    }
+    size_t item_len = 1 + service->txt[at];
+    memmove(service->txt + at, service->txt + at + item_len, service->txt_len - at - item_len);
+    service->txt_len -= item_len;
+    if (!service->txt_len) {
+        free(service->txt);
+        service->txt = NULL;
+    }
+}
+
+/**
+ * @brief  creates/allocates new service
+ * @param  service       service type
+ * @param  proto         service proto
+ * @param  hostname      service hostname
+ * @param  port          service port
+ * @param  instance      service instance
+ * @param  txt           service TXT data from _mdns_allocate_txt() or NULL, freed on error
+ * @param  txt_len       length of the TXT data
+ *
+ * @return pointer to the service or NULL on error
+ */
+static mdns_service_t *_mdns_create_service(const char *service, const char *proto, const char *hostname,
+        uint16_t port, const char *instance, uint8_t *txt, uint16_t txt_len)
+{
+    mdns_service_t *s = (mdns_service_t *)calloc(1, sizeof(mdns_service_t));
+    if (!s) {
+        MDNS_MALLOC_FAILED;
+        free(txt);
+        return NULL;
+    }
+
+    s->txt = txt;
+    s->txt_len = txt_len;
+    s->priority = 0;
+    s->weight = 0;
+    s->instance = instance ? strndup(instance, MDNS_NAME_BUF_LEN - 1) : NULL;
+    s->port = port;
+    s->subtype = NULL;
+
+    if (hostname) {
+        s->hostname = _mdns_str_intern(hostname);
+        if (!s->hostname) {
+            goto fail;
+        }
+    } else {
+        s->hostname = NULL;
+    }
+
+    s->service = _mdns_str_intern(service);
+    if (!s->service) {
         goto fail;
     }
 
-    s->proto = strndup(proto, MDNS_NAME_BUF_LEN - 1);
+    s->proto = _mdns_str_intern(proto);
     if (!s->proto) {
         goto fail;
     }
     return s;
 
 fail:
-    _mdns_free_linked_txt(s->txt);
+    free(s->txt);
     free((char *)s->instance);
-    free((char *)s->service);
-    free((char *)s->proto);
-    free((char *)s->hostname);
+    _mdns_str_release(s->service);
+    _mdns_str_release(s->proto);
+    _mdns_str_release(s->hostname);
     free(s);
 
     return NULL;
@@ -2711,13 +4024,14 @@ static void _mdns_dealloc_scheduled_service_answers(mdns_out_answer_t **destinat
 }
 
 /**
- * @brief  Find, remove and free answers and scheduled packets for service
+ * @brief  Find, remove and free answers and scheduled packets for service, forget the records multicast for it
  */
 static void _mdns_remove_scheduled_service_packets(mdns_service_t *service)
 {
     if (!service) {
         return;
     }
+    _mdns_forget_multicast_records(service, NULL);
     mdns_tx_packet_t *p = NULL;
     mdns_tx_packet_t *q = _mdns_server->tx_queue_head;
     while (q) {
@@ -2798,7 +4112,7 @@ static void _mdns_free_service_subtype(mdns_service_t *service)
 {
     while (service->subtype) {
         mdns_subtype_t *next = service->subtype->next;
-        free((char *)service->subtype->subtype);
+        _mdns_str_release(service->subtype->subtype);
         free(service->subtype);
         service->subtype = next;
     }
@@ -2815,16 +4129,10 @@ static void _mdns_free_service(mdns_service_t *service)
         return;
     }
     free((char *)service->instance);
-    free((char *)service->service);
-    free((char *)service->proto);
-    free((char *)service->hostname);
-    while (service->txt) {
-        mdns_txt_linked_item_t *s = service->txt;
-        service->txt = service->txt->next;
-        free((char *)s->key);
-        free((char *)s->value);
-        free(s);
-    }
+    _mdns_str_release(service->service);
+    _mdns_str_release(service->proto);
+    _mdns_str_release(service->hostname);
+    free(service->txt);
     _mdns_free_service_subtype(service);
     free(service);
 }
@@ -2896,7 +4204,6 @@ static int _mdns_check_srv_collision(mdns_service_t *service, uint16_t priority,
  */
 static int _mdns_check_txt_collision(mdns_service_t *service, const uint8_t *data, size_t len)
 {
-    size_t data_len = 0;
     if (len == 1 && service->txt) {
         return -1;//we win
     } else if (len > 1 && !service->txt) {
@@ -2905,28 +4212,13 @@ static int _mdns_check_txt_collision(mdns_service_t *service, const uint8_t *dat
         return 0;//same
     }
 
-    mdns_txt_linked_item_t *txt = service->txt;
-    while (txt) {
-        data_len += 1 /* record-len */ + strlen(txt->key) + txt->value_len + (txt->value ? 1 : 0 /* "=" */);
-        txt = txt->next;
-    }
-
-    if (len > data_len) {
+    if (len > service->txt_len) {
         return 1;//they win
-    } else if (len < data_len) {
+    } else if (len < service->txt_len) {
         return -1;//we win
     }
 
-    uint8_t ours[len];
-    uint16_t index = 0;
-
-    txt = service->txt;
-    while (txt) {
-        append_one_txt_record_entry(ours, &index, txt);
-        txt = txt->next;
-    }
-
-    int ret = memcmp(ours, data, len);
+    int ret = memcmp(service->txt, data, len);
     if (ret > 0) {
         return -1;//we win
     } else if (ret < 0) {
@@ -3049,25 +4341,18 @@ static int _mdns_check_aaaa_collision(esp_ip6_addr_t *ip, mdns_if_t tcpip_if)
 static bool _hostname_is_ours(const char *hostname)
 {
     if (!_str_null_or_empty(_mdns_server->hostname) &&
-            strcasecmp(hostname, _mdns_server->hostname) == 0) {
+            _mdns_str_equal(hostname, _mdns_server->hostname)) {
         return true;
     }
-    mdns_host_item_t *host = _mdns_host_list;
-    while (host != NULL) {
-        if (strcasecmp(hostname, host->hostname) == 0) {
-            return true;
-        }
-        host = host->next;
-    }
-    return false;
+    return _mdns_find_delegated_host(hostname) != NULL;
 }
 
 /**
  * @brief Adds a delegated hostname to the linked list
- * @param hostname Host name pointer
+ * @param hostname Host name, the host keeps a shared copy
  * @param address_list Address list
  * @return  true on success
- *          false if the host wasn't attached (this is our hostname, or alloc failure) so we have to free the structs
+ *          false if the host wasn't attached (this is our hostname, or alloc failure) so we have to free the address list
  */
 static bool _mdns_delegate_hostname_add(const char *hostname, mdns_ip_addr_t *address_list)
 {
@@ -3080,10 +4365,17 @@ static bool _mdns_delegate_hostname_add(const char *hostname, mdns_ip_addr_t *ad
     if (host == NULL) {
         return false;
     }
+    host->hostname = _mdns_str_intern(hostname);
+    if (host->hostname == NULL) {
+        free(host);
+        return false;
+    }
     host->address_list = address_list;
-    host->hostname = hostname;
     host->next = _mdns_host_list;
     _mdns_host_list = host;
+    mdns_host_item_t **bucket = &_mdns_host_table[_mdns_name_hash(hostname, NULL, NULL)];
+    host->hash_next = *bucket;
+    *bucket = host;
     return true;
 }
 
@@ -3100,21 +4392,18 @@ static void free_address_list(mdns_ip_addr_t *address_list)
 static bool _mdns_delegate_hostname_set_address(const char *hostname, mdns_ip_addr_t *address_list)
 {
     if (!_str_null_or_empty(_mdns_server->hostname) &&
-            strcasecmp(hostname, _mdns_server->hostname) == 0) {
+            _mdns_str_equal(hostname, _mdns_server->hostname)) {
         return false;
     }
-    mdns_host_item_t *host = _mdns_host_list;
-    while (host != NULL) {
-        if (strcasecmp(hostname, host->hostname) == 0) {
-            // free previous address list
-            free_address_list(host->address_list);
-            // set current address list to the host
-            host->address_list = address_list;
-            return true;
-        }
-        host = host->next;
+    mdns_host_item_t *host = _mdns_find_delegated_host(hostname);
+    if (host == NULL) {
+        return false;
     }
-    return false;
+    // free previous address list
+    free_address_list(host->address_list);
+    // set current address list to the host
+    host->address_list = address_list;
+    return true;
 }
 
 static mdns_ip_addr_t *copy_address_list(const mdns_ip_addr_t *address_list)
@@ -3146,12 +4435,13 @@ static void free_delegated_hostnames(void)
     mdns_host_item_t *host = _mdns_host_list;
     while (host != NULL) {
         free_address_list(host->address_list);
-        free((char *)host->hostname);
+        _mdns_str_release(host->hostname);
         mdns_host_item_t *item = host;
         host = host->next;
         free(item);
     }
     _mdns_host_list = NULL;
+    memset(_mdns_host_table, 0, sizeof(_mdns_host_table));
 }
 
 static bool _mdns_delegate_hostname_remove(const char *hostname)
@@ -3159,10 +4449,13 @@ static bool _mdns_delegate_hostname_remove(const char *hostname)
     mdns_srv_item_t *srv = _mdns_server->services;
     mdns_srv_item_t *prev_srv = NULL;
     while (srv) {
-        if (strcasecmp(srv->service->hostname, hostname) == 0) {
+        if (_mdns_str_equal(srv->service->hostname, hostname)) {
             mdns_srv_item_t *to_free = srv;
             _mdns_send_bye(&srv, 1, false);
             _mdns_remove_scheduled_service_packets(srv->service);
+            for (int i = 0; i < MDNS_SRV_INDEX_MAX; i++) {
+                _mdns_srv_index_unlink(srv, i);
+            }
             if (prev_srv == NULL) {
                 _mdns_server->services = srv->next;
                 srv = srv->next;
@@ -3177,17 +4470,25 @@ static bool _mdns_delegate_hostname_remove(const char *hostname)
             srv = srv->next;
         }
     }
+    mdns_host_item_t **bucket = &_mdns_host_table[_mdns_name_hash(hostname, NULL, NULL)];
+    while (*bucket != NULL && !_mdns_str_equal(hostname, (*bucket)->hostname)) {
+        bucket = &(*bucket)->hash_next;
+    }
+    if (*bucket != NULL) {
+        *bucket = (*bucket)->hash_next;
+    }
     mdns_host_item_t *host = _mdns_host_list;
     mdns_host_item_t *prev_host = NULL;
     while (host != NULL) {
-        if (strcasecmp(hostname, host->hostname) == 0) {
+        if (_mdns_str_equal(hostname, host->hostname)) {
             if (prev_host == NULL) {
                 _mdns_host_list = host->next;
             } else {
                 prev_host->next = host->next;
             }
+            _mdns_forget_multicast_records(NULL, host);
             free_address_list(host->address_list);
-            free((char *)host->hostname);
+            _mdns_str_release(host->hostname);
             free(host);
             break;
         } else {
@@ -3204,10 +4505,10 @@ static bool _mdns_delegate_hostname_remove(const char *hostname)
 static bool _mdns_name_is_discovery(mdns_name_t *name, uint16_t type)
 {
     return (
-               (name->host[0] && !strcasecmp(name->host, "_services"))
-               && (name->service[0] && !strcasecmp(name->service, "_dns-sd"))
-               && (name->proto[0] && !strcasecmp(name->proto, "_udp"))
-               && (name->domain[0] && !strcasecmp(name->domain, MDNS_DEFAULT_DOMAIN))
+               (name->host[0] && _mdns_str_equal(name->host, "_services"))
+               && (name->service[0] && _mdns_str_equal(name->service, "_dns-sd"))
+               && (name->proto[0] && _mdns_str_equal(name->proto, "_udp"))
+               && (name->domain[0] && _mdns_str_equal(name->domain, MDNS_DEFAULT_DOMAIN))
                && type == MDNS_TYPE_PTR
            );
 }
@@ -3223,13 +4524,13 @@ static bool _mdns_name_is_selfhosted(mdns_name_t *name)
 
     // hostname only -- check if selfhosted name
     if (_str_null_or_empty(name->service) && _str_null_or_empty(name->proto) &&
-            strcasecmp(name->host, _mdns_server->hostname) == 0 ) {
+            _mdns_str_equal(name->host, _mdns_server->hostname) ) {
         return true;
     }
 
     // service -- check if selfhosted service
     mdns_srv_item_t *srv = _mdns_get_service_item(name->service, name->proto, NULL);
-    if (srv && strcasecmp(_mdns_server->hostname, srv->service->hostname) == 0) {
+    if (srv && _mdns_str_equal(_mdns_server->hostname, srv->service->hostname)) {
         return true;
     }
     return false;
@@ -3241,9 +4542,9 @@ static bool _mdns_name_is_selfhosted(mdns_name_t *name)
 static bool _mdns_name_is_ours(mdns_name_t *name)
 {
     //domain have to be "local"
-    if (_str_null_or_empty(name->domain) || ( strcasecmp(name->domain, MDNS_DEFAULT_DOMAIN)
+    if (_str_null_or_empty(name->domain) || ( !_mdns_str_equal(name->domain, MDNS_DEFAULT_DOMAIN)
 #ifdef CONFIG_MDNS_RESPOND_REVERSE_QUERIES
-            && strcasecmp(name->domain, "arpa")
+            && !_mdns_str_equal(name->domain, "arpa")
 #endif /* CONFIG_MDNS_RESPOND_REVERSE_QUERIES */
                                             ) ) {
         return false;
@@ -3290,7 +4591,7 @@ static bool _mdns_name_is_ours(mdns_name_t *name)
     }
 
     //compare the instance against the name
-    if (strcasecmp(name->host, instance) == 0) {
+    if (_mdns_str_equal(name->host, instance)) {
         return true;
     }
 
@@ -3340,24 +4641,31 @@ static const uint8_t *_mdns_parse_fqdn(const uint8_t *packet, const uint8_t *sta
     name->domain[0] = 0;
     name->invalid = false;
 
-    static char buf[MDNS_NAME_BUF_LEN];
+    mdns_name_labels_t labels;
+    labels.host_merged = false;
 
-    const uint8_t *next_data = (uint8_t *)_mdns_read_fqdn(packet, start, name, buf, packet_len);
+    const uint8_t *next_data = _mdns_read_fqdn(packet, start, name, &labels, packet_len);
     if (!next_data) {
         return 0;
     }
+    // every part is copied once, to where it belongs: a name of three parts has no host, of two no service
+    char *parts[] = {name->host, name->service, name->proto, name->domain};
+    if (!name->invalid && name->parts == 3) {
+        parts[0] = name->service;
+        parts[1] = name->proto;
+        parts[2] = name->domain;
+    } else if (!name->invalid && name->parts == 2) {
+        parts[1] = name->domain;
+    }
+    for (uint8_t i = 0; i < name->parts; i++) {
+        _mdns_name_copy_part(name, &labels, i, parts[i]);
+    }
     if (!name->parts || name->invalid) {
         return next_data;
     }
-    if (name->parts == 3) {
-        memmove((uint8_t *)name + (MDNS_NAME_BUF_LEN), (uint8_t *)name, 3 * (MDNS_NAME_BUF_LEN));
-        name->host[0] = 0;
-    } else if (name->parts == 2) {
-        memmove((uint8_t *)(name->domain), (uint8_t *)(name->service), (MDNS_NAME_BUF_LEN));
-        name->service[0] = 0;
-        name->proto[0] = 0;
-    }
-    if (strcasecmp(name->domain, MDNS_DEFAULT_DOMAIN) == 0 || strcasecmp(name->domain, "arpa") == 0) {
+    // the last part is the domain, a single part is the host (without a domain)
+    const mdns_label_t *domain = &labels.parts[name->parts - 1];
+    if (name->parts > 1 && (_mdns_label_is(domain, "local", 5) || _mdns_label_is(domain, "arpa", 4))) {
         return next_data;
     }
     name->invalid = true; // mark the current name invalid, but continue with other question
@@ -3376,22 +4684,22 @@ static bool _mdns_question_matches(mdns_parsed_question_t *question, uint16_t ty
         return true;
     } else if (type == MDNS_TYPE_PTR || type == MDNS_TYPE_SDPTR) {
         if (question->service && question->proto && question->domain
-                && !strcasecmp(service->service->service, question->service)
-                && !strcasecmp(service->service->proto, question->proto)
-                && !strcasecmp(MDNS_DEFAULT_DOMAIN, question->domain)) {
+                && _mdns_str_equal(service->service->service, question->service)
+                && _mdns_str_equal(service->service->proto, question->proto)
+                && _mdns_str_equal(MDNS_DEFAULT_DOMAIN, question->domain)) {
             if  (!service->service->instance) {
                 return true;
-            } else if (service->service->instance && question->host && !strcasecmp(service->service->instance, question->host)) {
+            } else if (service->service->instance && question->host && _mdns_str_equal(service->service->instance, question->host)) {
                 return true;
             }
         }
     } else if (service && (type == MDNS_TYPE_SRV || type == MDNS_TYPE_TXT)) {
         const char *name = _mdns_get_service_instance_name(service->service);
         if (name && question->host && question->service && question->proto && question->domain
-                && !strcasecmp(name, question->host)
-                && !strcasecmp(service->service->service, question->service)
-                && !strcasecmp(service->service->proto, question->proto)
-                && !strcasecmp(MDNS_DEFAULT_DOMAIN, question->domain)) {
+                && _mdns_str_equal(name, question->host)
+                && _mdns_str_equal(service->service->service, question->service)
+                && _mdns_str_equal(service->service->proto, question->proto)
+                && _mdns_str_equal(MDNS_DEFAULT_DOMAIN, question->domain)) {
             return true;
         }
     }
@@ -3401,34 +4709,40 @@ static bool _mdns_question_matches(mdns_parsed_question_t *question, uint16_t ty
 
 /**
  * @brief  Removes saved question from parsed data
+ *
+ * @return true if the question was found
  */
-static void _mdns_remove_parsed_question(mdns_parsed_packet_t *parsed_packet, uint16_t type, mdns_srv_item_t *service)
+static bool _mdns_remove_parsed_question(mdns_parsed_packet_t *parsed_packet, uint16_t type, mdns_srv_item_t *service)
 {
     mdns_parsed_question_t *q = parsed_packet->questions;
 
+    if (!q) {
+        return false;
+    }
     if (_mdns_question_matches(q, type, service)) {
         parsed_packet->questions = q->next;
-        free(q->host);
-        free(q->service);
-        free(q->proto);
-        free(q->domain);
-        free(q);
-        return;
+        return true;
     }
 
     while (q->next) {
         mdns_parsed_question_t *p = q->next;
         if (_mdns_question_matches(p, type, service)) {
             q->next = p->next;
-            free(p->host);
-            free(p->service);
-            free(p->proto);
-            free(p->domain);
-            free(p);
-            return;
+            return true;
         }
         q = q->next;
     }
+    return false;
+}
+
+/**
+ * @brief  Removes the question answered by a known answer of the querier, if the known answer is fresh enough
+ */
+static void _mdns_remove_known_answer_question(mdns_parsed_packet_t *parsed_packet, uint16_t type, mdns_srv_item_t *service, uint32_t ttl)
+{
+    if (_mdns_known_answer_is_fresh(type, ttl) && _mdns_remove_parsed_question(parsed_packet, type, service)) {
+        _mdns_server->suppressed.known_answer++;
+    }
 }
 
 /**
@@ -3495,13 +4809,13 @@ static void _mdns_result_txt_create(const uint8_t *data, size_t len, mdns_txt_it
 
     mdns_txt_item_t *txt = (mdns_txt_item_t *)malloc(sizeof(mdns_txt_item_t) * num_items);
     if (!txt) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return;
     }
     uint8_t *txt_value_len = (uint8_t *)malloc(num_items);
     if (!txt_value_len) {
         free(txt);
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return;
     }
     memset(txt, 0, sizeof(mdns_txt_item_t) * num_items);
@@ -3525,7 +4839,7 @@ static void _mdns_result_txt_create(const uint8_t *data, size_t len, mdns_txt_it
         }
         char *key = (char *)malloc(name_len + 1);
         if (!key) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             goto handle_error;//error
         }
 
@@ -3535,14 +4849,15 @@ static void _mdns_result_txt_create(const uint8_t *data, size_t len, mdns_txt_it
 
         memcpy(key, data + i, name_len);
         key[name_len] = 0;
-        i += name_len + 1;
+        // items without a value have no '='
+        i += (size_t)name_len < partLen ? name_len + 1 : name_len;
         t->key = key;
 
         int new_value_len = partLen - name_len - 1;
         if (new_value_len > 0) {
             char *value = (char *)malloc(new_value_len + 1);
             if (!value) {
-                HOOK_MALLOC_FAILED;
+                MDNS_MALLOC_FAILED;
                 goto handle_error;//error
             }
             memcpy(value, data + i, new_value_len);
@@ -3569,29 +4884,49 @@ handle_error :
 }
 
 /**
- * @brief  Duplicate string or return error
+ * @brief  Allocates zeroed memory of the parsed packet from the parser arena
+ *
+ * @return the memory or NULL if the arena is exhausted
  */
-static esp_err_t _mdns_strdup_check(char **out, char *in)
+static void *_mdns_parse_arena_alloc(mdns_parse_arena_t *arena, size_t size, size_t align)
 {
+    uintptr_t start = ((uintptr_t)(arena->buf + arena->used) + align - 1) & ~(uintptr_t)(align - 1);
+    size_t offset = start - (uintptr_t)arena->buf;
+    if (offset + size > sizeof(arena->buf)) {
+        return NULL;
+    }
+    arena->used = offset + size;
+    memset(arena->buf + offset, 0, size);
+    return arena->buf + offset;
+}
+
+/**
+ * @brief  Copies string to the parser arena (empty strings are stored as NULL) or returns error
+ */
+static esp_err_t _mdns_parse_arena_strdup(mdns_parse_arena_t *arena, char **out, const char *in)
+{
+    *out = NULL;
     if (in && in[0]) {
-        *out = strdup(in);
+        size_t len = strlen(in) + 1;
+        *out = (char *)_mdns_parse_arena_alloc(arena, len, 1);
         if (!*out) {
-            return ESP_FAIL;
+            return ESP_ERR_NO_MEM;
         }
-        return ESP_OK;
+        memcpy(*out, in, len);
     }
-    *out = NULL;
     return ESP_OK;
 }
 
+#define _mdns_parse_arena_new(arena, type) ((type *)_mdns_parse_arena_alloc(arena, sizeof(type), sizeof(void *)))
+
 /**
  * @brief  main packet parser
  *
  * @param  packet       the packet
+ * @param  arena        scratch memory of the parsed data, reused for every packet
  */
-void mdns_parse_packet(mdns_rx_packet_t *packet)
+void mdns_parse_packet(mdns_rx_packet_t *packet, mdns_parse_arena_t *arena)
 {
-    static mdns_name_t n;
     mdns_header_t header;
     const uint8_t *data = _mdns_get_packet_data(packet);
     size_t len = _mdns_get_packet_len(packet);
@@ -3602,7 +4937,6 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
     char *browse_result_instance = NULL;
     char *browse_result_service = NULL;
     char *browse_result_proto = NULL;
-    mdns_browse_sync_t *out_sync_browse = NULL;
 
 #ifdef MDNS_ENABLE_DEBUG
     _mdns_dbg_printf("\nRX[%lu][%lu]: ", (unsigned long)packet->tcpip_if, (unsigned long)packet->ip_protocol);
@@ -3646,14 +4980,13 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
         return;
     }
 
-    mdns_parsed_packet_t *parsed_packet = (mdns_parsed_packet_t *)malloc(sizeof(mdns_parsed_packet_t));
+    arena->used = 0;
+    mdns_parsed_packet_t *parsed_packet = _mdns_parse_arena_new(arena, mdns_parsed_packet_t);
     if (!parsed_packet) {
-        HOOK_MALLOC_FAILED;
         return;
     }
-    memset(parsed_packet, 0, sizeof(mdns_parsed_packet_t));
 
-    mdns_name_t *name = &n;
+    mdns_name_t *name = &arena->name;
     memset(name, 0, sizeof(mdns_name_t));
 
     header.id = _mdns_read_u16(data, MDNS_HEAD_ID_OFFSET);
@@ -3664,13 +4997,11 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
     header.additional = _mdns_read_u16(data, MDNS_HEAD_ADDITIONAL_OFFSET);
 
     if (header.flags == MDNS_FLAGS_QR_AUTHORITATIVE && packet->src_port != MDNS_SERVICE_PORT) {
-        free(parsed_packet);
         return;
     }
 
     //if we have not set the hostname, we can not answer questions
     if (header.questions && !header.answers && _str_null_or_empty(_mdns_server->hostname)) {
-        free(parsed_packet);
         return;
     }
 
@@ -3714,23 +5045,20 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                 parsed_packet->discovery = true;
                 mdns_srv_item_t *a = _mdns_server->services;
                 while (a) {
-                    mdns_parsed_question_t *question = (mdns_parsed_question_t *)calloc(1, sizeof(mdns_parsed_question_t));
+                    mdns_parsed_question_t *question = _mdns_parse_arena_new(arena, mdns_parsed_question_t);
                     if (!question) {
-                        HOOK_MALLOC_FAILED;
                         goto clear_rx_packet;
                     }
                     question->next = parsed_packet->questions;
                     parsed_packet->questions = question;
 
+                    // services are not removed while a packet is parsed, so their names need no copy
                     question->unicast = unicast;
                     question->type = MDNS_TYPE_SDPTR;
                     question->host = NULL;
-                    question->service = strdup(a->service->service);
-                    question->proto = strdup(a->service->proto);
-                    question->domain = strdup(MDNS_DEFAULT_DOMAIN);
-                    if (!question->service || !question->proto || !question->domain) {
-                        goto clear_rx_packet;
-                    }
+                    question->service = (char *)a->service->service;
+                    question->proto = (char *)a->service->proto;
+                    question->domain = (char *)MDNS_DEFAULT_DOMAIN;
                     a = a->next;
                 }
                 continue;
@@ -3743,9 +5071,8 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                 parsed_packet->probe = true;
             }
 
-            mdns_parsed_question_t *question = (mdns_parsed_question_t *)calloc(1, sizeof(mdns_parsed_question_t));
+            mdns_parsed_question_t *question = _mdns_parse_arena_new(arena, mdns_parsed_question_t);
             if (!question) {
-                HOOK_MALLOC_FAILED;
                 goto clear_rx_packet;
             }
             question->next = parsed_packet->questions;
@@ -3754,10 +5081,10 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
             question->unicast = unicast;
             question->type = type;
             question->sub = name->sub;
-            if (_mdns_strdup_check(&(question->host), name->host)
-                    || _mdns_strdup_check(&(question->service), name->service)
-                    || _mdns_strdup_check(&(question->proto), name->proto)
-                    || _mdns_strdup_check(&(question->domain), name->domain)) {
+            if (_mdns_parse_arena_strdup(arena, &(question->host), name->host)
+                    || _mdns_parse_arena_strdup(arena, &(question->service), name->service)
+                    || _mdns_parse_arena_strdup(arena, &(question->proto), name->proto)
+                    || _mdns_parse_arena_strdup(arena, &(question->domain), name->domain)) {
                 goto clear_rx_packet;
             }
         }
@@ -3783,6 +5110,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
             uint32_t ttl = _mdns_read_u32(content, MDNS_TTL_OFFSET);
             uint16_t data_len = _mdns_read_u16(content, MDNS_LEN_OFFSET);
             const uint8_t *data_ptr = content + MDNS_DATA_OFFSET;
+            bool cache_flush = !!(mdns_class & 0x8000);
             mdns_class &= 0x7FFF;
 
             content = data_ptr + data_len;
@@ -3819,40 +5147,35 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                     //skip this record
                     continue;
                 }
+                if (mdns_class == 0x0001) {
+                    _mdns_cache_add_record(packet->tcpip_if, packet->ip_protocol, name, type, cache_flush, ttl,
+                                           data, len, data_ptr, data_len, arena);
+                }
                 search_result = _mdns_search_find_from(_mdns_server->search_once, name, type, packet->tcpip_if, packet->ip_protocol);
+                if (search_result) {
+                    // keep the name of the record to find the other searches it answers, the record data is parsed into `name`
+                    memcpy(&arena->owner, name, sizeof(mdns_name_t));
+                }
                 browse_result = _mdns_browse_find_from(_mdns_server->browse, name, type, packet->tcpip_if, packet->ip_protocol);
                 if (browse_result) {
-                    if (!out_sync_browse) {
-                        // will be freed in function `_mdns_browse_sync`
-                        out_sync_browse = (mdns_browse_sync_t *)malloc(sizeof(mdns_browse_sync_t));
-                        if (!out_sync_browse) {
-                            HOOK_MALLOC_FAILED;
-                            goto clear_rx_packet;
-                        }
-                        out_sync_browse->browse = browse_result;
-                        out_sync_browse->sync_result = NULL;
-                    }
                     if (!browse_result_service) {
-                        browse_result_service = (char *)malloc(MDNS_NAME_BUF_LEN);
+                        browse_result_service = (char *)_mdns_parse_arena_alloc(arena, MDNS_NAME_BUF_LEN, 1);
                         if (!browse_result_service) {
-                            HOOK_MALLOC_FAILED;
                             goto clear_rx_packet;
                         }
                     }
-                    memcpy(browse_result_service, browse_result->service, MDNS_NAME_BUF_LEN);
+                    memcpy(browse_result_service, browse_result->service, strlen(browse_result->service) + 1);
                     if (!browse_result_proto) {
-                        browse_result_proto = (char *)malloc(MDNS_NAME_BUF_LEN);
+                        browse_result_proto = (char *)_mdns_parse_arena_alloc(arena, MDNS_NAME_BUF_LEN, 1);
                         if (!browse_result_proto) {
-                            HOOK_MALLOC_FAILED;
                             goto clear_rx_packet;
                         }
                     }
-                    memcpy(browse_result_proto, browse_result->proto, MDNS_NAME_BUF_LEN);
+                    memcpy(browse_result_proto, browse_result->proto, strlen(browse_result->proto) + 1);
                     if (type == MDNS_TYPE_SRV || type == MDNS_TYPE_TXT) {
                         if (!browse_result_instance) {
-                            browse_result_instance = (char *)malloc(MDNS_NAME_BUF_LEN);
+                            browse_result_instance = (char *)_mdns_parse_arena_alloc(arena, MDNS_NAME_BUF_LEN, 1);
                             if (!browse_result_instance) {
-                                HOOK_MALLOC_FAILED;
                                 goto clear_rx_packet;
                             }
                         }
@@ -3866,8 +5189,12 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                     continue;//error
                 }
                 if (search_result) {
-                    _mdns_search_result_add_ptr(search_result, name->host, name->service, name->proto,
-                                                packet->tcpip_if, packet->ip_protocol, ttl);
+                    // the answer goes to every search asking for it
+                    while (search_result) {
+                        _mdns_search_result_add_ptr(search_result, name->host, name->service, name->proto,
+                                                    packet->tcpip_if, packet->ip_protocol, ttl);
+                        search_result = _mdns_search_find_from(search_result->next, &arena->owner, type, packet->tcpip_if, packet->ip_protocol);
+                    }
                 } else if ((discovery || ours) && !name->sub && _mdns_name_is_ours(name)) {
                     if (name->host[0]) {
                         service = _mdns_get_service_item_instance(name->host, name->service, name->proto, NULL);
@@ -3875,9 +5202,9 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                         service = _mdns_get_service_item(name->service, name->proto, NULL);
                     }
                     if (discovery && service) {
-                        _mdns_remove_parsed_question(parsed_packet, MDNS_TYPE_SDPTR, service);
+                        _mdns_remove_known_answer_question(parsed_packet, MDNS_TYPE_SDPTR, service, ttl);
                     } else if (service && parsed_packet->questions && !parsed_packet->probe) {
-                        _mdns_remove_parsed_question(parsed_packet, type, service);
+                        _mdns_remove_known_answer_question(parsed_packet, type, service, ttl);
                     } else if (service) {
                         //check if TTL is more than half of the full TTL value (4500)
                         if (ttl > (MDNS_ANSWER_PTR_TTL / 2)) {
@@ -3885,9 +5212,8 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                         }
                     }
                     if (service) {
-                        mdns_parsed_record_t *record = malloc(sizeof(mdns_parsed_record_t));
+                        mdns_parsed_record_t *record = _mdns_parse_arena_new(arena, mdns_parsed_record_t);
                         if (!record) {
-                            HOOK_MALLOC_FAILED;
                             goto clear_rx_packet;
                         }
                         record->next = parsed_packet->records;
@@ -3895,55 +5221,14 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                         record->type = MDNS_TYPE_PTR;
                         record->record_type = MDNS_ANSWER;
                         record->ttl = ttl;
-                        record->host = NULL;
-                        record->service = NULL;
-                        record->proto = NULL;
-                        if (name->host[0]) {
-                            record->host = malloc(MDNS_NAME_BUF_LEN);
-                            if (!record->host) {
-                                HOOK_MALLOC_FAILED;
-                                goto clear_rx_packet;
-                            }
-                            memcpy(record->host, name->host, MDNS_NAME_BUF_LEN);
-                        }
-                        if (name->service[0]) {
-                            record->service = malloc(MDNS_NAME_BUF_LEN);
-                            if (!record->service) {
-                                HOOK_MALLOC_FAILED;
-                                goto clear_rx_packet;
-                            }
-                            memcpy(record->service, name->service, MDNS_NAME_BUF_LEN);
-                        }
-                        if (name->proto[0]) {
-                            record->proto = malloc(MDNS_NAME_BUF_LEN);
-                            if (!record->proto) {
-                                HOOK_MALLOC_FAILED;
-                                goto clear_rx_packet;
-                            }
-                            memcpy(record->proto, name->proto, MDNS_NAME_BUF_LEN);
+                        if (_mdns_parse_arena_strdup(arena, &(record->host), name->host)
+                                || _mdns_parse_arena_strdup(arena, &(record->service), name->service)
+                                || _mdns_parse_arena_strdup(arena, &(record->proto), name->proto)) {
+                            goto clear_rx_packet;
                         }
                     }
                 }
             } else if (type == MDNS_TYPE_SRV) {
-                mdns_result_t *result = NULL;
-                if (search_result && search_result->type == MDNS_TYPE_PTR) {
-                    result = search_result->result;
-                    while (result) {
-                        if (_mdns_get_esp_netif(packet->tcpip_if) == result->esp_netif
-                                && packet->ip_protocol == result->ip_protocol
-                                && result->instance_name && !strcmp(name->host, result->instance_name)) {
-                            break;
-                        }
-                        result = result->next;
-                    }
-                    if (!result) {
-                        result = _mdns_search_result_add_ptr(search_result, name->host, name->service, name->proto,
-                                                             packet->tcpip_if, packet->ip_protocol, ttl);
-                        if (!result) {
-                            continue;//error
-                        }
-                    }
-                }
                 bool is_selfhosted = _mdns_name_is_selfhosted(name);
                 if (!_mdns_parse_fqdn(data, data_ptr + MDNS_SRV_FQDN_OFFSET, name, len)) {
                     continue;//error
@@ -3957,20 +5242,24 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
 
                 if (browse_result) {
                     _mdns_browse_result_add_srv(browse_result, name->host, browse_result_instance, browse_result_service,
-                                                browse_result_proto, port, packet->tcpip_if, packet->ip_protocol, ttl, out_sync_browse);
+                                                browse_result_proto, port, packet->tcpip_if, packet->ip_protocol, ttl);
                 }
                 if (search_result) {
-                    if (search_result->type == MDNS_TYPE_PTR) {
-                        if (!result->hostname) { // assign host/port for this entry only if not previously set
-                            result->port = port;
-                            result->hostname = strdup(name->host);
+                    while (search_result) {
+                        if (search_result->type == MDNS_TYPE_PTR) {
+                            mdns_result_t *result = _mdns_search_result_get_instance(search_result, &arena->owner, packet->tcpip_if, packet->ip_protocol, ttl);
+                            if (result && !result->hostname) { // assign host/port for this entry only if not previously set
+                                result->port = port;
+                                result->hostname = (char *)_mdns_str_intern(name->host);
+                            }
+                        } else {
+                            _mdns_search_result_add_srv(search_result, name->host, port, packet->tcpip_if, packet->ip_protocol, ttl);
                         }
-                    } else {
-                        _mdns_search_result_add_srv(search_result, name->host, port, packet->tcpip_if, packet->ip_protocol, ttl);
+                        search_result = _mdns_search_find_from(search_result->next, &arena->owner, type, packet->tcpip_if, packet->ip_protocol);
                     }
                 } else if (ours) {
                     if (parsed_packet->questions && !parsed_packet->probe) {
-                        _mdns_remove_parsed_question(parsed_packet, type, service);
+                        _mdns_remove_known_answer_question(parsed_packet, type, service, ttl);
                         continue;
                     } else if (parsed_packet->distributed) {
                         _mdns_remove_scheduled_answer(packet->tcpip_if, packet->ip_protocol, type, service);
@@ -3993,11 +5282,14 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                             do_not_reply = true;
                             if (_mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].probe_running) {
                                 _mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].failed_probes++;
+                                _mdns_server->stats.probe_conflicts++;
                                 if (!_str_null_or_empty(service->service->instance)) {
                                     char *new_instance = _mdns_mangle_name((char *)service->service->instance);
                                     if (new_instance) {
                                         free((char *)service->service->instance);
                                         service->service->instance = new_instance;
+                                        service->service->wire.generation = 0;
+                                        _mdns_srv_item_reindex_instance(service);
                                     }
                                     _mdns_probe_all_pcbs(&service, 1, false, false);
                                 } else if (!_str_null_or_empty(_mdns_server->instance)) {
@@ -4005,6 +5297,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                                     if (new_instance) {
                                         free((char *)_mdns_server->instance);
                                         _mdns_server->instance = new_instance;
+                                        _mdns_names_changed();
                                     }
                                     _mdns_restart_all_pcbs_no_instance();
                                 } else {
@@ -4019,6 +5312,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                                 }
                             } else if (service) {
                                 _mdns_pcb_send_bye(packet->tcpip_if, packet->ip_protocol, &service, 1, false);
+                                _mdns_server->stats.reprobes++;
                                 _mdns_init_pcb_probe(packet->tcpip_if, packet->ip_protocol, &service, 1, false);
                             }
                         }
@@ -4031,47 +5325,33 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                 uint8_t *txt_value_len = NULL;
                 size_t txt_count = 0;
 
-                mdns_result_t *result = NULL;
                 if (browse_result) {
-                    _mdns_result_txt_create(data_ptr, data_len, &txt, &txt_value_len, &txt_count);
                     _mdns_browse_result_add_txt(browse_result, browse_result_instance, browse_result_service, browse_result_proto,
-                                                txt, txt_value_len, txt_count, packet->tcpip_if, packet->ip_protocol, ttl, out_sync_browse);
+                                                data_ptr, data_len, packet->tcpip_if, packet->ip_protocol, ttl);
                 }
                 if (search_result) {
-                    if (search_result->type == MDNS_TYPE_PTR) {
-                        result = search_result->result;
-                        while (result) {
-                            if (_mdns_get_esp_netif(packet->tcpip_if) == result->esp_netif
-                                    && packet->ip_protocol == result->ip_protocol
-                                    && result->instance_name && !strcmp(name->host, result->instance_name)) {
-                                break;
-                            }
-                            result = result->next;
-                        }
-                        if (!result) {
-                            result = _mdns_search_result_add_ptr(search_result, name->host, name->service, name->proto,
-                                                                 packet->tcpip_if, packet->ip_protocol, ttl);
-                            if (!result) {
-                                continue;//error
+                    while (search_result) {
+                        if (search_result->type == MDNS_TYPE_PTR) {
+                            mdns_result_t *result = _mdns_search_result_get_instance(search_result, name, packet->tcpip_if, packet->ip_protocol, ttl);
+                            if (result && !result->txt) {
+                                _mdns_result_txt_create(data_ptr, data_len, &txt, &txt_value_len, &txt_count);
+                                if (txt_count) {
+                                    result->txt = txt;
+                                    result->txt_count = txt_count;
+                                    result->txt_value_len = txt_value_len;
+                                }
                             }
-                        }
-                        if (!result->txt) {
+                        } else {
                             _mdns_result_txt_create(data_ptr, data_len, &txt, &txt_value_len, &txt_count);
                             if (txt_count) {
-                                result->txt = txt;
-                                result->txt_count = txt_count;
-                                result->txt_value_len = txt_value_len;
+                                _mdns_search_result_add_txt(search_result, txt, txt_value_len, txt_count, packet->tcpip_if, packet->ip_protocol, ttl);
                             }
                         }
-                    } else {
-                        _mdns_result_txt_create(data_ptr, data_len, &txt, &txt_value_len, &txt_count);
-                        if (txt_count) {
-                            _mdns_search_result_add_txt(search_result, txt, txt_value_len, txt_count, packet->tcpip_if, packet->ip_protocol, ttl);
-                        }
+                        search_result = _mdns_search_find_from(search_result->next, name, type, packet->tcpip_if, packet->ip_protocol);
                     }
                 } else if (ours) {
                     if (parsed_packet->questions && !parsed_packet->probe && service) {
-                        _mdns_remove_parsed_question(parsed_packet, type, service);
+                        _mdns_remove_known_answer_question(parsed_packet, type, service, ttl);
                         continue;
                     }
                     if (!_mdns_name_is_selfhosted(name)) {
@@ -4088,6 +5368,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                     }
                     if (col && !_mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].probe_running && service) {
                         do_not_reply = true;
+                        _mdns_server->stats.reprobes++;
                         _mdns_init_pcb_probe(packet->tcpip_if, packet->ip_protocol, &service, 1, true);
                     } else if (ttl > (MDNS_ANSWER_TXT_TTL / 2) && !col && !parsed_packet->authoritative && !parsed_packet->probe && !parsed_packet->questions && !_mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].probe_running) {
                         _mdns_remove_scheduled_answer(packet->tcpip_if, packet->ip_protocol, type, service);
@@ -4101,7 +5382,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                 ip6.type = ESP_IPADDR_TYPE_V6;
                 memcpy(ip6.u_addr.ip6.addr, data_ptr, MDNS_ANSWER_AAAA_SIZE);
                 if (browse_result) {
-                    _mdns_browse_result_add_ip(browse_result, name->host, &ip6, packet->tcpip_if, packet->ip_protocol, ttl, out_sync_browse);
+                    _mdns_browse_result_add_ip(browse_result, name->host, &ip6, packet->tcpip_if, packet->ip_protocol, ttl);
                 }
                 if (search_result) {
                     //check for more applicable searches (PTR & A/AAAA at the same time)
@@ -4111,7 +5392,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                     }
                 } else if (ours) {
                     if (parsed_packet->questions && !parsed_packet->probe) {
-                        _mdns_remove_parsed_question(parsed_packet, type, NULL);
+                        _mdns_remove_known_answer_question(parsed_packet, type, NULL, ttl);
                         continue;
                     }
                     if (!_mdns_name_is_selfhosted(name)) {
@@ -4133,6 +5414,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                         if (_mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].probe_running) {
                             if (col && (parsed_packet->probe || parsed_packet->authoritative)) {
                                 _mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].failed_probes++;
+                                _mdns_server->stats.probe_conflicts++;
                                 char *new_host = _mdns_mangle_name((char *)_mdns_server->hostname);
                                 if (new_host) {
                                     _mdns_remap_self_service_hostname(_mdns_server->hostname, new_host);
@@ -4143,6 +5425,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                                 _mdns_restart_all_pcbs();
                             }
                         } else {
+                            _mdns_server->stats.reprobes++;
                             _mdns_init_pcb_probe(packet->tcpip_if, packet->ip_protocol, NULL, 0, true);
                         }
                     } else if (ttl > 60 && !col && !parsed_packet->authoritative && !parsed_packet->probe && !parsed_packet->questions && !_mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].probe_running) {
@@ -4158,7 +5441,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                 ip.type = ESP_IPADDR_TYPE_V4;
                 memcpy(&(ip.u_addr.ip4.addr), data_ptr, 4);
                 if (browse_result) {
-                    _mdns_browse_result_add_ip(browse_result, name->host, &ip, packet->tcpip_if, packet->ip_protocol, ttl, out_sync_browse);
+                    _mdns_browse_result_add_ip(browse_result, name->host, &ip, packet->tcpip_if, packet->ip_protocol, ttl);
                 }
                 if (search_result) {
                     //check for more applicable searches (PTR & A/AAAA at the same time)
@@ -4168,7 +5451,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                     }
                 } else if (ours) {
                     if (parsed_packet->questions && !parsed_packet->probe) {
-                        _mdns_remove_parsed_question(parsed_packet, type, NULL);
+                        _mdns_remove_known_answer_question(parsed_packet, type, NULL, ttl);
                         continue;
                     }
                     if (!_mdns_name_is_selfhosted(name)) {
@@ -4190,6 +5473,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                         if (_mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].probe_running) {
                             if (col && (parsed_packet->probe || parsed_packet->authoritative)) {
                                 _mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].failed_probes++;
+                                _mdns_server->stats.probe_conflicts++;
                                 char *new_host = _mdns_mangle_name((char *)_mdns_server->hostname);
                                 if (new_host) {
                                     _mdns_remap_self_service_hostname(_mdns_server->hostname, new_host);
@@ -4200,6 +5484,7 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
                                 _mdns_restart_all_pcbs();
                             }
                         } else {
+                            _mdns_server->stats.reprobes++;
                             _mdns_init_pcb_probe(packet->tcpip_if, packet->ip_protocol, NULL, 0, true);
                         }
                     } else if (ttl > 60 && !col && !parsed_packet->authoritative && !parsed_packet->probe && !parsed_packet->questions && !_mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].probe_running) {
@@ -4219,65 +5504,10 @@ void mdns_parse_packet(mdns_rx_packet_t *packet)
     if (!do_not_reply && _mdns_server->interfaces[packet->tcpip_if].pcbs[packet->ip_protocol].state > PCB_PROBE_3 && (parsed_packet->questions || parsed_packet->discovery)) {
         _mdns_create_answer_from_parsed_packet(parsed_packet);
     }
-    if (out_sync_browse) {
-#ifdef MDNS_ENABLE_DEBUG
-        _mdns_dbg_printf("Browse %s%s total result:", out_sync_browse->browse->service, out_sync_browse->browse->proto);
-        debug_printf_browse_result_all(out_sync_browse->browse->result);
-#endif // MDNS_ENABLE_DEBUG
-        if (out_sync_browse->sync_result) {
-#ifdef MDNS_ENABLE_DEBUG
-            _mdns_dbg_printf("Changed result:");
-            debug_printf_browse_result_all(out_sync_browse->sync_result->result);
-#endif // MDNS_ENABLE_DEBUG
-            _mdns_sync_browse_action(ACTION_BROWSE_SYNC, out_sync_browse);
-        } else {
-            free(out_sync_browse);
-        }
-    }
 
 clear_rx_packet:
-    while (parsed_packet->questions) {
-        mdns_parsed_question_t *question = parsed_packet->questions;
-        parsed_packet->questions = parsed_packet->questions->next;
-        if (question->host) {
-            free(question->host);
-        }
-        if (question->service) {
-            free(question->service);
-        }
-        if (question->proto) {
-            free(question->proto);
-        }
-        if (question->domain) {
-            free(question->domain);
-        }
-        free(question);
-    }
-    while (parsed_packet->records) {
-        mdns_parsed_record_t *record = parsed_packet->records;
-        parsed_packet->records = parsed_packet->records->next;
-        if (record->host) {
-            free(record->host);
-        }
-        if (record->service) {
-            free(record->service);
-        }
-        if (record->proto) {
-            free(record->proto);
-        }
-        record->next = NULL;
-        free(record);
-    }
-    free(parsed_packet);
-    if (browse_result_instance) {
-        free(browse_result_instance);
-    }
-    if (browse_result_service) {
-        free(browse_result_service);
-    }
-    if (browse_result_proto) {
-        free(browse_result_proto);
-    }
+    // the parsed data lives in the arena, which is reused by the next packet
+    return;
 }
 
 /**
@@ -4303,6 +5533,7 @@ void _mdns_disable_pcb(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
 
     if (mdns_is_netif_ready(tcpip_if, ip_protocol)) {
         _mdns_clear_pcb_tx_queue_head(tcpip_if, ip_protocol);
+        _mdns_cache_remove_pcb(tcpip_if, ip_protocol);
         mdns_pcb_deinit_local(tcpip_if, ip_protocol);
         mdns_if_t other_if = _mdns_get_other_if (tcpip_if);
         if (other_if != MDNS_MAX_INTERFACES && _mdns_server->interfaces[other_if].pcbs[ip_protocol].state == PCB_DUP) {
@@ -4333,6 +5564,11 @@ static void perform_event_action(mdns_if_t mdns_if, mdns_event_actions_t action)
     }
     if (action & MDNS_EVENT_ENABLE_IP6) {
         _mdns_enable_pcb(mdns_if, MDNS_IP_PROTOCOL_V6);
+        // browse again on the new address, the planner sends the queries with the next timer tick
+        for (mdns_browse_t *browse = _mdns_server->browse; browse; browse = browse->next) {
+            browse->interval = 0;
+        }
+        _mdns_timer_arm();
     }
     if (action & MDNS_EVENT_DISABLE_IP4) {
         _mdns_disable_pcb(mdns_if, MDNS_IP_PROTOCOL_V4);
@@ -4359,6 +5595,7 @@ static void perform_event_action(mdns_if_t mdns_if, mdns_event_actions_t action)
                          esp_ip4_addr2_16(ip), esp_ip4_addr1_16(ip)) > 0 && reverse_query_name) {
                 ESP_LOGD(TAG, "Registered reverse query: %s.arpa", reverse_query_name);
                 _mdns_delegate_hostname_add(reverse_query_name, NULL);
+                free(reverse_query_name);
             }
         }
     }
@@ -4384,6 +5621,7 @@ static void perform_event_action(mdns_if_t mdns_if, mdns_event_actions_t action)
                 }
                 ESP_LOGD(TAG, "Registered reverse query: %s.arpa", reverse_query_name);
                 _mdns_delegate_hostname_add(reverse_query_name, NULL);
+                free(reverse_query_name);
             }
         }
     }
@@ -4481,11 +5719,6 @@ void mdns_preset_if_handle_system_event(void *arg, esp_event_base_t event_base,
                         post_mdns_enable_pcb(mdns_if, MDNS_IP_PROTOCOL_V6);
                         post_mdns_announce_pcb(mdns_if, MDNS_IP_PROTOCOL_V4);
                     }
-                    mdns_browse_t *browse = _mdns_server->browse;
-                    while (browse) {
-                        _mdns_browse_send(browse, mdns_if);
-                        browse = browse->next;
-                    }
                 }
                 break;
                 default:
@@ -4519,7 +5752,7 @@ static mdns_search_once_t *_mdns_search_init(const char *name, const char *servi
 {
     mdns_search_once_t *search = (mdns_search_once_t *)malloc(sizeof(mdns_search_once_t));
     if (!search) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return NULL;
     }
     memset(search, 0, sizeof(mdns_search_once_t));
@@ -4562,6 +5795,7 @@ static mdns_search_once_t *_mdns_search_init(const char *name, const char *servi
     search->result = NULL;
     search->state = SEARCH_INIT;
     search->sent_at = 0;
+    search->interval = MDNS_QUERY_MIN_INTERVAL_MS;
     search->started_at = xTaskGetTickCount() * portTICK_PERIOD_MS;
     search->notifier = notifier;
     search->next = NULL;
@@ -4589,6 +5823,7 @@ static void _mdns_search_add(mdns_search_once_t *search)
 {
     search->next = _mdns_server->search_once;
     _mdns_server->search_once = search;
+    _mdns_timer_arm();
 }
 
 /**
@@ -4614,7 +5849,7 @@ static mdns_ip_addr_t *_mdns_result_addr_create_ip(esp_ip_addr_t *ip)
 {
     mdns_ip_addr_t *a = (mdns_ip_addr_t *)malloc(sizeof(mdns_ip_addr_t));
     if (!a) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return NULL;
     }
     memset(a, 0, sizeof(mdns_ip_addr_t));
@@ -4685,7 +5920,7 @@ static void _mdns_search_result_add_ip(mdns_search_once_t *search, const char *h
         if (!search->max_results || search->num_results < search->max_results) {
             r = (mdns_result_t *)malloc(sizeof(mdns_result_t));
             if (!r) {
-                HOOK_MALLOC_FAILED;
+                MDNS_MALLOC_FAILED;
                 return;
             }
 
@@ -4697,7 +5932,7 @@ static void _mdns_search_result_add_ip(mdns_search_once_t *search, const char *h
                 return;
             }
             a->next = r->addr;
-            r->hostname = strdup(hostname);
+            r->hostname = (char *)_mdns_str_intern(hostname);
             r->addr = a;
             r->esp_netif = _mdns_get_esp_netif(tcpip_if);
             r->ip_protocol = ip_protocol;
@@ -4709,7 +5944,7 @@ static void _mdns_search_result_add_ip(mdns_search_once_t *search, const char *h
     } else if (search->type == MDNS_TYPE_PTR || search->type == MDNS_TYPE_SRV) {
         r = search->result;
         while (r) {
-            if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && !strcasecmp(hostname, r->hostname)) {
+            if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && _mdns_str_equal(hostname, r->hostname)) {
                 _mdns_result_add_ip(r, ip);
                 _mdns_result_update_ttl(r, ttl);
                 break;
@@ -4728,7 +5963,7 @@ static mdns_result_t *_mdns_search_result_add_ptr(mdns_search_once_t *search, co
 {
     mdns_result_t *r = search->result;
     while (r) {
-        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->instance_name) && !strcasecmp(instance, r->instance_name)) {
+        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->instance_name) && _mdns_str_equal(instance, r->instance_name)) {
             _mdns_result_update_ttl(r, ttl);
             return r;
         }
@@ -4737,7 +5972,7 @@ static mdns_result_t *_mdns_search_result_add_ptr(mdns_search_once_t *search, co
     if (!search->max_results || search->num_results < search->max_results) {
         r = (mdns_result_t *)malloc(sizeof(mdns_result_t));
         if (!r) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             return NULL;
         }
 
@@ -4761,6 +5996,23 @@ static mdns_result_t *_mdns_search_result_add_ptr(mdns_search_once_t *search, co
     return NULL;
 }
 
+/**
+ * @brief  Finds the result of a PTR search for the instance of a SRV or TXT record, adding it if not found
+ */
+static mdns_result_t *_mdns_search_result_get_instance(mdns_search_once_t *search, const mdns_name_t *instance,
+        mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl)
+{
+    mdns_result_t *result = search->result;
+    while (result) {
+        if (_mdns_get_esp_netif(tcpip_if) == result->esp_netif && ip_protocol == result->ip_protocol
+                && result->instance_name && !strcmp(instance->host, result->instance_name)) {
+            return result;
+        }
+        result = result->next;
+    }
+    return _mdns_search_result_add_ptr(search, instance->host, instance->service, instance->proto, tcpip_if, ip_protocol, ttl);
+}
+
 /**
  * @brief  Called from parser to add SRV data to search result
  */
@@ -4769,7 +6021,7 @@ static void _mdns_search_result_add_srv(mdns_search_once_t *search, const char *
 {
     mdns_result_t *r = search->result;
     while (r) {
-        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && !strcasecmp(hostname, r->hostname)) {
+        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && _mdns_str_equal(hostname, r->hostname)) {
             _mdns_result_update_ttl(r, ttl);
             return;
         }
@@ -4778,12 +6030,12 @@ static void _mdns_search_result_add_srv(mdns_search_once_t *search, const char *
     if (!search->max_results || search->num_results < search->max_results) {
         r = (mdns_result_t *)malloc(sizeof(mdns_result_t));
         if (!r) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             return;
         }
 
         memset(r, 0, sizeof(mdns_result_t));
-        r->hostname = strdup(hostname);
+        r->hostname = (char *)_mdns_str_intern(hostname);
         if (!r->hostname) {
             free(r);
             return;
@@ -4827,7 +6079,7 @@ static void _mdns_search_result_add_txt(mdns_search_once_t *search, mdns_txt_ite
     if (!search->max_results || search->num_results < search->max_results) {
         r = (mdns_result_t *)malloc(sizeof(mdns_result_t));
         if (!r) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             goto free_txt;
         }
 
@@ -4872,7 +6124,7 @@ static mdns_search_once_t *_mdns_search_find_from(mdns_search_once_t *s, mdns_na
                 continue;
             }
             if (s->type != MDNS_TYPE_PTR && s->type != MDNS_TYPE_SRV) {
-                if (!strcasecmp(name->host, s->instance)) {
+                if (_mdns_str_equal(name->host, s->instance)) {
                     return s;
                 }
                 s = s->next;
@@ -4880,7 +6132,7 @@ static mdns_search_once_t *_mdns_search_find_from(mdns_search_once_t *s, mdns_na
             }
             r = s->result;
             while (r) {
-                if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && !strcasecmp(name->host, r->hostname)) {
+                if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && _mdns_str_equal(name->host, r->hostname)) {
                     return s;
                 }
                 r = r->next;
@@ -4895,130 +6147,684 @@ static mdns_search_once_t *_mdns_search_find_from(mdns_search_once_t *s, mdns_na
                 s = s->next;
                 continue;
             }
-            if (strcasecmp(name->service, s->service)
-                    || strcasecmp(name->proto, s->proto)) {
+            if (!_mdns_str_equal(name->service, s->service)
+                    || !_mdns_str_equal(name->proto, s->proto)) {
                 s = s->next;
                 continue;
             }
             if (s->type != MDNS_TYPE_PTR) {
-                if (s->instance && strcasecmp(name->host, s->instance) == 0) {
+                if (s->instance && _mdns_str_equal(name->host, s->instance)) {
                     return s;
                 }
                 s = s->next;
                 continue;
             }
-            return s;
-        }
-
-        if (type == MDNS_TYPE_PTR && type == s->type && !strcasecmp(name->service, s->service) && !strcasecmp(name->proto, s->proto)) {
-            return s;
+            return s;
+        }
+
+        if (type == MDNS_TYPE_PTR && type == s->type && _mdns_str_equal(name->service, s->service) && _mdns_str_equal(name->proto, s->proto)) {
+            return s;
+        }
+
+        s = s->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief  Compares two optional names of a query, ignoring case
+ */
+static inline bool _mdns_query_name_equal(const char *a, const char *b)
+{
+    if (_str_null_or_empty(a) || _str_null_or_empty(b)) {
+        return _str_null_or_empty(a) && _str_null_or_empty(b);
+    }
+    return _mdns_str_equal(a, b);
+}
+
+/**
+ * @brief  Adds a question to a query packet, unless the packet already asks it
+ *
+ * @return false if out of memory
+ */
+static bool _mdns_query_add_question(mdns_tx_packet_t *packet, uint16_t type, bool unicast, const char *host, const char *service, const char *proto)
+{
+    mdns_out_question_t *q = packet->questions;
+    while (q) {
+        if (q->type == type && q->unicast == unicast && _mdns_query_name_equal(q->host, host)
+                && _mdns_query_name_equal(q->service, service) && _mdns_query_name_equal(q->proto, proto)) {
+            return true;
+        }
+        q = q->next;
+    }
+    q = (mdns_out_question_t *)malloc(sizeof(mdns_out_question_t));
+    if (!q) {
+        MDNS_MALLOC_FAILED;
+        return false;
+    }
+    q->next = NULL;
+    q->unicast = unicast;
+    q->type = type;
+    q->host = host;
+    q->service = service;
+    q->proto = proto;
+    q->domain = MDNS_DEFAULT_DOMAIN;
+    q->own_dynamic_memory = false;
+    queueToEnd(mdns_out_question_t, packet->questions, q);
+    return true;
+}
+
+/**
+ * @brief  Adds a known PTR answer to a query packet, unless the packet already lists it
+ *
+ * @return false if out of memory
+ */
+static bool _mdns_query_add_known_answer(mdns_tx_packet_t *packet, const char *instance, const char *service, const char *proto)
+{
+    mdns_out_answer_t *a = packet->answers;
+    while (a) {
+        if (a->type == MDNS_TYPE_PTR && _mdns_query_name_equal(a->custom_instance, instance)
+                && _mdns_query_name_equal(a->custom_service, service) && _mdns_query_name_equal(a->custom_proto, proto)) {
+            return true;
+        }
+        a = a->next;
+    }
+    a = (mdns_out_answer_t *)malloc(sizeof(mdns_out_answer_t));
+    if (!a) {
+        MDNS_MALLOC_FAILED;
+        return false;
+    }
+    a->type = MDNS_TYPE_PTR;
+    a->service = NULL;
+    a->host = NULL;
+    a->custom_instance = instance;
+    a->custom_service = service;
+    a->custom_proto = proto;
+    a->bye = false;
+    a->flush = false;
+    a->next = NULL;
+    queueToEnd(mdns_out_answer_t, packet->answers, a);
+    return true;
+}
+
+/**
+ * @brief  Adds the question of a search and its known answers to a query packet for particular interface
+ *
+ * @return false if out of memory
+ */
+static bool _mdns_search_add_to_packet(mdns_tx_packet_t *packet, mdns_search_once_t *search, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+{
+    mdns_result_t *r = NULL;
+    if (!_mdns_query_add_question(packet, search->type, search->unicast, search->instance, search->service, search->proto)) {
+        return false;
+    }
+    if (search->type == MDNS_TYPE_PTR) {
+        r = search->result;
+        while (r) {
+            //full record on the same interface is available
+            if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && r->instance_name && r->hostname && r->addr
+                    && !_mdns_query_add_known_answer(packet, r->instance_name, search->service, search->proto)) {
+                return false;
+            }
+            r = r->next;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  Adds the PTR question of a browse and its known answers to a query packet for particular interface
+ *
+ * @return false if out of memory
+ */
+static bool _mdns_browse_add_to_packet(mdns_tx_packet_t *packet, mdns_browse_t *browse, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+{
+    if (!_mdns_query_add_question(packet, MDNS_TYPE_PTR, false, NULL, browse->service, browse->proto)) {
+        return false;
+    }
+    mdns_result_t *r = browse->result;
+    while (r) {
+        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && r->ttl && r->instance_name && r->hostname
+                && !_mdns_query_add_known_answer(packet, r->instance_name, browse->service, browse->proto)) {
+            return false;
+        }
+        r = r->next;
+    }
+    return true;
+}
+
+/**
+ * @brief  Create search packet for particular interface
+ */
+static mdns_tx_packet_t *_mdns_create_search_packet(mdns_search_once_t *search, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+{
+    mdns_tx_packet_t *packet = _mdns_alloc_packet_default(tcpip_if, ip_protocol);
+    if (!packet) {
+        return NULL;
+    }
+    if (!_mdns_search_add_to_packet(packet, search, tcpip_if, ip_protocol)) {
+        _mdns_free_tx_packet(packet);
+        return NULL;
+    }
+    return packet;
+}
+
+/**
+ * @brief  Send search packet to particular interface
+ */
+static void _mdns_search_send_pcb(mdns_search_once_t *search, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+{
+    mdns_tx_packet_t *packet = NULL;
+    if (mdns_is_netif_ready(tcpip_if, ip_protocol) && _mdns_server->interfaces[tcpip_if].pcbs[ip_protocol].state > PCB_INIT) {
+        packet = _mdns_create_search_packet(search, tcpip_if, ip_protocol);
+        if (!packet) {
+            return;
+        }
+        _mdns_dispatch_tx_packet(packet);
+        _mdns_free_tx_packet(packet);
+    }
+}
+
+/**
+ * @brief  Checks whether a search needs to send its query
+ */
+static inline bool _mdns_search_query_due(const mdns_search_once_t *search, uint32_t now)
+{
+    return search->state == SEARCH_INIT || (now - search->sent_at) > search->interval;
+}
+
+/**
+ * @brief  Checks whether a browse needs to send its query
+ */
+static inline bool _mdns_browse_query_due(const mdns_browse_t *browse, uint32_t now)
+{
+    return browse->state == BROWSE_RUNNING && (!browse->interval || (now - browse->sent_at) > browse->interval);
+}
+
+/**
+ * @brief  Doubles the interval of a repeated query, up to the maximum
+ */
+static inline uint32_t _mdns_query_next_interval(uint32_t interval)
+{
+    if (interval < MDNS_QUERY_MIN_INTERVAL_MS) {
+        return MDNS_QUERY_MIN_INTERVAL_MS;
+    }
+    return interval >= MDNS_QUERY_MAX_INTERVAL_MS / 2 ? MDNS_QUERY_MAX_INTERVAL_MS : interval * 2;
+}
+
+/**
+ * @brief  Sends the queries of all searches and browses due at the same time
+ *
+ * The questions (and known answers) of all of them are merged into one packet per interface,
+ * asking each question once.
+ */
+static void _mdns_query_plan_send(uint32_t now)
+{
+    mdns_search_once_t *s;
+    mdns_browse_t *b;
+    for (uint8_t i = 0; i < MDNS_MAX_INTERFACES; i++) {
+        for (uint8_t j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
+            if (!mdns_is_netif_ready((mdns_if_t)i, (mdns_ip_protocol_t)j) || _mdns_server->interfaces[i].pcbs[j].state <= PCB_INIT) {
+                continue;
+            }
+            mdns_tx_packet_t *packet = _mdns_alloc_packet_default((mdns_if_t)i, (mdns_ip_protocol_t)j);
+            if (!packet) {
+                return;
+            }
+            bool added = true;
+            for (s = _mdns_server->search_once; s && added; s = s->next) {
+                if (s->state != SEARCH_OFF && _mdns_search_query_due(s, now)) {
+                    added = _mdns_search_add_to_packet(packet, s, (mdns_if_t)i, (mdns_ip_protocol_t)j);
+                }
+            }
+            for (b = _mdns_server->browse; b && added; b = b->next) {
+                if (_mdns_browse_query_due(b, now)) {
+                    added = _mdns_browse_add_to_packet(packet, b, (mdns_if_t)i, (mdns_ip_protocol_t)j);
+                }
+            }
+            if (added && packet->questions) {
+                _mdns_dispatch_tx_packet(packet);
+            }
+            _mdns_free_tx_packet(packet);
+        }
+    }
+    for (s = _mdns_server->search_once; s; s = s->next) {
+        if (s->state != SEARCH_OFF && _mdns_search_query_due(s, now)) {
+            if (s->state == SEARCH_RUNNING) {
+                s->interval = _mdns_query_next_interval(s->interval);
+            }
+            s->state = SEARCH_RUNNING;
+            s->sent_at = now;
+        }
+    }
+    for (b = _mdns_server->browse; b; b = b->next) {
+        if (_mdns_browse_query_due(b, now)) {
+            b->interval = _mdns_query_next_interval(b->interval);
+            b->sent_at = now;
+        }
+    }
+}
+
+/**
+ * @brief  Time a cached record expires, in ms
+ */
+static inline uint32_t _mdns_cache_expires_at(const mdns_cache_entry_t *e)
+{
+    return e->received_at + e->ttl * 1000;
+}
+
+/**
+ * @brief  Time of the next refresh query of a cached record, in ms
+ */
+static inline uint32_t _mdns_cache_refresh_at(const mdns_cache_entry_t *e)
+{
+    return e->received_at + e->ttl * (800 + 50 * e->refreshes + e->jitter);
+}
+
+/**
+ * @brief  Remaining TTL of a cached record, in seconds
+ */
+static inline uint32_t _mdns_cache_ttl_left(const mdns_cache_entry_t *e, uint32_t now)
+{
+    uint32_t left = (_mdns_cache_expires_at(e) - now) / 1000;
+    return left ? left : 1;
+}
+
+static inline bool _mdns_cache_refresh_due(const mdns_cache_entry_t *e, uint32_t now)
+{
+    return e->used && e->refreshes < MDNS_CACHE_REFRESH_QUERIES && (int32_t)(_mdns_cache_refresh_at(e) - now) <= 0;
+}
+
+/**
+ * @brief  Checks whether a cached record has the given name and type
+ *
+ * PTR records are named by their service, SRV and TXT records by their instance and A/AAAA records by their host.
+ */
+static bool _mdns_cache_entry_is(const mdns_cache_entry_t *e, uint16_t type, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol,
+                                 const char *instance, const char *service, const char *proto, const char *hostname)
+{
+    if (e->type != type || e->tcpip_if != tcpip_if || e->ip_protocol != ip_protocol) {
+        return false;
+    }
+    if (type == MDNS_TYPE_A || type == MDNS_TYPE_AAAA) {
+        return _mdns_str_equal(e->hostname, hostname);
+    }
+    if (type != MDNS_TYPE_PTR && !_mdns_str_equal(e->instance, instance)) {
+        return false;
+    }
+    return _mdns_str_equal(e->service, service) && _mdns_str_equal(e->proto, proto);
+}
+
+static void _mdns_cache_entry_free(mdns_cache_entry_t *e)
+{
+    queueDetach(mdns_cache_entry_t, _mdns_server->cache, e);
+    free(e);
+    _mdns_server->cache_stats.entries--;
+}
+
+/**
+ * @brief  Drops the record expiring soonest to make room for a new one
+ */
+static void _mdns_cache_evict(uint32_t now)
+{
+    mdns_cache_entry_t *e = _mdns_server->cache;
+    mdns_cache_entry_t *victim = e;
+    while (e) {
+        if ((int32_t)(_mdns_cache_expires_at(e) - _mdns_cache_expires_at(victim)) < 0) {
+            victim = e;
+        }
+        e = e->next;
+    }
+    if (!victim) {
+        return;
+    }
+    if ((int32_t)(_mdns_cache_expires_at(victim) - now) <= 0) {
+        _mdns_server->cache_stats.expired++;
+    } else {
+        _mdns_server->cache_stats.evicted++;
+    }
+    _mdns_cache_entry_free(victim);
+}
+
+/**
+ * @brief  Called from parser to cache a record of a response from another host
+ *
+ * Handles the goodbye (zero TTL) and the cache-flush bit as described in RFC 6762 sections 10.1 and 10.2.
+ */
+static void _mdns_cache_add_record(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, mdns_name_t *name, uint16_t type,
+                                   bool flush, uint32_t ttl, const uint8_t *packet, size_t packet_len,
+                                   const uint8_t *rdata, uint16_t rdata_len, mdns_parse_arena_t *arena)
+{
+    const char *instance = "";
+    const char *service = name->service;
+    const char *proto = name->proto;
+    const char *hostname = "";
+    const uint8_t *txt = NULL;
+    uint16_t txt_len = 0;
+    uint16_t port = 0;
+    esp_ip_addr_t addr;
+    mdns_name_t *target = &arena->target;
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+
+    if (!MDNS_CACHE_SIZE || name->invalid || name->sub || !_mdns_str_equal(name->domain, MDNS_DEFAULT_DOMAIN)) {
+        return;
+    }
+    memset(&addr, 0, sizeof(esp_ip_addr_t));
+    switch (type) {
+    case MDNS_TYPE_PTR:
+        if (name->host[0] || !name->service[0]
+                || !_mdns_parse_fqdn(packet, rdata, target, packet_len) || target->invalid || target->sub || !target->host[0]) {
+            return;
+        }
+        instance = target->host;
+        break;
+    case MDNS_TYPE_SRV:
+        if (!name->host[0] || !name->service[0] || rdata_len <= MDNS_SRV_FQDN_OFFSET
+                || !_mdns_parse_fqdn(packet, rdata + MDNS_SRV_FQDN_OFFSET, target, packet_len) || target->invalid || !target->host[0]) {
+            return;
+        }
+        instance = name->host;
+        hostname = target->host;
+        port = _mdns_read_u16(rdata, MDNS_SRV_PORT_OFFSET);
+        break;
+    case MDNS_TYPE_TXT:
+        if (!name->host[0] || !name->service[0]) {
+            return;
+        }
+        instance = name->host;
+        txt = rdata;
+        txt_len = rdata_len;
+        break;
+#ifdef CONFIG_LWIP_IPV4
+    case MDNS_TYPE_A:
+        if (!name->host[0] || name->service[0] || rdata_len != sizeof(esp_ip4_addr_t)) {
+            return;
+        }
+        hostname = name->host;
+        addr.type = ESP_IPADDR_TYPE_V4;
+        memcpy(&addr.u_addr.ip4.addr, rdata, sizeof(esp_ip4_addr_t));
+        break;
+#endif /* CONFIG_LWIP_IPV4 */
+#ifdef CONFIG_LWIP_IPV6
+    case MDNS_TYPE_AAAA:
+        if (!name->host[0] || name->service[0] || rdata_len != MDNS_ANSWER_AAAA_SIZE) {
+            return;
+        }
+        hostname = name->host;
+        addr.type = ESP_IPADDR_TYPE_V6;
+        memcpy(addr.u_addr.ip6.addr, rdata, MDNS_ANSWER_AAAA_SIZE);
+        break;
+#endif /* CONFIG_LWIP_IPV6 */
+    default:
+        return;
+    }
+    if (ttl > MDNS_CACHE_MAX_TTL) {
+        ttl = MDNS_CACHE_MAX_TTL;
+    }
+
+    mdns_cache_entry_t *e = _mdns_server->cache;
+    mdns_cache_entry_t *same = NULL;
+    while (e) {
+        if (_mdns_cache_entry_is(e, type, tcpip_if, ip_protocol, instance, service, proto, hostname)) {
+            bool is_same = true;
+            if (type == MDNS_TYPE_PTR) {
+                is_same = _mdns_str_equal(e->instance, instance);
+            } else if (type == MDNS_TYPE_A || type == MDNS_TYPE_AAAA) {
+                is_same = !memcmp(&e->addr, &addr, sizeof(esp_ip_addr_t));
+            }
+            if (is_same) {
+                same = e;
+            } else if (flush && (now - e->received_at) > 1000 && (int32_t)(_mdns_cache_expires_at(e) - now) > 1000) {
+                // records of this name received more than a second ago are outdated, but may still be in flight
+                e->ttl = (now - e->received_at) / 1000 + 1;
+                e->refreshes = MDNS_CACHE_REFRESH_QUERIES;
+            }
+        }
+        e = e->next;
+    }
+
+    if (!ttl) {
+        // goodbye, the record is removed a second later
+        if (same) {
+            same->received_at = now;
+            same->ttl = 1;
+            same->refreshes = MDNS_CACHE_REFRESH_QUERIES;
+        }
+        return;
+    }
+    if (same) {
+        if ((type != MDNS_TYPE_SRV || (same->port == port && _mdns_str_equal(same->hostname, hostname)))
+                && (type != MDNS_TYPE_TXT || (same->txt_len == txt_len && !memcmp(same->txt, txt, txt_len)))) {
+            same->received_at = now;
+            same->ttl = ttl;
+            same->refreshes = 0;
+            same->used = false;
+            return;
+        }
+        // the data has changed, the entry is allocated again
+        _mdns_cache_entry_free(same);
+    }
+
+    if (_mdns_server->cache_stats.entries >= MDNS_CACHE_SIZE) {
+        _mdns_cache_evict(now);
+    }
+    size_t instance_len = strlen(instance) + 1;
+    size_t service_len = strlen(service) + 1;
+    size_t proto_len = strlen(proto) + 1;
+    size_t hostname_len = strlen(hostname) + 1;
+    e = (mdns_cache_entry_t *)malloc(sizeof(mdns_cache_entry_t) + instance_len + service_len + proto_len + hostname_len + txt_len);
+    if (!e) {
+        MDNS_MALLOC_FAILED;
+        return;
+    }
+    memset(e, 0, sizeof(mdns_cache_entry_t));
+    e->type = type;
+    e->tcpip_if = tcpip_if;
+    e->ip_protocol = ip_protocol;
+    e->received_at = now;
+    e->ttl = ttl;
+    e->jitter = esp_random() % 21;
+    e->port = port;
+    e->addr = addr;
+    e->instance = (char *)(e + 1);
+    memcpy(e->instance, instance, instance_len);
+    e->service = e->instance + instance_len;
+    memcpy(e->service, service, service_len);
+    e->proto = e->service + service_len;
+    memcpy(e->proto, proto, proto_len);
+    e->hostname = e->proto + proto_len;
+    memcpy(e->hostname, hostname, hostname_len);
+    e->txt = (uint8_t *)e->hostname + hostname_len;
+    e->txt_len = txt_len;
+    if (txt_len) {
+        memcpy(e->txt, txt, txt_len);
+    }
+    e->next = _mdns_server->cache;
+    _mdns_server->cache = e;
+    _mdns_server->cache_stats.entries++;
+}
+
+/**
+ * @brief  Finds a cached record that has not expired yet
+ */
+static mdns_cache_entry_t *_mdns_cache_find_from(mdns_cache_entry_t *e, uint16_t type, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol,
+        const char *instance, const char *service, const char *proto, const char *hostname, uint32_t now)
+{
+    while (e) {
+        if (_mdns_cache_entry_is(e, type, tcpip_if, ip_protocol, instance, service, proto, hostname)
+                && (int32_t)(_mdns_cache_expires_at(e) - now) > 0) {
+            return e;
+        }
+        e = e->next;
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Adds the cached addresses of a host to a search result
+ */
+static void _mdns_cache_answer_ip(mdns_search_once_t *search, mdns_result_t *r, const char *hostname,
+                                  mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t now)
+{
+    static const uint16_t types[] = { MDNS_TYPE_A, MDNS_TYPE_AAAA };
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        mdns_cache_entry_t *e = _mdns_cache_find_from(_mdns_server->cache, types[i], tcpip_if, ip_protocol, NULL, NULL, NULL, hostname, now);
+        while (e) {
+            e->used = true;
+            if (r) {
+                _mdns_result_add_ip(r, &e->addr);
+            } else {
+                _mdns_search_result_add_ip(search, e->hostname, &e->addr, tcpip_if, ip_protocol, _mdns_cache_ttl_left(e, now));
+            }
+            e = _mdns_cache_find_from(e->next, types[i], tcpip_if, ip_protocol, NULL, NULL, NULL, hostname, now);
+        }
+    }
+}
+
+/**
+ * @brief  Answers a query from the cache
+ *
+ * Browsing (PTR) needs the SRV record of each instance to be cached, other types need at least one record.
+ *
+ * @return true if the results of the search were filled in from the cache
+ */
+static bool _mdns_cache_answer(mdns_search_once_t *search)
+{
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    bool complete = true;
+    mdns_cache_entry_t *e = _mdns_server->cache;
+
+    for (; e; e = e->next) {
+        if (e->type != search->type || (int32_t)(_mdns_cache_expires_at(e) - now) <= 0) {
+            continue;
+        }
+        uint32_t ttl = _mdns_cache_ttl_left(e, now);
+        if (e->type == MDNS_TYPE_A || e->type == MDNS_TYPE_AAAA) {
+            if (search->instance && _mdns_str_equal(e->hostname, search->instance)) {
+                e->used = true;
+                _mdns_search_result_add_ip(search, e->hostname, &e->addr, e->tcpip_if, e->ip_protocol, ttl);
+            }
+            continue;
+        }
+        if (!search->service || !search->proto || !_mdns_str_equal(e->service, search->service) || !_mdns_str_equal(e->proto, search->proto)
+                || (search->instance && !_mdns_str_equal(e->instance, search->instance))) {
+            continue;
+        }
+        e->used = true;
+        if (e->type == MDNS_TYPE_SRV) {
+            _mdns_search_result_add_srv(search, e->hostname, e->port, e->tcpip_if, e->ip_protocol, ttl);
+            _mdns_cache_answer_ip(search, NULL, e->hostname, e->tcpip_if, e->ip_protocol, now);
+        } else if (e->type == MDNS_TYPE_TXT) {
+            mdns_txt_item_t *txt = NULL;
+            uint8_t *txt_value_len = NULL;
+            size_t txt_count = 0;
+            _mdns_result_txt_create(e->txt, e->txt_len, &txt, &txt_value_len, &txt_count);
+            if (txt_count) {
+                _mdns_search_result_add_txt(search, txt, txt_value_len, txt_count, e->tcpip_if, e->ip_protocol, ttl);
+            }
+        } else if (e->type == MDNS_TYPE_PTR) {
+            mdns_result_t *r = _mdns_search_result_add_ptr(search, e->instance, e->service, e->proto, e->tcpip_if, e->ip_protocol, ttl);
+            if (!r) {
+                continue;
+            }
+            mdns_cache_entry_t *srv = _mdns_cache_find_from(_mdns_server->cache, MDNS_TYPE_SRV, e->tcpip_if, e->ip_protocol,
+                                      e->instance, e->service, e->proto, NULL, now);
+            if (!srv) {
+                complete = false;
+                continue;
+            }
+            srv->used = true;
+            if (!r->hostname) {
+                r->hostname = (char *)_mdns_str_intern(srv->hostname);
+                r->port = srv->port;
+            }
+            mdns_cache_entry_t *txt = _mdns_cache_find_from(_mdns_server->cache, MDNS_TYPE_TXT, e->tcpip_if, e->ip_protocol,
+                                      e->instance, e->service, e->proto, NULL, now);
+            if (txt) {
+                txt->used = true;
+                if (!r->txt) {
+                    _mdns_result_txt_create(txt->txt, txt->txt_len, &r->txt, &r->txt_value_len, &r->txt_count);
+                }
+            }
+            _mdns_cache_answer_ip(search, r, srv->hostname, e->tcpip_if, e->ip_protocol, now);
         }
-
-        s = s->next;
     }
 
-    return NULL;
+    if (!search->result || !complete) {
+        _mdns_query_results_free(search->result);
+        search->result = NULL;
+        search->num_results = 0;
+        _mdns_server->cache_stats.misses++;
+        return false;
+    }
+    _mdns_server->cache_stats.hits++;
+    // the records used are refreshed before they expire
+    _mdns_timer_arm();
+    return true;
 }
 
 /**
- * @brief  Create search packet for particular interface
+ * @brief  Sends a query for a cached record, the records due for a refresh with the same question are refreshed too
  */
-static mdns_tx_packet_t *_mdns_create_search_packet(mdns_search_once_t *search, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+static void _mdns_cache_refresh(mdns_cache_entry_t *e, uint32_t now)
 {
-    mdns_result_t *r = NULL;
-    mdns_tx_packet_t *packet = _mdns_alloc_packet_default(tcpip_if, ip_protocol);
-    if (!packet) {
-        return NULL;
-    }
-
-    mdns_out_question_t *q = (mdns_out_question_t *)malloc(sizeof(mdns_out_question_t));
-    if (!q) {
-        HOOK_MALLOC_FAILED;
-        _mdns_free_tx_packet(packet);
-        return NULL;
+    mdns_search_once_t search;
+    memset(&search, 0, sizeof(mdns_search_once_t));
+    search.type = e->type;
+    if (e->type == MDNS_TYPE_A || e->type == MDNS_TYPE_AAAA) {
+        search.instance = e->hostname;
+    } else {
+        if (e->type != MDNS_TYPE_PTR) {
+            search.instance = e->instance;
+        }
+        search.service = e->service;
+        search.proto = e->proto;
     }
-    q->next = NULL;
-    q->unicast = search->unicast;
-    q->type = search->type;
-    q->host = search->instance;
-    q->service = search->service;
-    q->proto = search->proto;
-    q->domain = MDNS_DEFAULT_DOMAIN;
-    q->own_dynamic_memory = false;
-    queueToEnd(mdns_out_question_t, packet->questions, q);
+    _mdns_search_send_pcb(&search, e->tcpip_if, e->ip_protocol);
+    _mdns_server->cache_stats.refresh_queries++;
 
-    if (search->type == MDNS_TYPE_PTR) {
-        r = search->result;
-        while (r) {
-            //full record on the same interface is available
-            if (r->esp_netif != _mdns_get_esp_netif(tcpip_if) || r->ip_protocol != ip_protocol || r->instance_name == NULL || r->hostname == NULL || r->addr == NULL) {
-                r = r->next;
-                continue;
-            }
-            mdns_out_answer_t *a = (mdns_out_answer_t *)malloc(sizeof(mdns_out_answer_t));
-            if (!a) {
-                HOOK_MALLOC_FAILED;
-                _mdns_free_tx_packet(packet);
-                return NULL;
-            }
-            a->type = MDNS_TYPE_PTR;
-            a->service = NULL;
-            a->custom_instance = r->instance_name;
-            a->custom_service = search->service;
-            a->custom_proto = search->proto;
-            a->bye = false;
-            a->flush = false;
-            a->next = NULL;
-            queueToEnd(mdns_out_answer_t, packet->answers, a);
-            r = r->next;
+    mdns_cache_entry_t *f = e->next;
+    while (f) {
+        if (_mdns_cache_refresh_due(f, now)
+                && _mdns_cache_entry_is(f, e->type, e->tcpip_if, e->ip_protocol, e->instance, e->service, e->proto, e->hostname)) {
+            f->refreshes++;
         }
+        f = f->next;
     }
-
-    return packet;
+    e->refreshes++;
 }
 
 /**
- * @brief  Send search packet to particular interface
+ * @brief  Removes the expired records and sends the refresh queries due
  */
-static void _mdns_search_send_pcb(mdns_search_once_t *search, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+static void _mdns_cache_run(uint32_t now)
 {
-    mdns_tx_packet_t *packet = NULL;
-    if (mdns_is_netif_ready(tcpip_if, ip_protocol) && _mdns_server->interfaces[tcpip_if].pcbs[ip_protocol].state > PCB_INIT) {
-        packet = _mdns_create_search_packet(search, tcpip_if, ip_protocol);
-        if (!packet) {
-            return;
+    mdns_cache_entry_t *e = _mdns_server->cache;
+    while (e) {
+        mdns_cache_entry_t *next = e->next;
+        if ((int32_t)(_mdns_cache_expires_at(e) - now) <= 0) {
+            _mdns_cache_entry_free(e);
+            _mdns_server->cache_stats.expired++;
+        } else if (_mdns_cache_refresh_due(e, now)) {
+            _mdns_cache_refresh(e, now);
         }
-        _mdns_dispatch_tx_packet(packet);
-        _mdns_free_tx_packet(packet);
+        e = next;
     }
 }
 
 /**
- * @brief  Send search packet to all available interfaces
+ * @brief  Removes the records received on an interface that goes down
  */
-static void _mdns_search_send(mdns_search_once_t *search)
+static void _mdns_cache_remove_pcb(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
 {
-    mdns_search_once_t *queue = _mdns_server->search_once;
-    bool found = false;
-    // looking for this search in active searches
-    while (queue) {
-        if (queue == search) {
-            found = true;
-            break;
-        }
-        queue = queue->next;
-    }
-
-    if (!found) {
-        // no longer active -> skip sending this search
-        return;
-    }
-
-    uint8_t i, j;
-    for (i = 0; i < MDNS_MAX_INTERFACES; i++) {
-        for (j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
-            _mdns_search_send_pcb(search, (mdns_if_t)i, (mdns_ip_protocol_t)j);
+    mdns_cache_entry_t *e = _mdns_server->cache;
+    while (e) {
+        mdns_cache_entry_t *next = e->next;
+        if (e->tcpip_if == tcpip_if && e->ip_protocol == ip_protocol) {
+            _mdns_cache_entry_free(e);
         }
+        e = next;
     }
 }
 
@@ -5033,7 +6839,10 @@ static void _mdns_tx_handle_packet(mdns_tx_packet_t *p)
         _mdns_free_tx_packet(p);
         return;
     }
-    _mdns_dispatch_tx_packet(p);
+    if (!p->dispatched) {
+        _mdns_dispatch_tx_packet(p);
+    }
+    p->dispatched = false;
 
     switch (pcb->state) {
     case PCB_PROBE_1:
@@ -5083,28 +6892,19 @@ static void _mdns_remap_self_service_hostname(const char *old_hostname, const ch
 {
     mdns_srv_item_t *service = _mdns_server->services;
 
+    //the hostname is the SRV target and the default instance of the services which don't have their own
+    _mdns_names_changed();
+
     while (service) {
         if (service->service->hostname &&
                 strcmp(service->service->hostname, old_hostname) == 0) {
-            free((char *)service->service->hostname);
-            service->service->hostname = strdup(new_hostname);
+            _mdns_str_release(service->service->hostname);
+            service->service->hostname = _mdns_str_intern(new_hostname);
         }
         service = service->next;
     }
 }
 
-static void _mdns_sync_browse_result_link_free(mdns_browse_sync_t *browse_sync)
-{
-    mdns_browse_result_sync_t *current = browse_sync->sync_result;
-    mdns_browse_result_sync_t *need_free;
-    while (current) {
-        need_free = current;
-        current = current->next;
-        free(need_free);
-    }
-    free(browse_sync);
-}
-
 /**
  * @brief  Free action data
  */
@@ -5119,8 +6919,6 @@ static void _mdns_free_action(mdns_action_t *action)
         break;
     case ACTION_SEARCH_ADD:
     //fallthrough
-    case ACTION_SEARCH_SEND:
-    //fallthrough
     case ACTION_SEARCH_END:
         _mdns_search_free(action->data.search_add.search);
         break;
@@ -5130,14 +6928,25 @@ static void _mdns_free_action(mdns_action_t *action)
         _mdns_browse_item_free(action->data.browse_add.browse);
         break;
     case ACTION_BROWSE_SYNC:
-        _mdns_sync_browse_result_link_free(action->data.browse_sync.browse_sync);
-        break;
-    case ACTION_TX_HANDLE:
-        _mdns_free_tx_packet(action->data.tx_handle.packet);
+        // the changes stay in the results of the browse
         break;
+    case ACTION_TIMER:
+        // statically allocated, can be queued again
+        _mdns_timer_action_queued = false;
+        return;
     case ACTION_RX_HANDLE:
         _mdns_packet_free(action->data.rx_handle.packet);
         break;
+    case ACTION_RX_BATCH_HANDLE: {
+        mdns_rx_packet_t *packet = action->data.rx_handle.packet;
+        _mdns_rx_batch_taken(packet);
+        while (packet) {
+            mdns_rx_packet_t *next = packet->next;
+            _mdns_packet_free(packet);
+            packet = next;
+        }
+    }
+    break;
     case ACTION_DELEGATE_HOSTNAME_SET_ADDR:
     case ACTION_DELEGATE_HOSTNAME_ADD:
         free((char *)action->data.delegate_hostname.hostname);
@@ -5149,7 +6958,47 @@ static void _mdns_free_action(mdns_action_t *action)
     default:
         break;
     }
-    free(action);
+    _mdns_action_release(action);
+}
+
+/**
+ * @brief  Whether the service thread is behind with the received packets, so it drops queries
+ */
+static bool _mdns_rx_overloaded(void)
+{
+    return _mdns_rx_pending() >= MDNS_RX_SHED_LEVEL;
+}
+
+/**
+ * @brief  Whether a received packet may be dropped under overload
+ *
+ * Queries may be, the queriers repeat them, but not probes (queries with authority records), whose
+ * conflicts must be detected, nor responses, which update the cache, the searches and the browses.
+ */
+static bool _mdns_rx_sheddable(mdns_rx_packet_t *packet)
+{
+    const uint8_t *data = (const uint8_t *)_mdns_get_packet_data(packet);
+    if (_mdns_get_packet_len(packet) < MDNS_HEAD_LEN) {
+        return true;
+    }
+    return !(_mdns_read_u16(data, MDNS_HEAD_FLAGS_OFFSET) & MDNS_FLAGS_QUERY_REPSONSE) && !_mdns_read_u16(data, MDNS_HEAD_SERVERS_OFFSET);
+}
+
+/**
+ * @brief  Counts a received packet and parses it, unless it is a query received under overload
+ */
+static void _mdns_handle_rx_packet(mdns_rx_packet_t *packet, bool overloaded)
+{
+    mdns_netif_stats_t *stats = _mdns_stats_netif(packet->tcpip_if, packet->ip_protocol);
+    if (overloaded && _mdns_rx_sheddable(packet)) {
+        stats->rx_shed++;
+        return;
+    }
+    stats->rx_packets++;
+    stats->rx_bytes += _mdns_get_packet_len(packet);
+    int64_t start = esp_timer_get_time();
+    mdns_parse_packet(packet, &_mdns_server->parse_arena);
+    _mdns_stats_latency(_mdns_server->stats.parse_us, start);
 }
 
 /**
@@ -5174,15 +7023,13 @@ static void _mdns_execute_action(mdns_action_t *action)
         _mdns_send_bye_all_pcbs_no_instance(false);
         free((char *)_mdns_server->instance);
         _mdns_server->instance = action->data.instance;
+        _mdns_names_changed();
         _mdns_restart_all_pcbs_no_instance();
 
         break;
     case ACTION_SEARCH_ADD:
         _mdns_search_add(action->data.search_add.search);
         break;
-    case ACTION_SEARCH_SEND:
-        _mdns_search_send(action->data.search_add.search);
-        break;
     case ACTION_SEARCH_END:
         _mdns_search_finish(action->data.search_add.search);
         break;
@@ -5191,35 +7038,37 @@ static void _mdns_execute_action(mdns_action_t *action)
         _mdns_browse_add(action->data.browse_add.browse);
         break;
     case ACTION_BROWSE_SYNC:
-        _mdns_browse_sync(action->data.browse_sync.browse_sync);
-        _mdns_sync_browse_result_link_free(action->data.browse_sync.browse_sync);
+        _mdns_browse_sync(action->data.browse_sync.browse);
         break;
     case ACTION_BROWSE_END:
         _mdns_browse_finish(action->data.browse_add.browse);
         break;
 
-    case ACTION_TX_HANDLE: {
-        mdns_tx_packet_t *p = _mdns_server->tx_queue_head;
-        // packet to be handled should be at tx head, but must be consistent with the one pushed to action queue
-        if (p && p == action->data.tx_handle.packet && p->queued) {
-            p->queued = false; // clearing, as the packet might be reused (pushed and transmitted again)
-            _mdns_server->tx_queue_head = p->next;
-            _mdns_tx_handle_packet(p);
-        } else {
-            ESP_LOGD(TAG, "Skipping transmit of an unexpected packet!");
-        }
-    }
-    break;
+    case ACTION_TIMER:
+        _mdns_timer_run();
+        return; // statically allocated
     case ACTION_RX_HANDLE:
-        mdns_parse_packet(action->data.rx_handle.packet);
+        _mdns_handle_rx_packet(action->data.rx_handle.packet, _mdns_rx_overloaded());
         _mdns_packet_free(action->data.rx_handle.packet);
         break;
+    case ACTION_RX_BATCH_HANDLE: {
+        mdns_rx_packet_t *packet = action->data.rx_handle.packet;
+        _mdns_rx_batch_taken(packet);
+        bool overloaded = _mdns_rx_overloaded();
+        while (packet) {
+            mdns_rx_packet_t *next = packet->next;
+            _mdns_handle_rx_packet(packet, overloaded);
+            _mdns_packet_free(packet);
+            packet = next;
+        }
+    }
+    break;
     case ACTION_DELEGATE_HOSTNAME_ADD:
         if (!_mdns_delegate_hostname_add(action->data.delegate_hostname.hostname,
                                          action->data.delegate_hostname.address_list)) {
-            free((char *)action->data.delegate_hostname.hostname);
             free_address_list(action->data.delegate_hostname.address_list);
         }
+        free((char *)action->data.delegate_hostname.hostname);
         xSemaphoreGive(_mdns_server->action_sema);
         break;
     case ACTION_DELEGATE_HOSTNAME_SET_ADDR:
@@ -5236,7 +7085,7 @@ static void _mdns_execute_action(mdns_action_t *action)
     default:
         break;
     }
-    free(action);
+    _mdns_action_release(action);
 }
 
 /**
@@ -5246,104 +7095,241 @@ static esp_err_t _mdns_send_search_action(mdns_action_type_t type, mdns_search_o
 {
     mdns_action_t *action = NULL;
 
-    action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return ESP_ERR_NO_MEM;
     }
 
     action->type = type;
     action->data.search_add.search = search;
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
-        free(action);
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     return ESP_OK;
 }
 
 /**
- * @brief  Called from timer task to run mDNS responder
- *
- * periodically checks first unqueued packet (from tx head).
- * if it is scheduled to be transmitted, then pushes the packet to action queue to be handled.
+ * @brief  Finds the earliest time a scheduled packet or a running search needs the service thread
  *
+ * @return true if there is anything scheduled at all
  */
-static void _mdns_scheduler_run(void)
+static bool _mdns_timer_next_deadline(uint32_t now, uint32_t *deadline)
 {
-    MDNS_SERVICE_LOCK();
-    mdns_tx_packet_t *p = _mdns_server->tx_queue_head;
-    mdns_action_t *action = NULL;
-
-    // find first unqueued packet
-    while (p && p->queued) {
-        p = p->next;
+    bool scheduled = false;
+    if (_mdns_server->tx_queue_head) {
+        *deadline = _mdns_server->tx_queue_head->send_at;
+        scheduled = true;
     }
-    if (!p) {
-        MDNS_SERVICE_UNLOCK();
-        return;
+    mdns_search_once_t *s = _mdns_server->search_once;
+    while (s) {
+        if (s->state != SEARCH_OFF) {
+            uint32_t at = s->started_at + s->timeout + 1;
+            if (s->state == SEARCH_INIT) {
+                at = now;
+            } else if ((int32_t)(s->sent_at + s->interval + 1 - at) < 0) {
+                at = s->sent_at + s->interval + 1;
+            }
+            if (!scheduled || (int32_t)(at - *deadline) < 0) {
+                *deadline = at;
+                scheduled = true;
+            }
+        }
+        s = s->next;
     }
-    while (p && (int32_t)(p->send_at - (xTaskGetTickCount() * portTICK_PERIOD_MS)) < 0) {
-        action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
-        if (action) {
-            action->type = ACTION_TX_HANDLE;
-            action->data.tx_handle.packet = p;
-            p->queued = true;
-            if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
-                free(action);
-                p->queued = false;
+    mdns_browse_t *b = _mdns_server->browse;
+    while (b) {
+        if (b->state == BROWSE_RUNNING) {
+            uint32_t at = b->interval ? b->sent_at + b->interval + 1 : now;
+            if (!scheduled || (int32_t)(at - *deadline) < 0) {
+                *deadline = at;
+                scheduled = true;
             }
-        } else {
-            HOOK_MALLOC_FAILED;
-            break;
         }
-        //Find the next unqued packet
-        p = p->next;
+        b = b->next;
     }
-    MDNS_SERVICE_UNLOCK();
+    mdns_cache_entry_t *e = _mdns_server->cache;
+    while (e) {
+        uint32_t at = _mdns_cache_expires_at(e);
+        if (e->used && e->refreshes < MDNS_CACHE_REFRESH_QUERIES) {
+            at = _mdns_cache_refresh_at(e);
+        }
+        if (!scheduled || (int32_t)(at - *deadline) < 0) {
+            *deadline = at;
+            scheduled = true;
+        }
+        e = e->next;
+    }
+    return scheduled;
 }
 
 /**
- * @brief  Called from timer task to run active searches
+ * @brief  Arms the one-shot timer for the earliest deadline
+ *
+ * Keeps the timer if it's already armed for an earlier time and stops it if there is nothing scheduled,
+ * so that an idle responder does not wake up at all.
  */
-static void _mdns_search_run(void)
+static void _mdns_timer_arm(void)
 {
-    MDNS_SERVICE_LOCK();
-    mdns_search_once_t *s = _mdns_server->search_once;
-    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
-    if (!s) {
-        MDNS_SERVICE_UNLOCK();
+    uint32_t now, deadline;
+    if (!_mdns_server->timer_handle) {
+        return;
+    }
+    now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    if (!_mdns_timer_next_deadline(now, &deadline)) {
+        if (_mdns_server->timer_armed) {
+            esp_timer_stop(_mdns_server->timer_handle);
+            _mdns_server->timer_armed = false;
+        }
+        return;
+    }
+    if (_mdns_server->timer_armed && (int32_t)(deadline - _mdns_server->timer_deadline) >= 0) {
         return;
     }
+    int32_t delay = (int32_t)(deadline - now);
+    esp_timer_stop(_mdns_server->timer_handle);
+    if (esp_timer_start_once(_mdns_server->timer_handle, delay > 0 ? (uint64_t)delay * 1000 : 0) == ESP_OK) {
+        _mdns_server->timer_armed = true;
+        _mdns_server->timer_deadline = deadline;
+    }
+}
+
+/**
+ * @brief  Finishes the timed out searches and sends the queries of searches and browses due for (re)transmission
+ */
+static void _mdns_search_run(uint32_t now)
+{
+    bool due = false;
+    mdns_search_once_t *s = _mdns_server->search_once;
     while (s) {
+        mdns_search_once_t *next = s->next;
         if (s->state != SEARCH_OFF) {
             if (now > (s->started_at + s->timeout)) {
-                s->state = SEARCH_OFF;
-                if (_mdns_send_search_action(ACTION_SEARCH_END, s) != ESP_OK) {
-                    s->state = SEARCH_RUNNING;
-                }
-            } else if (s->state == SEARCH_INIT || (now - s->sent_at) > 1000) {
-                s->state = SEARCH_RUNNING;
-                s->sent_at = now;
-                if (_mdns_send_search_action(ACTION_SEARCH_SEND, s) != ESP_OK) {
-                    s->sent_at -= 1000;
-                }
+                _mdns_search_finish(s);
+            } else if (_mdns_search_query_due(s, now)) {
+                due = true;
             }
         }
-        s = s->next;
+        s = next;
     }
-    MDNS_SERVICE_UNLOCK();
+    mdns_browse_t *b = _mdns_server->browse;
+    while (b && !due) {
+        due = _mdns_browse_query_due(b, now);
+        b = b->next;
+    }
+    if (due) {
+        _mdns_query_plan_send(now);
+    }
+}
+
+/**
+ * @brief  Checks whether two packets write the same questions and records (apart from the addresses of this host)
+ */
+static bool _mdns_tx_packets_same_records(const mdns_tx_packet_t *a, const mdns_tx_packet_t *b)
+{
+    if (a->flags != b->flags || a->id != b->id) {
+        return false;
+    }
+    const mdns_out_question_t *qa = a->questions, *qb = b->questions;
+    for (; qa && qb; qa = qa->next, qb = qb->next) {
+        if (qa->type != qb->type || qa->unicast != qb->unicast || qa->host != qb->host
+                || qa->service != qb->service || qa->proto != qb->proto || qa->domain != qb->domain) {
+            return false;
+        }
+    }
+    if (qa || qb) {
+        return false;
+    }
+    const mdns_out_answer_t *sa[] = { a->answers, a->servers, a->additional };
+    const mdns_out_answer_t *sb[] = { b->answers, b->servers, b->additional };
+    for (uint8_t i = 0; i < 3; i++) {
+        const mdns_out_answer_t *ra = sa[i], *rb = sb[i];
+        for (; ra && rb; ra = ra->next, rb = rb->next) {
+            if (ra->type != rb->type || ra->bye != rb->bye || ra->flush != rb->flush
+                    || ra->service != rb->service || ra->host != rb->host || ra->custom_instance != rb->custom_instance
+                    || ra->custom_service != rb->custom_service || ra->custom_proto != rb->custom_proto) {
+                return false;
+            }
+        }
+        if (ra || rb) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  Handles a packet due now, together with the packets of the other PCBs writing the same records
+ *
+ * Probes and announcements of all PCBs are scheduled together. The ones due within MDNS_TX_FANOUT_WINDOW_MS
+ * are taken out of the queue and sent encoding their records once, then each of them advances its PCB.
+ */
+static void _mdns_tx_handle_packet_fanout(mdns_tx_packet_t *p, uint32_t now)
+{
+    mdns_tx_packet_t *same[MDNS_MAX_INTERFACES * MDNS_IP_PROTOCOL_MAX] = { p };
+    size_t len = 1;
+
+    if (_mdns_server->interfaces[p->tcpip_if].pcbs[p->ip_protocol].state != PCB_OFF) {
+        mdns_tx_packet_t **q = &_mdns_server->tx_queue_head;
+        while (*q && (int32_t)((*q)->send_at - now) < MDNS_TX_FANOUT_WINDOW_MS && len < sizeof(same) / sizeof(same[0])) {
+            mdns_tx_packet_t *c = *q;
+            bool taken = _mdns_server->interfaces[c->tcpip_if].pcbs[c->ip_protocol].state == PCB_OFF;
+            for (size_t i = 0; i < len && !taken; i++) {
+                taken = same[i]->tcpip_if == c->tcpip_if && same[i]->ip_protocol == c->ip_protocol;
+            }
+            if (!taken && _mdns_tx_packets_same_records(p, c)) {
+                *q = c->next;
+                same[len++] = c;
+            } else {
+                q = &c->next;
+            }
+        }
+    }
+    if (len > 1) {
+        _mdns_dispatch_tx_packet_to(p, same, len);
+        for (size_t i = 0; i < len; i++) {
+            same[i]->dispatched = true;
+        }
+    }
+    for (size_t i = 0; i < len; i++) {
+        _mdns_tx_handle_packet(same[i]);
+    }
+}
+
+/**
+ * @brief  Called from service thread when the timer expires
+ *
+ * Transmits the packets scheduled until now (or within the current tick), runs the active searches
+ * and arms the timer for the next deadline.
+ */
+static void _mdns_timer_run(void)
+{
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    _mdns_timer_action_queued = false;
+    _mdns_server->timer_armed = false;
+    while (_mdns_server->tx_queue_head && (int32_t)(_mdns_server->tx_queue_head->send_at - now) < (int32_t)portTICK_PERIOD_MS) {
+        mdns_tx_packet_t *p = _mdns_server->tx_queue_head;
+        _mdns_server->tx_queue_head = p->next;
+        _mdns_tx_handle_packet_fanout(p, now);
+    }
+    _mdns_search_run(now);
+    _mdns_cache_run(now);
+    _mdns_timer_arm();
 }
 
 /**
  * @brief  the main MDNS service task. Packets are received and parsed here
+ *
+ * Waits for an action in any of the lanes, then executes the one the scheduler picks.
  */
 static void _mdns_service_task(void *pvParameters)
 {
     mdns_action_t *a = NULL;
     for (;;) {
-        if (_mdns_server && _mdns_server->action_queue) {
-            if (xQueueReceive(_mdns_server->action_queue, &a, portMAX_DELAY) == pdTRUE) {
-                if (a && a->type == ACTION_TASK_STOP) {
+        if (_mdns_server && _mdns_server->lanes_pending) {
+            if (xSemaphoreTake(_mdns_server->lanes_pending, portMAX_DELAY) == pdTRUE && (a = _mdns_action_take()) != NULL) {
+                if (a->type == ACTION_TASK_STOP) {
                     break;
                 }
                 MDNS_SERVICE_LOCK();
@@ -5358,10 +7344,21 @@ static void _mdns_service_task(void *pvParameters)
     vTaskDelete(NULL);
 }
 
+/**
+ * @brief  Called from timer task when the earliest deadline expires, hands the work over to the service thread
+ */
 static void _mdns_timer_cb(void *arg)
 {
-    _mdns_scheduler_run();
-    _mdns_search_run();
+    mdns_action_t *action = &_mdns_timer_action;
+    if (_mdns_timer_action_queued) {
+        return;
+    }
+    _mdns_timer_action_queued = true;
+    if (!_mdns_action_post(MDNS_LANE_TIMER, action)) {
+        // cannot happen with a single timer action, but retry later rather than lose the deadlines
+        _mdns_timer_action_queued = false;
+        esp_timer_start_once(_mdns_server->timer_handle, MDNS_TIMER_PERIOD_US);
+    }
 }
 
 static esp_err_t _mdns_start_timer(void)
@@ -5376,18 +7373,20 @@ static esp_err_t _mdns_start_timer(void)
     if (err) {
         return err;
     }
-    return esp_timer_start_periodic(_mdns_server->timer_handle, MDNS_TIMER_PERIOD_US);
+    _mdns_timer_arm();
+    return ESP_OK;
 }
 
 static esp_err_t _mdns_stop_timer(void)
 {
     esp_err_t err = ESP_OK;
     if (_mdns_server->timer_handle) {
-        err = esp_timer_stop(_mdns_server->timer_handle);
-        if (err) {
-            return err;
-        }
+        esp_timer_stop(_mdns_server->timer_handle);
         err = esp_timer_delete(_mdns_server->timer_handle);
+        if (!err) {
+            _mdns_server->timer_handle = NULL;
+            _mdns_server->timer_armed = false;
+        }
     }
     return err;
 }
@@ -5440,7 +7439,7 @@ static esp_err_t _mdns_service_task_stop(void)
         mdns_action_t action;
         mdns_action_t *a = &action;
         action.type = ACTION_TASK_STOP;
-        if (xQueueSend(_mdns_server->action_queue, &a, (TickType_t)0) != pdPASS) {
+        if (!_mdns_action_post(MDNS_LANE_CONTROL, a)) {
             vTaskDelete(_mdns_service_task_handle);
             _mdns_service_task_handle = NULL;
         }
@@ -5459,17 +7458,18 @@ static esp_err_t mdns_post_custom_action_tcpip_if(mdns_if_t mdns_if, mdns_event_
         return ESP_ERR_INVALID_STATE;
     }
 
-    mdns_action_t *action = (mdns_action_t *)calloc(1, sizeof(mdns_action_t));
+    mdns_action_t *action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return ESP_ERR_NO_MEM;
     }
+    memset(action, 0, sizeof(mdns_action_t));
     action->type = ACTION_SYSTEM_EVENT;
     action->data.sys_event.event_action = event_action;
     action->data.sys_event.interface = mdns_if;
 
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
-        free(action);
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
+        _mdns_action_release(action);
     }
     return ESP_OK;
 }
@@ -5560,6 +7560,28 @@ esp_err_t mdns_unregister_netif(esp_netif_t *esp_netif)
 }
 
 
+/**
+ * @brief  Free the actions still pending and delete the lanes
+ */
+static void _mdns_lanes_delete(void)
+{
+    for (mdns_lane_t i = 0; i < MDNS_LANE_MAX; i++) {
+        if (!_mdns_server->lanes[i]) {
+            continue;
+        }
+        mdns_action_t *c;
+        while (xQueueReceive(_mdns_server->lanes[i], &c, 0) == pdTRUE) {
+            _mdns_free_action(c);
+        }
+        vQueueDelete(_mdns_server->lanes[i]);
+        _mdns_server->lanes[i] = NULL;
+    }
+    if (_mdns_server->lanes_pending) {
+        vSemaphoreDelete(_mdns_server->lanes_pending);
+        _mdns_server->lanes_pending = NULL;
+    }
+}
+
 esp_err_t mdns_init(void)
 {
     esp_err_t err = ESP_OK;
@@ -5570,25 +7592,33 @@ esp_err_t mdns_init(void)
 
     _mdns_server = (mdns_server_t *)malloc(sizeof(mdns_server_t));
     if (!_mdns_server) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return ESP_ERR_NO_MEM;
     }
     memset((uint8_t *)_mdns_server, 0, sizeof(mdns_server_t));
+    atomic_store(&_mdns_action_pool_in_use_max, atomic_load(&_mdns_action_pool_in_use));
+    atomic_store(&_mdns_stats_alloc_failures, 0);
+    memset(_mdns_stats_rx_dropped, 0, sizeof(_mdns_stats_rx_dropped));
+    atomic_store(&_mdns_rx_batched, 0);
     // zero-out local copy of netifs to initiate a fresh search by interface key whenever a netif ptr is needed
     for (mdns_if_t i = 0; i < MDNS_MAX_INTERFACES; ++i) {
         s_esp_netifs[i].netif = NULL;
     }
 
-    _mdns_server->action_queue = xQueueCreate(MDNS_ACTION_QUEUE_LEN, sizeof(mdns_action_t *));
-    if (!_mdns_server->action_queue) {
+    _mdns_server->lanes[MDNS_LANE_CONTROL] = xQueueCreate(MDNS_ACTION_QUEUE_LEN, sizeof(mdns_action_t *));
+    _mdns_server->lanes[MDNS_LANE_TIMER] = xQueueCreate(1, sizeof(mdns_action_t *));
+    _mdns_server->lanes[MDNS_LANE_RX] = xQueueCreate(MDNS_RX_QUEUE_LEN, sizeof(mdns_action_t *));
+    _mdns_server->lanes_pending = xSemaphoreCreateCounting(MDNS_ACTION_QUEUE_LEN + 1 + MDNS_RX_QUEUE_LEN, 0);
+    if (!_mdns_server->lanes[MDNS_LANE_CONTROL] || !_mdns_server->lanes[MDNS_LANE_TIMER] || !_mdns_server->lanes[MDNS_LANE_RX]
+            || !_mdns_server->lanes_pending) {
         err = ESP_ERR_NO_MEM;
-        goto free_server;
+        goto free_lanes;
     }
 
     _mdns_server->action_sema = xSemaphoreCreateBinary();
     if (!_mdns_server->action_sema) {
         err = ESP_ERR_NO_MEM;
-        goto free_queue;
+        goto free_lanes;
     }
 
 #if MDNS_ESP_WIFI_ENABLED && (CONFIG_MDNS_PREDEF_NETIF_STA || CONFIG_MDNS_PREDEF_NETIF_AP)
@@ -5650,9 +7680,8 @@ free_event_handlers:
     unregister_predefined_handlers();
 #endif
     vSemaphoreDelete(_mdns_server->action_sema);
-free_queue:
-    vQueueDelete(_mdns_server->action_queue);
-free_server:
+free_lanes:
+    _mdns_lanes_delete();
     free(_mdns_server);
     _mdns_server = NULL;
     return err;
@@ -5678,13 +7707,7 @@ void mdns_free(void)
     }
     free((char *)_mdns_server->hostname);
     free((char *)_mdns_server->instance);
-    if (_mdns_server->action_queue) {
-        mdns_action_t *c;
-        while (xQueueReceive(_mdns_server->action_queue, &c, 0) == pdTRUE) {
-            _mdns_free_action(c);
-        }
-        vQueueDelete(_mdns_server->action_queue);
-    }
+    _mdns_lanes_delete();
     _mdns_clear_tx_queue_head();
     while (_mdns_server->search_once) {
         mdns_search_once_t *h = _mdns_server->search_once;
@@ -5704,6 +7727,7 @@ void mdns_free(void)
         _mdns_browse_item_free(b);
 
     }
+    queueFree(mdns_cache_entry_t, _mdns_server->cache);
     vSemaphoreDelete(_mdns_server->action_sema);
     free(_mdns_server);
     _mdns_server = NULL;
@@ -5722,17 +7746,17 @@ esp_err_t mdns_hostname_set(const char *hostname)
         return ESP_ERR_NO_MEM;
     }
 
-    mdns_action_t *action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    mdns_action_t *action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         free(new_hostname);
         return ESP_ERR_NO_MEM;
     }
     action->type = ACTION_HOSTNAME_SET;
     action->data.hostname_set.hostname = new_hostname;
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
         free(new_hostname);
-        free(action);
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     xSemaphoreTake(_mdns_server->action_sema, portMAX_DELAY);
@@ -5770,18 +7794,18 @@ esp_err_t mdns_delegate_hostname_add(const char *hostname, const mdns_ip_addr_t
         return ESP_ERR_NO_MEM;
     }
 
-    mdns_action_t *action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    mdns_action_t *action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         free(new_hostname);
         return ESP_ERR_NO_MEM;
     }
     action->type = ACTION_DELEGATE_HOSTNAME_ADD;
     action->data.delegate_hostname.hostname = new_hostname;
     action->data.delegate_hostname.address_list = copy_address_list(address_list);
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
         free(new_hostname);
-        free(action);
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     xSemaphoreTake(_mdns_server->action_sema, portMAX_DELAY);
@@ -5801,17 +7825,17 @@ esp_err_t mdns_delegate_hostname_remove(const char *hostname)
         return ESP_ERR_NO_MEM;
     }
 
-    mdns_action_t *action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    mdns_action_t *action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         free(new_hostname);
         return ESP_ERR_NO_MEM;
     }
     action->type = ACTION_DELEGATE_HOSTNAME_REMOVE;
     action->data.delegate_hostname.hostname = new_hostname;
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
         free(new_hostname);
-        free(action);
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     return ESP_OK;
@@ -5830,18 +7854,18 @@ esp_err_t mdns_delegate_hostname_set_address(const char *hostname, const mdns_ip
         return ESP_ERR_NO_MEM;
     }
 
-    mdns_action_t *action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    mdns_action_t *action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         free(new_hostname);
         return ESP_ERR_NO_MEM;
     }
     action->type = ACTION_DELEGATE_HOSTNAME_SET_ADDR;
     action->data.delegate_hostname.hostname = new_hostname;
     action->data.delegate_hostname.address_list = copy_address_list(address_list);
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
         free(new_hostname);
-        free(action);
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     return ESP_OK;
@@ -5869,17 +7893,17 @@ esp_err_t mdns_instance_name_set(const char *instance)
         return ESP_ERR_NO_MEM;
     }
 
-    mdns_action_t *action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    mdns_action_t *action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         free(new_instance);
         return ESP_ERR_NO_MEM;
     }
     action->type = ACTION_INSTANCE_SET;
     action->data.instance = new_instance;
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
         free(new_instance);
-        free(action);
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     return ESP_OK;
@@ -5900,32 +7924,33 @@ esp_err_t mdns_service_add_for_host(const char *instance, const char *service, c
     esp_err_t ret = ESP_OK;
     const char *hostname = host ? host : _mdns_server->hostname;
     mdns_service_t *s = NULL;
+    uint8_t *txt_data = NULL;
+    uint16_t txt_len = 0;
 
     ESP_GOTO_ON_FALSE(_mdns_can_add_more_services(), ESP_ERR_NO_MEM, err, TAG, "Cannot add more services");
 
     mdns_srv_item_t *item = _mdns_get_service_item_instance(instance, service, proto, hostname);
     ESP_GOTO_ON_FALSE(!item, ESP_ERR_INVALID_ARG, err, TAG, "Service already exists");
 
-    s = _mdns_create_service(service, proto, hostname, port, instance, num_items, txt);
+    ESP_GOTO_ON_ERROR(_mdns_allocate_txt(num_items, txt, &txt_data, &txt_len), err, TAG, "Cannot create service TXT data");
+
+    s = _mdns_create_service(service, proto, hostname, port, instance, txt_data, txt_len);
     ESP_GOTO_ON_FALSE(s, ESP_ERR_NO_MEM, err, TAG, "Cannot create service: Out of memory");
 
     item = (mdns_srv_item_t *)malloc(sizeof(mdns_srv_item_t));
     ESP_GOTO_ON_FALSE(item, ESP_ERR_NO_MEM, err, TAG, "Cannot create service: Out of memory");
 
     item->service = s;
-    item->next = NULL;
-
-    item->next = _mdns_server->services;
-    _mdns_server->services = item;
+    _mdns_srv_item_attach(item);
     _mdns_probe_all_pcbs(&item, 1, false, false);
     MDNS_SERVICE_UNLOCK();
     return ESP_OK;
 
 err:
-    MDNS_SERVICE_UNLOCK();
     _mdns_free_service(s);
+    MDNS_SERVICE_UNLOCK();
     if (ret == ESP_ERR_NO_MEM) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
     }
     return ret;
 }
@@ -5958,11 +7983,11 @@ bool mdns_service_exists_with_instance(const char *instance, const char *service
     return ret;
 }
 
-static mdns_txt_item_t *_copy_mdns_txt_items(mdns_txt_linked_item_t *items, uint8_t **txt_value_len, size_t *txt_count)
+static mdns_txt_item_t *_copy_mdns_txt_items(const uint8_t *txt, uint16_t txt_len, uint8_t **txt_value_len, size_t *txt_count)
 {
     mdns_txt_item_t *ret = NULL;
     size_t ret_index = 0;
-    for (mdns_txt_linked_item_t *tmp = items; tmp != NULL; tmp = tmp->next) {
+    for (uint16_t i = 0; i < txt_len; i += 1 + txt[i]) {
         ret_index++;
     }
     *txt_count = ret_index;
@@ -5973,29 +7998,34 @@ static mdns_txt_item_t *_copy_mdns_txt_items(mdns_txt_linked_item_t *items, uint
     ret = (mdns_txt_item_t *)calloc(ret_index, sizeof(mdns_txt_item_t));
     *txt_value_len = (uint8_t *)calloc(ret_index, sizeof(uint8_t));
     if (!ret || !(*txt_value_len)) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         goto handle_error;
     }
     ret_index = 0;
-    for (mdns_txt_linked_item_t *tmp = items; tmp != NULL; tmp = tmp->next) {
-        size_t key_len = strlen(tmp->key);
+    for (uint16_t i = 0; i < txt_len; i += 1 + txt[i]) {
+        const char *item = (const char *)txt + i + 1;
+        const char *eq = (const char *)memchr(item, '=', txt[i]);
+        size_t key_len = eq ? (size_t)(eq - item) : txt[i];
+        size_t value_len = eq ? txt[i] - key_len - 1 : 0;
         char *key = (char *)malloc(key_len + 1);
         if (!key) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             goto handle_error;
         }
-        memcpy(key, tmp->key, key_len);
+        memcpy(key, item, key_len);
         key[key_len] = 0;
         ret[ret_index].key = key;
-        char *value = (char *)malloc(tmp->value_len + 1);
+        char *value = (char *)malloc(value_len + 1);
         if (!value) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             goto handle_error;
         }
-        memcpy(value, tmp->value, tmp->value_len);
-        value[tmp->value_len] = 0;
+        if (value_len) {
+            memcpy(value, item + key_len + 1, value_len);
+        }
+        value[value_len] = 0;
         ret[ret_index].value = value;
-        (*txt_value_len)[ret_index] = tmp->value_len;
+        (*txt_value_len)[ret_index] = value_len;
         ret_index++;
     }
     return ret;
@@ -6015,7 +8045,7 @@ static mdns_ip_addr_t *_copy_delegated_host_address_list(char *hostname)
 {
     mdns_host_item_t *host = _mdns_host_list;
     while (host) {
-        if (strcasecmp(host->hostname, hostname) == 0) {
+        if (_mdns_str_equal(host->hostname, hostname)) {
             return copy_address_list(host->address_list);
         }
         host = host->next;
@@ -6037,14 +8067,14 @@ static mdns_result_t *_mdns_lookup_service(const char *instance, const char *ser
             s = s->next;
             continue;
         }
-        bool is_service_selfhosted = !_str_null_or_empty(_mdns_server->hostname) && !strcasecmp(_mdns_server->hostname, srv->hostname);
-        bool is_service_delegated = _str_null_or_empty(_mdns_server->hostname) || strcasecmp(_mdns_server->hostname, srv->hostname);
+        bool is_service_selfhosted = !_str_null_or_empty(_mdns_server->hostname) && _mdns_str_equal(_mdns_server->hostname, srv->hostname);
+        bool is_service_delegated = _str_null_or_empty(_mdns_server->hostname) || !_mdns_str_equal(_mdns_server->hostname, srv->hostname);
         if ((selfhost && is_service_selfhosted) || (!selfhost && is_service_delegated)) {
-            if (!strcasecmp(srv->service, service) && !strcasecmp(srv->proto, proto) &&
+            if (_mdns_str_equal(srv->service, service) && _mdns_str_equal(srv->proto, proto) &&
                     (_str_null_or_empty(instance) || _mdns_instance_name_match(srv->instance, instance))) {
                 mdns_result_t *item = (mdns_result_t *)malloc(sizeof(mdns_result_t));
                 if (!item) {
-                    HOOK_MALLOC_FAILED;
+                    MDNS_MALLOC_FAILED;
                     goto handle_error;
                 }
                 item->next = results;
@@ -6055,7 +8085,7 @@ static mdns_result_t *_mdns_lookup_service(const char *instance, const char *ser
                 if (srv->instance) {
                     item->instance_name = strndup(srv->instance, MDNS_NAME_BUF_LEN - 1);
                     if (!item->instance_name) {
-                        HOOK_MALLOC_FAILED;
+                        MDNS_MALLOC_FAILED;
                         goto handle_error;
                     }
                 } else {
@@ -6063,21 +8093,21 @@ static mdns_result_t *_mdns_lookup_service(const char *instance, const char *ser
                 }
                 item->service_type = strndup(srv->service, MDNS_NAME_BUF_LEN - 1);
                 if (!item->service_type) {
-                    HOOK_MALLOC_FAILED;
+                    MDNS_MALLOC_FAILED;
                     goto handle_error;
                 }
                 item->proto = strndup(srv->proto, MDNS_NAME_BUF_LEN - 1);
                 if (!item->proto) {
-                    HOOK_MALLOC_FAILED;
+                    MDNS_MALLOC_FAILED;
                     goto handle_error;
                 }
-                item->hostname = strndup(srv->hostname, MDNS_NAME_BUF_LEN - 1);
+                item->hostname = (char *)_mdns_str_intern(srv->hostname);
                 if (!item->hostname) {
-                    HOOK_MALLOC_FAILED;
+                    MDNS_MALLOC_FAILED;
                     goto handle_error;
                 }
                 item->port = srv->port;
-                item->txt = _copy_mdns_txt_items(srv->txt, &(item->txt_value_len), &(item->txt_count));
+                item->txt = _copy_mdns_txt_items(srv->txt, srv->txt_len, &(item->txt_value_len), &(item->txt_count));
                 // We should not append addresses for selfhost lookup result as we don't know which interface's address to append.
                 if (selfhost) {
                     item->addr = NULL;
@@ -6114,6 +8144,7 @@ esp_err_t mdns_service_port_set_for_host(const char *instance, const char *servi
     ESP_GOTO_ON_FALSE(s, ESP_ERR_NOT_FOUND, err, TAG, "Service doesn't exist");
 
     s->service->port = port;
+    s->service->wire.generation = 0;
     _mdns_announce_all_pcbs(&s, 1, true);
 
 err:
@@ -6140,18 +8171,13 @@ esp_err_t mdns_service_txt_set_for_host(const char *instance, const char *servic
     mdns_srv_item_t *s = _mdns_get_service_item_instance(instance, service, proto, hostname);
     ESP_GOTO_ON_FALSE(s, ESP_ERR_NOT_FOUND, err, TAG, "Service doesn't exist");
 
-    mdns_txt_linked_item_t *new_txt = NULL;
-    if (num_items) {
-        new_txt = _mdns_allocate_txt(num_items, txt_items);
-        if (!new_txt) {
-            return ESP_ERR_NO_MEM;
-        }
-    }
+    uint16_t txt_len = 0;
+    uint8_t *txt = NULL;
+    ESP_GOTO_ON_ERROR(_mdns_allocate_txt(num_items, txt_items, &txt, &txt_len), err, TAG, "Cannot set TXT items");
     mdns_service_t *srv = s->service;
-    mdns_txt_linked_item_t *txt = srv->txt;
-    srv->txt = NULL;
-    _mdns_free_linked_txt(txt);
-    srv->txt = new_txt;
+    free(srv->txt);
+    srv->txt = txt;
+    srv->txt_len = txt_len;
     _mdns_announce_all_pcbs(&s, 1, false);
 
 err:
@@ -6172,8 +8198,6 @@ esp_err_t mdns_service_txt_item_set_for_host_with_explicit_value_len(const char
 {
     MDNS_SERVICE_LOCK();
     esp_err_t ret = ESP_OK;
-    char *value = NULL;
-    mdns_txt_linked_item_t *new_txt = NULL;
     const char *hostname = host ? host : _mdns_server->hostname;
     ESP_GOTO_ON_FALSE(_mdns_server && _mdns_server->services && !_str_null_or_empty(service) && !_str_null_or_empty(proto) && !_str_null_or_empty(key) &&
                       !((!value_arg && value_len)), ESP_ERR_INVALID_ARG, err, TAG, "Invalid state or arguments");
@@ -6181,34 +8205,9 @@ esp_err_t mdns_service_txt_item_set_for_host_with_explicit_value_len(const char
     mdns_srv_item_t *s = _mdns_get_service_item_instance(instance, service, proto, hostname);
     ESP_GOTO_ON_FALSE(s, ESP_ERR_NOT_FOUND, err, TAG, "Service doesn't exist");
 
-    mdns_service_t *srv = s->service;
-    if (value_len > 0) {
-        value = (char *) malloc(value_len);
-        ESP_GOTO_ON_FALSE(value, ESP_ERR_NO_MEM, out_of_mem, TAG, "Out of memory");
-        memcpy(value, value_arg, value_len);
-    } else {
-        value_len = 0;
-    }
-    mdns_txt_linked_item_t *txt = srv->txt;
-    while (txt) {
-        if (strcmp(txt->key, key) == 0) {
-            free((char *)txt->value);
-            txt->value = value;
-            txt->value_len = value_len;
-            break;
-        }
-        txt = txt->next;
-    }
-    if (!txt) {
-        new_txt = (mdns_txt_linked_item_t *)malloc(sizeof(mdns_txt_linked_item_t));
-        ESP_GOTO_ON_FALSE(new_txt, ESP_ERR_NO_MEM, out_of_mem, TAG, "Out of memory");
-        new_txt->key = strdup(key);
-        ESP_GOTO_ON_FALSE(new_txt->key, ESP_ERR_NO_MEM, out_of_mem, TAG, "Out of memory");
-        new_txt->value = value;
-        new_txt->value_len = value_len;
-        new_txt->next = srv->txt;
-        srv->txt = new_txt;
-    }
+    ret = _mdns_txt_item_set(s->service, key, value_len ? value_arg : NULL, value_len);
+    ESP_GOTO_ON_FALSE(ret != ESP_ERR_NO_MEM, ESP_ERR_NO_MEM, out_of_mem, TAG, "Out of memory");
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "TXT item %s is too long", key);
 
     _mdns_announce_all_pcbs(&s, 1, false);
 
@@ -6217,9 +8216,7 @@ err:
     return ret;
 out_of_mem:
     MDNS_SERVICE_UNLOCK();
-    HOOK_MALLOC_FAILED;
-    free(value);
-    free(new_txt);
+    MDNS_MALLOC_FAILED;
     return ret;
 }
 
@@ -6258,40 +8255,19 @@ esp_err_t mdns_service_txt_item_remove_for_host(const char *instance, const char
     ESP_GOTO_ON_FALSE(_mdns_server && _mdns_server->services && !_str_null_or_empty(service) && !_str_null_or_empty(proto) && !_str_null_or_empty(key),
                       ESP_ERR_INVALID_ARG, err, TAG, "Invalid state or arguments");
 
-    mdns_srv_item_t *s = _mdns_get_service_item_instance(instance, service, proto, hostname);
-    ESP_GOTO_ON_FALSE(s, ESP_ERR_NOT_FOUND, err, TAG, "Service doesn't exist");
-
-    mdns_service_t *srv = s->service;
-    mdns_txt_linked_item_t *txt = srv->txt;
-    if (!txt) {
-        goto err;
-    }
-    if (strcmp(txt->key, key) == 0) {
-        srv->txt = txt->next;
-        free((char *)txt->key);
-        free((char *)txt->value);
-        free(txt);
-    } else {
-        while (txt->next) {
-            if (strcmp(txt->next->key, key) == 0) {
-                mdns_txt_linked_item_t *t = txt->next;
-                txt->next = t->next;
-                free((char *)t->key);
-                free((char *)t->value);
-                free(t);
-                break;
-            } else {
-                txt = txt->next;
-            }
-        }
-    }
-
+    mdns_srv_item_t *s = _mdns_get_service_item_instance(instance, service, proto, hostname);
+    ESP_GOTO_ON_FALSE(s, ESP_ERR_NOT_FOUND, err, TAG, "Service doesn't exist");
+
+    if (!s->service->txt) {
+        goto err;
+    }
+    _mdns_txt_item_remove(s->service, key);
     _mdns_announce_all_pcbs(&s, 1, false);
 
 err:
     MDNS_SERVICE_UNLOCK();
     if (ret == ESP_ERR_NO_MEM) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
     }
     return ret;
 }
@@ -6318,7 +8294,7 @@ static esp_err_t _mdns_service_subtype_remove_for_host(mdns_srv_item_t *service,
             } else {
                 pre->next = srv_subtype->next;
             }
-            free((char *)srv_subtype->subtype);
+            _mdns_str_release(srv_subtype->subtype);
             free(srv_subtype);
             ret = ESP_OK;
             break;
@@ -6365,7 +8341,7 @@ static esp_err_t _mdns_service_subtype_add_for_host(mdns_srv_item_t *service, co
 
     mdns_subtype_t *subtype_item = (mdns_subtype_t *)malloc(sizeof(mdns_subtype_t));
     ESP_GOTO_ON_FALSE(subtype_item, ESP_ERR_NO_MEM, out_of_mem, TAG, "Out of memory");
-    subtype_item->subtype = strdup(subtype);
+    subtype_item->subtype = _mdns_str_intern(subtype);
     ESP_GOTO_ON_FALSE(subtype_item->subtype, ESP_ERR_NO_MEM, out_of_mem, TAG, "Out of memory");
     subtype_item->next = service->service->subtype;
     service->service->subtype = subtype_item;
@@ -6373,7 +8349,7 @@ static esp_err_t _mdns_service_subtype_add_for_host(mdns_srv_item_t *service, co
 err:
     return ret;
 out_of_mem:
-    HOOK_MALLOC_FAILED;
+    MDNS_MALLOC_FAILED;
     free(subtype_item);
     return ret;
 }
@@ -6481,6 +8457,8 @@ esp_err_t mdns_service_instance_name_set_for_host(const char *instance_old, cons
         free((char *)s->service->instance);
     }
     s->service->instance = strndup(instance, MDNS_NAME_BUF_LEN - 1);
+    s->service->wire.generation = 0;
+    _mdns_srv_item_reindex_instance(s);
     ESP_GOTO_ON_FALSE(s->service->instance, ESP_ERR_NO_MEM, err, TAG, "Out of memory");
     _mdns_probe_all_pcbs(&s, 1, false, false);
 
@@ -6507,43 +8485,11 @@ esp_err_t mdns_service_remove_for_host(const char *instance, const char *service
     mdns_srv_item_t *s = _mdns_get_service_item_instance(instance, service, proto, hostname);
     ESP_GOTO_ON_FALSE(s, ESP_ERR_NOT_FOUND, err, TAG, "Service doesn't exist");
 
-    mdns_srv_item_t *a = _mdns_server->services;
-    mdns_srv_item_t *b = a;
-    if (instance) {
-        while (a) {
-            if (_mdns_service_match_instance(a->service, instance, service, proto, hostname)) {
-                if (_mdns_server->services != a) {
-                    b->next = a->next;
-                } else {
-                    _mdns_server->services = a->next;
-                }
-                _mdns_send_bye(&a, 1, false);
-                _mdns_remove_scheduled_service_packets(a->service);
-                _mdns_free_service(a->service);
-                free(a);
-                break;
-            }
-            b = a;
-            a = a->next;
-        }
-    } else {
-        while (a) {
-            if (_mdns_service_match(a->service, service, proto, hostname)) {
-                if (_mdns_server->services != a) {
-                    b->next = a->next;
-                } else {
-                    _mdns_server->services = a->next;
-                }
-                _mdns_send_bye(&a, 1, false);
-                _mdns_remove_scheduled_service_packets(a->service);
-                _mdns_free_service(a->service);
-                free(a);
-                break;
-            }
-            b = a;
-            a = a->next;
-        }
-    }
+    _mdns_srv_item_detach(s);
+    _mdns_send_bye(&s, 1, false);
+    _mdns_remove_scheduled_service_packets(s->service);
+    _mdns_free_service(s->service);
+    free(s);
 
 err:
     MDNS_SERVICE_UNLOCK();
@@ -6570,6 +8516,7 @@ esp_err_t mdns_service_remove_all(void)
     _mdns_send_final_bye(false);
     mdns_srv_item_t *services = _mdns_server->services;
     _mdns_server->services = NULL;
+    memset(_mdns_server->service_index, 0, sizeof(_mdns_server->service_index));
     while (services) {
         mdns_srv_item_t *s = services;
         services = services->next;
@@ -6601,7 +8548,7 @@ static void _mdns_query_results_free(mdns_result_t *results)
     while (results) {
         r = results;
 
-        free((char *)(r->hostname));
+        _mdns_str_release(r->hostname);
         free((char *)(r->instance_name));
         free((char *)(r->service_type));
         free((char *)(r->proto));
@@ -6695,6 +8642,15 @@ esp_err_t mdns_query_generic(const char *name, const char *service, const char *
         return ESP_ERR_NO_MEM;
     }
 
+    MDNS_SERVICE_LOCK();
+    bool cached = _mdns_cache_answer(search);
+    MDNS_SERVICE_UNLOCK();
+    if (cached) {
+        *results = search->result;
+        _mdns_search_free(search);
+        return ESP_OK;
+    }
+
     if (_mdns_send_search_action(ACTION_SEARCH_ADD, search)) {
         _mdns_search_free(search);
         return ESP_ERR_NO_MEM;
@@ -7079,20 +9035,20 @@ void mdns_debug_packet(const uint8_t *data, size_t len)
 /**
  * @brief  Browse sync result action
  */
-static esp_err_t _mdns_sync_browse_action(mdns_action_type_t type, mdns_browse_sync_t *browse_sync)
+static esp_err_t _mdns_sync_browse_action(mdns_action_type_t type, mdns_browse_t *browse)
 {
     mdns_action_t *action = NULL;
 
-    action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    action = _mdns_action_alloc();
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return ESP_ERR_NO_MEM;
     }
 
     action->type = type;
-    action->data.browse_sync.browse_sync = browse_sync;
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
-        free(action);
+    action->data.browse_sync.browse = browse;
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     return ESP_OK;
@@ -7105,17 +9061,17 @@ static esp_err_t _mdns_send_browse_action(mdns_action_type_t type, mdns_browse_t
 {
     mdns_action_t *action = NULL;
 
-    action = (mdns_action_t *)malloc(sizeof(mdns_action_t));
+    action = _mdns_action_alloc();
 
     if (!action) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return ESP_ERR_NO_MEM;
     }
 
     action->type = type;
     action->data.browse_add.browse = browse;
-    if (xQueueSend(_mdns_server->action_queue, &action, (TickType_t)0) != pdPASS) {
-        free(action);
+    if (!_mdns_action_post(MDNS_LANE_CONTROL, action)) {
+        _mdns_action_release(action);
         return ESP_ERR_NO_MEM;
     }
     return ESP_OK;
@@ -7142,7 +9098,7 @@ static mdns_browse_t *_mdns_browse_init(const char *service, const char *proto,
     mdns_browse_t *browse = (mdns_browse_t *)malloc(sizeof(mdns_browse_t));
 
     if (!browse) {
-        HOOK_MALLOC_FAILED;
+        MDNS_MALLOC_FAILED;
         return NULL;
     }
     memset(browse, 0, sizeof(mdns_browse_t));
@@ -7189,6 +9145,29 @@ mdns_browse_t *mdns_browse_new(const char *service, const char *proto, mdns_brow
     return browse;
 }
 
+mdns_browse_t *mdns_browse_delta_new(const char *service, const char *proto, mdns_browse_delta_notify_t notifier, void *arg)
+{
+    mdns_browse_t *browse = NULL;
+
+    if (!_mdns_server || _str_null_or_empty(service) || _str_null_or_empty(proto) || !notifier) {
+        return NULL;
+    }
+
+    browse = _mdns_browse_init(service, proto, NULL);
+    if (!browse) {
+        return NULL;
+    }
+    browse->delta_notifier = notifier;
+    browse->delta_arg = arg;
+
+    if (_mdns_send_browse_action(ACTION_BROWSE_ADD, browse)) {
+        _mdns_browse_item_free(browse);
+        return NULL;
+    }
+
+    return browse;
+}
+
 esp_err_t mdns_browse_delete(const char *service, const char *proto)
 {
     mdns_browse_t *browse = NULL;
@@ -7209,6 +9188,55 @@ esp_err_t mdns_browse_delete(const char *service, const char *proto)
     return ESP_OK;
 }
 
+esp_err_t mdns_suppression_stats_get(mdns_suppression_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!_mdns_server) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    MDNS_SERVICE_LOCK();
+    *stats = _mdns_server->suppressed;
+    MDNS_SERVICE_UNLOCK();
+    return ESP_OK;
+}
+
+esp_err_t mdns_cache_stats_get(mdns_cache_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!_mdns_server) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    MDNS_SERVICE_LOCK();
+    *stats = _mdns_server->cache_stats;
+    MDNS_SERVICE_UNLOCK();
+    return ESP_OK;
+}
+
+esp_err_t mdns_stats_get(mdns_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!_mdns_server) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    MDNS_SERVICE_LOCK();
+    *stats = _mdns_server->stats;
+    MDNS_SERVICE_UNLOCK();
+    for (mdns_if_t i = 0; i < MDNS_MAX_INTERFACES && i < CONFIG_MDNS_MAX_INTERFACES; i++) {
+        for (int j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
+            stats->netif[i][j].rx_dropped = atomic_load(&_mdns_stats_rx_dropped[i][j]);
+        }
+    }
+    stats->action_queue_max = atomic_load(&_mdns_action_pool_in_use_max);
+    stats->alloc_failed = atomic_load(&_mdns_stats_alloc_failures);
+    return ESP_OK;
+}
+
 /**
  * @brief  Mark browse as finished, remove and free it from browse chain
  */
@@ -7251,76 +9279,103 @@ static void _mdns_browse_add(mdns_browse_t *browse)
     if (!found) {
         browse->next = _mdns_server->browse;
         _mdns_server->browse = browse;
-    }
-    for (uint8_t interface_idx = 0; interface_idx < MDNS_MAX_INTERFACES; interface_idx++) {
-        _mdns_browse_send(browse, (mdns_if_t)interface_idx);
-    }
-    if (found) {
+    } else {
+        // query again, starting over with the shortest interval
+        queue->interval = 0;
         _mdns_browse_item_free(browse);
     }
+    // the query is sent from the timer, together with the other searches and browses due
+    _mdns_timer_arm();
 }
 
 /**
- * @brief  Send PTR query packet to all available interfaces for browsing.
+ * @brief  Record changed fields of a browse result and schedule their notification
  */
-static void _mdns_browse_send(mdns_browse_t *browse, mdns_if_t interface)
+static void _mdns_browse_result_changed(mdns_browse_t *browse, mdns_result_t *r, uint8_t changed)
 {
-    // Using search once for sending the PTR query
-    mdns_search_once_t search = {0};
-
-    search.instance = NULL;
-    search.service = browse->service;
-    search.proto = browse->proto;
-    search.type = MDNS_TYPE_PTR;
-    search.unicast = false;
-    search.result = NULL;
-    search.next = NULL;
+    if (!changed) {
+        return;
+    }
+    ((mdns_browse_result_t *)r)->changed |= changed;
+    // one sync per browse delivers all the changes collected until it runs
+    if (!browse->sync_pending && _mdns_sync_browse_action(ACTION_BROWSE_SYNC, browse) == ESP_OK) {
+        browse->sync_pending = true;
+    }
+}
 
-    for (uint8_t protocol_idx = 0; protocol_idx < MDNS_IP_PROTOCOL_MAX; protocol_idx++) {
-        _mdns_search_send_pcb(&search, interface, (mdns_ip_protocol_t)protocol_idx);
+/**
+ * @brief  Update TTL of a browse result
+ *
+ * @return MDNS_BROWSE_CHANGED_TTL if the TTL changed, 0 otherwise
+ */
+static uint8_t _mdns_browse_result_set_ttl(mdns_result_t *r, uint32_t ttl)
+{
+    uint32_t previous_ttl = r->ttl;
+    if (r->ttl == 0) {
+        r->ttl = ttl;
+    } else {
+        _mdns_result_update_ttl(r, ttl);
     }
+    return previous_ttl != r->ttl ? MDNS_BROWSE_CHANGED_TTL : 0;
 }
 
 /**
- * @brief  Add result to browse, only add when the result is a new one.
+ * @brief  Allocate a browse result and add it to the browse
  */
-static esp_err_t _mdns_add_browse_result(mdns_browse_sync_t *sync_browse, mdns_result_t *r)
+static mdns_result_t *_mdns_browse_result_new(mdns_browse_t *browse, const char *instance, const char *service, const char *proto,
+                                              mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl)
 {
-    mdns_browse_result_sync_t *sync_r = sync_browse->sync_result;
-    while (sync_r) {
-        if (sync_r->result == r) {
-            break;
-        }
-        sync_r = sync_r->next;
+    mdns_browse_result_t *entry = (mdns_browse_result_t *)malloc(sizeof(mdns_browse_result_t));
+    if (!entry) {
+        MDNS_MALLOC_FAILED;
+        return NULL;
     }
-    if (!sync_r) {
-        // Do not find, need to add the result to the list
-        mdns_browse_result_sync_t *new = (mdns_browse_result_sync_t *)malloc(sizeof(mdns_browse_result_sync_t));
+    memset(entry, 0, sizeof(mdns_browse_result_t));
+    mdns_result_t *r = &entry->result;
+    r->instance_name = strdup(instance);
+    r->service_type = strdup(service);
+    r->proto = strdup(proto);
+    if (!r->instance_name || !r->service_type || !r->proto) {
+        MDNS_MALLOC_FAILED;
+        free(r->instance_name);
+        free(r->service_type);
+        free(r->proto);
+        free(entry);
+        return NULL;
+    }
+    r->esp_netif = _mdns_get_esp_netif(tcpip_if);
+    r->ip_protocol = ip_protocol;
+    r->ttl = ttl;
+    r->next = browse->result;
+    browse->result = r;
+    return r;
+}
 
-        if (!new) {
-            HOOK_MALLOC_FAILED;
-            return ESP_ERR_NO_MEM;
+/**
+ * @brief  Find browse result of a service instance
+ */
+static mdns_result_t *_mdns_browse_result_find(mdns_browse_t *browse, const char *instance, const char *service, const char *proto,
+                                               mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
+{
+    mdns_result_t *r = browse->result;
+    while (r) {
+        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol &&
+                !_str_null_or_empty(r->instance_name) && _mdns_str_equal(instance, r->instance_name) &&
+                !_str_null_or_empty(r->service_type) && _mdns_str_equal(service, r->service_type) &&
+                !_str_null_or_empty(r->proto) && _mdns_str_equal(proto, r->proto)) {
+            return r;
         }
-        new->result = r;
-        new->next = sync_browse->sync_result;
-        sync_browse->sync_result = new;
+        r = r->next;
     }
-    return ESP_OK;
+    return NULL;
 }
 
 /**
  * @brief  Called from parser to add A/AAAA data to search result
  */
 static void _mdns_browse_result_add_ip(mdns_browse_t *browse, const char *hostname, esp_ip_addr_t *ip,
-                                       mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl, mdns_browse_sync_t *out_sync_browse)
+                                       mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl)
 {
-    if (out_sync_browse->browse == NULL) {
-        return;
-    } else {
-        if (out_sync_browse->browse != browse) {
-            return;
-        }
-    }
     mdns_result_t *r = NULL;
     mdns_ip_addr_t *r_a = NULL;
     if (browse) {
@@ -7328,7 +9383,7 @@ static void _mdns_browse_result_add_ip(mdns_browse_t *browse, const char *hostna
         while (r) {
             if (r->ip_protocol == ip_protocol) {
                 // Find the target result in browse result.
-                if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && !_str_null_or_empty(r->hostname) && !strcasecmp(hostname, r->hostname)) {
+                if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && !_str_null_or_empty(r->hostname) && _mdns_str_equal(hostname, r->hostname)) {
                     r_a = r->addr;
                     // Check if the address has already added in result.
                     while (r_a) {
@@ -7353,16 +9408,7 @@ static void _mdns_browse_result_add_ip(mdns_browse_t *browse, const char *hostna
                         }
                         a->next = r->addr;
                         r->addr = a;
-                        if (r->ttl != ttl) {
-                            if (r->ttl == 0) {
-                                r->ttl = ttl;
-                            } else {
-                                _mdns_result_update_ttl(r, ttl);
-                            }
-                        }
-                        if (_mdns_add_browse_result(out_sync_browse, r) != ESP_OK) {
-                            return;
-                        }
+                        _mdns_browse_result_changed(browse, r, MDNS_BROWSE_CHANGED_ADDR | _mdns_browse_result_set_ttl(r, ttl));
                         break;
                     }
                 }
@@ -7385,8 +9431,8 @@ static mdns_browse_t *_mdns_browse_find_from(mdns_browse_t *b, mdns_name_t *name
     mdns_result_t *r = NULL;
     while (b) {
         if (type == MDNS_TYPE_SRV || type == MDNS_TYPE_TXT) {
-            if (strcasecmp(name->service, b->service)
-                    || strcasecmp(name->proto, b->proto)) {
+            if (!_mdns_str_equal(name->service, b->service)
+                    || !_mdns_str_equal(name->proto, b->proto)) {
                 b = b->next;
                 continue;
             }
@@ -7394,7 +9440,7 @@ static mdns_browse_t *_mdns_browse_find_from(mdns_browse_t *b, mdns_name_t *name
         } else if (type == MDNS_TYPE_A || type == MDNS_TYPE_AAAA) {
             r = b->result;
             while (r) {
-                if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && !strcasecmp(name->host, r->hostname)) {
+                if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol && !_str_null_or_empty(r->hostname) && _mdns_str_equal(name->host, r->hostname)) {
                     return b;
                 }
                 r = r->next;
@@ -7406,126 +9452,83 @@ static mdns_browse_t *_mdns_browse_find_from(mdns_browse_t *b, mdns_name_t *name
     return b;
 }
 
-static bool is_txt_item_in_list(mdns_txt_item_t txt, uint8_t txt_value_len, mdns_txt_item_t *txt_list, uint8_t *txt_value_len_list, size_t txt_count)
+/**
+ * @brief  Check if TXT data carries the same items as a result, without creating them
+ */
+static bool _mdns_result_txt_equal(const mdns_result_t *r, const uint8_t *data, size_t len)
 {
-    for (size_t i = 0; i < txt_count; i++) {
-        if (strcmp(txt.key, txt_list[i].key) == 0) {
-            if (txt_value_len == txt_value_len_list[i] && memcmp(txt.value, txt_list[i].value, txt_value_len) == 0) {
-                return true;
-            } else {
-                // The key value is unique, so there is no need to continue searching.
+    int num_items = _mdns_txt_items_count_get(data, len);
+    if (num_items <= 0) {
+        return r->txt_count == 0;
+    }
+    size_t i = 0, count = 0;
+    while (i < len) {
+        size_t part_len = data[i++];
+        if (!part_len) {
+            break;
+        }
+        int name_len = _mdns_txt_item_name_get_len(data + i, part_len);
+        if (name_len >= 0) {
+            size_t value_len = (size_t)name_len < part_len ? part_len - name_len - 1 : 0;
+            size_t j;
+            for (j = 0; j < r->txt_count; j++) {
+                if (strlen(r->txt[j].key) == (size_t)name_len && !memcmp(r->txt[j].key, data + i, name_len)) {
+                    break;
+                }
+            }
+            if (j == r->txt_count || r->txt_value_len[j] != value_len ||
+                    (value_len && memcmp(r->txt[j].value, data + i + name_len + 1, value_len))) {
                 return false;
             }
+            count++;
         }
+        i += part_len;
     }
-    return false;
+    return count == r->txt_count;
 }
 
 /**
  * @brief  Called from parser to add TXT data to search result
+ *
+ * The TXT items are created only if they changed.
  */
 static void _mdns_browse_result_add_txt(mdns_browse_t *browse, const char *instance, const char *service, const char *proto,
-                                        mdns_txt_item_t *txt, uint8_t *txt_value_len, size_t txt_count, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol,
-                                        uint32_t ttl, mdns_browse_sync_t *out_sync_browse)
+                                        const uint8_t *data, size_t len, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol,
+                                        uint32_t ttl)
 {
-    if (out_sync_browse->browse == NULL) {
-        return;
-    } else {
-        if (out_sync_browse->browse != browse) {
+    uint8_t changed = 0;
+    mdns_result_t *r = _mdns_browse_result_find(browse, instance, service, proto, tcpip_if, ip_protocol);
+    if (r) {
+        changed |= _mdns_browse_result_set_ttl(r, ttl);
+        if (_mdns_result_txt_equal(r, data, len)) {
+            _mdns_browse_result_changed(browse, r, changed);
             return;
         }
-    }
-    mdns_result_t *r = browse->result;
-    while (r) {
-        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol &&
-                !_str_null_or_empty(r->instance_name) && !strcasecmp(instance, r->instance_name) &&
-                !_str_null_or_empty(r->service_type) && !strcasecmp(service, r->service_type) &&
-                !_str_null_or_empty(r->proto) && !strcasecmp(proto, r->proto)) {
-            bool should_update = false;
-            if (r->txt) {
-                // Check if txt changed
-                if (txt_count != r->txt_count) {
-                    should_update = true;
-                } else {
-                    for (size_t txt_index = 0; txt_index < txt_count; txt_index++) {
-                        if (!is_txt_item_in_list(txt[txt_index], txt_value_len[txt_index], r->txt, r->txt_value_len, r->txt_count)) {
-                            should_update = true;
-                            break;
-                        }
-                    }
-                }
-                // If the result has a previous txt entry, we delete it and re-add.
-                for (size_t i = 0; i < r->txt_count; i++) {
-                    free((char *)(r->txt[i].key));
-                    free((char *)(r->txt[i].value));
-                }
-                free(r->txt);
-                free(r->txt_value_len);
-            }
-            r->txt = txt;
-            r->txt_value_len = txt_value_len;
-            r->txt_count = txt_count;
-            if (r->ttl != ttl) {
-                uint32_t previous_ttl = r->ttl;
-                if (r->ttl == 0) {
-                    r->ttl = ttl;
-                } else {
-                    _mdns_result_update_ttl(r, ttl);
-                }
-                if (previous_ttl != r->ttl) {
-                    should_update = true;
-                }
-            }
-            if (should_update) {
-                if (_mdns_add_browse_result(out_sync_browse, r) != ESP_OK) {
-                    return;
-                }
-            }
+        // The TXT changed, delete the previous items and re-add.
+        for (size_t i = 0; i < r->txt_count; i++) {
+            free((char *)(r->txt[i].key));
+            free((char *)(r->txt[i].value));
+        }
+        free(r->txt);
+        free(r->txt_value_len);
+        r->txt = NULL;
+        r->txt_value_len = NULL;
+        r->txt_count = 0;
+    } else {
+        r = _mdns_browse_result_new(browse, instance, service, proto, tcpip_if, ip_protocol, ttl);
+        if (!r) {
             return;
         }
-        r = r->next;
-    }
-    r = (mdns_result_t *)malloc(sizeof(mdns_result_t));
-    if (!r) {
-        HOOK_MALLOC_FAILED;
-        goto free_txt;
-    }
-    memset(r, 0, sizeof(mdns_result_t));
-    r->instance_name = strdup(instance);
-    r->service_type = strdup(service);
-    r->proto = strdup(proto);
-    if (!r->instance_name || !r->service_type || !r->proto) {
-        free(r->instance_name);
-        free(r->service_type);
-        free(r->proto);
-        free(r);
-        return;
+        changed |= MDNS_BROWSE_CHANGED_TTL;
     }
-    r->txt = txt;
-    r->txt_value_len = txt_value_len;
-    r->txt_count = txt_count;
-    r->esp_netif = _mdns_get_esp_netif(tcpip_if);
-    r->ip_protocol = ip_protocol;
-    r->ttl = ttl;
-    r->next = browse->result;
-    browse->result = r;
-    _mdns_add_browse_result(out_sync_browse, r);
-    return;
-
-free_txt:
-    for (size_t i = 0; i < txt_count; i++) {
-        free((char *)(txt[i].key));
-        free((char *)(txt[i].value));
-    }
-    free(txt);
-    free(txt_value_len);
-    return;
+    _mdns_result_txt_create(data, len, &r->txt, &r->txt_value_len, &r->txt_count);
+    _mdns_browse_result_changed(browse, r, changed | MDNS_BROWSE_CHANGED_TXT);
 }
 
 static esp_err_t _mdns_copy_address_in_previous_result(mdns_result_t *result_list, mdns_result_t *r)
 {
     while (result_list) {
-        if (!_str_null_or_empty(result_list->hostname) && !_str_null_or_empty(r->hostname) && !strcasecmp(result_list->hostname, r->hostname) &&
+        if (!_str_null_or_empty(result_list->hostname) && !_str_null_or_empty(r->hostname) && _mdns_str_equal(result_list->hostname, r->hostname) &&
                 result_list->ip_protocol == r->ip_protocol && result_list->addr && !r->addr) {
             // If there is a same hostname in previous result, we need to copy the address here.
             r->addr = copy_address_list(result_list->addr);
@@ -7544,102 +9547,78 @@ static esp_err_t _mdns_copy_address_in_previous_result(mdns_result_t *result_lis
  * @brief  Called from parser to add SRV data to search result
  */
 static void _mdns_browse_result_add_srv(mdns_browse_t *browse, const char *hostname, const char *instance, const char *service, const char *proto,
-                                        uint16_t port, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl, mdns_browse_sync_t *out_sync_browse)
+                                        uint16_t port, mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, uint32_t ttl)
 {
-    if (out_sync_browse->browse == NULL) {
-        return;
+    uint8_t changed = 0;
+    mdns_result_t *r = _mdns_browse_result_find(browse, instance, service, proto, tcpip_if, ip_protocol);
+    if (r) {
+        changed |= _mdns_browse_result_set_ttl(r, ttl);
     } else {
-        if (out_sync_browse->browse != browse) {
+        r = _mdns_browse_result_new(browse, instance, service, proto, tcpip_if, ip_protocol, ttl);
+        if (!r) {
             return;
         }
+        changed |= MDNS_BROWSE_CHANGED_TTL;
     }
-    mdns_result_t *r = browse->result;
-    while (r) {
-        if (r->esp_netif == _mdns_get_esp_netif(tcpip_if) && r->ip_protocol == ip_protocol &&
-                !_str_null_or_empty(r->instance_name) && !strcasecmp(instance, r->instance_name) &&
-                !_str_null_or_empty(r->service_type) && !strcasecmp(service, r->service_type) &&
-                !_str_null_or_empty(r->proto) && !strcasecmp(proto, r->proto)) {
-            if (_str_null_or_empty(r->hostname) || strcasecmp(hostname, r->hostname)) {
-                r->hostname = strdup(hostname);
-                r->port = port;
-                if (!r->hostname) {
-                    HOOK_MALLOC_FAILED;
-                    return;
-                }
-                if (!r->addr) {
-                    esp_err_t err = _mdns_copy_address_in_previous_result(browse->result, r);
-                    if (err == ESP_ERR_NO_MEM) {
-                        return;
-                    }
-                }
-                if (_mdns_add_browse_result(out_sync_browse, r) != ESP_OK) {
-                    return;
-                }
-            }
-            if (r->ttl != ttl) {
-                uint32_t previous_ttl = r->ttl;
-                if (r->ttl == 0) {
-                    r->ttl = ttl;
-                } else {
-                    _mdns_result_update_ttl(r, ttl);
-                }
-                if (previous_ttl != r->ttl) {
-                    if (_mdns_add_browse_result(out_sync_browse, r) != ESP_OK) {
-                        return;
-                    }
-                }
-            }
+    if (_str_null_or_empty(r->hostname) || !_mdns_str_equal(hostname, r->hostname)) {
+        const char *new_hostname = _mdns_str_intern(hostname);
+        if (!new_hostname) {
+            _mdns_browse_result_changed(browse, r, changed);
             return;
         }
-        r = r->next;
-    }
-    r = (mdns_result_t *)malloc(sizeof(mdns_result_t));
-    if (!r) {
-        HOOK_MALLOC_FAILED;
-        return;
+        _mdns_str_release(r->hostname);
+        r->hostname = (char *)new_hostname;
+        changed |= MDNS_BROWSE_CHANGED_SRV;
+        if (!r->addr && _mdns_copy_address_in_previous_result(browse->result, r) == ESP_OK && r->addr) {
+            changed |= MDNS_BROWSE_CHANGED_ADDR;
+        }
     }
-
-    memset(r, 0, sizeof(mdns_result_t));
-    r->hostname = strdup(hostname);
-    r->instance_name = strdup(instance);
-    r->service_type = strdup(service);
-    r->proto = strdup(proto);
-    if (!r->hostname || !r->instance_name || !r->service_type || !r->proto) {
-        HOOK_MALLOC_FAILED;
-        free(r->hostname);
-        free(r->instance_name);
-        free(r->service_type);
-        free(r->proto);
-        free(r);
-        return;
+    if (r->port != port) {
+        r->port = port;
+        changed |= MDNS_BROWSE_CHANGED_SRV;
     }
-    r->port = port;
-    r->esp_netif = _mdns_get_esp_netif(tcpip_if);
-    r->ip_protocol = ip_protocol;
-    r->ttl = ttl;
-    r->next = browse->result;
-    browse->result = r;
-    _mdns_add_browse_result(out_sync_browse, r);
-    return;
+    _mdns_browse_result_changed(browse, r, changed);
 }
 
-static void _mdns_browse_sync(mdns_browse_sync_t *browse_sync)
+/**
+ * @brief  Notify the changes of browse results collected since the previous sync
+ */
+static void _mdns_browse_sync(mdns_browse_t *browse)
 {
-    mdns_browse_t *browse = browse_sync->browse;
-    mdns_browse_result_sync_t *sync_result = browse_sync->sync_result;
-    while (sync_result) {
-        mdns_result_t *result = sync_result->result;
+    mdns_browse_t *b = _mdns_server->browse;
+    while (b && b != browse) {
+        b = b->next;
+    }
+    if (!b) {
+        // the browse finished before the sync was handled
+        return;
+    }
+    browse->sync_pending = false;
+    mdns_result_t *result = browse->result;
+    while (result) {
+        mdns_result_t *next = result->next;
+        mdns_browse_result_t *entry = (mdns_browse_result_t *)result;
+        if (entry->changed) {
 #ifdef MDNS_ENABLE_DEBUG
-        debug_printf_browse_result(result, browse_sync->browse);
+            debug_printf_browse_result(result, browse);
 #endif
-        browse->notifier(result);
-        if (result->ttl == 0) {
-            queueDetach(mdns_result_t, browse->result, result);
-            // Just free current result
-            result->next = NULL;
-            mdns_query_results_free(result);
+            if (browse->notifier) {
+                browse->notifier(result);
+            }
+            if (browse->delta_notifier && (result->ttl || entry->added)) {
+                mdns_browse_event_t event = result->ttl == 0 ? MDNS_BROWSE_REMOVED : entry->added ? MDNS_BROWSE_UPDATED : MDNS_BROWSE_ADDED;
+                browse->delta_notifier(event, result, entry->changed, browse->delta_arg);
+            }
+            entry->changed = 0;
+            entry->added = true;
+            if (result->ttl == 0) {
+                queueDetach(mdns_result_t, browse->result, result);
+                // Just free current result
+                result->next = NULL;
+                _mdns_query_results_free(result);
+            }
         }
-        sync_result = sync_result->next;
+        result = next;
     }
 }
 
@@ -7681,14 +9660,4 @@ static void debug_printf_browse_result(mdns_result_t *r_t, mdns_browse_t *b_t)
     _mdns_dbg_printf("browse pointer: %p\n", b_t);
     _debug_printf_result(r_t);
 }
-
-static void debug_printf_browse_result_all(mdns_result_t *r_t)
-{
-    int count = 0;
-    while (r_t) {
-        _mdns_dbg_printf("----------------result %d---------------\n", count++);
-        _debug_printf_result(r_t);
-        r_t = r_t->next;
-    }
-}
 #endif // MDNS_ENABLE_DEBUG
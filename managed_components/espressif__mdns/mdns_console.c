@@ -1413,6 +1413,58 @@ static void register_mdns_browse_del(void)
     ESP_ERROR_CHECK( esp_console_cmd_register(&cmd_browse_del) );
 }
 
+static void mdns_print_histogram(const char *name, const uint32_t *histogram)
+{
+    printf("%s:", name);
+    for (int i = 0; i < MDNS_STATS_LATENCY_BUCKETS; i++) {
+        if (i < MDNS_STATS_LATENCY_BUCKETS - 1) {
+            printf(" <%d: %" PRIu32 ",", 8 << i, histogram[i]);
+        } else {
+            printf(" >=%d: %" PRIu32 " (us)\n", 8 << (i - 1), histogram[i]);
+        }
+    }
+}
+
+static int cmd_mdns_stats(int argc, char **argv)
+{
+    mdns_stats_t stats;
+    if (mdns_stats_get(&stats) != ESP_OK) {
+        printf("ERROR: mDNS is not running\n");
+        return 1;
+    }
+    for (int i = 0; i < CONFIG_MDNS_MAX_INTERFACES; i++) {
+        esp_netif_t *netif = _mdns_get_esp_netif(i);
+        for (int j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
+            mdns_netif_stats_t *s = &stats.netif[i][j];
+            if (!netif && !s->rx_packets && !s->tx_packets) {
+                continue;
+            }
+            printf("%s %s: RX %" PRIu32 " packets %" PRIu32 " bytes %" PRIu32 " dropped %" PRIu32 " shed, TX %" PRIu32 " packets %" PRIu32 " bytes %" PRIu32 " failed\n",
+                   netif ? esp_netif_get_ifkey(netif) : "-", ip_protocol_str[j], s->rx_packets, s->rx_bytes, s->rx_dropped, s->rx_shed,
+                   s->tx_packets, s->tx_bytes, s->tx_failed);
+        }
+    }
+    printf("Queues: %" PRIu32 " actions, %" PRIu32 " packets at most\n", stats.action_queue_max, stats.tx_queue_max);
+    printf("Allocation failures: %" PRIu32 ", probe conflicts: %" PRIu32 ", reprobes: %" PRIu32 "\n",
+           stats.alloc_failed, stats.probe_conflicts, stats.reprobes);
+    mdns_print_histogram("Parse", stats.parse_us);
+    mdns_print_histogram("Answer", stats.answer_us);
+    return 0;
+}
+
+static void register_mdns_stats(void)
+{
+    const esp_console_cmd_t cmd_stats = {
+        .command = "mdns_stats",
+        .help = "Print MDNS engine counters",
+        .hint = NULL,
+        .func = &cmd_mdns_stats,
+        .argtable = NULL
+    };
+
+    ESP_ERROR_CHECK( esp_console_cmd_register(&cmd_stats) );
+}
+
 void mdns_console_register(void)
 {
     register_mdns_init();
@@ -1435,6 +1487,7 @@ void mdns_console_register(void)
 
     register_mdns_browse();
     register_mdns_browse_del();
+    register_mdns_stats();
 
 #ifdef CONFIG_LWIP_IPV4
     register_mdns_query_a();
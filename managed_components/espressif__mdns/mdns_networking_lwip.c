@@ -9,6 +9,7 @@
  *
  */
 #include <string.h>
+#include <stdatomic.h>
 #include "esp_log.h"
 #include "lwip/ip_addr.h"
 #include "lwip/pbuf.h"
@@ -145,7 +146,7 @@ static void _udp_recv(void *arg, struct udp_pcb *upcb, struct pbuf *pb, const ip
 
         mdns_rx_packet_t *packet = (mdns_rx_packet_t *)malloc(sizeof(mdns_rx_packet_t));
         if (!packet) {
-            HOOK_MALLOC_FAILED;
+            MDNS_MALLOC_FAILED;
             //missed packet - no memory
             pbuf_free(this_pb);
             continue;
@@ -276,12 +277,28 @@ typedef struct {
     struct tcpip_api_call_data call;
     mdns_if_t tcpip_if;
     mdns_ip_protocol_t ip_protocol;
-    struct pbuf *pbt;
-    const ip_addr_t *ip;
-    uint16_t port;
     esp_err_t err;
 } mdns_api_call_t;
 
+/**
+ * @brief  Destination of an outgoing packet on its way to the tcpip thread
+ *
+ * Kept in front of the packet data in its pbuf, so sending a packet takes no allocation besides the pbuf.
+ */
+typedef struct {
+    mdns_if_t tcpip_if;
+    mdns_ip_protocol_t ip_protocol;
+    ip_addr_t ip;
+    uint16_t port;
+} mdns_tx_msg_t;
+
+#define MDNS_TX_MSG_LEN LWIP_MEM_ALIGN_SIZE(sizeof(mdns_tx_msg_t))
+
+// counted on the tcpip thread (sent, failed) and on the mdns task (queued, failed)
+static _Atomic uint32_t s_tx_queued;
+static _Atomic uint32_t s_tx_sent;
+static _Atomic uint32_t s_tx_failed;
+
 /**
  * @brief  Start PCB from LwIP thread
  */
@@ -328,58 +345,80 @@ esp_err_t _mdns_pcb_deinit(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
     return msg.err;
 }
 
-static err_t _mdns_udp_pcb_write_api(struct tcpip_api_call_data *api_call_msg)
+/**
+ * @brief  Send a packet from LwIP thread, the sender doesn't wait for it
+ */
+static void _mdns_udp_pcb_send_cb(void *ctx)
 {
-    void *nif = NULL;
-    mdns_api_call_t *msg = (mdns_api_call_t *)api_call_msg;
-    nif = esp_netif_get_netif_impl(_mdns_get_esp_netif(msg->tcpip_if));
-    if (!nif || !mdns_is_netif_ready(msg->tcpip_if, msg->ip_protocol) || _pcb_main == NULL) {
-        pbuf_free(msg->pbt);
-        msg->err = ERR_IF;
-        return ERR_IF;
+    struct pbuf *pbt = (struct pbuf *)ctx;
+    mdns_tx_msg_t msg;
+    err_t err = ERR_IF;
+    // the UDP and IP headers are written over the destination, so take it out of the pbuf first
+    memcpy(&msg, pbt->payload, sizeof(msg));
+    pbuf_remove_header(pbt, MDNS_TX_MSG_LEN);
+    void *nif = esp_netif_get_netif_impl(_mdns_get_esp_netif(msg.tcpip_if));
+    if (nif && mdns_is_netif_ready(msg.tcpip_if, msg.ip_protocol) && _pcb_main != NULL) {
+        err = udp_sendto_if (_pcb_main, pbt, &msg.ip, msg.port, (struct netif *)nif);
+    }
+    pbuf_free(pbt);
+    if (err == ERR_OK) {
+        atomic_fetch_add(&s_tx_sent, 1);
+    } else {
+        atomic_fetch_add(&s_tx_failed, 1);
     }
-    esp_err_t err = udp_sendto_if (_pcb_main, msg->pbt, msg->ip, msg->port, (struct netif *)nif);
-    pbuf_free(msg->pbt);
-    msg->err = err;
-    return err;
 }
 
-size_t _mdns_udp_pcb_write(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, const esp_ip_addr_t *ip, uint16_t port, uint8_t *data, size_t len)
+void *_mdns_udp_pcb_alloc(uint8_t **data)
 {
-    struct pbuf *pbt = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+    struct pbuf *pbt = pbuf_alloc(PBUF_TRANSPORT, MDNS_TX_MSG_LEN + MDNS_MAX_PACKET_SIZE, PBUF_RAM);
     if (pbt == NULL) {
-        return 0;
+        return NULL;
     }
-    memcpy((uint8_t *)pbt->payload, data, len);
+    *data = (uint8_t *)pbt->payload + MDNS_TX_MSG_LEN;
+    return pbt;
+}
+
+size_t _mdns_udp_pcb_send(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, const esp_ip_addr_t *ip, uint16_t port, void *buf, size_t len)
+{
+    struct pbuf *pbt = (struct pbuf *)buf;
+    mdns_tx_msg_t *msg = (mdns_tx_msg_t *)pbt->payload;
+    pbuf_realloc(pbt, MDNS_TX_MSG_LEN + len);
 
-    ip_addr_t ip_add_copy;
 #if LWIP_IPV6 && LWIP_IPV4
-    ip_add_copy.type = ip->type;
-    memcpy(&(ip_add_copy.u_addr), &(ip->u_addr), sizeof(ip_add_copy.u_addr));
+    msg->ip.type = ip->type;
+    memcpy(&(msg->ip.u_addr), &(ip->u_addr), sizeof(msg->ip.u_addr));
 #elif LWIP_IPV4
-    ip_add_copy.addr = ip->u_addr.ip4.addr;
+    msg->ip.addr = ip->u_addr.ip4.addr;
 #elif LWIP_IPV6
 #if LWIP_IPV6_SCOPES
-    ip_add_copy.zone = ip->u_addr.ip6.zone;
+    msg->ip.zone = ip->u_addr.ip6.zone;
 #endif // LWIP_IPV6_SCOPES
-    memcpy(ip_add_copy.addr, ip->u_addr.ip6.addr, sizeof(ip_add_copy.addr));
+    memcpy(msg->ip.addr, ip->u_addr.ip6.addr, sizeof(msg->ip.addr));
 #endif
-
-    mdns_api_call_t msg = {
-        .tcpip_if = tcpip_if,
-        .ip_protocol = ip_protocol,
-        .pbt = pbt,
-        .ip = &ip_add_copy,
-        .port = port
-    };
-    tcpip_api_call(_mdns_udp_pcb_write_api, &msg.call);
-
-    if (msg.err) {
+    msg->tcpip_if = tcpip_if;
+    msg->ip_protocol = ip_protocol;
+    msg->port = port;
+
+    atomic_fetch_add(&s_tx_queued, 1);
+    // the mailbox of the tcpip thread may be full during a burst, then wait for room instead of dropping the packet
+    if (tcpip_try_callback(_mdns_udp_pcb_send_cb, pbt) != ERR_OK
+            && tcpip_callback(_mdns_udp_pcb_send_cb, pbt) != ERR_OK) {
+        pbuf_free(pbt);
+        atomic_fetch_add(&s_tx_failed, 1);
         return 0;
     }
     return len;
 }
 
+void _mdns_get_tx_stats(mdns_tx_stats_t *stats)
+{
+    // packets are counted as queued before they are sent or fail, so reading the outcomes first
+    // keeps sent + failed within queued
+    stats->sent = atomic_load(&s_tx_sent);
+    stats->failed = atomic_load(&s_tx_failed);
+    stats->queued = atomic_load(&s_tx_queued);
+}
+
 void *_mdns_get_packet_data(mdns_rx_packet_t *packet)
 {
     return packet->pb->payload;
@@ -8,6 +8,9 @@
  * @brief MDNS Server Networking module implemented using BSD sockets
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     // recvmmsg()
+#endif
 #include <string.h>
 #include "esp_event.h"
 #include "mdns_networking.h"
@@ -41,6 +44,7 @@ static interfaces_t s_interfaces[MDNS_MAX_INTERFACES];
 
 static const char *TAG = "mdns_networking";
 static bool s_run_sock_recv_task = false;
+static TaskHandle_t s_sock_recv_task = NULL;
 static int create_socket(esp_netif_t *netif);
 static int join_mdns_multicast_group(int sock, esp_netif_t *netif, mdns_ip_protocol_t ip_protocol);
 
@@ -57,6 +61,39 @@ struct pbuf  {
 #define s6_addr32 un.u32_addr
 #endif // CONFIG_IDF_TARGET_LINUX
 
+#ifndef CONFIG_MDNS_RX_SLAB_SIZE
+#define CONFIG_MDNS_RX_SLAB_SIZE 0
+#endif
+#define MDNS_RX_SLAB_SIZE CONFIG_MDNS_RX_SLAB_SIZE
+
+#ifndef CONFIG_MDNS_RX_BATCH_SIZE
+#define CONFIG_MDNS_RX_BATCH_SIZE 1
+#endif
+#define MDNS_RX_BATCH_SIZE CONFIG_MDNS_RX_BATCH_SIZE
+
+#if defined(__linux__) && MDNS_RX_BATCH_SIZE > 1
+#define MDNS_RX_USE_RECVMMSG 1
+#endif
+
+/**
+ * @brief Pre-allocated receive buffer holding the packet, its pbuf and the payload
+ *
+ * The packet is the first member, so the packet pointer passed to the mDNS task
+ * identifies the slot when it comes back in _mdns_packet_free()
+ */
+typedef struct {
+    mdns_rx_packet_t packet;
+    struct pbuf pb;
+    uint8_t payload[MDNS_MAX_PACKET_SIZE];
+} rx_slot_t;
+
+static rx_slot_t *s_rx_slab = NULL;
+static QueueHandle_t s_rx_free_slots = NULL;
+static bool s_rx_slab_active = false;   // the receive task may still take slots from the slab
+static mdns_rx_slab_stats_t s_rx_stats;
+static mdns_tx_stats_t s_tx_stats;
+static uint8_t s_tx_buffer[MDNS_MAX_PACKET_SIZE];
+
 static void __attribute__((constructor)) ctor_networking_socket(void)
 {
     for (int i = 0; i < sizeof(s_interfaces) / sizeof(s_interfaces[0]); ++i) {
@@ -85,13 +122,126 @@ size_t _mdns_get_packet_len(mdns_rx_packet_t *packet)
     return packet->pb->len;
 }
 
+static inline bool rx_slab_owns(mdns_rx_packet_t *packet)
+{
+    return s_rx_slab && (rx_slot_t *)packet >= s_rx_slab && (rx_slot_t *)packet < s_rx_slab + MDNS_RX_SLAB_SIZE;
+}
+
+static inline uint32_t rx_slab_in_use(void)
+{
+    return s_rx_free_slots ? MDNS_RX_SLAB_SIZE - uxQueueMessagesWaiting(s_rx_free_slots) : 0;
+}
+
+/**
+ * @brief  Free the slab once the receive task has stopped and all slots came back
+ */
+static void rx_slab_try_free(void)
+{
+    if (s_rx_slab_active || !s_rx_slab || rx_slab_in_use() != 0) {
+        return;
+    }
+    vQueueDelete(s_rx_free_slots);
+    s_rx_free_slots = NULL;
+    free(s_rx_slab);
+    s_rx_slab = NULL;
+    s_rx_stats.slots = 0;
+}
+
+/**
+ * @brief  Allocate the receive slab (if not allocated yet) before starting the receive task
+ */
+static void rx_slab_acquire(void)
+{
+    s_rx_slab_active = true;
+    if (MDNS_RX_SLAB_SIZE == 0 || s_rx_slab) {
+        return;
+    }
+    s_rx_slab = (rx_slot_t *)calloc(MDNS_RX_SLAB_SIZE, sizeof(rx_slot_t));
+    s_rx_free_slots = xQueueCreate(MDNS_RX_SLAB_SIZE, sizeof(rx_slot_t *));
+    if (!s_rx_slab || !s_rx_free_slots) {
+        MDNS_MALLOC_FAILED;
+        ESP_LOGW(TAG, "Failed to allocate receive buffers, using heap for each packet");
+        if (s_rx_free_slots) {
+            vQueueDelete(s_rx_free_slots);
+            s_rx_free_slots = NULL;
+        }
+        free(s_rx_slab);
+        s_rx_slab = NULL;
+        return;
+    }
+    for (int i = 0; i < MDNS_RX_SLAB_SIZE; i++) {
+        rx_slot_t *slot = &s_rx_slab[i];
+        slot->pb.payload = slot->payload;
+        xQueueSend(s_rx_free_slots, &slot, 0);
+    }
+    s_rx_stats.slots = MDNS_RX_SLAB_SIZE;
+}
+
+/**
+ * @brief  Called after the receive task has stopped
+ */
+static void rx_slab_release(void)
+{
+    s_rx_slab_active = false;
+    rx_slab_try_free();
+}
+
+/**
+ * @brief  Take a free slot from the slab, or NULL if all slots are owned by the mDNS task
+ */
+static mdns_rx_packet_t *rx_slab_get(void)
+{
+    rx_slot_t *slot = NULL;
+    if (!s_rx_free_slots || xQueueReceive(s_rx_free_slots, &slot, 0) != pdTRUE) {
+        return NULL;
+    }
+    slot->pb.next = NULL;
+    slot->packet.pb = &slot->pb;
+    return &slot->packet;
+}
+
+/**
+ * @brief  Copy the packet received into the shared buffer to heap memory
+ */
+static mdns_rx_packet_t *rx_heap_alloc(const uint8_t *data, size_t len)
+{
+    mdns_rx_packet_t *packet = (mdns_rx_packet_t *) calloc(1, sizeof(mdns_rx_packet_t));
+    struct pbuf *packet_pbuf = calloc(1, sizeof(struct pbuf));
+    uint8_t *buf = malloc(len);
+    if (packet == NULL || packet_pbuf == NULL || buf == NULL ) {
+        free(buf);
+        free(packet_pbuf);
+        free(packet);
+        MDNS_MALLOC_FAILED;
+        ESP_LOGE(TAG, "Failed to allocate the mdns packet");
+        return NULL;
+    }
+    memcpy(buf, data, len);
+    packet_pbuf->next = NULL;
+    packet_pbuf->payload = buf;
+    packet->pb = packet_pbuf;
+    return packet;
+}
+
 void _mdns_packet_free(mdns_rx_packet_t *packet)
 {
+    if (rx_slab_owns(packet)) {
+        rx_slot_t *slot = (rx_slot_t *)packet;
+        xQueueSend(s_rx_free_slots, &slot, 0);
+        rx_slab_try_free();
+        return;
+    }
     free(packet->pb->payload);
     free(packet->pb);
     free(packet);
 }
 
+void _mdns_get_rx_slab_stats(mdns_rx_slab_stats_t *stats)
+{
+    *stats = s_rx_stats;
+    stats->in_use = rx_slab_in_use();
+}
+
 esp_err_t _mdns_pcb_deinit(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
 {
     s_interfaces[tcpip_if].proto &= ~(ip_protocol == MDNS_IP_PROTOCOL_V4 ? PROTO_IPV4 : PROTO_IPV6);
@@ -111,7 +261,10 @@ esp_err_t _mdns_pcb_deinit(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol)
 
     // no interface alive, stop the rx task
     s_run_sock_recv_task = false;
-    vTaskDelay(pdMS_TO_TICKS(500));
+    while (s_sock_recv_task) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    rx_slab_release();
     return ESP_OK;
 }
 
@@ -191,29 +344,48 @@ static inline size_t espaddr_to_inet(const esp_ip_addr_t *addr, const uint16_t p
     return ss_addr_len;
 }
 
-size_t _mdns_udp_pcb_write(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, const esp_ip_addr_t *ip, uint16_t port, uint8_t *data, size_t len)
+void *_mdns_udp_pcb_alloc(uint8_t **data)
+{
+    // sendto() copies the packet, so one buffer is enough
+    *data = s_tx_buffer;
+    return s_tx_buffer;
+}
+
+size_t _mdns_udp_pcb_send(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, const esp_ip_addr_t *ip, uint16_t port, void *buf, size_t len)
 {
+    s_tx_stats.queued++;
     if (!(s_interfaces[tcpip_if].proto & (ip_protocol == MDNS_IP_PROTOCOL_V4 ? PROTO_IPV4 : PROTO_IPV6))) {
+        s_tx_stats.failed++;
         return 0;
     }
     int sock = s_interfaces[tcpip_if].sock;
     if (sock < 0) {
+        s_tx_stats.failed++;
         return 0;
     }
     struct sockaddr_storage in_addr;
     size_t ss_size = espaddr_to_inet(ip, htons(port), ip_protocol, &in_addr);
     if (!ss_size) {
         ESP_LOGE(TAG, "espaddr_to_inet() failed: Mismatch of IP protocols");
+        s_tx_stats.failed++;
         return 0;
     }
     ESP_LOGD(TAG, "[sock=%d]: Sending to IP %s port %d", sock, get_string_address(&in_addr), port);
-    ssize_t actual_len = sendto(sock, data, len, 0, (struct sockaddr *)&in_addr, ss_size);
+    ssize_t actual_len = sendto(sock, buf, len, 0, (struct sockaddr *)&in_addr, ss_size);
     if (actual_len < 0) {
-        ESP_LOGE(TAG, "[sock=%d]: _mdns_udp_pcb_write sendto() has failed\n errno=%d: %s", sock, errno, strerror(errno));
+        ESP_LOGE(TAG, "[sock=%d]: _mdns_udp_pcb_send sendto() has failed\n errno=%d: %s", sock, errno, strerror(errno));
+        s_tx_stats.failed++;
+        return 0;
     }
+    s_tx_stats.sent++;
     return actual_len;
 }
 
+void _mdns_get_tx_stats(mdns_tx_stats_t *stats)
+{
+    *stats = s_tx_stats;
+}
+
 static inline void inet_to_espaddr(const struct sockaddr_storage *in_addr, esp_ip_addr_t *addr, uint16_t *port)
 {
 #ifdef CONFIG_LWIP_IPV4
@@ -246,6 +418,154 @@ static inline void inet_to_espaddr(const struct sockaddr_storage *in_addr, esp_i
 #endif // CONFIG_LWIP_IPV6
 }
 
+/**
+ * @brief  Complete the received packet, copying its data to heap if it wasn't received into a slab slot
+ */
+static mdns_rx_packet_t *rx_packet_prepare(mdns_rx_packet_t *packet, const uint8_t *data, int len,
+        mdns_if_t tcpip_if, struct sockaddr_storage *raddr)
+{
+    uint16_t port = 0;
+    esp_ip_addr_t addr = {0};
+
+    s_rx_stats.rx_packets++;
+    ESP_LOGD(TAG, "[sock=%d]: Received from IP:%s", s_interfaces[tcpip_if].sock, get_string_address(raddr));
+    ESP_LOG_BUFFER_HEXDUMP(TAG, data, len, ESP_LOG_VERBOSE);
+    inet_to_espaddr(raddr, &addr, &port);
+
+    if (!packet) {
+        // No free slot, allocate the packet structure and copy the data
+        s_rx_stats.slab_exhausted++;
+        packet = rx_heap_alloc(data, len);
+        if (!packet) {
+            s_rx_stats.dropped++;
+            return NULL;
+        }
+    }
+    packet->pb->tot_len = len;
+    packet->pb->len = len;
+    packet->tcpip_if = tcpip_if;
+    packet->src_port = ntohs(port);
+    memcpy(&packet->src, &addr, sizeof(esp_ip_addr_t));
+    // TODO(IDF-3651): Add the correct dest addr -- for mdns to decide multicast/unicast
+    // Currently it's enough to assume the packet is multicast and mdns to check the source port of the packet
+    memset(&packet->dest, 0, sizeof(esp_ip_addr_t));
+    packet->multicast = 1;
+    packet->dest.type = packet->src.type;
+    packet->ip_protocol =
+        packet->src.type == ESP_IPADDR_TYPE_V4 ? MDNS_IP_PROTOCOL_V4 : MDNS_IP_PROTOCOL_V6;
+    packet->next = NULL;
+    return packet;
+}
+
+#ifdef MDNS_RX_USE_RECVMMSG
+/**
+ * @brief  Receive up to MDNS_RX_BATCH_SIZE datagrams with a single recvmmsg() call
+ *
+ * @return number of received datagrams, -1 on error
+ */
+static int sock_recv_batch(int sock, mdns_if_t tcpip_if, mdns_rx_packet_t **batch)
+{
+    // used from the receive task only
+    static uint8_t recvbufs[MDNS_RX_BATCH_SIZE][MDNS_MAX_PACKET_SIZE];
+    static struct mmsghdr msgs[MDNS_RX_BATCH_SIZE];
+    static struct iovec iovecs[MDNS_RX_BATCH_SIZE];
+    static struct sockaddr_storage raddrs[MDNS_RX_BATCH_SIZE];
+    static mdns_rx_packet_t *slots[MDNS_RX_BATCH_SIZE];
+    mdns_rx_packet_t **tail = batch;
+
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < MDNS_RX_BATCH_SIZE; i++) {
+        slots[i] = rx_slab_get();
+        iovecs[i].iov_base = slots[i] ? slots[i]->pb->payload : recvbufs[i];
+        iovecs[i].iov_len = MDNS_MAX_PACKET_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &raddrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(raddrs[i]);
+    }
+    int received = recvmmsg(sock, msgs, MDNS_RX_BATCH_SIZE, MSG_DONTWAIT, NULL);
+    if (received < 0) {
+        ESP_LOGE(TAG, "multicast recvmmsg failed. errno=%d: %s", errno, strerror(errno));
+    }
+    for (int i = 0; i < MDNS_RX_BATCH_SIZE; i++) {
+        if (i >= received) {
+            if (slots[i]) {
+                _mdns_packet_free(slots[i]);
+            }
+            continue;
+        }
+        mdns_rx_packet_t *packet = rx_packet_prepare(slots[i], iovecs[i].iov_base, msgs[i].msg_len, tcpip_if, &raddrs[i]);
+        if (packet) {
+            *tail = packet;
+            tail = &packet->next;
+        }
+    }
+    return received;
+}
+#else
+/**
+ * @brief  Receive the datagram signalled by select() and drain up to MDNS_RX_BATCH_SIZE-1 more without blocking
+ *
+ * @return number of received datagrams, -1 on error
+ */
+static int sock_recv_batch(int sock, mdns_if_t tcpip_if, mdns_rx_packet_t **batch)
+{
+    static uint8_t recvbuf[MDNS_MAX_PACKET_SIZE];
+    mdns_rx_packet_t **tail = batch;
+    int received = 0;
+
+    while (received < MDNS_RX_BATCH_SIZE) {
+        struct sockaddr_storage raddr; // Large enough for both IPv4 or IPv6
+        socklen_t socklen = sizeof(struct sockaddr_storage);
+        // Receive directly into a slab slot if there's one free, the slot is then handed over to the mdns engine
+        mdns_rx_packet_t *packet = rx_slab_get();
+        uint8_t *data = packet ? packet->pb->payload : recvbuf;
+        int len = recvfrom(sock, data, MDNS_MAX_PACKET_SIZE, received ? MSG_DONTWAIT : 0,
+                           (struct sockaddr *) &raddr, &socklen);
+        if (len < 0) {
+            if (packet) {
+                _mdns_packet_free(packet);
+            }
+            if (received && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            ESP_LOGE(TAG, "multicast recvfrom failed. errno=%d: %s", errno, strerror(errno));
+            return received ? received : -1;
+        }
+        packet = rx_packet_prepare(packet, data, len, tcpip_if, &raddr);
+        if (packet) {
+            *tail = packet;
+            tail = &packet->next;
+        }
+        received++;
+    }
+    return received;
+}
+#endif // MDNS_RX_USE_RECVMMSG
+
+/**
+ * @brief  Pass the received packets to the mdns main engine, as a single action
+ */
+static void rx_batch_post(mdns_rx_packet_t *batch)
+{
+    uint32_t in_use = rx_slab_in_use();
+    if (in_use > s_rx_stats.in_use_max) {
+        s_rx_stats.in_use_max = in_use;
+    }
+    esp_err_t err = batch->next ? _mdns_send_rx_batch_action(batch) : _mdns_send_rx_action(batch);
+    if (err == ESP_OK) {
+        s_rx_stats.rx_batches++;
+        return;
+    }
+    ESP_LOGE(TAG, "_mdns_send_rx_action failed!");
+    while (batch) {
+        mdns_rx_packet_t *next = batch->next;
+        s_rx_stats.dropped++;
+        _mdns_packet_free(batch);
+        batch = next;
+    }
+}
+
 void sock_recv_task(void *arg)
 {
     while (s_run_sock_recv_task) {
@@ -280,60 +600,18 @@ void sock_recv_task(void *arg)
                     continue;
                 }
                 if (FD_ISSET(sock, &rfds)) {
-                    static char recvbuf[MDNS_MAX_PACKET_SIZE];
-                    uint16_t port = 0;
-
-                    struct sockaddr_storage raddr; // Large enough for both IPv4 or IPv6
-                    socklen_t socklen = sizeof(struct sockaddr_storage);
-                    esp_ip_addr_t addr = {0};
-                    int len = recvfrom(sock, recvbuf, sizeof(recvbuf), 0,
-                                       (struct sockaddr *) &raddr, &socklen);
-                    if (len < 0) {
-                        ESP_LOGE(TAG, "multicast recvfrom failed. errno=%d: %s", errno, strerror(errno));
+                    mdns_rx_packet_t *batch = NULL;
+                    if (sock_recv_batch(sock, tcpip_if, &batch) < 0) {
                         break;
                     }
-                    ESP_LOGD(TAG, "[sock=%d]: Received from IP:%s", sock, get_string_address(&raddr));
-                    ESP_LOG_BUFFER_HEXDUMP(TAG, recvbuf, len, ESP_LOG_VERBOSE);
-                    inet_to_espaddr(&raddr, &addr, &port);
-
-                    // Allocate the packet structure and pass it to the mdns main engine
-                    mdns_rx_packet_t *packet = (mdns_rx_packet_t *) calloc(1, sizeof(mdns_rx_packet_t));
-                    struct pbuf *packet_pbuf = calloc(1, sizeof(struct pbuf));
-                    uint8_t *buf = malloc(len);
-                    if (packet == NULL || packet_pbuf == NULL || buf == NULL ) {
-                        free(buf);
-                        free(packet_pbuf);
-                        free(packet);
-                        HOOK_MALLOC_FAILED;
-                        ESP_LOGE(TAG, "Failed to allocate the mdns packet");
-                        continue;
-                    }
-                    memcpy(buf, recvbuf, len);
-                    packet_pbuf->next = NULL;
-                    packet_pbuf->payload = buf;
-                    packet_pbuf->tot_len = len;
-                    packet_pbuf->len = len;
-                    packet->tcpip_if = tcpip_if;
-                    packet->pb = packet_pbuf;
-                    packet->src_port = ntohs(port);
-                    memcpy(&packet->src, &addr, sizeof(esp_ip_addr_t));
-                    // TODO(IDF-3651): Add the correct dest addr -- for mdns to decide multicast/unicast
-                    // Currently it's enough to assume the packet is multicast and mdns to check the source port of the packet
-                    memset(&packet->dest, 0, sizeof(esp_ip_addr_t));
-                    packet->multicast = 1;
-                    packet->dest.type = packet->src.type;
-                    packet->ip_protocol =
-                        packet->src.type == ESP_IPADDR_TYPE_V4 ? MDNS_IP_PROTOCOL_V4 : MDNS_IP_PROTOCOL_V6;
-                    if (_mdns_send_rx_action(packet) != ESP_OK) {
-                        ESP_LOGE(TAG, "_mdns_send_rx_action failed!");
-                        free(packet->pb->payload);
-                        free(packet->pb);
-                        free(packet);
+                    if (batch) {
+                        rx_batch_post(batch);
                     }
                 }
             }
         }
     }
+    s_sock_recv_task = NULL;
     vTaskDelete(NULL);
 }
 
@@ -341,7 +619,8 @@ static void mdns_networking_init(void)
 {
     if (s_run_sock_recv_task == false) {
         s_run_sock_recv_task = true;
-        xTaskCreate( sock_recv_task, "mdns recv task", 3 * 1024, NULL, 5, NULL );
+        rx_slab_acquire();
+        xTaskCreate( sock_recv_task, "mdns recv task", 3 * 1024, NULL, 5, &s_sock_recv_task );
     }
 }
 
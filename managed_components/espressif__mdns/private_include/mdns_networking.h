@@ -19,6 +19,11 @@
  */
 esp_err_t _mdns_send_rx_action(mdns_rx_packet_t *packet);
 
+/**
+ * @brief  Queue a batch of RX packets, linked through their next pointer, as a single action
+ */
+esp_err_t _mdns_send_rx_batch_action(mdns_rx_packet_t *packets);
+
 bool mdns_is_netif_ready(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol);
 
 /**
@@ -31,16 +36,41 @@ esp_err_t _mdns_pcb_init(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol);
  */
 esp_err_t _mdns_pcb_deinit(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol);
 
+/**
+ * @brief  Allocate a buffer for an outgoing packet
+ *
+ * @param  data         set to the MDNS_MAX_PACKET_SIZE bytes the packet is written to
+ *
+ * @return handle of the buffer, to be passed to _mdns_udp_pcb_send(), or NULL if out of memory
+ */
+void *_mdns_udp_pcb_alloc(uint8_t **data);
+
 /**
  * @brief  send packet over UDP
  *
- * @param  server       The server
- * @param  data         byte array containing the packet data
+ * Takes over the buffer, also on error. The lwIP implementation hands the packet over to the tcpip thread
+ * without waiting for it to be sent, the outcome is counted in the TX statistics.
+ *
+ * @param  buf          buffer from _mdns_udp_pcb_alloc() holding the packet data
  * @param  len          length of the packet data
  *
- * @return length of sent packet or 0 on error
+ * @return length of the packet sent (or queued for sending) or 0 on error
  */
-size_t _mdns_udp_pcb_write(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, const esp_ip_addr_t *ip, uint16_t port, uint8_t *data, size_t len);
+size_t _mdns_udp_pcb_send(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, const esp_ip_addr_t *ip, uint16_t port, void *buf, size_t len);
+
+/**
+ * @brief  Transmit statistics of the networking layer
+ */
+typedef struct {
+    uint32_t queued;            /*!< Packets passed to _mdns_udp_pcb_send() */
+    uint32_t sent;              /*!< Packets sent */
+    uint32_t failed;            /*!< Packets dropped, because the interface was down or sending failed */
+} mdns_tx_stats_t;
+
+/**
+ * @brief  Get transmit statistics, packets queued but neither sent nor failed are still on their way
+ */
+void _mdns_get_tx_stats(mdns_tx_stats_t *stats);
 
 /**
  * @brief  Gets data pointer to the mDNS packet
@@ -57,4 +87,24 @@ size_t _mdns_get_packet_len(mdns_rx_packet_t *packet);
  */
 void _mdns_packet_free(mdns_rx_packet_t *packet);
 
+#ifdef CONFIG_MDNS_NETWORKING_SOCKET
+/**
+ * @brief  Receive buffer statistics of the socket networking layer
+ */
+typedef struct {
+    uint32_t slots;             /*!< Number of pre-allocated receive buffers */
+    uint32_t in_use;            /*!< Buffers currently owned by the mDNS task */
+    uint32_t in_use_max;        /*!< High-water mark of buffers in use */
+    uint32_t rx_packets;        /*!< Packets received on all sockets */
+    uint32_t rx_batches;        /*!< Actions posted to the mDNS task, each carrying one or more packets */
+    uint32_t slab_exhausted;    /*!< Packets received while no buffer was free (heap fallback) */
+    uint32_t dropped;           /*!< Packets dropped due to allocation or action queue failure */
+} mdns_rx_slab_stats_t;
+
+/**
+ * @brief  Get receive buffer statistics
+ */
+void _mdns_get_rx_slab_stats(mdns_rx_slab_stats_t *stats);
+#endif /* CONFIG_MDNS_NETWORKING_SOCKET */
+
 #endif /* ESP_MDNS_NETWORKING_H_ */
@@ -58,19 +58,53 @@
 /** The maximum number of services */
 #define MDNS_MAX_SERVICES           CONFIG_MDNS_MAX_SERVICES
 
+/** Number of buckets of the service and host lookup tables */
+#define MDNS_LOOKUP_HASH_BUCKETS    CONFIG_MDNS_LOOKUP_HASH_BUCKETS
+
 #define MDNS_ANSWER_PTR_TTL         4500
 #define MDNS_ANSWER_TXT_TTL         4500
 #define MDNS_ANSWER_SRV_TTL         120
 #define MDNS_ANSWER_A_TTL           120
 #define MDNS_ANSWER_AAAA_TTL        120
 
+/** Number of records received from other hosts kept in the cache */
+#define MDNS_CACHE_SIZE             CONFIG_MDNS_CACHE_SIZE
+/** Longer TTLs are cached for a day, so that times stay within the range of the millisecond tick */
+#define MDNS_CACHE_MAX_TTL          86400
+/** Refresh queries are sent at 80, 85, 90 and 95 percent of the TTL, plus up to 2 percent (RFC 6762 section 5.2) */
+#define MDNS_CACHE_REFRESH_QUERIES  4
+
+/** Multicast answers remembered per interface, to send a record at most once per interval (RFC 6762 section 6) */
+#define MDNS_MULTICAST_RECORDS      32
+#define MDNS_MULTICAST_INTERVAL_MS  1000
+
+/** Shared answers joining an already scheduled response are sent this long after the query (RFC 6762 section 6) */
+#define MDNS_TX_COALESCE_MIN_MS     20
+#define MDNS_TX_COALESCE_MAX_MS     120
+/** Packets of other interfaces with the same records, due within this time, are encoded together with the one being sent */
+#define MDNS_TX_FANOUT_WINDOW_MS    10
+/** Queries of searches and browses are repeated after 1 s, then with the interval doubled up to an hour (RFC 6762 section 5.2) */
+#define MDNS_QUERY_MIN_INTERVAL_MS  1000
+#define MDNS_QUERY_MAX_INTERVAL_MS  (60 * 60 * 1000)
+
 #define MDNS_FLAGS_QUERY_REPSONSE   0x8000
 #define MDNS_FLAGS_AUTHORITATIVE    0x0400
 #define MDNS_FLAGS_QR_AUTHORITATIVE (MDNS_FLAGS_QUERY_REPSONSE | MDNS_FLAGS_AUTHORITATIVE)
 #define MDNS_FLAGS_DISTRIBUTED      0x0200
+#define MDNS_FLAGS_TRUNCATED        0x0200                  // TC, more known answers of the query follow
 
 #define MDNS_NAME_REF               0xC000
 
+/** Names remembered for compression while a packet is assembled, the rest is found by scanning the packet */
+#define MDNS_NAME_DICT_ENTRIES      64
+#define MDNS_NAME_DICT_BUCKETS      32
+#define MDNS_NAME_DICT_NONE         0xFF
+#define MDNS_NAME_DICT_LABELS       8
+
+#define MDNS_NAME_DICT_LABEL_IRREGULAR  0x01    // empty, too long or containing a dot
+#define MDNS_NAME_DICT_LABEL_SUB        0x02    // "_sub", skipped by _mdns_read_fqdn()
+#define MDNS_NAME_DICT_LABEL_MERGES     0x04    // merged into the host part by _mdns_read_fqdn() if it follows the first part
+
 //custom type! only used by this implementation
 //to help manage service discovery handling
 #define MDNS_TYPE_SDPTR             0x0032
@@ -102,6 +136,10 @@
 
 #define MDNS_PACKET_QUEUE_LEN       16                      // Maximum packets that can be queued for parsing
 #define MDNS_ACTION_QUEUE_LEN       CONFIG_MDNS_ACTION_QUEUE_LEN  // Maximum actions pending to the server
+#define MDNS_RX_QUEUE_LEN           CONFIG_MDNS_RX_QUEUE_LEN      // Maximum received packets pending to the server, also those of batches
+#define MDNS_RX_SHED_LEVEL          (MDNS_RX_QUEUE_LEN * 3 / 4)   // Received packets pending above which queries are dropped
+#define MDNS_LANE_PASS_MAX          4                       // Actions of the other lanes served while a waiting lane is passed over
+#define MDNS_ACTION_POOL_SIZE       (MDNS_ACTION_QUEUE_LEN + MDNS_RX_QUEUE_LEN + 2) // Pre-allocated actions: the pending ones, the one executed and one being posted
 #define MDNS_TXT_MAX_LEN            1024                    // Maximum string length of text data in TXT record
 #if defined(CONFIG_LWIP_IPV6) && defined(CONFIG_MDNS_RESPOND_REVERSE_QUERIES)
 #define MDNS_NAME_MAX_LEN           (64+4)                  // Need to account for IPv6 reverse queries (64 char address  + ".ip6" )
@@ -110,6 +148,7 @@
 #endif
 #define MDNS_NAME_BUF_LEN           (MDNS_NAME_MAX_LEN+1)   // Maximum char buffer size to hold hostname, instance, service or proto
 #define MDNS_MAX_PACKET_SIZE        1460                    // Maximum size of mDNS  outgoing packet
+#define MDNS_PARSE_ARENA_SIZE       (MDNS_MAX_PACKET_SIZE + MDNS_MAX_SERVICES * 128) // Parser scratch memory: question names, plus discovery questions and known answers per service
 
 #define MDNS_HEAD_LEN               12
 #define MDNS_HEAD_ID_OFFSET         0
@@ -170,6 +209,11 @@
 #define HOOK_MALLOC_FAILED  ESP_LOGE(TAG, "Cannot allocate memory (line: %d, free heap: %" PRIu32 " bytes)", __LINE__, esp_get_free_heap_size());
 #endif
 
+/**
+ * @brief  Counts a failed allocation (see mdns_stats_get()) and calls HOOK_MALLOC_FAILED
+ */
+#define MDNS_MALLOC_FAILED  do { _mdns_stats_alloc_failed(); HOOK_MALLOC_FAILED; } while (0)
+
 typedef size_t mdns_if_t;
 
 typedef enum {
@@ -188,13 +232,13 @@ typedef enum {
     ACTION_HOSTNAME_SET,
     ACTION_INSTANCE_SET,
     ACTION_SEARCH_ADD,
-    ACTION_SEARCH_SEND,
     ACTION_SEARCH_END,
     ACTION_BROWSE_ADD,
     ACTION_BROWSE_SYNC,
     ACTION_BROWSE_END,
-    ACTION_TX_HANDLE,
+    ACTION_TIMER,
     ACTION_RX_HANDLE,
+    ACTION_RX_BATCH_HANDLE,
     ACTION_TASK_STOP,
     ACTION_DELEGATE_HOSTNAME_ADD,
     ACTION_DELEGATE_HOSTNAME_REMOVE,
@@ -202,6 +246,19 @@ typedef enum {
     ACTION_MAX
 } mdns_action_type_t;
 
+/**
+ * @brief  Queues of the actions for the service thread, in the order of their priority
+ *
+ * The scheduler takes from the first lane with actions waiting, but serves a waiting lane at the latest
+ * after it was passed over MDNS_LANE_PASS_MAX times, so neither of them is starved.
+ */
+typedef enum {
+    MDNS_LANE_CONTROL,                      /*!< API calls and system events */
+    MDNS_LANE_TIMER,                        /*!< the timer action, transmitting the packets due and running the searches */
+    MDNS_LANE_RX,                           /*!< received packets, queries are dropped above MDNS_RX_SHED_LEVEL */
+    MDNS_LANE_MAX
+} mdns_lane_t;
+
 
 typedef struct {
     uint16_t id;
@@ -222,6 +279,51 @@ typedef struct {
     bool    invalid;
 } mdns_name_t;
 
+/**
+ * @brief  Label of a received name, where it is in the packet
+ */
+typedef struct {
+    const uint8_t *data;            /*!< First byte of the label */
+    uint8_t len;                    /*!< Length of the label, up to a zero byte in it */
+} mdns_label_t;
+
+/**
+ * @brief  Labels of the parts of a received name, as the parser found them (see mdns_name_t)
+ */
+typedef struct {
+    mdns_label_t parts[4];          /*!< Labels of the parts in the order they were read */
+    bool host_merged;               /*!< The first part has more labels, it was written to the host of the name */
+} mdns_name_labels_t;
+
+/**
+ * @brief Compression dictionary of the packet being assembled
+ *
+ * Every name (and name suffix) written out in full is remembered with the offset of its first label,
+ * hashed the way it reads back, so later occurrences can be replaced by a pointer without searching the packet.
+ */
+typedef struct {
+    const uint8_t *packet;                  /*!< packet the entries refer to */
+    bool overflow;                          /*!< some names were not remembered, search the packet instead */
+    uint8_t count;                          /*!< number of used entries */
+    uint8_t buckets[MDNS_NAME_DICT_BUCKETS];/*!< newest entry of each bucket */
+    struct {
+        uint32_t hash;                      /*!< case-insensitive hash of the name parts */
+        uint16_t offset;                    /*!< offset of the first label in the packet */
+        uint8_t next;                       /*!< older entry in the same bucket */
+    } entries[MDNS_NAME_DICT_ENTRIES];
+} mdns_name_dict_t;
+
+typedef enum {
+    MDNS_NAME_DICT_MATCHABLE,   /*!< can be found in the dictionary */
+    MDNS_NAME_DICT_NEVER,       /*!< would never be compressed by a packet search either */
+    MDNS_NAME_DICT_IRREGULAR,   /*!< labels that do not read back as they are, only the packet search knows */
+} mdns_name_dict_class_t;
+
+typedef struct {
+    uint32_t hash;              /*!< case-insensitive hash of the length and a few characters */
+    uint8_t flags;              /*!< MDNS_NAME_DICT_LABEL_* */
+} mdns_name_dict_label_t;
+
 typedef struct mdns_parsed_question_s {
     struct mdns_parsed_question_s *next;
     uint16_t type;
@@ -263,7 +365,22 @@ typedef struct {
     uint16_t id;
 } mdns_parsed_packet_t;
 
+/**
+ * @brief Scratch memory of the packet parser
+ *
+ * The parsed packet, its questions and records and the strings they refer to are carved from the buffer,
+ * so parsing needs no heap and all of its state belongs to the caller. Everything is released at once
+ * when the next packet is parsed with the same arena.
+ */
 typedef struct {
+    mdns_name_t name;                       /*!< name currently being parsed */
+    mdns_name_t target;                     /*!< target of a PTR or SRV record being cached */
+    mdns_name_t owner;                      /*!< name of the record answering a search, to find all the searches it answers */
+    size_t used;                            /*!< bytes of the buffer handed out */
+    uint8_t buf[MDNS_PARSE_ARENA_SIZE];     /*!< storage of the parsed data */
+} mdns_parse_arena_t;
+
+typedef struct mdns_rx_packet_s {
     mdns_if_t tcpip_if;
     mdns_ip_protocol_t ip_protocol;
     struct pbuf *pb;
@@ -271,35 +388,69 @@ typedef struct {
     esp_ip_addr_t dest;
     uint16_t src_port;
     uint8_t multicast;
+    struct mdns_rx_packet_s *next;          /*!< next packet of an RX batch */
 } mdns_rx_packet_t;
 
-typedef struct mdns_txt_linked_item_s {
-    const char *key;                        /*!< item key name */
-    char *value;                            /*!< item value string */
-    uint8_t value_len;                      /*!< item value length */
-    struct mdns_txt_linked_item_s *next;    /*!< next result, or NULL for the last result in the list */
-} mdns_txt_linked_item_t;
-
 typedef struct mdns_subtype_s {
-    const char *subtype;                    /*!< subtype */
+    const char *subtype;                    /*!< subtype (interned) */
     struct mdns_subtype_s *next;            /*!< next result, or NULL for the last result in the list */
 } mdns_subtype_t;
 
+/**
+ * @brief String shared by all services using it
+ *
+ * Service types, protocols, hostnames and subtypes repeat across the services, so the services
+ * reference a single copy of each, counting its users.
+ */
+typedef struct mdns_str_s {
+    struct mdns_str_s *next;                /*!< next string of the table */
+    uint16_t refs;                          /*!< number of references to the string */
+    char str[];                             /*!< the string */
+} mdns_str_t;
+
+/**
+ * @brief Parts of the records of a service which are the same in every packet, encoded once
+ *
+ * The labels of the names are keyed for the compression dictionary as _mdns_append_fqdn() keys them, how much
+ * of a name is written out still depends on the packet. The parts are valid while their generation is the one
+ * of the names of the responder; the mdns_service_*() calls changing a service set it to 0.
+ */
+typedef struct {
+    uint32_t generation;                    /*!< generation of the names the parts were encoded for, 0 if none */
+    mdns_name_dict_label_t name[4];         /*!< keys of the instance, service type, protocol and domain labels */
+    mdns_name_dict_label_t host[2];         /*!< keys of the labels of the SRV target: host and domain */
+    uint8_t srv[6];                         /*!< SRV priority, weight and port as they go on the wire */
+} mdns_service_wire_t;
+
 typedef struct {
     const char *instance;
-    const char *service;
-    const char *proto;
-    const char *hostname;
+    const char *service;                    /*!< service type (interned) */
+    const char *proto;                      /*!< protocol (interned) */
+    const char *hostname;                   /*!< hostname (interned) */
     uint16_t priority;
     uint16_t weight;
     uint16_t port;
-    mdns_txt_linked_item_t *txt;
+    uint16_t txt_len;                       /*!< length of the TXT data */
+    uint8_t *txt;                           /*!< TXT data as it goes on the wire ("key=value" strings, each prefixed by its length), NULL without items */
     mdns_subtype_t *subtype;
+    mdns_service_wire_t wire;               /*!< encoded parts of the records, see _mdns_service_wire() */
 } mdns_service_t;
 
+/**
+ * @brief Keys the services are indexed by in the lookup tables
+ */
+typedef enum {
+    MDNS_SRV_INDEX_TYPE,        /*!< service type and protocol */
+    MDNS_SRV_INDEX_INSTANCE,    /*!< instance name (empty if default), service type and protocol */
+    MDNS_SRV_INDEX_MAX
+} mdns_srv_index_t;
+
 typedef struct mdns_srv_item_s {
     struct mdns_srv_item_s *next;
     mdns_service_t *service;
+    struct mdns_srv_item_s *hash_next[MDNS_SRV_INDEX_MAX];  /*!< next item in the same lookup bucket */
+    uint16_t hash_bucket[MDNS_SRV_INDEX_MAX];               /*!< bucket the item is linked to */
+    uint32_t seq;                                           /*!< insertion order, newer services are matched first */
 } mdns_srv_item_t;
 
 typedef struct mdns_out_question_s {
@@ -317,6 +468,7 @@ typedef struct mdns_host_item_t {
     const char *hostname;
     mdns_ip_addr_t *address_list;
     struct mdns_host_item_t *next;
+    struct mdns_host_item_t *hash_next;
 } mdns_host_item_t;
 
 typedef struct mdns_out_answer_s {
@@ -331,6 +483,18 @@ typedef struct mdns_out_answer_s {
     const char *custom_proto;
 } mdns_out_answer_t;
 
+/**
+ * @brief Record recently multicast (or scheduled to be) in response to a question
+ */
+typedef struct {
+    uint32_t sent_at;                       /*!< time the record is (or was) sent at, in ms */
+    uint16_t type;                          /*!< record type, 0 for unused entries */
+    mdns_if_t tcpip_if;                     /*!< interface the record was sent on */
+    mdns_ip_protocol_t ip_protocol;         /*!< pcb type V4/V6 */
+    const mdns_service_t *service;          /*!< service of the record */
+    const mdns_host_item_t *host;           /*!< host of the record */
+} mdns_multicast_record_t;
+
 typedef struct mdns_tx_packet_s {
     struct mdns_tx_packet_s *next;
     uint32_t send_at;
@@ -340,14 +504,27 @@ typedef struct mdns_tx_packet_s {
     uint16_t port;
     uint16_t flags;
     uint8_t distributed;
+    uint8_t dispatched;                     /*!< already sent together with a packet of another interface */
     mdns_out_question_t *questions;
     mdns_out_answer_t *answers;
     mdns_out_answer_t *servers;
     mdns_out_answer_t *additional;
-    bool queued;
     uint16_t id;
 } mdns_tx_packet_t;
 
+/**
+ * @brief Packet being serialized, with the position of the next question and record to write
+ */
+typedef struct {
+    void *buf;                              /*!< buffer of the networking layer, NULL if written to scratch memory */
+    uint8_t *packet;                        /*!< data of the packet, inside the buffer */
+    uint16_t index;                         /*!< length of the data written so far */
+    uint16_t counts[3];                     /*!< records written to the answer, authority and additional section */
+    uint8_t section;                        /*!< section of the next record */
+    mdns_out_question_t *question;          /*!< next question, questions are written to the first packet only */
+    mdns_out_answer_t *answer;              /*!< next record */
+} mdns_tx_encoder_t;
+
 typedef struct {
     mdns_pcb_state_t state;
     mdns_srv_item_t **probe_services;
@@ -377,6 +554,7 @@ typedef struct mdns_search_once_s {
     mdns_search_once_state_t state;
     uint32_t started_at;
     uint32_t sent_at;
+    uint32_t interval;                      /*!< time from the last query to the next one, doubled after each query */
     uint32_t timeout;
     mdns_query_notify_t notifier;
     SemaphoreHandle_t done_semaphore;
@@ -395,21 +573,63 @@ typedef struct mdns_browse_s {
 
     mdns_browse_state_t state;
     mdns_browse_notify_t notifier;
+    mdns_browse_delta_notify_t delta_notifier;
+    void *delta_arg;
+    bool sync_pending;                      /*!< ACTION_BROWSE_SYNC is queued for this browse */
+    uint32_t sent_at;
+    uint32_t interval;                      /*!< time from the last query to the next one, 0 until the first query */
 
     char *service;
     char *proto;
-    mdns_result_t *result;
+    mdns_result_t *result;                  /*!< results, allocated as mdns_browse_result_t */
 } mdns_browse_t;
 
-typedef struct mdns_browse_result_sync_t {
-    mdns_result_t *result;
-    struct mdns_browse_result_sync_t *next;
-} mdns_browse_result_sync_t;
+/**
+ * @brief Result of a running browse
+ *
+ * The result stays at the same address until it is removed, the changes are collected in it
+ * until the browse is synchronized.
+ */
+typedef struct {
+    mdns_result_t result;                   /*!< must be first, the results are freed as mdns_result_t */
+    uint8_t changed;                        /*!< mdns_browse_changed_t fields not notified yet */
+    bool added;                             /*!< the added event was delivered */
+} mdns_browse_result_t;
 
-typedef struct mdns_browse_sync {
-    mdns_browse_t *browse;
-    mdns_browse_result_sync_t *sync_result;
-} mdns_browse_sync_t;
+/**
+ * @brief Record received from another host
+ *
+ * The entry and its strings and TXT data are allocated in one block.
+ */
+typedef struct mdns_cache_entry_s {
+    struct mdns_cache_entry_s *next;
+    uint16_t type;
+    mdns_if_t tcpip_if;
+    mdns_ip_protocol_t ip_protocol;
+    uint32_t received_at;                   /*!< time the record was last received, in ms */
+    uint32_t ttl;                           /*!< TTL of the record, in seconds */
+    uint8_t refreshes;                      /*!< refresh queries sent since the record was received */
+    uint8_t jitter;                         /*!< random delay of the refresh queries, in per mille of the TTL */
+    bool used;                              /*!< answered a query since received, so it's refreshed before it expires */
+    char *instance;                         /*!< PTR target, SRV and TXT owner */
+    char *service;
+    char *proto;
+    char *hostname;                         /*!< SRV target, A and AAAA owner */
+    uint16_t port;
+    uint16_t txt_len;
+    uint8_t *txt;                           /*!< TXT data as received */
+    esp_ip_addr_t addr;
+} mdns_cache_entry_t;
+
+/**
+ * @brief Counters of the packet aggregation
+ */
+typedef struct {
+    uint32_t merged;                        /*!< responses merged into another response scheduled on the interface */
+    uint32_t continued;                     /*!< packets sent for records that did not fit into the previous packet */
+    uint32_t truncated;                     /*!< queries sent with the TC bit, their known answers continue in the next packet */
+    uint32_t fanned_out;                    /*!< packets copied from the encoding of the same records for another interface */
+} mdns_coalesce_stats_t;
 
 typedef struct mdns_server_s {
     struct {
@@ -418,12 +638,26 @@ typedef struct mdns_server_s {
     const char *hostname;
     const char *instance;
     mdns_srv_item_t *services;
-    QueueHandle_t action_queue;
+    mdns_srv_item_t *service_index[MDNS_SRV_INDEX_MAX][MDNS_LOOKUP_HASH_BUCKETS];
+    uint32_t service_seq;
+    QueueHandle_t lanes[MDNS_LANE_MAX];     /*!< pending actions, see mdns_lane_t */
+    SemaphoreHandle_t lanes_pending;        /*!< counts the actions in all lanes, the service thread waits on it */
+    uint8_t lane_passed[MDNS_LANE_MAX];     /*!< times the lane was passed over while its actions were waiting */
     SemaphoreHandle_t action_sema;
     mdns_tx_packet_t *tx_queue_head;
     mdns_search_once_t *search_once;
     esp_timer_handle_t timer_handle;
+    uint32_t timer_deadline;                /*!< time the one-shot timer is armed for */
+    bool timer_armed;
     mdns_browse_t *browse;
+    mdns_parse_arena_t parse_arena;
+    mdns_multicast_record_t multicast_records[MDNS_MULTICAST_RECORDS];
+    uint8_t multicast_records_next;         /*!< entry to be replaced next, when no entry of the record exists */
+    mdns_suppression_stats_t suppressed;
+    mdns_cache_entry_t *cache;
+    mdns_cache_stats_t cache_stats;
+    mdns_coalesce_stats_t coalesced;
+    mdns_stats_t stats;                     /*!< engine counters, see mdns_stats_get() */
 } mdns_server_t;
 
 typedef struct {
@@ -440,9 +674,6 @@ typedef struct {
         struct {
             mdns_search_once_t *search;
         } search_add;
-        struct {
-            mdns_tx_packet_t *packet;
-        } tx_handle;
         struct {
             mdns_rx_packet_t *packet;
         } rx_handle;
@@ -454,11 +685,32 @@ typedef struct {
             mdns_browse_t *browse;
         } browse_add;
         struct {
-            mdns_browse_sync_t *browse_sync;
+            mdns_browse_t *browse;
         } browse_sync;
     } data;
 } mdns_action_t;
 
+/**
+ * @brief  Action pool statistics
+ */
+typedef struct {
+    uint32_t slots;             /*!< Number of pre-allocated actions */
+    uint32_t in_use;            /*!< Pooled actions currently allocated */
+    uint32_t in_use_max;        /*!< High-water mark of pooled actions in use */
+    uint32_t allocated;         /*!< Actions taken from the pool */
+    uint32_t pool_exhausted;    /*!< Actions allocated while the pool was empty (heap fallback) */
+} mdns_action_pool_stats_t;
+
+/**
+ * @brief  Get action pool statistics
+ */
+void _mdns_get_action_pool_stats(mdns_action_pool_stats_t *stats);
+
+/**
+ * @brief  Count a failed memory allocation, may be called from any task
+ */
+void _mdns_stats_alloc_failed(void);
+
 /*
  * @brief  Convert mnds if to esp-netif handle
  *
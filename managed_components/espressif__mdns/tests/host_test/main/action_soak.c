@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <inttypes.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mdns.h"
+#include "mdns_private.h"
+#include "action_soak.h"
+#ifdef CONFIG_IDF_TARGET_LINUX
+#include <malloc.h>
+#else
+#include "esp_heap_caps.h"
+#endif
+
+#ifdef CONFIG_TEST_ACTION_SOAK
+
+static const char *TAG = "mdns-action-soak";
+
+typedef struct {
+    size_t free_bytes;          // free heap memory
+    size_t fragmented_bytes;    // free memory outside of the largest free block (top of heap on linux)
+    size_t free_blocks;
+} heap_state_t;
+
+static void get_heap_state(heap_state_t *state)
+{
+#ifdef CONFIG_IDF_TARGET_LINUX
+    struct mallinfo2 info = mallinfo2();
+    state->free_bytes = info.fordblks;
+    state->fragmented_bytes = info.fordblks - info.keepcost;
+    state->free_blocks = info.ordblks;
+#else
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_INTERNAL);
+    state->free_bytes = info.total_free_bytes;
+    state->fragmented_bytes = info.total_free_bytes - info.largest_free_block;
+    state->free_blocks = info.free_blocks;
+#endif
+}
+
+static void log_heap_state(const char *when, const heap_state_t *state)
+{
+    ESP_LOGI(TAG, "heap %s: %zu bytes free, %zu of them fragmented, %zu free blocks",
+             when, state->free_bytes, state->fragmented_bytes, state->free_blocks);
+}
+
+/**
+ * @brief  Retries posting an asynchronous action while the action queue is full
+ */
+static void post_retrying(esp_err_t (*post)(const char *, const mdns_ip_addr_t *), const char *hostname, const mdns_ip_addr_t *address)
+{
+    while (post(hostname, address) == ESP_ERR_NO_MEM) {
+        vTaskDelay(1);
+    }
+}
+
+static esp_err_t remove_host(const char *hostname, const mdns_ip_addr_t *address)
+{
+    return mdns_delegate_hostname_remove(hostname);
+}
+
+void mdns_test_action_soak(void)
+{
+    mdns_ip_addr_t address = { .addr = { .type = ESP_IPADDR_TYPE_V4, .u_addr.ip4.addr = ESP_IP4TOADDR(192, 168, 1, 60) }, .next = NULL };
+    mdns_ip_addr_t moved = { .addr = { .type = ESP_IPADDR_TYPE_V4, .u_addr.ip4.addr = ESP_IP4TOADDR(192, 168, 1, 61) }, .next = NULL };
+    mdns_action_pool_stats_t before, after;
+    heap_state_t heap_before, heap_after;
+
+    get_heap_state(&heap_before);
+    _mdns_get_action_pool_stats(&before);
+    int64_t start = esp_timer_get_time();
+    // every round posts three actions: a synchronous one, which waits for the asynchronous ones queued before it
+    for (int i = 0; i < CONFIG_TEST_ACTION_SOAK_ACTIONS / 3; i++) {
+        if (mdns_delegate_hostname_add("soak-host", &address) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to add delegated host in round %d", i);
+            break;
+        }
+        post_retrying(mdns_delegate_hostname_set_address, "soak-host", &moved);
+        post_retrying(remove_host, "soak-host", NULL);
+    }
+    mdns_delegate_hostname_add("soak-host", &address);
+    mdns_delegate_hostname_remove("soak-host");
+    vTaskDelay(pdMS_TO_TICKS(100));
+    int64_t elapsed = esp_timer_get_time() - start;
+    _mdns_get_action_pool_stats(&after);
+    get_heap_state(&heap_after);
+
+    uint32_t pooled = after.allocated - before.allocated;
+    uint32_t from_heap = after.pool_exhausted - before.pool_exhausted;
+    ESP_LOGI(TAG, "actions: %" PRIu32 " in %" PRIi64 " ms, pooled: %" PRIu32 ", heap fallback: %" PRIu32 ", pool slots: %" PRIu32 ", in use max: %" PRIu32,
+             pooled + from_heap, elapsed / 1000, pooled, from_heap, after.slots, after.in_use_max);
+    log_heap_state("before", &heap_before);
+    log_heap_state("after", &heap_after);
+}
+
+#endif // CONFIG_TEST_ACTION_SOAK
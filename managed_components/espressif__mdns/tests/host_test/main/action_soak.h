@@ -0,0 +1,12 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#pragma once
+
+/**
+ * @brief Posts a large number of actions to the mDNS task and reports
+ * action pool usage and heap fragmentation before and after
+ */
+void mdns_test_action_soak(void);
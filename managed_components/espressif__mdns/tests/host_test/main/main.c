@@ -10,6 +10,9 @@
 #include "esp_console.h"
 #include "mdns.h"
 #include "mdns_console.h"
+#include "rx_burst.h"
+#include "action_soak.h"
+#include "name_bench.h"
 
 static const char *TAG = "mdns-test";
 
@@ -116,6 +119,14 @@ static void mdns_test_app(esp_netif_t *interface)
     ESP_ERROR_CHECK(esp_console_start_repl(repl));
     xEventGroupWaitBits(s_exit_signal, 1, pdTRUE, pdFALSE, portMAX_DELAY);
     repl->del(repl);
+#elif defined(CONFIG_TEST_RX_BURST)
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    mdns_test_rx_burst(interface);
+#elif defined(CONFIG_TEST_ACTION_SOAK)
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    mdns_test_action_soak();
+#elif defined(CONFIG_TEST_NAME_BENCH)
+    mdns_test_name_bench();
 #else
     vTaskDelay(pdMS_TO_TICKS(10000));
     query_mdns_host("david-work");
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <string.h>
+#include <strings.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "name_bench.h"
+
+#ifdef CONFIG_TEST_NAME_BENCH
+// the corpus of `make names` in test_afl_fuzz_host, the functions of mdns.c it calls are injected by ../CMakeLists.txt
+#include "../../test_afl_fuzz_host/names_corpus.h"
+
+static const char *TAG = "mdns-name-bench";
+
+static int64_t run_parse(const uint8_t *(*parse)(const uint8_t *, const uint8_t *, mdns_name_t *, size_t), mdns_name_t *names)
+{
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < CONFIG_TEST_NAME_BENCH_ITERATIONS; i++) {
+        for (size_t n = 0; n < s_name_count; n++) {
+            if (!parse(s_names[n].packet, s_names[n].start, &names[n], MDNS_MAX_PACKET_SIZE)) {
+                abort();
+            }
+        }
+    }
+    return esp_timer_get_time() - start;
+}
+
+static int64_t run_match(const mdns_name_t *names, bool (*equal)(const char *, const char *), int *matches)
+{
+    *matches = 0;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < CONFIG_TEST_NAME_BENCH_ITERATIONS; i++) {
+        for (size_t n = 0; n < s_name_count; n++) {
+            *matches += names_match(&names[n], equal);
+        }
+    }
+    return esp_timer_get_time() - start;
+}
+
+void mdns_test_name_bench(void)
+{
+    static mdns_name_t names[NAMES_MAX], ref_names[NAMES_MAX];
+    int matches, ref_matches;
+
+    mdns_test_init_di();
+    names_build_corpus();
+    int64_t ref_parse = run_parse(ref_parse_fqdn, ref_names);
+    int64_t parse = run_parse(mdns_test_parse_fqdn, names);
+    for (size_t n = 0; n < s_name_count; n++) {
+        if (!names_equal(&names[n], &ref_names[n])) {
+            ESP_LOGE(TAG, "Name %zu is parsed differently", n);
+            return;
+        }
+    }
+    int64_t ref_match = run_match(names, ref_str_equal, &ref_matches);
+    int64_t match = run_match(names, mdns_test_str_equal, &matches);
+    if (matches != ref_matches) {
+        ESP_LOGE(TAG, "The names matched %d times instead of %d", matches, ref_matches);
+        return;
+    }
+
+    int64_t runs = (int64_t)CONFIG_TEST_NAME_BENCH_ITERATIONS * s_name_count;
+    ESP_LOGI(TAG, "%u names, %d matches, parse and match per name:", (unsigned)s_name_count, matches / CONFIG_TEST_NAME_BENCH_ITERATIONS);
+    ESP_LOGI(TAG, "copied labels, strcasecmp(): %" PRIi64 " ns, %" PRIi64 " ns", ref_parse * 1000 / runs, ref_match * 1000 / runs);
+    ESP_LOGI(TAG, "labels in place, by words:   %" PRIi64 " ns, %" PRIi64 " ns", parse * 1000 / runs, match * 1000 / runs);
+}
+
+#endif // CONFIG_TEST_NAME_BENCH
@@ -0,0 +1,12 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#pragma once
+
+/**
+ * @brief Parses and matches a corpus of Bonjour names, once with the parser of the
+ * responder and once with copied labels and strcasecmp(), and reports the time per name
+ */
+void mdns_test_name_bench(void);
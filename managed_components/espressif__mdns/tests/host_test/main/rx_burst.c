@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <string.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mdns.h"
+#include "mdns_networking.h"
+#include "rx_burst.h"
+
+#ifdef CONFIG_TEST_RX_BURST
+
+static const char *TAG = "mdns-rx-burst";
+
+/**
+ * Captured traffic of a busy segment, replayed in a loop:
+ * PTR question for _hap._tcp, DNS-SD enumeration and an A answer of a foreign host
+ */
+static const uint8_t s_ptr_hap[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, '_', 'h', 'a', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+    0x00, 0x0c, 0x00, 0x01
+};
+
+static const uint8_t s_ptr_services[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x09, '_', 's', 'e', 'r', 'v', 'i', 'c', 'e', 's', 0x07, '_', 'd', 'n', 's', '-', 's', 'd',
+    0x04, '_', 'u', 'd', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+    0x00, 0x0c, 0x00, 0x01
+};
+
+static const uint8_t s_a_answer[] = {
+    0x00, 0x00, 0x84, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x06, 'i', 'p', 'h', 'o', 'n', 'e', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+    0x00, 0x01, 0x80, 0x01, 0x00, 0x00, 0x00, 0x78, 0x00, 0x04, 192, 168, 1, 50
+};
+
+static const struct {
+    const uint8_t *data;
+    size_t len;
+} s_burst[] = {
+    { s_ptr_hap, sizeof(s_ptr_hap) },
+    { s_ptr_services, sizeof(s_ptr_services) },
+    { s_a_answer, sizeof(s_a_answer) },
+};
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int open_sender(esp_netif_t *interface)
+{
+    esp_netif_ip_info_t ip_info = { 0 };
+    if (esp_netif_get_ip_info(interface, &ip_info) != ESP_OK) {
+        return -1;
+    }
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+    struct in_addr iface = { .s_addr = ip_info.ip.addr };
+    unsigned char loop = 1;
+    if (setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) < 0 ||
+            setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+void mdns_test_rx_burst(esp_netif_t *interface)
+{
+    const int bursts = CONFIG_TEST_RX_BURST_PACKETS / CONFIG_TEST_RX_BURST_SIZE;
+    uint32_t *latency_us = calloc(bursts, sizeof(uint32_t));
+    int sock = open_sender(interface);
+    if (sock < 0 || !latency_us) {
+        ESP_LOGE(TAG, "Failed to prepare the sender");
+        free(latency_us);
+        return;
+    }
+    struct sockaddr_in dest = {
+        .sin_family = AF_INET,
+        .sin_port = htons(5353),
+        .sin_addr.s_addr = inet_addr("224.0.0.251"),
+    };
+
+    mdns_rx_slab_stats_t before, after;
+    _mdns_get_rx_slab_stats(&before);
+    uint32_t expected = before.rx_packets;
+    int64_t start = esp_timer_get_time();
+    clock_t cpu_start = clock();
+    int completed = 0;
+    for (int b = 0; b < bursts; b++) {
+        int64_t burst_start = esp_timer_get_time();
+        for (int i = 0; i < CONFIG_TEST_RX_BURST_SIZE; i++) {
+            const int p = (b * CONFIG_TEST_RX_BURST_SIZE + i) % (sizeof(s_burst) / sizeof(s_burst[0]));
+            sendto(sock, s_burst[p].data, s_burst[p].len, 0, (struct sockaddr *)&dest, sizeof(dest));
+        }
+        expected += CONFIG_TEST_RX_BURST_SIZE;
+        // wait until the receive task has picked up the whole burst (or give up after 1s on lost datagrams)
+        do {
+            _mdns_get_rx_slab_stats(&after);
+            if ((int32_t)(after.rx_packets - expected) >= 0) {
+                break;
+            }
+            vTaskDelay(1);
+        } while (esp_timer_get_time() - burst_start < 1000000);
+        latency_us[completed++] = (uint32_t)(esp_timer_get_time() - burst_start);
+        expected = after.rx_packets;
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    double cpu_s = (double)(clock() - cpu_start) / CLOCKS_PER_SEC;
+    _mdns_get_rx_slab_stats(&after);
+    close(sock);
+
+    qsort(latency_us, completed, sizeof(uint32_t), cmp_u32);
+    uint32_t received = after.rx_packets - before.rx_packets;
+    uint32_t from_heap = after.slab_exhausted - before.slab_exhausted;
+    uint32_t batches = after.rx_batches - before.rx_batches;
+    ESP_LOGI(TAG, "slab slots: %" PRIu32 ", packets sent: %d, received: %" PRIu32 ", dropped: %" PRIu32,
+             after.slots, bursts * CONFIG_TEST_RX_BURST_SIZE, received, after.dropped - before.dropped);
+    ESP_LOGI(TAG, "zero-copy: %" PRIu32 ", heap fallback: %" PRIu32 " (%" PRIu32 " allocations), slots in use max: %" PRIu32,
+             received - from_heap, from_heap, 3 * from_heap, after.in_use_max);
+    ESP_LOGI(TAG, "burst of %d latency p50: %" PRIu32 " us, p99: %" PRIu32 " us, total: %" PRIi64 " us",
+             CONFIG_TEST_RX_BURST_SIZE, latency_us[completed / 2], latency_us[(completed * 99) / 100], elapsed);
+    ESP_LOGI(TAG, "rx actions: %" PRIu32 " (%.2f packets each), throughput: %.0f packets/s, %.0f packets/CPU-second",
+             batches, batches ? (double)received / batches : 0.0, received * 1e6 / (elapsed ? elapsed : 1),
+             cpu_s > 0 ? received / cpu_s : 0.0);
+    free(latency_us);
+}
+
+#endif // CONFIG_TEST_RX_BURST
@@ -0,0 +1,14 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#pragma once
+
+#include "esp_netif.h"
+
+/**
+ * @brief Replays a burst of captured mDNS traffic to the interface and reports
+ * receive path allocations and latency
+ */
+void mdns_test_rx_burst(esp_netif_t *interface);
@@ -0,0 +1,292 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test_common.h"
+
+//
+// Microbenchmark of the responder: time from a parsed query to the dispatched answer
+// with a growing number of registered services and delegated hosts,
+// and the time to assemble an announcement of all the services;
+// also the time to parse a query with known answers of several services, which suppress the response.
+// The "uncached" runs encode the parts of the records kept per service (mdns_service_wire_t) for every response,
+// as if the names of the services had just changed
+
+#define BENCH_ITERATIONS    20000
+#define BENCH_ROUNDS        5
+#define BENCH_ANNOUNCE_ITERATIONS   2000
+#define BENCH_ANNOUNCE_SERVICES     64
+#define BENCH_KNOWN_ANSWERS         8
+
+static size_t bench_append_label(uint8_t *out, const char *label)
+{
+    size_t len = strlen(label);
+    out[0] = (uint8_t)len;
+    memcpy(out + 1, label, len);
+    return len + 1;
+}
+
+/**
+ * @brief  Builds a single question query for [instance.]service.proto.local or host.local
+ */
+static size_t bench_build_query(uint8_t *out, const char *instance, const char *service, const char *proto, uint16_t type)
+{
+    static const uint8_t header[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    size_t len = sizeof(header);
+    memcpy(out, header, len);
+    if (instance) {
+        len += bench_append_label(out + len, instance);
+    }
+    if (service) {
+        len += bench_append_label(out + len, service);
+        len += bench_append_label(out + len, proto);
+    }
+    len += bench_append_label(out + len, "local");
+    out[len++] = 0;
+    out[len++] = type >> 8;
+    out[len++] = type & 0xFF;
+    out[len++] = 0x00;
+    out[len++] = 0x01;
+    return len;
+}
+
+static size_t bench_append_service_name(uint8_t *out, const char *instance, int service)
+{
+    char label[16];
+    size_t len = 0;
+    if (instance) {
+        len += bench_append_label(out + len, instance);
+    }
+    snprintf(label, sizeof(label), "_svc%03d", service);
+    len += bench_append_label(out + len, label);
+    len += bench_append_label(out + len, "_tcp");
+    len += bench_append_label(out + len, "local");
+    out[len++] = 0;
+    return len;
+}
+
+/**
+ * @brief  Builds a query for the PTR records of the first services, with all of them as known answers
+ */
+static size_t bench_build_known_answer_query(uint8_t *out, int count)
+{
+    static const uint8_t ptr_question[] = { 0x00, 0x0C, 0x00, 0x01 };
+    static const uint8_t ptr_answer[] = { 0x00, 0x0C, 0x00, 0x01, 0x00, 0x00, 0x11, 0x94 };
+    char instance[16];
+    size_t len = MDNS_HEAD_LEN;
+    memset(out, 0, MDNS_HEAD_LEN);
+    out[MDNS_HEAD_QUESTIONS_OFFSET + 1] = count;
+    out[MDNS_HEAD_ANSWERS_OFFSET + 1] = count;
+    for (int i = 0; i < count; i++) {
+        len += bench_append_service_name(out + len, NULL, i);
+        memcpy(out + len, ptr_question, sizeof(ptr_question));
+        len += sizeof(ptr_question);
+    }
+    for (int i = 0; i < count; i++) {
+        len += bench_append_service_name(out + len, NULL, i);
+        memcpy(out + len, ptr_answer, sizeof(ptr_answer));
+        len += sizeof(ptr_answer);
+        snprintf(instance, sizeof(instance), "bench-%03d", i);
+        size_t data_len = bench_append_service_name(out + len + 2, instance, i);
+        out[len++] = data_len >> 8;
+        out[len++] = data_len & 0xFF;
+        len += data_len;
+    }
+    return len;
+}
+
+static int bench_cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+/**
+ * @brief  Runs the query repeatedly, reports the time per query (parsing and answering)
+ *         and per response (assembling and sending the answer packet)
+ */
+static void bench_query(const char *name, const uint8_t *query, size_t len, uint32_t *samples, bool uncached)
+{
+    // the fastest of a few rounds, to filter out the noise of the host machine
+    uint64_t best_total = UINT64_MAX, best_response = UINT64_MAX;
+    uint32_t best_p99 = 0;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t total = 0, response = 0;
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            // past the interval the answers are multicast at most once in
+            g_tick += MDNS_MULTICAST_INTERVAL_MS;
+            uint32_t start = bench_now_ns();
+            test_receive(query, len);
+            if (uncached) {
+                mdns_test_names_changed();
+            }
+            uint32_t parsed = bench_now_ns();
+            test_send(true);
+            samples[i] = bench_now_ns() - start;
+            total += samples[i];
+            response += start + samples[i] - parsed;
+        }
+        if (response < best_response) {
+            best_response = response;
+        }
+        if (total < best_total) {
+            qsort(samples, BENCH_ITERATIONS, sizeof(uint32_t), bench_cmp_u32);
+            best_total = total;
+            best_p99 = samples[(BENCH_ITERATIONS * 99) / 100];
+        }
+    }
+    printf("  %-14s %6u ns/query (p99: %6u ns), %6u ns/response\n", name, (unsigned)(best_total / BENCH_ITERATIONS),
+           (unsigned)best_p99, (unsigned)(best_response / BENCH_ITERATIONS));
+}
+
+/**
+ * @brief  Parses the packet repeatedly, for packets which are not answered
+ */
+static void bench_parse(const char *name, const uint8_t *packet, size_t len)
+{
+    uint64_t best_total = UINT64_MAX;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t total = 0;
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            uint32_t start = bench_now_ns();
+            test_receive(packet, len);
+            total += bench_now_ns() - start;
+            test_send(true);
+        }
+        if (total < best_total) {
+            best_total = total;
+        }
+    }
+    printf("  %-14s %6u ns/packet\n", name, (unsigned)(best_total / BENCH_ITERATIONS));
+}
+
+/**
+ * @brief  Assembles an announcement of the registered services (with the addresses of their hosts) repeatedly
+ *
+ * Only the beginning fits into a packet, the rest of the records are tried and dropped.
+ */
+static void bench_announce(void)
+{
+    void *services[BENCH_ANNOUNCE_SERVICES];
+    int len = 0;
+    for (mdns_srv_item_t *s = _mdns_server->services; s && len < BENCH_ANNOUNCE_SERVICES; s = s->next) {
+        services[len++] = s;
+    }
+    void *packet = mdns_test_create_announce_packet((mdns_if_t)0, MDNS_IP_PROTOCOL_V4, services, len, true);
+    if (!packet) {
+        abort();
+    }
+    uint64_t best_total = UINT64_MAX;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t total = 0;
+        for (int i = 0; i < BENCH_ANNOUNCE_ITERATIONS; i++) {
+            uint32_t start = bench_now_ns();
+            mdns_test_dispatch_tx_packet(packet);
+            total += bench_now_ns() - start;
+        }
+        if (total < best_total) {
+            best_total = total;
+        }
+    }
+    printf("  %-14s %6u ns/packet (%d services)\n", "announce", (unsigned)(best_total / BENCH_ANNOUNCE_ITERATIONS), len);
+    mdns_test_free_tx_packet(packet);
+}
+
+static int bench_populate(int count)
+{
+    // TXT items of a typical HomeKit accessory
+    mdns_txt_item_t txt[] = {
+        {"c#", "2"}, {"ff", "0"}, {"id", "DE:AD:BE:EF:00:32"}, {"md", "bench"},
+        {"pv", "1.1"}, {"s#", "1"}, {"sf", "1"}, {"ci", "2"},
+    };
+    char service[16], instance[16], host[16];
+    mdns_ip_addr_t addr = { .addr = { .type = ESP_IPADDR_TYPE_V4 } };
+    addr.addr.u_addr.ip4.addr = 0x0101a8c0;
+    for (int i = 0; i < count; i++) {
+        snprintf(service, sizeof(service), "_svc%03d", i);
+        snprintf(instance, sizeof(instance), "bench-%03d", i);
+        snprintf(host, sizeof(host), "host%03d", i);
+        if (mdns_delegate_hostname_add(host, &addr)) {
+            return ESP_FAIL;
+        }
+        test_execute_last_action();
+        if (mdns_service_add_for_host(instance, service, "_tcp", host, 80 + i, txt, sizeof(txt) / sizeof(txt[0]))) {
+            return ESP_FAIL;
+        }
+        // let the probing and announcing of the new service run to completion
+        test_send(true);
+    }
+    return ESP_OK;
+}
+
+static void bench_depopulate(int count)
+{
+    char host[16];
+    mdns_service_remove_all();
+    for (int i = 0; i < count; i++) {
+        snprintf(host, sizeof(host), "host%03d", i);
+        mdns_delegate_hostname_remove(host);
+        test_execute_last_action();
+    }
+    test_send(true);
+}
+
+int main(int argc, char **argv)
+{
+    static const int counts[] = { 8, 64, 256 };
+    uint8_t ptr_query[MDNS_MAX_PACKET_SIZE], srv_query[MDNS_MAX_PACKET_SIZE], txt_query[MDNS_MAX_PACKET_SIZE];
+    uint8_t a_query[MDNS_MAX_PACKET_SIZE], known_query[MDNS_MAX_PACKET_SIZE];
+    // the first registered service and host are the last ones in the lists
+    size_t ptr_len = bench_build_query(ptr_query, NULL, "_svc000", "_tcp", MDNS_TYPE_PTR);
+    size_t srv_len = bench_build_query(srv_query, "bench-000", "_svc000", "_tcp", MDNS_TYPE_SRV);
+    size_t txt_len = bench_build_query(txt_query, "bench-000", "_svc000", "_tcp", MDNS_TYPE_TXT);
+    size_t a_len = bench_build_query(a_query, "host000", NULL, NULL, MDNS_TYPE_A);
+    size_t known_len = bench_build_known_answer_query(known_query, BENCH_KNOWN_ANSWERS);
+    uint32_t *samples = malloc(BENCH_ITERATIONS * sizeof(uint32_t));
+
+    if (!samples) {
+        abort();
+    }
+    test_start("bench");
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        if (counts[c] > MDNS_MAX_SERVICES) {
+            printf("%d services: skipped, CONFIG_MDNS_MAX_SERVICES is %d\n", counts[c], MDNS_MAX_SERVICES);
+            continue;
+        }
+        if (bench_populate(counts[c])) {
+            abort();
+        }
+        printf("%d services, %d delegated hosts, %d lookup buckets:\n", counts[c], counts[c], MDNS_LOOKUP_HASH_BUCKETS);
+        bench_query("PTR", ptr_query, ptr_len, samples, false);
+        bench_query("PTR uncached", ptr_query, ptr_len, samples, true);
+        bench_query("SRV", srv_query, srv_len, samples, false);
+        bench_query("SRV uncached", srv_query, srv_len, samples, true);
+        bench_query("TXT", txt_query, txt_len, samples, false);
+        bench_query("TXT uncached", txt_query, txt_len, samples, true);
+        bench_query("A (delegated)", a_query, a_len, samples, false);
+        bench_parse("known answers", known_query, known_len);
+        bench_announce();
+        bench_depopulate(counts[c]);
+    }
+
+    free(samples);
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
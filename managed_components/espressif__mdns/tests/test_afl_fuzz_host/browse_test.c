@@ -0,0 +1,279 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "test_common.h"
+
+//
+// Browse test: a network of AirPlay devices announces itself to a delta browse, then keeps refreshing
+// its records. Only the announcements and the real changes must be notified, and the refreshes
+// must not allocate any memory. A browse with the full result notifier runs next to it.
+
+#define BROWSE_DEVICES          200
+#define BROWSE_HAP_DEVICES      10
+#define BROWSE_REFRESHES        5
+#define BROWSE_TTL              120
+
+#if defined(CONFIG_LWIP_IPV4) || defined(CONFIG_LWIP_IPV6)
+#define BROWSE_ADDR_CHANGED     MDNS_BROWSE_CHANGED_ADDR
+#else
+#define BROWSE_ADDR_CHANGED     0   // addresses are not parsed without IPv4 or IPv6
+#endif
+
+//
+// Allocation counting, all allocations are routed here by the linker (-Wl,--wrap=malloc,...)
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+char *__real_strdup(const char *s);
+char *__real_strndup(const char *s, size_t n);
+
+static size_t s_allocs;
+
+void *__wrap_malloc(size_t size)
+{
+    s_allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    s_allocs++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    s_allocs++;
+    return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(const char *s)
+{
+    s_allocs++;
+    return __real_strdup(s);
+}
+
+char *__wrap_strndup(const char *s, size_t n)
+{
+    s_allocs++;
+    return __real_strndup(s, n);
+}
+
+typedef struct {
+    const mdns_result_t *handle;    // result given at the added event
+    uint32_t changed;               // fields of the last event
+    mdns_browse_event_t event;
+    int events;
+} browse_device_t;
+
+static browse_device_t s_devices[BROWSE_DEVICES];
+static int s_events[MDNS_BROWSE_REMOVED + 1];
+static int s_bad_events;
+static int s_full_notifications;
+
+static void browse_delta_cb(mdns_browse_event_t event, const mdns_result_t *result, uint32_t changed, void *arg)
+{
+    int i;
+    if ((uintptr_t)arg != 0xB0 || !result->instance_name || sscanf(result->instance_name, "Speaker %d", &i) != 1
+            || i < 0 || i >= BROWSE_DEVICES) {
+        s_bad_events++;
+        return;
+    }
+    browse_device_t *d = &s_devices[i];
+    if (event == MDNS_BROWSE_ADDED) {
+        if (d->handle) {
+            s_bad_events++;
+        }
+        d->handle = result;
+    } else if (d->handle != result) {
+        s_bad_events++;
+    }
+    d->event = event;
+    d->changed = changed;
+    d->events++;
+    s_events[event]++;
+}
+
+static void browse_full_cb(mdns_result_t *result)
+{
+    s_full_notifications++;
+}
+
+static uint8_t *browse_put_name(uint8_t *p, const char *instance, const char *service, const char *proto, const char *host)
+{
+    const char *labels[] = { instance, service, proto, host, "local" };
+    for (size_t i = 0; i < sizeof(labels) / sizeof(labels[0]); i++) {
+        if (labels[i]) {
+            *p++ = strlen(labels[i]);
+            memcpy(p, labels[i], strlen(labels[i]));
+            p += strlen(labels[i]);
+        }
+    }
+    *p++ = 0;
+    return p;
+}
+
+static uint8_t *browse_put_record(uint8_t *p, uint16_t type, uint32_t ttl, uint16_t len)
+{
+    const uint8_t rr[] = { type >> 8, type & 0xFF, 0x80, 0x01, ttl >> 24, (ttl >> 16) & 0xFF, (ttl >> 8) & 0xFF, ttl & 0xFF, len >> 8, len & 0xFF };
+    memcpy(p, rr, sizeof(rr));
+    return p + sizeof(rr);
+}
+
+/**
+ * @brief  Receives the announcement of a device (SRV, TXT and address records) and synchronizes the browses
+ */
+static void browse_receive_announcement(const char *service, const char *instance_fmt, int i, uint16_t port, int version, uint32_t ttl)
+{
+    uint8_t packet[512];
+    char instance[32], host[32], txt[128];
+    uint8_t *p = packet + 12, *rdlen;
+    uint16_t answers = 2;
+
+    snprintf(instance, sizeof(instance), instance_fmt, i);
+    snprintf(host, sizeof(host), "%s-%d", service + 1, i);
+    memset(packet, 0, 12);
+    packet[2] = 0x84;
+
+    p = browse_put_name(p, instance, service, "_tcp", NULL);
+    p = browse_put_record(p, MDNS_TYPE_SRV, ttl, 0);
+    rdlen = p;
+    *p++ = 0; *p++ = 0; *p++ = 0; *p++ = 0;
+    *p++ = port >> 8; *p++ = port & 0xFF;
+    p = browse_put_name(p, NULL, NULL, NULL, host);
+    rdlen[-1] = p - rdlen;
+
+    p = browse_put_name(p, instance, service, "_tcp", NULL);
+    int txt_len = snprintf(txt, sizeof(txt), "%cmodel=AudioAccessory5,1%cfeatures=0x4A7FDFD5,0x3C155FDE%csrcvers=%d",
+                           23, 30, 9 + (version > 9) + (version > 99), version);
+    p = browse_put_record(p, MDNS_TYPE_TXT, ttl, txt_len);
+    memcpy(p, txt, txt_len);
+    p += txt_len;
+#ifdef CONFIG_LWIP_IPV4
+    p = browse_put_name(p, NULL, NULL, NULL, host);
+    p = browse_put_record(p, MDNS_TYPE_A, ttl, 4);
+    *p++ = 192; *p++ = 168; *p++ = i >> 8; *p++ = i & 0xFF;
+    answers++;
+#endif
+#ifdef CONFIG_LWIP_IPV6
+    p = browse_put_name(p, NULL, NULL, NULL, host);
+    p = browse_put_record(p, MDNS_TYPE_AAAA, ttl, 16);
+    memset(p, 0, 16);
+    p[0] = 0xFE; p[1] = 0x80; p[14] = i >> 8; p[15] = i & 0xFF;
+    p += 16;
+    answers++;
+#endif
+    packet[7] = answers;
+
+    // clear the slot of the mocked queue, a sync is only handled if the packet queued one
+    mdns_action_t *a = NULL;
+    xQueueSend(_mdns_server->lanes[MDNS_LANE_CONTROL], &a, 0);
+    test_receive(packet, p - packet);
+    GetLastItem(&a);
+    if (a) {
+        if (a->type != ACTION_BROWSE_SYNC) {
+            printf("Unexpected action %d\n", a->type);
+            abort();
+        }
+        mdns_test_execute_action(a);
+    }
+}
+
+static void browse_announce_all(int version, uint32_t ttl)
+{
+    for (int i = 0; i < BROWSE_DEVICES; i++) {
+        browse_receive_announcement("_airplay", "Speaker %d", i, 7000, version, ttl);
+    }
+    for (int i = 0; i < BROWSE_HAP_DEVICES; i++) {
+        browse_receive_announcement("_hap", "Bridge %d", i, 8080, version, ttl);
+    }
+}
+
+static void browse_expect(const char *step, int added, int updated, int removed, int full)
+{
+    printf("%-24s %4d added, %4d updated, %4d removed, %4d full notifications\n", step,
+           s_events[MDNS_BROWSE_ADDED], s_events[MDNS_BROWSE_UPDATED], s_events[MDNS_BROWSE_REMOVED], s_full_notifications);
+    if (s_events[MDNS_BROWSE_ADDED] != added || s_events[MDNS_BROWSE_UPDATED] != updated
+            || s_events[MDNS_BROWSE_REMOVED] != removed || s_full_notifications != full || s_bad_events) {
+        printf("Unexpected browse events\n");
+        abort();
+    }
+    memset(s_events, 0, sizeof(s_events));
+    s_full_notifications = 0;
+}
+
+int main(int argc, char **argv)
+{
+    test_start("browse");
+
+    if (!mdns_browse_delta_new("_airplay", "_tcp", browse_delta_cb, (void *)0xB0)) {
+        abort();
+    }
+    test_execute_last_action();
+    if (!mdns_browse_new("_hap", "_tcp", browse_full_cb)) {
+        abort();
+    }
+    test_execute_last_action();
+
+    // every device is added once, with all its records
+    browse_announce_all(1, BROWSE_TTL);
+    browse_expect("announcements", BROWSE_DEVICES, 0, 0, BROWSE_HAP_DEVICES);
+    for (int i = 0; i < BROWSE_DEVICES; i++) {
+        if (s_devices[i].changed != (MDNS_BROWSE_CHANGED_SRV | MDNS_BROWSE_CHANGED_TXT | MDNS_BROWSE_CHANGED_TTL | BROWSE_ADDR_CHANGED)) {
+            printf("Speaker %d added with fields 0x%" PRIx32 "\n", i, s_devices[i].changed);
+            abort();
+        }
+    }
+
+    // refreshes of the same records are not notified and do not allocate
+    size_t allocs = s_allocs;
+    for (int r = 0; r < BROWSE_REFRESHES; r++) {
+        browse_announce_all(1, BROWSE_TTL);
+    }
+    allocs = s_allocs - allocs;
+    browse_expect("refreshes", 0, 0, 0, 0);
+    printf("%-24s %.2f allocations per refreshed device\n", "", (double)allocs / (BROWSE_REFRESHES * (BROWSE_DEVICES + BROWSE_HAP_DEVICES)));
+    if (allocs) {
+        abort();
+    }
+
+    // a new firmware version changes one TXT item, a moved device changes its port
+    browse_receive_announcement("_airplay", "Speaker %d", 7, 7000, 2, BROWSE_TTL);
+    browse_receive_announcement("_airplay", "Speaker %d", 9, 7001, 1, BROWSE_TTL);
+    browse_receive_announcement("_hap", "Bridge %d", 3, 8080, 2, BROWSE_TTL);
+    browse_expect("changes", 0, 2, 0, 1);
+    if (s_devices[7].changed != MDNS_BROWSE_CHANGED_TXT || s_devices[9].changed != MDNS_BROWSE_CHANGED_SRV) {
+        printf("Changed fields 0x%" PRIx32 " and 0x%" PRIx32 "\n", s_devices[7].changed, s_devices[9].changed);
+        abort();
+    }
+
+    // goodbye packets remove the devices
+    browse_receive_announcement("_airplay", "Speaker %d", 11, 7000, 1, 0);
+    browse_receive_announcement("_airplay", "Speaker %d", 12, 7000, 1, 0);
+    browse_expect("goodbyes", 0, 0, 2, 0);
+    if (s_devices[11].event != MDNS_BROWSE_REMOVED || s_devices[12].event != MDNS_BROWSE_REMOVED) {
+        abort();
+    }
+
+    if (mdns_browse_delete("_airplay", "_tcp")) {
+        abort();
+    }
+    test_execute_last_action();
+    if (mdns_browse_delete("_hap", "_tcp")) {
+        abort();
+    }
+    test_execute_last_action();
+    printf("Browse test passed\n");
+
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
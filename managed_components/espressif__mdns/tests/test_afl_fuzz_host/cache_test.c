@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+
+#include "test_common.h"
+
+//
+// Record cache test: a printer announces itself while a search for printers runs. The search takes its
+// whole timeout, the same query repeated afterwards is answered from the cache. Without the responses
+// to the refresh queries the records expire and the query goes to the network again.
+
+#define CACHE_QUERY_TIMEOUT_MS  3000
+#define CACHE_WARM_QUERIES      1000
+#define CACHE_SRV_TTL           120
+
+#ifdef CONFIG_LWIP_IPV4
+#define CACHE_A_RECORDS         1
+#else
+#define CACHE_A_RECORDS         0   // A records are not parsed without IPv4
+#endif
+
+static uint32_t s_search_done_at;
+
+/**
+ * @brief  Receives the announcement of Printer._ipp._tcp.local (PTR, SRV, TXT and A records)
+ */
+static void cache_receive_announcement(void)
+{
+    static const uint8_t response[] = {
+        0x00, 0x00, 0x84, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
+        // _ipp._tcp.local PTR Printer._ipp._tcp.local
+        0x04, '_', 'i', 'p', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+        0x00, 0x0C, 0x00, 0x01, 0x00, 0x00, 0x11, 0x94, 0x00, 0x0A,
+        0x07, 'P', 'r', 'i', 'n', 't', 'e', 'r', 0xC0, 0x0C,
+        // Printer._ipp._tcp.local SRV 0 0 631 printer.local
+        0xC0, 0x27, 0x00, 0x21, 0x80, 0x01, 0x00, 0x00, 0x00, CACHE_SRV_TTL, 0x00, 0x10,
+        0x00, 0x00, 0x00, 0x00, 0x02, 0x77, 0x07, 'p', 'r', 'i', 'n', 't', 'e', 'r', 0xC0, 0x16,
+        // Printer._ipp._tcp.local TXT "rp=ipp"
+        0xC0, 0x27, 0x00, 0x10, 0x80, 0x01, 0x00, 0x00, 0x11, 0x94, 0x00, 0x07,
+        0x06, 'r', 'p', '=', 'i', 'p', 'p',
+        // printer.local A 192.168.1.50
+        0xC0, 0x43, 0x00, 0x01, 0x80, 0x01, 0x00, 0x00, 0x00, CACHE_SRV_TTL, 0x00, 0x04,
+        0xC0, 0xA8, 0x01, 0x32
+    };
+    g_packet.src.u_addr.ip4.addr = 0x3201a8c0;
+    test_receive(response, sizeof(response));
+}
+
+static void cache_search_done(mdns_search_once_t *search)
+{
+    s_search_done_at = g_tick;
+}
+
+static bool cache_result_is_printer(mdns_result_t *r)
+{
+    return r && !r->next && r->instance_name && !strcmp(r->instance_name, "Printer")
+           && r->hostname && !strcmp(r->hostname, "printer") && r->port == 631
+           && r->txt_count == 1 && !strcmp(r->txt[0].key, "rp") && r->txt_value_len[0] == 3
+           && (!CACHE_A_RECORDS || (r->addr && r->addr->addr.u_addr.ip4.addr == 0x3201a8c0));
+}
+
+static uint64_t cache_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    mdns_result_t *results = NULL;
+    uint8_t num_results = 0;
+    mdns_cache_stats_t stats;
+
+    test_start("cache");
+    test_wait(10000);
+
+    // cold: the query waits for its timeout, collecting the answers
+    mdns_search_once_t *search = mdns_query_async_new(NULL, "_ipp", "_tcp", MDNS_TYPE_PTR, CACHE_QUERY_TIMEOUT_MS, 0, cache_search_done);
+    if (!search) {
+        abort();
+    }
+    uint32_t started_at = g_tick;
+    test_execute_last_action();
+    test_wait(20);
+    cache_receive_announcement();
+    test_wait(2 * CACHE_QUERY_TIMEOUT_MS);
+    if (!s_search_done_at || !mdns_query_async_get_results(search, 0, &results, &num_results) || !cache_result_is_printer(results)) {
+        printf("Search did not find the printer\n");
+        abort();
+    }
+    uint32_t cold_ms = s_search_done_at - started_at;
+    mdns_query_results_free(results);
+    mdns_query_async_delete(search);
+
+    // warm: the same query is answered from the cache
+    uint64_t start = cache_time_ns();
+    for (int i = 0; i < CACHE_WARM_QUERIES; i++) {
+        if (mdns_query_ptr("_ipp", "_tcp", CACHE_QUERY_TIMEOUT_MS, 20, &results) || !cache_result_is_printer(results)) {
+            printf("Query was not answered from the cache\n");
+            abort();
+        }
+        mdns_query_results_free(results);
+    }
+    double warm_us = (cache_time_ns() - start) / 1000.0 / CACHE_WARM_QUERIES;
+    if (mdns_query_srv("Printer", "_ipp", "_tcp", CACHE_QUERY_TIMEOUT_MS, &results) || !results || results->port != 631) {
+        printf("SRV query was not answered from the cache\n");
+        abort();
+    }
+    mdns_query_results_free(results);
+#ifdef CONFIG_LWIP_IPV4
+    if (mdns_query("printer", NULL, NULL, MDNS_TYPE_A, CACHE_QUERY_TIMEOUT_MS, 1, &results) || !results || !results->addr) {
+        printf("A query was not answered from the cache\n");
+        abort();
+    }
+    mdns_query_results_free(results);
+#endif
+
+    if (mdns_cache_stats_get(&stats)) {
+        abort();
+    }
+    printf("PTR query latency: %" PRIu32 " ms cold, %.2f us warm\n", cold_ms, warm_us);
+    printf("Cache: %" PRIu32 " entries, %" PRIu32 " hits, %" PRIu32 " misses, hit rate %.1f %%\n",
+           stats.entries, stats.hits, stats.misses, 100.0 * stats.hits / (stats.hits + stats.misses));
+    if (stats.entries != 3 + CACHE_A_RECORDS || stats.hits != CACHE_WARM_QUERIES + 1 + CACHE_A_RECORDS || cold_ms < CACHE_QUERY_TIMEOUT_MS) {
+        printf("Unexpected cache statistics\n");
+        abort();
+    }
+
+    // nobody answers the refresh queries, the SRV and A records expire
+    uint32_t sent = g_tx_packets;
+    test_wait(CACHE_SRV_TTL * 1000 + 1000);
+    if (mdns_cache_stats_get(&stats)) {
+        abort();
+    }
+    printf("After %d s: %" PRIu32 " refresh queries (%" PRIu32 " packets), %" PRIu32 " records expired\n",
+           CACHE_SRV_TTL, stats.refresh_queries, g_tx_packets - sent, stats.expired);
+    if (stats.refresh_queries != (1 + CACHE_A_RECORDS) * MDNS_CACHE_REFRESH_QUERIES
+            || stats.expired != 1 + CACHE_A_RECORDS || stats.entries != 2) {
+        printf("Records were not refreshed or did not expire\n");
+        abort();
+    }
+    // the service thread would run this search, the mocked semaphore does not wait for it
+    mdns_query_ptr("_ipp", "_tcp", CACHE_QUERY_TIMEOUT_MS, 20, &results);
+    mdns_query_results_free(results);
+    if (mdns_cache_stats_get(&stats) || stats.misses != 1) {
+        printf("Query for expired records was answered from the cache\n");
+        abort();
+    }
+    printf("Cache test passed\n");
+
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "test_common.h"
+
+//
+// TX aggregation test: a bridge exposing many accessories announces them all at once, which takes
+// more than one packet, then its controllers resolve every accessory. The answers to the resolve
+// queries are compared with the responses sent one by one, as they were before being merged.
+// With IPv4 the bridge also browses for other bridges, listing more known answers than fit a query.
+
+#define COALESCE_SERVICES       24
+#define COALESCE_SPACING_MS     4
+#define COALESCE_OTHERS         80
+#define COALESCE_PCBS           (MDNS_MAX_INTERFACES * MDNS_IP_PROTOCOL_MAX)
+
+static uint32_t s_records;          // records of the responses sent
+static uint32_t s_truncated;        // queries sent with the TC bit
+static uint32_t s_continued;        // queries without questions, continuing the known answers
+static bool s_oversized;
+
+size_t mock_udp_pcb_send(void *buf, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    bool response = p[MDNS_HEAD_FLAGS_OFFSET] & (MDNS_FLAGS_QUERY_REPSONSE >> 8);
+    for (int i = MDNS_HEAD_ANSWERS_OFFSET; i <= MDNS_HEAD_ADDITIONAL_OFFSET && response; i += 2) {
+        s_records += (p[i] << 8) | p[i + 1];
+    }
+    if (!response && !p[MDNS_HEAD_QUESTIONS_OFFSET + 1]) {
+        s_continued++;
+    }
+    if (p[MDNS_HEAD_FLAGS_OFFSET] & (MDNS_FLAGS_TRUNCATED >> 8)) {
+        s_truncated++;
+    }
+    if (len > MDNS_MAX_PACKET_SIZE) {
+        s_oversized = true;
+    }
+    g_tx_packets++;
+    g_tx_bytes += len;
+    return len;
+}
+
+/**
+ * @brief  Builds the SRV and TXT query a controller resolves an accessory with
+ */
+static size_t coalesce_build_resolve(uint8_t *out, int accessory)
+{
+    size_t len = MDNS_HEAD_LEN;
+    memset(out, 0, MDNS_HEAD_LEN);
+    out[MDNS_HEAD_QUESTIONS_OFFSET + 1] = 2;
+    out[len] = snprintf((char *)out + len + 1, MDNS_NAME_BUF_LEN, "Accessory %d", accessory);
+    len += out[len] + 1;
+    static const uint8_t rest[] = {
+        0x04, '_', 'h', 'a', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+        0x00, 0x21, 0x00, 0x01,
+        0xC0, 0x0C, 0x00, 0x10, 0x00, 0x01
+    };
+    memcpy(out + len, rest, sizeof(rest));
+    return len + sizeof(rest);
+}
+
+typedef struct {
+    uint32_t packets;
+    size_t bytes;
+    uint32_t records;
+} coalesce_result_t;
+
+/**
+ * @brief  Every accessory is resolved by a query, the responses are sent one by one or as scheduled
+ */
+static void coalesce_resolve_all(bool one_by_one, coalesce_result_t *result)
+{
+    uint8_t query[MDNS_MAX_PACKET_SIZE];
+    uint32_t packets = g_tx_packets, records = s_records;
+    size_t bytes = g_tx_bytes;
+
+    for (int i = 0; i < COALESCE_SERVICES; i++) {
+        test_receive(query, coalesce_build_resolve(query, i));
+        if (one_by_one) {
+            test_send(true);
+        }
+        test_wait(COALESCE_SPACING_MS);
+    }
+    test_wait(MDNS_TX_COALESCE_MAX_MS);
+    result->packets = g_tx_packets - packets;
+    result->bytes = g_tx_bytes - bytes;
+    result->records = s_records - records;
+}
+
+#ifdef CONFIG_LWIP_IPV4
+/**
+ * @brief  Receives the PTR, SRV and A records of other bridges, answering our browse query
+ */
+static void coalesce_receive_others(void)
+{
+    uint8_t response[MDNS_MAX_PACKET_SIZE];
+    int other = 0;
+    while (other < COALESCE_OTHERS) {
+        size_t len = MDNS_HEAD_LEN;
+        uint16_t records = 0;
+        memset(response, 0, MDNS_HEAD_LEN);
+        response[MDNS_HEAD_FLAGS_OFFSET] = MDNS_FLAGS_QR_AUTHORITATIVE >> 8;
+        static const uint8_t hap[] = { 0x04, '_', 'h', 'a', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00 };
+        for (int i = 0; i < 12 && other < COALESCE_OTHERS; i++, other++) {
+            // _hap._tcp.local PTR Other NN._hap._tcp.local
+            memcpy(response + len, hap, sizeof(hap));
+            len += sizeof(hap);
+            const uint8_t ptr[] = { 0x00, 0x0C, 0x00, 0x01, 0x00, 0x00, 0x11, 0x94, 0x00, 11 };
+            memcpy(response + len, ptr, sizeof(ptr));
+            len += sizeof(ptr);
+            size_t instance = len;
+            len += 1 + sprintf((char *)response + len, "%cOther %02d", 8, other) - 1;
+            response[len++] = 0xC0;
+            response[len++] = MDNS_HEAD_LEN;
+            // Other NN._hap._tcp.local SRV 0 0 80 other-NN.local
+            const uint8_t srv[] = { 0xC0 | (instance >> 8), instance & 0xFF, 0x00, 0x21, 0x80, 0x01, 0x00, 0x00, 0x00, 0x78, 0x00, 17,
+                                    0x00, 0x00, 0x00, 0x00, 0x00, 80
+                                  };
+            memcpy(response + len, srv, sizeof(srv));
+            len += sizeof(srv);
+            size_t host = len;
+            len += sprintf((char *)response + len, "%cother-%02d", 8, other);
+            response[len++] = 0xC0;
+            response[len++] = MDNS_HEAD_LEN + 10;
+            // other-NN.local A 192.168.1.NN
+            const uint8_t a[] = { 0xC0 | (host >> 8), host & 0xFF, 0x00, 0x01, 0x80, 0x01, 0x00, 0x00, 0x00, 0x78, 0x00, 0x04,
+                                  192, 168, 1, 100 + other
+                                };
+            memcpy(response + len, a, sizeof(a));
+            len += sizeof(a);
+            records += 3;
+        }
+        response[MDNS_HEAD_ANSWERS_OFFSET + 1] = records;
+        test_receive(response, len);
+    }
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    mdns_txt_item_t txt[] = { {"c#", "2"}, {"ff", "0"}, {"id", "DE:AD:BE:EF:00:32"}, {"md", "bridge"}, {"sf", "1"} };
+    coalesce_result_t single, merged;
+    char instance[MDNS_NAME_BUF_LEN];
+
+    test_start("bridge");
+    test_send(true);
+
+    // the announcement does not fit into a single packet
+    uint32_t packets = g_tx_packets, records = s_records;
+    for (int i = 0; i < COALESCE_SERVICES; i++) {
+        snprintf(instance, sizeof(instance), "Accessory %d", i);
+        if (mdns_service_add(instance, "_hap", "_tcp", 8000 + i, txt, sizeof(txt) / sizeof(txt[0]))) {
+            abort();
+        }
+    }
+    test_send(true);
+    packets = g_tx_packets - packets;
+    records = s_records - records;
+    printf("Announcement of %d services on %d interfaces: %" PRIu32 " records in %" PRIu32 " packets (%" PRIu32 " continued)\n",
+           COALESCE_SERVICES, COALESCE_PCBS, records, packets, _mdns_server->coalesced.continued);
+    // SDPTR, PTR, SRV and TXT of each service, announced three times
+    if (records < COALESCE_PCBS * 3 * 4 * COALESCE_SERVICES || !_mdns_server->coalesced.continued || s_oversized) {
+        printf("Records of the announcement were lost\n");
+        abort();
+    }
+
+    g_packet.src.u_addr.ip4.addr = 0x0a01a8c0;
+
+    // the controllers resolve all accessories, after the rate limiting interval of the announced records
+    test_wait(2 * MDNS_MULTICAST_INTERVAL_MS);
+    coalesce_resolve_all(true, &single);
+    test_wait(2 * MDNS_MULTICAST_INTERVAL_MS);
+    coalesce_resolve_all(false, &merged);
+
+    uint32_t burst_ms = COALESCE_SERVICES * COALESCE_SPACING_MS + MDNS_TX_COALESCE_MAX_MS;
+    printf("Resolving %d services within %" PRIu32 " ms:\n", COALESCE_SERVICES, burst_ms);
+    printf("  one by one %4" PRIu32 " packets %6zu bytes %4" PRIu32 " records\n", single.packets, single.bytes, single.records);
+    printf("  merged     %4" PRIu32 " packets %6zu bytes %4" PRIu32 " records\n", merged.packets, merged.bytes, merged.records);
+    printf("  saved      %4" PRIu32 " packets/s %6zu bytes/s (%" PRIu32 " responses merged)\n",
+           (single.packets - merged.packets) * 1000 / burst_ms, (single.bytes - merged.bytes) * 1000 / burst_ms, _mdns_server->coalesced.merged);
+    if (merged.records != single.records || merged.packets * 4 > single.packets || s_oversized) {
+        printf("Responses were not merged\n");
+        abort();
+    }
+
+#ifdef CONFIG_LWIP_IPV4
+    // the known answers of the browse query continue in packets with the TC bit
+    mdns_search_once_t *search = mdns_query_async_new(NULL, "_hap", "_tcp", MDNS_TYPE_PTR, 3000, COALESCE_OTHERS + 1, NULL);
+    if (!search) {
+        abort();
+    }
+    test_execute_last_action();
+    test_wait(20);
+    coalesce_receive_others();
+    test_wait(MDNS_MULTICAST_INTERVAL_MS);
+    printf("Browse query with %d known answers: %" PRIu32 " queries with the TC bit, %" PRIu32 " continued\n",
+           COALESCE_OTHERS, s_truncated, s_continued);
+    if (!s_truncated || s_continued != s_truncated || s_oversized) {
+        printf("Known answers were not continued\n");
+        abort();
+    }
+    mdns_query_async_delete(search);
+#endif
+    printf("TX aggregation test passed\n");
+
+    mdns_service_remove_all();
+    test_send(true);
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
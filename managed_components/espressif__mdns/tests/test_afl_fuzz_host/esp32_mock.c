@@ -8,12 +8,19 @@
 #include <pthread.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <time.h>
 #include "esp32_mock.h"
 #include "esp_log.h"
 
 void     *g_queue;
 int       g_queue_send_shall_fail = 0;
 int       g_size = 0;
+uint32_t  g_tick = 0;
+bool      g_tick_stopped = false;
+uint32_t  g_tx_packets = 0;
+size_t    g_tx_bytes = 0;
+
+static uint8_t s_tx_buffer[1460];  // MDNS_MAX_PACKET_SIZE
 
 const char *WIFI_EVENT = "wifi_event";
 const char *ETH_EVENT = "eth_event";
@@ -31,35 +38,104 @@ esp_err_t esp_event_handler_unregister(const char *event_base, int32_t event_id,
     return ESP_OK;
 }
 
+__attribute__((weak)) void *mock_udp_pcb_alloc(uint8_t **data)
+{
+    *data = s_tx_buffer;
+    return s_tx_buffer;
+}
+
+__attribute__((weak)) size_t mock_udp_pcb_send(void *buf, size_t len)
+{
+    g_tx_packets++;
+    g_tx_bytes += len;
+    return len;
+}
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    bool running;
+    uint32_t expires_at;        // in g_tick milliseconds
+    uint32_t period;            // zero for one-shot timers
+};
+
+static struct esp_timer s_timer;
+
 esp_err_t esp_timer_delete(esp_timer_handle_t timer)
 {
+    timer->running = false;
     return ESP_OK;
 }
 
 esp_err_t esp_timer_stop(esp_timer_handle_t timer)
 {
+    if (!timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->running = false;
     return ESP_OK;
 }
 
-esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+static esp_err_t esp_timer_start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us)
 {
+    if (timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->running = true;
+    timer->expires_at = g_tick + timeout_us / 1000;
+    timer->period = period_us / 1000;
     return ESP_OK;
 }
 
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return esp_timer_start(timer, period, period);
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return esp_timer_start(timer, timeout_us, 0);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args,
                            esp_timer_handle_t *out_handle)
 {
+    memset(&s_timer, 0, sizeof(s_timer));
+    s_timer.callback = create_args->callback;
+    s_timer.arg = create_args->arg;
+    *out_handle = &s_timer;
     return ESP_OK;
 }
 
+bool FireTimer(void)
+{
+    if (!s_timer.running || (int32_t)(g_tick - s_timer.expires_at) < 0) {
+        return false;
+    }
+    if (s_timer.period) {
+        s_timer.expires_at += s_timer.period;
+    } else {
+        s_timer.running = false;
+    }
+    s_timer.callback(s_timer.arg);
+    return true;
+}
+
 uint32_t xTaskGetTickCount(void)
 {
-    static uint32_t tick = 0;
-    return tick++;
+    return g_tick_stopped ? g_tick : g_tick++;
 }
 
-/// Queue mock
-QueueHandle_t xQueueCreate( uint32_t uxQueueLength, uint32_t uxItemSize )
+/// Queue mock: each queue keeps only the item sent last, GetLastItem() reads the one of the queue sent to last
+/// (weak, tests may provide real queues)
+__attribute__((weak)) QueueHandle_t xQueueCreate( uint32_t uxQueueLength, uint32_t uxItemSize )
 {
     g_size = uxItemSize;
     g_queue = malloc((uxQueueLength) * (uxItemSize));
@@ -67,27 +143,33 @@ QueueHandle_t xQueueCreate( uint32_t uxQueueLength, uint32_t uxItemSize )
 }
 
 
-void vQueueDelete( QueueHandle_t xQueue )
+__attribute__((weak)) void vQueueDelete( QueueHandle_t xQueue )
 {
     free(xQueue);
 }
 
-uint32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+__attribute__((weak)) uint32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
 {
     if (g_queue_send_shall_fail) {
         return pdFALSE;
     } else {
         memcpy(xQueue, pvItemToQueue, g_size);
+        g_queue = xQueue;
         return pdPASS;
     }
 }
 
 
-uint32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+__attribute__((weak)) uint32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
 {
     return pdFALSE;
 }
 
+__attribute__((weak)) uint32_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+    return 0;
+}
+
 void GetLastItem(void *pvBuffer)
 {
     memcpy(pvBuffer, g_queue, g_size);
@@ -59,6 +59,7 @@
 #define _mdns_pcb_deinit(a,b)       true
 #define xSemaphoreCreateMutex()     malloc(1)
 #define xSemaphoreCreateBinary()    malloc(1)
+#define xSemaphoreCreateCounting(m, i)  malloc(1)
 #define vSemaphoreDelete(s)         free(s)
 #define queueQUEUE_TYPE_MUTEX       ( ( uint8_t ) 1U
 #define xTaskCreatePinnedToCore(a,b,c,d,e,f,g)     *(f) = malloc(1)
@@ -68,7 +69,8 @@
 
 #define ESP_TASK_PRIO_MAX 25
 #define ESP_TASKD_EVENT_PRIO 5
-#define _mdns_udp_pcb_write(tcpip_if, ip_protocol, ip, port, data, len) len
+#define _mdns_udp_pcb_alloc(data) mock_udp_pcb_alloc(data)
+#define _mdns_udp_pcb_send(tcpip_if, ip_protocol, ip, port, buf, len) mock_udp_pcb_send(buf, len)
 #define TaskHandle_t TaskHandle_t
 
 
@@ -108,6 +110,13 @@ struct pbuf {
 };
 
 uint32_t xTaskGetTickCount(void);
+extern uint32_t g_tick;         // advances by one on every read, tests may move it forward
+extern bool g_tick_stopped;     // g_tick does not advance on reads while set
+extern uint32_t g_tx_packets;   // packets and bytes "sent" by mdns
+extern size_t g_tx_bytes;
+extern int g_queue_send_shall_fail;     // xQueueSend() fails while set
+void *mock_udp_pcb_alloc(uint8_t **data);           // weak, tests may provide the buffers and send the packets
+size_t mock_udp_pcb_send(void *buf, size_t len);
 typedef void (*esp_timer_cb_t)(void *arg);
 
 // Queue mock
@@ -120,10 +129,14 @@ uint32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t
 
 uint32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait);
 
+uint32_t uxQueueMessagesWaiting(QueueHandle_t xQueue);
+
 void GetLastItem(void *pvBuffer);
 
 void ForceTaskDelete(void);
 
+bool FireTimer(void);           // runs the timer callback if the timer expired by g_tick
+
 esp_err_t esp_event_handler_register(const char *event_base, int32_t event_id, void *event_handler, void *event_handler_arg);
 
 esp_err_t esp_event_handler_unregister(const char *event_base, int32_t event_id, void *event_handler);
@@ -0,0 +1,229 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "test_common.h"
+
+//
+// Equivalence test of the name compression: the input (from AFL, a file or a PRNG) describes
+// a sequence of names and record data, which is written both by mdns _mdns_append_fqdn()
+// with its compression dictionary and by the reference implementation searching the packet.
+// The packets have to be byte-identical.
+
+static const char *s_labels[] = {
+    "_http", "_HTTP", "_tcp", "_udp", "_TCP", "local", "LOCAL", "Local", "_sub", "_printer", "_services", "_dns-sd",
+    "printer", "Printer", "My Printer", "esp32", "esp32-2", "a", "A", "arpa", "in-addr", "ip6", "x.y",
+    "0123456789012345678901234567890123456789012345678901234567890123",
+};
+
+// record data that may follow a name in a real packet
+static const struct {
+    const uint8_t *data;
+    size_t len;
+} s_fillers[] = {
+    { (const uint8_t *)"\x00\x0c\x00\x01\x00\x00\x11\x94\x00\x00", 10 },   // PTR type, class, ttl, length
+    { (const uint8_t *)"\x00\x21\x80\x01\x00\x00\x00\x78\x00\x00", 10 },   // SRV type, class, ttl, length
+    { (const uint8_t *)"\x00\x00\x00\x00\x00\x50", 6 },                     // SRV priority, weight, port
+    { (const uint8_t *)"\x09" "board=esp\x06" "path=/", 17 },             // TXT data
+    { (const uint8_t *)"\xc0\xa8\x01\x05", 4 },                             // A address
+};
+
+/**
+ * @brief  Compares a part of the name read back with strcasecmp(), as the search used to
+ */
+static bool ref_part_is(const mdns_name_t *name, const mdns_name_labels_t *labels, uint8_t part, const char *string)
+{
+    char buf[MDNS_NAME_BUF_LEN];
+    if (part == 0 && labels->host_merged) {
+        return !strcasecmp(string, name->host);
+    }
+    memcpy(buf, labels->parts[part].data, labels->parts[part].len);
+    buf[labels->parts[part].len] = 0;
+    return !strcasecmp(string, buf);
+}
+
+/**
+ * @brief  The name compression as it was before the dictionary: searching the whole packet for every name
+ */
+static uint16_t ref_append_fqdn(uint8_t *packet, uint16_t *index, const char *strings[], uint8_t count, size_t packet_len)
+{
+    if (!count) {
+        if (*index >= MDNS_MAX_PACKET_SIZE) {
+            return 0;
+        }
+        packet[(*index)++] = 0;
+        return 1;
+    }
+    mdns_name_t name;
+    mdns_name_labels_t labels;
+    uint8_t len = strlen(strings[0]);
+    uint8_t *len_location = (uint8_t *)memchr(packet, (char)len, *index);
+    while (len_location) {
+        if (len_location + 1 + len > packet + *index || memcmp(len_location + 1, strings[0], len)) {
+search_next:
+            len_location = (uint8_t *)memchr(len_location + 1, (char)len, *index - (len_location + 1 - packet));
+            continue;
+        }
+        memset(&name, 0, sizeof(name));
+        memset(&labels, 0, sizeof(labels));
+        if (!mdns_test_read_fqdn(packet, len_location, &name, &labels, packet_len) || name.parts != count) {
+            goto search_next;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            if (!ref_part_is(&name, &labels, i, strings[i])) {
+                goto search_next;
+            }
+        }
+        break;
+    }
+    if (!len_location) {
+        if ((*index + len + 1) >= MDNS_MAX_PACKET_SIZE) {
+            return 0;
+        }
+        packet[(*index)++] = len;
+        memcpy(packet + *index, strings[0], len);
+        *index += len;
+        return len + 1 + ref_append_fqdn(packet, index, &strings[1], count - 1, packet_len);
+    }
+    if ((*index + 1) >= MDNS_MAX_PACKET_SIZE) {
+        return 0;
+    }
+    uint16_t offset = (len_location - packet) | MDNS_NAME_REF;
+    packet[(*index)++] = offset >> 8;
+    packet[(*index)++] = offset & 0xFF;
+    return 2;
+}
+
+/**
+ * @brief  Checks whether the name written at the start offset is complete and points to a name which reads back
+ *
+ * The packet search reads names past the end of the written data, so it could take an unfinished name
+ * (followed by zeros or record data) as a previous occurrence, creating a looping or truncated name.
+ * The dictionary only knows complete names, so the packets differ from there on.
+ */
+static bool ref_name_is_valid(const uint8_t *packet, uint16_t start, uint16_t index)
+{
+    uint16_t pos = start;
+    while (pos < index && packet[pos] && (packet[pos] & 0xC0) != 0xC0) {
+        pos += packet[pos] + 1;
+    }
+    if (pos >= index) {
+        // ran out of space
+        return false;
+    }
+    if (!packet[pos]) {
+        return true;
+    }
+    mdns_name_t name = { 0 };
+    mdns_name_labels_t labels = { 0 };
+    return pos + 1 < index &&
+           mdns_test_read_fqdn(packet, packet + (((packet[pos] & 0x3F) << 8) | packet[pos + 1]), &name, &labels, MDNS_MAX_PACKET_SIZE);
+}
+
+static void append_both(uint8_t *ref, uint16_t *ref_index, uint8_t *out, uint16_t *out_index, const uint8_t *data, size_t len)
+{
+    if (*ref_index + len < MDNS_MAX_PACKET_SIZE) {
+        memcpy(ref + *ref_index, data, len);
+        *ref_index += len;
+    }
+    if (*out_index + len < MDNS_MAX_PACKET_SIZE) {
+        memcpy(out + *out_index, data, len);
+        *out_index += len;
+    }
+}
+
+/**
+ * @brief  Writes the packets described by the input, returns 0 if both implementations produced the same bytes
+ */
+static int run_input(const uint8_t *input, size_t input_len)
+{
+    static uint8_t ref[MDNS_MAX_PACKET_SIZE];
+    static uint8_t out[MDNS_MAX_PACKET_SIZE];
+    uint16_t ref_index = MDNS_HEAD_LEN;
+    uint16_t out_index = MDNS_HEAD_LEN;
+    memset(ref, 0, sizeof(ref));
+    memset(out, 0, sizeof(out));
+    mdns_test_name_dict_reset(out);
+
+    size_t i = 0;
+    while (i + 1 < input_len) {
+        uint8_t op = input[i++];
+        if (op & 0x80) {
+            // record data between the names
+            const int f = op % (sizeof(s_fillers) / sizeof(s_fillers[0]));
+            append_both(ref, &ref_index, out, &out_index, s_fillers[f].data, s_fillers[f].len);
+            continue;
+        }
+        const char *strings[8];
+        uint8_t count = 1 + op % 6;
+        for (uint8_t j = 0; j < count; j++) {
+            uint8_t label = i < input_len ? input[i++] : j;
+            // empty labels (which end the name early) are rare, as the dictionary leaves such packets to the search
+            strings[j] = label == 0xFF ? "" : s_labels[label % (sizeof(s_labels) / sizeof(s_labels[0]))];
+        }
+        uint16_t start = ref_index;
+        uint16_t ref_len = ref_append_fqdn(ref, &ref_index, strings, count, MDNS_MAX_PACKET_SIZE);
+        if (!ref_name_is_valid(ref, start, ref_index)) {
+            return 0;
+        }
+        uint16_t out_len = mdns_test_append_fqdn(out, &out_index, strings, count, MDNS_MAX_PACKET_SIZE);
+        if (ref_len != out_len || ref_index != out_index || memcmp(ref, out, ref_index)) {
+            printf("Mismatch after appending %u labels at input offset %zu: %u/%u bytes written, packet length %u/%u\n",
+                   count, i, ref_len, out_len, ref_index, out_index);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t buf[1460];
+    size_t len;
+
+    mdns_test_init_di();
+
+#ifdef INSTR_IS_OFF
+    if (argc == 2) {
+        // reproduce a failure reported by AFL
+        FILE *file = fopen(argv[1], "r");
+        if (!file) {
+            return 1;
+        }
+        len = fread(buf, 1, sizeof(buf), file);
+        fclose(file);
+        if (run_input(buf, len)) {
+            abort();
+        }
+        return 0;
+    }
+    // otherwise check a number of pseudo-random inputs
+    srand(0);
+    for (int run = 0; run < 20000; run++) {
+        len = 16 + rand() % 512;
+        for (size_t i = 0; i < len; i++) {
+            buf[i] = rand();
+        }
+        if (run_input(buf, len)) {
+            printf("Failed on run %d\n", run);
+            abort();
+        }
+    }
+    printf("Name compression matches the reference\n");
+#else
+    while (__AFL_LOOP(1000)) {
+        len = read(0, buf, sizeof(buf));
+        if (run_input(buf, len)) {
+            abort();
+        }
+    }
+#endif
+    return 0;
+}
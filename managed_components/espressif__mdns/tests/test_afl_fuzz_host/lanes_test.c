@@ -0,0 +1,482 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "test_common.h"
+
+//
+// Lanes test: the mDNS task under a flood of 2,000 received packets per second, more than it can parse,
+// while an application starts a query every 20 ms. The time is simulated in microseconds: the test
+// delivers the packets, calls the API and fires the timer on its clock, and charges every action the
+// task executes with a modeled cost, so the queues fill up as on a chip. It reports the latency of the
+// API calls and of the timer (the packets due to be sent) with the lanes of the engine, and with the
+// lanes merged into a single queue of MDNS_ACTION_QUEUE_LEN actions served in order, as it was before.
+
+#define LANES_RUN_MS            10000
+#define LANES_SETTLE_MS         3000        // probing and announcing before the flood
+#define LANES_STEP_US           10
+#define LANES_RX_INTERVAL_US    500         // 2,000 packets per second
+#define LANES_API_INTERVAL_US   20000
+#define LANES_COST_RX_US        600         // parsing (and answering) a packet, the flood is 1.2 times what the task handles
+#define LANES_COST_SHED_US      10          // dropping a query without parsing it
+#define LANES_COST_ACTION_US    200         // an API call or system event
+#define LANES_COST_TIMER_US     150         // a timer run, plus LANES_COST_TX_US for every packet it sends
+#define LANES_COST_TX_US        250
+#define LANES_PRINTERS          16
+#define LANES_SEARCHES_MAX      64
+#define LANES_SAMPLES_MAX       4096
+
+//
+// Real queues, replacing the mocked ones, optionally merged into a single queue
+typedef struct {
+    uint32_t len;
+    uint32_t count;
+    uint32_t head;
+    void *items[];
+} lanes_queue_t;
+
+static bool s_single_queue;         // the lanes post to s_fifo, which is served in order
+static lanes_queue_t *s_fifo;
+
+static lanes_queue_t *lanes_queue_new(uint32_t len)
+{
+    lanes_queue_t *q = calloc(1, sizeof(lanes_queue_t) + len * sizeof(void *));
+    if (!q) {
+        abort();
+    }
+    q->len = len;
+    return q;
+}
+
+static bool lanes_queue_push(lanes_queue_t *q, void *item)
+{
+    if (q->count == q->len) {
+        return false;
+    }
+    q->items[(q->head + q->count++) % q->len] = item;
+    return true;
+}
+
+static void *lanes_queue_pop(lanes_queue_t *q)
+{
+    if (!q->count) {
+        return NULL;
+    }
+    void *item = q->items[q->head];
+    q->head = (q->head + 1) % q->len;
+    q->count--;
+    return item;
+}
+
+QueueHandle_t xQueueCreate(uint32_t uxQueueLength, uint32_t uxItemSize)
+{
+    if (uxItemSize != sizeof(void *)) {
+        abort();
+    }
+    return lanes_queue_new(uxQueueLength);
+}
+
+void vQueueDelete(QueueHandle_t xQueue)
+{
+    free(xQueue);
+}
+
+uint32_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+{
+    void *item;
+    if (g_queue_send_shall_fail) {
+        return pdFALSE;
+    }
+    memcpy(&item, pvItemToQueue, sizeof(item));
+    return lanes_queue_push(s_single_queue ? s_fifo : (lanes_queue_t *)xQueue, item) ? pdPASS : pdFALSE;
+}
+
+uint32_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    void *item = lanes_queue_pop((lanes_queue_t *)xQueue);
+    memcpy(pvBuffer, &item, sizeof(item));
+    return item ? pdTRUE : pdFALSE;
+}
+
+uint32_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+    // there are no lanes to tell an overload with a single queue
+    return s_single_queue ? 0 : ((lanes_queue_t *)xQueue)->count;
+}
+
+//
+// Traffic
+static const uint8_t s_query[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x05, '_', 'h', 't', 't', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+    0x00, 0x0C, 0x00, 0x01
+};
+
+static uint8_t s_responses[LANES_PRINTERS][64];
+static size_t s_response_len;
+
+typedef struct {
+    uint32_t api_us[LANES_SAMPLES_MAX];     // from the call to the end of its action
+    uint32_t api_done;
+    uint32_t api_calls;
+    uint32_t api_failed;
+    uint32_t timer_us[LANES_SAMPLES_MAX];   // from the timer expiring to the end of the timer run
+    uint32_t timer_runs;
+    uint32_t rx_queries;
+    uint32_t rx_responses;
+    uint32_t dropped_queries;               // could not be queued
+    uint32_t dropped_responses;
+} lanes_result_t;
+
+static uint64_t s_now_us;
+static uint64_t s_free_at_us;               // the mDNS task is busy until then
+static uint64_t s_timer_expired_us;         // the timer expired and did not run yet, if not zero
+static uint32_t s_rx_count;
+static struct {
+    mdns_search_once_t *search;
+    uint64_t called_us;
+    bool started;
+} s_searches[LANES_SEARCHES_MAX];
+
+/**
+ * @brief  Writes the announcements of the printers browsed for, printer-A._ipp._tcp.local PTR and so on
+ */
+static void lanes_build_responses(void)
+{
+    for (int i = 0; i < LANES_PRINTERS; i++) {
+        const uint8_t head[] = {
+            0x00, 0x00, 0x84, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+            0x04, '_', 'i', 'p', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+            0x00, 0x0C, 0x00, 0x01, 0x00, 0x00, 0x11, 0x94, 0x00, 0x0C,
+            0x09, 'p', 'r', 'i', 'n', 't', 'e', 'r', '-', 'A' + i, 0xC0, 0x0C
+        };
+        memcpy(s_responses[i], head, sizeof(head));
+        s_response_len = sizeof(head);
+    }
+}
+
+static void lanes_receive(lanes_result_t *res)
+{
+    bool response = s_rx_count % 4 == 3;
+    mdns_rx_packet_t *packet = malloc(sizeof(mdns_rx_packet_t));
+    struct pbuf *pb = calloc(1, sizeof(struct pbuf));
+    if (!packet || !pb) {
+        abort();
+    }
+    pb->payload = response ? (void *)s_responses[(s_rx_count / 4) % LANES_PRINTERS] : (void *)s_query;
+    pb->len = response ? s_response_len : sizeof(s_query);
+    pb->tot_len = pb->len;
+    *packet = g_packet;
+    packet->pb = pb;
+    packet->src.type = ESP_IPADDR_TYPE_V4;
+    packet->src.u_addr.ip4.addr = 0x0001a8c0 | ((uint32_t)(10 + s_rx_count % 50) << 24);
+    s_rx_count++;
+    if (_mdns_send_rx_action(packet) != ESP_OK) {
+        free(pb);
+        free(packet);
+        if (response) {
+            res->dropped_responses++;
+        } else {
+            res->dropped_queries++;
+        }
+    }
+    if (response) {
+        res->rx_responses++;
+    } else {
+        res->rx_queries++;
+    }
+}
+
+/**
+ * @brief  Frees the results of a finished search and the search
+ */
+static void lanes_search_delete(mdns_search_once_t *search)
+{
+    mdns_result_t *results = NULL;
+    if (search->state != SEARCH_OFF || !mdns_query_async_get_results(search, 0, &results, NULL)) {
+        printf("A search did not finish\n");
+        abort();
+    }
+    mdns_query_results_free(results);
+    if (mdns_query_async_delete(search)) {
+        abort();
+    }
+}
+
+/**
+ * @brief  Starts a browse for printers, as an application would, and deletes the searches that finished
+ */
+static void lanes_call_api(lanes_result_t *res)
+{
+    for (int i = 0; i < LANES_SEARCHES_MAX; i++) {
+        if (s_searches[i].search && s_searches[i].started && s_searches[i].search->state == SEARCH_OFF) {
+            lanes_search_delete(s_searches[i].search);
+            s_searches[i].search = NULL;
+        }
+    }
+    for (int i = 0; i < LANES_SEARCHES_MAX; i++) {
+        if (!s_searches[i].search) {
+            s_searches[i].search = mdns_query_async_new(NULL, "_ipp", "_tcp", MDNS_TYPE_PTR, 100, 8, NULL);
+            s_searches[i].called_us = s_now_us;
+            s_searches[i].started = false;
+            res->api_calls++;
+            if (!s_searches[i].search) {
+                res->api_failed++;
+            }
+            return;
+        }
+    }
+    abort();
+}
+
+static mdns_action_t *lanes_take(void)
+{
+    return s_single_queue ? lanes_queue_pop(s_fifo) : mdns_test_action_take();
+}
+
+/**
+ * @brief  Executes an action, recording its latency, and returns its modeled cost
+ */
+static uint32_t lanes_execute(mdns_action_t *a, lanes_result_t *res)
+{
+    mdns_stats_t stats;
+    uint32_t cost = LANES_COST_ACTION_US;
+    uint32_t tx_packets = g_tx_packets;
+    uint32_t shed = 0;
+    mdns_action_type_t type = a->type;
+
+    if (type == ACTION_SEARCH_ADD) {
+        for (int i = 0; i < LANES_SEARCHES_MAX; i++) {
+            if (s_searches[i].search == a->data.search_add.search) {
+                s_searches[i].started = true;
+                if (res && res->api_done < LANES_SAMPLES_MAX) {
+                    res->api_us[res->api_done++] = s_now_us + cost - s_searches[i].called_us;
+                }
+            }
+        }
+    }
+    if (type == ACTION_RX_HANDLE && !mdns_stats_get(&stats)) {
+        shed = stats.netif[0][MDNS_IP_PROTOCOL_V4].rx_shed;
+    }
+    mdns_test_execute_action(a);
+    if (type == ACTION_RX_HANDLE && !mdns_stats_get(&stats)) {
+        cost = stats.netif[0][MDNS_IP_PROTOCOL_V4].rx_shed != shed ? LANES_COST_SHED_US : LANES_COST_RX_US;
+    }
+    if (type == ACTION_TIMER) {
+        cost = LANES_COST_TIMER_US + (g_tx_packets - tx_packets) * LANES_COST_TX_US;
+        if (res && res->timer_runs < LANES_SAMPLES_MAX) {
+            res->timer_us[res->timer_runs++] = s_now_us + cost - s_timer_expired_us;
+        }
+        s_timer_expired_us = 0;
+    }
+    return cost;
+}
+
+/**
+ * @brief  Lets the simulated time pass, with the flood and the API calls if a result is given
+ */
+static void lanes_run(uint32_t ms, lanes_result_t *res)
+{
+    uint64_t until = s_now_us + (uint64_t)ms * 1000;
+    uint64_t next_rx = s_now_us, next_api = s_now_us + LANES_API_INTERVAL_US;
+    for (; s_now_us < until; s_now_us += LANES_STEP_US) {
+        g_tick = s_now_us / 1000;
+        if (FireTimer() && !s_timer_expired_us) {
+            s_timer_expired_us = s_now_us;
+        }
+        while (res && next_rx <= s_now_us) {
+            lanes_receive(res);
+            next_rx += LANES_RX_INTERVAL_US;
+        }
+        if (res && next_api <= s_now_us) {
+            lanes_call_api(res);
+            next_api += LANES_API_INTERVAL_US;
+        }
+        mdns_action_t *a;
+        if (s_free_at_us <= s_now_us && (a = lanes_take()) != NULL) {
+            s_free_at_us = s_now_us + lanes_execute(a, res);
+        }
+    }
+}
+
+static int lanes_compare(const void *a, const void *b)
+{
+    return *(const uint32_t *)a < *(const uint32_t *)b ? -1 : *(const uint32_t *)a > *(const uint32_t *)b;
+}
+
+static uint32_t lanes_percentile(uint32_t *samples, uint32_t count, uint32_t percent)
+{
+    if (!count) {
+        return 0;
+    }
+    qsort(samples, count, sizeof(uint32_t), lanes_compare);
+    return samples[(count - 1) * percent / 100];
+}
+
+static void lanes_simulate(bool single_queue, lanes_result_t *res, mdns_stats_t *stats)
+{
+    mdns_txt_item_t txt[] = { {"path", "/"}, {"model", "lanes"} };
+
+    s_single_queue = single_queue;
+    s_fifo = lanes_queue_new(MDNS_ACTION_QUEUE_LEN);
+    s_now_us = s_free_at_us = s_timer_expired_us = 0;
+    s_rx_count = 0;
+    memset(s_searches, 0, sizeof(s_searches));
+    memset(res, 0, sizeof(*res));
+    g_tick_stopped = true;
+    g_tick = 0;
+
+    if (mdns_init()) {
+        abort();
+    }
+    for (int i = 0; i < MDNS_MAX_INTERFACES; i++) {
+        _mdns_server->interfaces[i].pcbs[MDNS_IP_PROTOCOL_V4].state = PCB_RUNNING;
+        _mdns_server->interfaces[i].pcbs[MDNS_IP_PROTOCOL_V6].state = PCB_RUNNING;
+    }
+    if (mdns_hostname_set("lanes")) {
+        abort();
+    }
+    lanes_run(10, NULL);
+    if (mdns_instance_name_set("Lanes")) {
+        abort();
+    }
+    lanes_run(10, NULL);
+    if (mdns_service_add(NULL, "_http", "_tcp", 80, txt, sizeof(txt) / sizeof(txt[0]))) {
+        abort();
+    }
+    lanes_run(LANES_SETTLE_MS, NULL);
+    lanes_run(LANES_RUN_MS, res);
+    // the flood stops, the task catches up
+    lanes_run(LANES_SETTLE_MS, NULL);
+    if (mdns_stats_get(stats)) {
+        abort();
+    }
+    for (int i = 0; i < LANES_SEARCHES_MAX; i++) {
+        if (s_searches[i].search) {
+            lanes_search_delete(s_searches[i].search);
+        }
+    }
+    ForceTaskDelete();
+    mdns_free();
+    g_queue_send_shall_fail = 0;
+    free(s_fifo);
+    s_fifo = NULL;
+}
+
+/**
+ * @brief  Links count queries into a batch, as the socket networking reads them at once
+ */
+static mdns_rx_packet_t *lanes_batch(int count)
+{
+    mdns_rx_packet_t *batch = NULL;
+    for (int i = 0; i < count; i++) {
+        mdns_rx_packet_t *packet = malloc(sizeof(mdns_rx_packet_t));
+        struct pbuf *pb = calloc(1, sizeof(struct pbuf));
+        if (!packet || !pb) {
+            abort();
+        }
+        pb->payload = (void *)s_query;
+        pb->len = pb->tot_len = sizeof(s_query);
+        *packet = g_packet;
+        packet->pb = pb;
+        packet->next = batch;
+        batch = packet;
+    }
+    return batch;
+}
+
+/**
+ * @brief  The limits of the RX lane count the packets of batches, not the batches
+ */
+static void lanes_check_batches(void)
+{
+    const int first = MDNS_RX_QUEUE_LEN - MDNS_RX_SHED_LEVEL;
+    mdns_stats_t stats;
+
+    s_single_queue = false;
+    if (mdns_init()) {
+        abort();
+    }
+    // the second batch fills the lane, the packets beyond are dropped, and so is the next packet
+    mdns_rx_packet_t *packet = lanes_batch(1);
+    if (_mdns_send_rx_batch_action(lanes_batch(first)) || _mdns_send_rx_batch_action(lanes_batch(MDNS_RX_SHED_LEVEL + 2))
+            || _mdns_send_rx_action(packet) != ESP_ERR_NO_MEM) {
+        abort();
+    }
+    free(packet->pb);
+    free(packet);
+    // the queries of the first batch are shed, as the packets of the second one are pending
+    mdns_action_t *a;
+    while ((a = mdns_test_action_take())) {
+        mdns_test_execute_action(a);
+    }
+    if (mdns_stats_get(&stats)) {
+        abort();
+    }
+    mdns_netif_stats_t *rx = &stats.netif[0][MDNS_IP_PROTOCOL_V4];
+    printf("Batches of %d and %d packets, then a packet: %" PRIu32 " parsed, %" PRIu32 " shed, %" PRIu32 " dropped\n",
+           first, MDNS_RX_SHED_LEVEL + 2, rx->rx_packets, rx->rx_shed, rx->rx_dropped);
+    if (rx->rx_packets != MDNS_RX_SHED_LEVEL || rx->rx_shed != first || rx->rx_dropped != 3) {
+        printf("The RX lane did not count the packets of the batches\n");
+        abort();
+    }
+    ForceTaskDelete();
+    mdns_free();
+    g_queue_send_shall_fail = 0;
+}
+
+static void lanes_report(const char *what, lanes_result_t *res, mdns_stats_t *stats)
+{
+    uint32_t api = res->api_done;
+    mdns_netif_stats_t *rx = &stats->netif[0][MDNS_IP_PROTOCOL_V4];
+    printf("%-13s %7" PRIu32 " %7" PRIu32 " %7" PRIu32 " %6" PRIu32 "  %7" PRIu32 " %7" PRIu32 " %7" PRIu32
+           "  %7" PRIu32 " %6" PRIu32 " %7" PRIu32 " %9" PRIu32 "\n", what,
+           lanes_percentile(res->api_us, api, 50), lanes_percentile(res->api_us, api, 99), lanes_percentile(res->api_us, api, 100),
+           res->api_failed, lanes_percentile(res->timer_us, res->timer_runs, 50),
+           lanes_percentile(res->timer_us, res->timer_runs, 99), lanes_percentile(res->timer_us, res->timer_runs, 100),
+           rx->rx_packets, rx->rx_shed, res->dropped_queries + res->dropped_responses, res->dropped_responses);
+}
+
+int main(int argc, char **argv)
+{
+    static lanes_result_t single, lanes;
+    mdns_stats_t single_stats, lanes_stats;
+
+    mdns_test_init_di();
+    lanes_build_responses();
+    lanes_simulate(true, &single, &single_stats);
+    lanes_simulate(false, &lanes, &lanes_stats);
+
+    printf("Lanes test: %d received packets/s (a quarter responses) for %d s at %d us each, a query started every %d ms\n",
+           1000000 / LANES_RX_INTERVAL_US, LANES_RUN_MS / 1000, LANES_COST_RX_US, LANES_API_INTERVAL_US / 1000);
+    printf("              API call latency us, failed   timer latency us         received packets\n");
+    printf("                  p50     p99     max          p50     p99     max   parsed   shed dropped responses dropped\n");
+    lanes_report("single queue", &single, &single_stats);
+    lanes_report("lanes", &lanes, &lanes_stats);
+
+    // an API call waits for the action in progress at most, the timer also for the API calls and a received packet
+    uint32_t api = lanes.api_done;
+    if (lanes.api_failed || lanes_percentile(lanes.api_us, api, 100) > LANES_COST_RX_US + 2 * LANES_COST_ACTION_US) {
+        printf("API calls were held up by the received packets\n");
+        abort();
+    }
+    if (lanes_percentile(lanes.timer_us, lanes.timer_runs, 99) > 5000) {
+        printf("The timer was held up by the received packets\n");
+        abort();
+    }
+    // under overload the queries are dropped, the responses are all parsed
+    if (!lanes_stats.netif[0][MDNS_IP_PROTOCOL_V4].rx_shed || lanes.dropped_responses) {
+        printf("Responses were dropped, or no queries\n");
+        abort();
+    }
+    lanes_check_batches();
+    printf("Lanes test passed\n");
+    return 0;
+}
@@ -6,11 +6,34 @@
 /*
  * MDNS Dependecy injection -- preincluded to inject interface test functions into static variables
  *
+ * The tests include it for the declarations of the test functions only, the definitions are compiled
+ * into mdns.c (MDNS_C_DEPENDENCY_INJECTION), here and in the name benchmark of the host_test app
  */
+#pragma once
 
 #include "mdns.h"
 #include "mdns_private.h"
 
+void mdns_test_init_di(void);
+void mdns_test_execute_action(void *action);
+void mdns_test_tx_handle_packet(void *packet);
+const uint8_t *mdns_test_read_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, mdns_name_labels_t *labels, size_t packet_len);
+uint16_t mdns_test_append_fqdn(uint8_t *packet, uint16_t *index, const char *strings[], uint8_t count, size_t packet_len);
+void mdns_test_name_dict_reset(const uint8_t *packet);
+void mdns_test_names_changed(void);
+const uint8_t *mdns_test_parse_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, size_t packet_len);
+bool mdns_test_label_equal(const char *a, const char *b, size_t len);
+bool mdns_test_str_equal(const char *a, const char *b);
+void *mdns_test_create_announce_packet(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, void *services[], size_t len, bool include_ip);
+void mdns_test_dispatch_tx_packet(void *packet);
+void mdns_test_free_tx_packet(void *packet);
+void *mdns_test_action_take(void);
+void mdns_test_search_free(mdns_search_once_t *search);
+esp_err_t mdns_test_send_search_action(mdns_action_type_t type, mdns_search_once_t *search);
+mdns_search_once_t *mdns_test_search_init(const char *name, const char *service, const char *proto, uint16_t type, uint32_t timeout, uint8_t max_results);
+mdns_srv_item_t *mdns_test_mdns_get_service_item(const char *service, const char *proto);
+
+#ifdef MDNS_C_DEPENDENCY_INJECTION
 void              (*mdns_test_static_execute_action)(mdns_action_t *) = NULL;
 mdns_srv_item_t *(*mdns_test_static_mdns_get_service_item)(const char *service, const char *proto, const char *hostname) = NULL;
 mdns_search_once_t *(*mdns_test_static_search_init)(const char *name, const char *service, const char *proto, uint16_t type, bool unicast,
@@ -18,6 +41,18 @@ mdns_search_once_t *(*mdns_test_static_search_init)(const char *name, const char
         mdns_query_notify_t notifier) = NULL;
 esp_err_t         (*mdns_test_static_send_search_action)(mdns_action_type_t type, mdns_search_once_t *search) = NULL;
 void              (*mdns_test_static_search_free)(mdns_search_once_t *search) = NULL;
+void              (*mdns_test_static_tx_handle_packet)(mdns_tx_packet_t *p) = NULL;
+const uint8_t    *(*mdns_test_static_read_fqdn)(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, mdns_name_labels_t *labels, size_t packet_len) = NULL;
+uint16_t          (*mdns_test_static_append_fqdn)(uint8_t *packet, uint16_t *index, const char *strings[], uint8_t count, size_t packet_len) = NULL;
+void              (*mdns_test_static_name_dict_reset)(const uint8_t *packet) = NULL;
+void              (*mdns_test_static_names_changed)(void) = NULL;
+const uint8_t    *(*mdns_test_static_parse_fqdn)(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, size_t packet_len) = NULL;
+bool              (*mdns_test_static_label_equal)(const char *a, const char *b, size_t len) = NULL;
+bool              (*mdns_test_static_str_equal)(const char *a, const char *b) = NULL;
+mdns_tx_packet_t *(*mdns_test_static_create_announce_packet)(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, mdns_srv_item_t *services[], size_t len, bool include_ip) = NULL;
+void              (*mdns_test_static_dispatch_tx_packet)(mdns_tx_packet_t *p) = NULL;
+void              (*mdns_test_static_free_tx_packet)(mdns_tx_packet_t *packet) = NULL;
+mdns_action_t    *(*mdns_test_static_action_take)(void) = NULL;
 
 static void _mdns_execute_action(mdns_action_t *action);
 static mdns_srv_item_t *_mdns_get_service_item(const char *service, const char *proto, const char *hostname);
@@ -25,6 +60,18 @@ static mdns_search_once_t *_mdns_search_init(const char *name, const char *servi
         uint32_t timeout, uint8_t max_results, mdns_query_notify_t notifier);
 static esp_err_t _mdns_send_search_action(mdns_action_type_t type, mdns_search_once_t *search);
 static void _mdns_search_free(mdns_search_once_t *search);
+static void _mdns_tx_handle_packet(mdns_tx_packet_t *p);
+static const uint8_t *_mdns_read_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, mdns_name_labels_t *labels, size_t packet_len);
+static uint16_t _mdns_append_fqdn(uint8_t *packet, uint16_t *index, const char *strings[], uint8_t count, size_t packet_len);
+static void _mdns_name_dict_reset(const uint8_t *packet);
+static void _mdns_names_changed(void);
+static const uint8_t *_mdns_parse_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, size_t packet_len);
+static bool _mdns_label_equal(const char *a, const char *b, size_t len);
+static bool _mdns_str_equal(const char *a, const char *b);
+static mdns_tx_packet_t *_mdns_create_announce_packet(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, mdns_srv_item_t *services[], size_t len, bool include_ip);
+static void _mdns_dispatch_tx_packet(mdns_tx_packet_t *p);
+static void _mdns_free_tx_packet(mdns_tx_packet_t *packet);
+static mdns_action_t *_mdns_action_take(void);
 
 void mdns_test_init_di(void)
 {
@@ -33,6 +80,18 @@ void mdns_test_init_di(void)
     mdns_test_static_search_init = _mdns_search_init;
     mdns_test_static_send_search_action = _mdns_send_search_action;
     mdns_test_static_search_free = _mdns_search_free;
+    mdns_test_static_tx_handle_packet = _mdns_tx_handle_packet;
+    mdns_test_static_read_fqdn = _mdns_read_fqdn;
+    mdns_test_static_append_fqdn = _mdns_append_fqdn;
+    mdns_test_static_name_dict_reset = _mdns_name_dict_reset;
+    mdns_test_static_names_changed = _mdns_names_changed;
+    mdns_test_static_parse_fqdn = _mdns_parse_fqdn;
+    mdns_test_static_label_equal = _mdns_label_equal;
+    mdns_test_static_str_equal = _mdns_str_equal;
+    mdns_test_static_create_announce_packet = _mdns_create_announce_packet;
+    mdns_test_static_dispatch_tx_packet = _mdns_dispatch_tx_packet;
+    mdns_test_static_free_tx_packet = _mdns_free_tx_packet;
+    mdns_test_static_action_take = _mdns_action_take;
 }
 
 void mdns_test_execute_action(void *action)
@@ -40,6 +99,66 @@ void mdns_test_execute_action(void *action)
     mdns_test_static_execute_action((mdns_action_t *)action);
 }
 
+void mdns_test_tx_handle_packet(void *packet)
+{
+    mdns_test_static_tx_handle_packet((mdns_tx_packet_t *)packet);
+}
+
+const uint8_t *mdns_test_read_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, mdns_name_labels_t *labels, size_t packet_len)
+{
+    return mdns_test_static_read_fqdn(packet, start, name, labels, packet_len);
+}
+
+uint16_t mdns_test_append_fqdn(uint8_t *packet, uint16_t *index, const char *strings[], uint8_t count, size_t packet_len)
+{
+    return mdns_test_static_append_fqdn(packet, index, strings, count, packet_len);
+}
+
+void mdns_test_name_dict_reset(const uint8_t *packet)
+{
+    mdns_test_static_name_dict_reset(packet);
+}
+
+void mdns_test_names_changed(void)
+{
+    mdns_test_static_names_changed();
+}
+
+const uint8_t *mdns_test_parse_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, size_t packet_len)
+{
+    return mdns_test_static_parse_fqdn(packet, start, name, packet_len);
+}
+
+bool mdns_test_label_equal(const char *a, const char *b, size_t len)
+{
+    return mdns_test_static_label_equal(a, b, len);
+}
+
+bool mdns_test_str_equal(const char *a, const char *b)
+{
+    return mdns_test_static_str_equal(a, b);
+}
+
+void *mdns_test_create_announce_packet(mdns_if_t tcpip_if, mdns_ip_protocol_t ip_protocol, void *services[], size_t len, bool include_ip)
+{
+    return mdns_test_static_create_announce_packet(tcpip_if, ip_protocol, (mdns_srv_item_t **)services, len, include_ip);
+}
+
+void mdns_test_dispatch_tx_packet(void *packet)
+{
+    mdns_test_static_dispatch_tx_packet((mdns_tx_packet_t *)packet);
+}
+
+void mdns_test_free_tx_packet(void *packet)
+{
+    mdns_test_static_free_tx_packet((mdns_tx_packet_t *)packet);
+}
+
+void *mdns_test_action_take(void)
+{
+    return mdns_test_static_action_take();
+}
+
 void mdns_test_search_free(mdns_search_once_t *search)
 {
     return mdns_test_static_search_free(search);
@@ -59,3 +178,5 @@ mdns_srv_item_t *mdns_test_mdns_get_service_item(const char *service, const char
 {
     return mdns_test_static_mdns_get_service_item(service, proto, NULL);
 }
+
+#endif /* MDNS_C_DEPENDENCY_INJECTION */
@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "test_common.h"
+#include "names_corpus.h"
+
+//
+// Name matching microbenchmark: the questions a responder sees on a home network (browsing, resolving
+// and looking up hosts of AirPlay, HomeKit, Cast, printers, Matter, ..., the corpus of names_corpus.h)
+// are written to packets with name compression, then parsed and matched against a table of services,
+// once with the parser of the responder and its word-at-a-time label comparison, and once as they were
+// before: with every label copied into a temporary buffer and compared by strcasecmp().
+// Both must read the same names, also from mangled packets, and find the same matches.
+
+#define NAMES_ROUNDS            20
+#define NAMES_ITERATIONS        2000
+#define NAMES_MANGLED_PACKETS   2000
+
+static uint64_t names_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief  Checks the label and name comparison against strcasecmp() on every pair of bytes
+ *         and on random labels at all alignments, equal but for the case of letters, a single byte or the length
+ */
+static void names_check_kernel(void)
+{
+    for (int a = 1; a < 256; a++) {
+        for (int b = 1; b < 256; b++) {
+            char sa[] = { (char)a, 0 }, sb[] = { (char)b, 0 };
+            if (mdns_test_label_equal(sa, sb, 1) != !strcasecmp(sa, sb)) {
+                printf("Bytes 0x%02x and 0x%02x compare differently\n", a, b);
+                abort();
+            }
+        }
+    }
+    char a[MDNS_NAME_BUF_LEN + 8], b[MDNS_NAME_BUF_LEN + 8];
+    srand(1);
+    for (int i = 0; i < 200000; i++) {
+        size_t len = 1 + rand() % 63;
+        char *pa = a + rand() % 8, *pb = b + rand() % 8;
+        for (size_t j = 0; j < len; j++) {
+            // mostly letters, digits and dashes, sometimes any byte
+            pa[j] = rand() % 8 ? "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_ @[]"[rand() % 68] : 1 + rand() % 255;
+            pb[j] = rand() % 2 ? toupper((unsigned char)pa[j]) : tolower((unsigned char)pa[j]);
+        }
+        if (rand() % 2) {
+            pb[rand() % len] = 1 + rand() % 255;
+        }
+        pa[len] = pb[len] = 0;
+        if (mdns_test_label_equal(pa, pb, len) != !strcasecmp(pa, pb)) {
+            printf("Labels \"%s\" and \"%s\" compare differently\n", pa, pb);
+            abort();
+        }
+        // as names, also of different lengths
+        if (rand() % 4 == 0) {
+            pb[rand() % (len + 1)] = 0;
+        }
+        if (mdns_test_str_equal(pa, pb) != !strcasecmp(pa, pb)) {
+            printf("Names \"%s\" and \"%s\" compare differently\n", pa, pb);
+            abort();
+        }
+    }
+}
+
+/**
+ * @brief  Parses the names at every offset of the packets, also after mangling them, with both parsers
+ */
+static void names_check_parser(void)
+{
+    mdns_name_t name, ref;
+    uint8_t mangled[MDNS_MAX_PACKET_SIZE];
+    for (int i = 0; i < NAMES_MANGLED_PACKETS; i++) {
+        const names_packet_t *p = &s_packets[i % s_packet_count];
+        memcpy(mangled, p->packet, p->len);
+        // the packets are parsed as they are first
+        int mangles = i < (int)s_packet_count ? 0 : 1 + rand() % 8;
+        for (int j = 0; j < mangles; j++) {
+            int pos = MDNS_HEAD_LEN + rand() % (p->len - MDNS_HEAD_LEN);
+            mangled[pos] = rand() % 4 ? rand() % 256 : (rand() % 2 ? toupper(mangled[pos]) : 0);
+        }
+        for (size_t pos = MDNS_HEAD_LEN; pos < p->len; pos++) {
+            const uint8_t *next = mdns_test_parse_fqdn(mangled, mangled + pos, &name, p->len);
+            if (next != ref_parse_fqdn(mangled, mangled + pos, &ref, p->len) || (next && !names_equal(&name, &ref))) {
+                printf("Name at offset %zu of packet %d is parsed differently\n", pos, i);
+                abort();
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Parses all the names of the corpus, returns the time it took
+ */
+static uint64_t names_parse(const uint8_t *(*parse)(const uint8_t *, const uint8_t *, mdns_name_t *, size_t))
+{
+    mdns_name_t name;
+    uint64_t start = names_now_ns();
+    for (int i = 0; i < NAMES_ITERATIONS; i++) {
+        for (size_t n = 0; n < s_name_count; n++) {
+            if (!parse(s_names[n].packet, s_names[n].start, &name, MDNS_MAX_PACKET_SIZE)) {
+                abort();
+            }
+        }
+    }
+    return names_now_ns() - start;
+}
+
+/**
+ * @brief  Matches all the parsed names of the corpus, returns the time it took
+ */
+static uint64_t names_match_all(const mdns_name_t *names, bool (*equal)(const char *, const char *), int *matches)
+{
+    *matches = 0;
+    uint64_t start = names_now_ns();
+    for (int i = 0; i < NAMES_ITERATIONS; i++) {
+        for (size_t n = 0; n < s_name_count; n++) {
+            *matches += names_match(&names[n], equal);
+        }
+    }
+    return names_now_ns() - start;
+}
+
+static void names_keep_best(uint64_t *best, uint64_t elapsed)
+{
+    if (elapsed < *best) {
+        *best = elapsed;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static mdns_name_t names[NAMES_MAX];
+
+    mdns_test_init_di();
+    names_build_corpus();
+    names_check_kernel();
+    names_check_parser();
+    for (size_t n = 0; n < s_name_count; n++) {
+        mdns_test_parse_fqdn(s_names[n].packet, s_names[n].start, &names[n], MDNS_MAX_PACKET_SIZE);
+    }
+
+    // the fastest of a few rounds, taking turns, to filter out the noise of the host machine
+    uint64_t ref_parse = UINT64_MAX, parse = UINT64_MAX, ref_match = UINT64_MAX, match = UINT64_MAX;
+    int ref_matches, matches;
+    for (int round = 0; round < NAMES_ROUNDS; round++) {
+        names_keep_best(&ref_parse, names_parse(ref_parse_fqdn));
+        names_keep_best(&parse, names_parse(mdns_test_parse_fqdn));
+        names_keep_best(&ref_match, names_match_all(names, ref_str_equal, &ref_matches));
+        names_keep_best(&match, names_match_all(names, mdns_test_str_equal, &matches));
+    }
+    if (matches != ref_matches || !matches) {
+        printf("The names matched %d times instead of %d\n", matches, ref_matches);
+        abort();
+    }
+    size_t runs = (size_t)NAMES_ITERATIONS * s_name_count;
+    printf("%zu names of the corpus in %zu packets, matched against %zu services and %zu hosts (%d matches):\n", s_name_count,
+           s_packet_count, sizeof(s_services) / sizeof(s_services[0]), sizeof(s_own_hosts) / sizeof(s_own_hosts[0]), matches / NAMES_ITERATIONS);
+    printf("  %-28s %8s %8s\n", "", "parse", "match");
+    printf("  %-28s %5.1f ns %5.1f ns\n", "copied labels, strcasecmp()", (double)ref_parse / runs, (double)ref_match / runs);
+    printf("  %-28s %5.1f ns %5.1f ns\n", "labels in place, by words", (double)parse / runs, (double)match / runs);
+    printf("Name matching benchmark passed\n");
+    return 0;
+}
@@ -0,0 +1,242 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+/*
+ * Corpus of the name matching benchmarks -- the questions a responder sees on a home network, the services
+ * they are matched against and the parser and comparison as they were before, which copied every label and
+ * compared it by strcasecmp(); shared by `make names` and the name benchmark of the host_test app
+ */
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "mdns_di.h"
+
+#define NAMES_MAX               256
+
+typedef struct {
+    const char *service;
+    const char *proto;
+} names_type_t;
+
+static const names_type_t s_types[] = {
+    { "_airplay", "_tcp" }, { "_raop", "_tcp" }, { "_companion-link", "_tcp" }, { "_hap", "_tcp" }, { "_hap", "_udp" },
+    { "_googlecast", "_tcp" }, { "_spotify-connect", "_tcp" }, { "_sleep-proxy", "_udp" }, { "_device-info", "_tcp" },
+    { "_ipp", "_tcp" }, { "_ipps", "_tcp" }, { "_printer", "_tcp" }, { "_pdl-datastream", "_tcp" }, { "_uscan", "_tcp" },
+    { "_http", "_tcp" }, { "_smb", "_tcp" }, { "_adisk", "_tcp" }, { "_ssh", "_tcp" }, { "_matter", "_tcp" },
+    { "_matterc", "_udp" }, { "_meshcop", "_udp" }, { "_esphomelib", "_tcp" }, { "_mqtt", "_tcp" }, { "_amzn-wplay", "_tcp" },
+};
+
+static const struct {
+    const char *instance;
+    uint8_t type;               // index to s_types
+} s_instances[] = {
+    { "Living Room", 0 }, { "A483E7123456@Living Room", 1 }, { "Kitchen", 2 }, { "Philips Hue - 1A2B3C", 3 },
+    { "Eve Energy 5F1A", 4 }, { "Chromecast-Ultra-7f3c2a5e9d1b4c6f", 5 }, { "Bedroom Speaker", 6 },
+    { "70-35-60-63.1 Living Room", 7 }, { "MacBook Pro", 8 }, { "HP LaserJet Pro M404 [5A1B2C]", 9 },
+    { "HP LaserJet Pro M404 [5A1B2C]", 10 }, { "Brother HL-L2350DW series", 11 }, { "Brother HL-L2350DW series", 14 },
+    { "Office NAS", 15 }, { "Office NAS", 16 }, { "raspberrypi", 17 }, { "9C1B8E2F4A7D3C10-0000000012345678", 18 },
+    { "A1B2C3D4E5F60718", 19 }, { "OpenThread Border Router #6A2F", 20 }, { "esphome-web-1a2b3c", 21 },
+    { "Mosquitto", 22 }, { "Echo-Dot-Kitchen", 23 }, { "ESP32 with mDNS", 14 }, { "esp32-mdns", 21 },
+};
+
+static const char *s_hosts[] = {
+    "MacBook-Pro", "iPhone", "Living-Room", "esp32-mdns", "Brother-HL-L2350DW", "hue-bridge-1a2b3c", "Android-3",
+    "raspberrypi", "HPA1B2C3", "office-nas", "9C1B8E2F4A7D3C10", "esphome-web-1a2b3c",
+};
+
+// the hosts and services of the responder matching the questions
+static const char *s_own_hosts[] = { "esp32-mdns", "esp32-printer" };
+
+static const struct {
+    const char *instance;
+    const char *service;
+    const char *proto;
+} s_services[] = {
+    { "ESP32 with mDNS", "_http", "_tcp" }, { "esp32-mdns", "_esphomelib", "_tcp" }, { "esp32-mdns", "_hap", "_tcp" },
+    { "esp32-mdns", "_matterc", "_udp" }, { "ESP32 Printer", "_ipp", "_tcp" }, { "ESP32 Printer", "_printer", "_tcp" },
+    { "ESP32 Speaker", "_raop", "_tcp" }, { "ESP32 Speaker", "_airplay", "_tcp" },
+};
+
+typedef struct {
+    uint8_t packet[MDNS_MAX_PACKET_SIZE];
+    uint16_t len;
+} names_packet_t;
+
+static names_packet_t s_packets[16];
+static size_t s_packet_count;
+static struct {
+    const uint8_t *packet;
+    const uint8_t *start;
+} s_names[NAMES_MAX];
+static size_t s_name_count;
+
+/**
+ * @brief  The name parser as it was before: every label copied into a buffer, then compared by strcasecmp()
+ */
+static const uint8_t *ref_read_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, char *buf, size_t packet_len)
+{
+    size_t index = 0;
+    const uint8_t *packet_end = packet + packet_len;
+    while (start + index < packet_end && start[index]) {
+        if (name->parts == 4) {
+            name->invalid = true;
+        }
+        uint8_t len = start[index++];
+        if (len < 0xC0) {
+            if (len > 63) {
+                return NULL;
+            }
+            uint8_t i;
+            for (i = 0; i < len; i++) {
+                if (start + index >= packet_end) {
+                    return NULL;
+                }
+                buf[i] = start[index++];
+            }
+            buf[len] = '\0';
+            if (name->parts == 1 && buf[0] != '_'
+                    && (strcasecmp(buf, "local") != 0)
+                    && (strcasecmp(buf, "arpa") != 0)
+#ifndef CONFIG_MDNS_RESPOND_REVERSE_QUERIES
+                    && (strcasecmp(buf, "ip6") != 0)
+                    && (strcasecmp(buf, "in-addr") != 0)
+#endif
+               ) {
+                strlcat(name->host, ".", sizeof(name->host));
+                strlcat(name->host, buf, sizeof(name->host));
+            } else if (strcasecmp(buf, "_sub") == 0) {
+                name->sub = 1;
+            } else if (!name->invalid) {
+                char *mdns_name_ptrs[] = {name->host, name->service, name->proto, name->domain};
+                memcpy(mdns_name_ptrs[name->parts++], buf, len + 1);
+            }
+        } else {
+            size_t address = (((uint16_t)len & 0x3F) << 8) | start[index++];
+            if ((packet + address) >= start) {
+                return NULL;
+            }
+            if (ref_read_fqdn(packet, packet + address, name, buf, packet_len)) {
+                return start + index;
+            }
+            return NULL;
+        }
+    }
+    return start + index + 1;
+}
+
+static const uint8_t *ref_parse_fqdn(const uint8_t *packet, const uint8_t *start, mdns_name_t *name, size_t packet_len)
+{
+    name->parts = 0;
+    name->sub = 0;
+    name->host[0] = 0;
+    name->service[0] = 0;
+    name->proto[0] = 0;
+    name->domain[0] = 0;
+    name->invalid = false;
+
+    char buf[MDNS_NAME_BUF_LEN];
+
+    const uint8_t *next_data = ref_read_fqdn(packet, start, name, buf, packet_len);
+    if (!next_data) {
+        return 0;
+    }
+    if (!name->parts || name->invalid) {
+        return next_data;
+    }
+    if (name->parts == 3) {
+        memmove((uint8_t *)name + (MDNS_NAME_BUF_LEN), (uint8_t *)name, 3 * (MDNS_NAME_BUF_LEN));
+        name->host[0] = 0;
+    } else if (name->parts == 2) {
+        memmove((uint8_t *)(name->domain), (uint8_t *)(name->service), (MDNS_NAME_BUF_LEN));
+        name->service[0] = 0;
+        name->proto[0] = 0;
+    }
+    if (strcasecmp(name->domain, "local") == 0 || strcasecmp(name->domain, "arpa") == 0) {
+        return next_data;
+    }
+    name->invalid = true;
+    return next_data;
+}
+
+static bool names_equal(const mdns_name_t *a, const mdns_name_t *b)
+{
+    return a->parts == b->parts && a->sub == b->sub && a->invalid == b->invalid && !strcmp(a->host, b->host)
+           && !strcmp(a->service, b->service) && !strcmp(a->proto, b->proto) && !strcmp(a->domain, b->domain);
+}
+
+static bool ref_str_equal(const char *a, const char *b)
+{
+    return !strcasecmp(a, b);
+}
+
+/**
+ * @brief  Matches a question against the responder, as it does: the type of PTR questions, type and instance
+ *         of SRV/TXT questions against the services and the host of address questions against the hosts
+ */
+static int names_match(const mdns_name_t *name, bool (*equal)(const char *, const char *))
+{
+    int matches = 0;
+    if (!name->service[0]) {
+        for (size_t i = 0; i < sizeof(s_own_hosts) / sizeof(s_own_hosts[0]); i++) {
+            matches += equal(s_own_hosts[i], name->host);
+        }
+        return matches;
+    }
+    for (size_t i = 0; i < sizeof(s_services) / sizeof(s_services[0]); i++) {
+        if (equal(s_services[i].service, name->service) && equal(s_services[i].proto, name->proto)
+                && (!name->host[0] || equal(s_services[i].instance, name->host))) {
+            matches++;
+        }
+    }
+    return matches;
+}
+
+static void names_add(const char *strings[], uint8_t count)
+{
+    names_packet_t *p = s_packet_count ? &s_packets[s_packet_count - 1] : NULL;
+    // a question is the name followed by type and class
+    if (!p || p->len + MDNS_NAME_MAX_LEN * 4 + 4 > MDNS_MAX_PACKET_SIZE) {
+        p = &s_packets[s_packet_count++];
+        mdns_test_name_dict_reset(p->packet);
+        p->len = MDNS_HEAD_LEN;
+    }
+    s_names[s_name_count].packet = p->packet;
+    s_names[s_name_count].start = p->packet + p->len;
+    if (!mdns_test_append_fqdn(p->packet, &p->len, strings, count, MDNS_MAX_PACKET_SIZE)) {
+        abort();
+    }
+    memcpy(p->packet + p->len, "\x00\x0c\x00\x01", 4);
+    p->len += 4;
+    s_name_count++;
+}
+
+/**
+ * @brief  Writes the questions of the corpus: browsing of every type, resolving of every instance and lookups
+ *         of every host, some of them in upper case as sent by a few stacks
+ */
+static void names_build_corpus(void)
+{
+    const char *dns_sd[] = { "_services", "_dns-sd", "_udp", "local" };
+    names_add(dns_sd, 4);
+    for (size_t i = 0; i < sizeof(s_types) / sizeof(s_types[0]); i++) {
+        const char *browse[] = { s_types[i].service, s_types[i].proto, i % 5 ? "local" : "LOCAL" };
+        names_add(browse, 3);
+    }
+    const char *sub[] = { "_universal", "_sub", "_ipp", "_tcp", "local" };
+    names_add(sub, 5);
+    for (size_t i = 0; i < sizeof(s_instances) / sizeof(s_instances[0]); i++) {
+        const names_type_t *t = &s_types[s_instances[i].type];
+        const char *resolve[] = { s_instances[i].instance, t->service, t->proto, "local" };
+        names_add(resolve, 4);
+    }
+    for (size_t i = 0; i < sizeof(s_hosts) / sizeof(s_hosts[0]); i++) {
+        const char *host[] = { s_hosts[i], "local" };
+        names_add(host, 2);
+    }
+    const char *reverse[] = { "20", "1", "168", "192", "in-addr", "arpa" };
+    names_add(reverse, 6);
+}
@@ -0,0 +1,228 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+
+//
+// Query planner test: a controller browses for HomeKit bridges and, at the same time, resolves one
+// of them with several searches (twice the PTR, then the SRV, TXT and A records). The questions of all
+// of them must go out together, in a single packet per PCB, repeated at growing intervals, and the
+// answers of a single response must reach every search asking for them.
+
+#define QUERY_TIMEOUT_MS        10000
+#define QUERY_PCBS              (MDNS_MAX_INTERFACES * MDNS_IP_PROTOCOL_MAX)
+#define QUERY_QUESTIONS         4       // PTR (asked by two searches and the browse), SRV, TXT and A
+#define QUERY_ROUNDS            4       // sent at 0, 1, 3 and 7 s
+#define QUERY_SEARCHES          5
+
+static uint32_t s_round_at[QUERY_ROUNDS + 1];
+static uint32_t s_round_packets[QUERY_ROUNDS + 1];
+static uint32_t s_rounds;
+static uint32_t s_bad_packets;      // queries not asking all questions
+static int s_browse_added;
+
+size_t mock_udp_pcb_send(void *buf, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    if (!(p[MDNS_HEAD_FLAGS_OFFSET] & (MDNS_FLAGS_QUERY_REPSONSE >> 8))) {
+        if (!s_rounds || s_round_at[s_rounds - 1] != g_tick) {
+            if (s_rounds <= QUERY_ROUNDS) {
+                s_round_at[s_rounds] = g_tick;
+            }
+            s_rounds++;
+        }
+        if (s_rounds <= QUERY_ROUNDS + 1) {
+            s_round_packets[s_rounds - 1]++;
+        }
+        if (((p[MDNS_HEAD_QUESTIONS_OFFSET] << 8) | p[MDNS_HEAD_QUESTIONS_OFFSET + 1]) != QUERY_QUESTIONS) {
+            s_bad_packets++;
+        }
+    }
+    g_tx_packets++;
+    g_tx_bytes += len;
+    return len;
+}
+
+/**
+ * @brief  Lets the time pass, running the timer callback and the work it hands over to the service thread
+ */
+static void query_wait(uint32_t ms)
+{
+    g_tick_stopped = true;
+    test_wait(ms);
+    g_tick_stopped = false;
+}
+
+static void query_browse_cb(mdns_browse_event_t event, const mdns_result_t *result, uint32_t changed, void *arg)
+{
+    if (event == MDNS_BROWSE_ADDED && result->instance_name && !strcmp(result->instance_name, "Bridge A")) {
+        s_browse_added++;
+    }
+}
+
+/**
+ * @brief  Receives the PTR, SRV, TXT and A records of the bridge in a single response
+ */
+static void query_receive_response(void)
+{
+    static const uint8_t response[] = {
+        0x00, 0x00, 0x84, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
+        // _hap._tcp.local PTR Bridge A._hap._tcp.local (the instance label at 39)
+        0x04, '_', 'h', 'a', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+        0x00, 0x0C, 0x00, 0x01, 0x00, 0x00, 0x11, 0x94, 0x00, 0x0B,
+        0x08, 'B', 'r', 'i', 'd', 'g', 'e', ' ', 'A', 0xC0, 0x0C,
+        // Bridge A._hap._tcp.local SRV 0 0 8080 bridge-a.local (the host label at 68)
+        0xC0, 0x27, 0x00, 0x21, 0x80, 0x01, 0x00, 0x00, 0x00, 0x78, 0x00, 0x11,
+        0x00, 0x00, 0x00, 0x00, 0x1F, 0x90,
+        0x08, 'b', 'r', 'i', 'd', 'g', 'e', '-', 'a', 0xC0, 0x16,
+        // Bridge A._hap._tcp.local TXT md=Bridge
+        0xC0, 0x27, 0x00, 0x10, 0x80, 0x01, 0x00, 0x00, 0x11, 0x94, 0x00, 0x0A,
+        0x09, 'm', 'd', '=', 'B', 'r', 'i', 'd', 'g', 'e',
+        // bridge-a.local A 192.168.1.20
+        0xC0, 0x44, 0x00, 0x01, 0x80, 0x01, 0x00, 0x00, 0x00, 0x78, 0x00, 0x04,
+        0xC0, 0xA8, 0x01, 0x14
+    };
+    // clear the slot of the mocked queue, a browse sync is only handled if the packet queued one
+    mdns_action_t *a = NULL;
+    xQueueSend(_mdns_server->lanes[MDNS_LANE_CONTROL], &a, 0);
+    test_receive(response, sizeof(response));
+    GetLastItem(&a);
+    if (a) {
+        mdns_test_execute_action(a);
+    }
+}
+
+static const mdns_result_t *query_result(const mdns_search_once_t *search)
+{
+    const mdns_result_t *r = search->result;
+    while (r && r->esp_netif != _mdns_get_esp_netif(g_packet.tcpip_if)) {
+        r = r->next;
+    }
+    return r;
+}
+
+int main(int argc, char **argv)
+{
+    mdns_search_once_t *searches[QUERY_SEARCHES];
+
+    test_start("controller");
+    // let the probes and announcements go out
+    query_wait(10000);
+    if (_mdns_server->tx_queue_head) {
+        printf("Announcements were not sent\n");
+        abort();
+    }
+    s_rounds = 0;
+    memset(s_round_packets, 0, sizeof(s_round_packets));
+    s_bad_packets = 0;
+
+    g_packet.src.u_addr.ip4.addr = 0x1401a8c0;
+
+    // everything is started within the same millisecond, as an application resolving a service does
+    g_tick_stopped = true;
+    if (!mdns_browse_delta_new("_hap", "_tcp", query_browse_cb, NULL)) {
+        abort();
+    }
+    test_execute_last_action();
+    searches[0] = mdns_query_async_new(NULL, "_hap", "_tcp", MDNS_TYPE_PTR, QUERY_TIMEOUT_MS, 0, NULL);
+    test_execute_last_action();
+    searches[1] = mdns_query_async_new(NULL, "_hap", "_tcp", MDNS_TYPE_PTR, QUERY_TIMEOUT_MS, 0, NULL);
+    test_execute_last_action();
+    searches[2] = mdns_query_async_new("Bridge A", "_hap", "_tcp", MDNS_TYPE_SRV, QUERY_TIMEOUT_MS, 0, NULL);
+    test_execute_last_action();
+    searches[3] = mdns_query_async_new("Bridge A", "_hap", "_tcp", MDNS_TYPE_TXT, QUERY_TIMEOUT_MS, 0, NULL);
+    test_execute_last_action();
+    searches[4] = mdns_query_async_new("bridge-a", NULL, NULL, MDNS_TYPE_A, QUERY_TIMEOUT_MS, 0, NULL);
+    test_execute_last_action();
+    g_tick_stopped = false;
+    for (int i = 0; i < QUERY_SEARCHES; i++) {
+        if (!searches[i]) {
+            abort();
+        }
+    }
+
+    // the first round of queries, then the response to it
+    uint32_t start = g_tick;
+    query_wait(10);
+    if (s_rounds != 1) {
+        printf("No queries were sent\n");
+        abort();
+    }
+    query_receive_response();
+    query_wait(QUERY_TIMEOUT_MS + 100);
+
+    printf("Queries of %d searches and a browse on %d PCBs:\n", QUERY_SEARCHES, QUERY_PCBS);
+    for (uint32_t i = 0; i < s_rounds && i < QUERY_ROUNDS + 1; i++) {
+        printf("  %6u ms: %u packets\n", (unsigned)(s_round_at[i] - start), (unsigned)s_round_packets[i]);
+    }
+    if (s_rounds != QUERY_ROUNDS || s_bad_packets) {
+        printf("Unexpected queries (%u rounds, %u with other than %d questions)\n", (unsigned)s_rounds, (unsigned)s_bad_packets, QUERY_QUESTIONS);
+        abort();
+    }
+    for (uint32_t i = 0; i < QUERY_ROUNDS; i++) {
+        uint32_t interval = i ? s_round_at[i] - s_round_at[i - 1] : 0;
+        uint32_t expected = i ? MDNS_QUERY_MIN_INTERVAL_MS << (i - 1) : 0;
+        if (s_round_packets[i] != QUERY_PCBS || interval < expected || interval > expected + CONFIG_MDNS_TIMER_PERIOD_MS) {
+            printf("Round %u was not sent in one packet per PCB after %u ms\n", (unsigned)i, (unsigned)expected);
+            abort();
+        }
+    }
+
+    // a single response answers all searches
+    const mdns_result_t *r;
+    for (int i = 0; i < 2; i++) {
+        r = query_result(searches[i]);
+        if (!r || !r->instance_name || strcmp(r->instance_name, "Bridge A") || !r->hostname || strcmp(r->hostname, "bridge-a")
+                || r->port != 8080 || r->txt_count != 1) {
+            printf("PTR search %d was not answered\n", i);
+            abort();
+        }
+    }
+    r = query_result(searches[2]);
+    if (!r || !r->hostname || strcmp(r->hostname, "bridge-a") || r->port != 8080) {
+        printf("SRV search was not answered\n");
+        abort();
+    }
+    r = query_result(searches[3]);
+    if (!r || r->txt_count != 1 || strcmp(r->txt[0].key, "md")) {
+        printf("TXT search was not answered\n");
+        abort();
+    }
+#if CONFIG_LWIP_IPV4
+    r = query_result(searches[4]);
+    if (!r || !r->addr || r->addr->addr.u_addr.ip4.addr != g_packet.src.u_addr.ip4.addr) {
+        printf("A search was not answered\n");
+        abort();
+    }
+#endif
+    if (s_browse_added != 1) {
+        printf("Browse was not answered\n");
+        abort();
+    }
+    printf("Query test passed\n");
+
+    for (int i = 0; i < QUERY_SEARCHES; i++) {
+        mdns_result_t *results = NULL;
+        if (!mdns_query_async_get_results(searches[i], 0, &results, NULL)) {
+            abort();
+        }
+        mdns_query_results_free(results);
+        if (mdns_query_async_delete(searches[i])) {
+            abort();
+        }
+    }
+    if (mdns_browse_delete("_hap", "_tcp")) {
+        abort();
+    }
+    test_execute_last_action();
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
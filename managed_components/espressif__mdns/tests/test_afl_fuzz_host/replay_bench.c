@@ -0,0 +1,643 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include <unistd.h>
+
+#include "test_common.h"
+
+//
+// Replay benchmark: feeds mDNS traffic, read from a pcap capture or generated, to a responder
+// with a few services, at the timing of the capture or at a given rate. Received packets go through
+// the action queue and scheduled packets are sent from the timer, as on the target, in virtual time.
+// Reports the CPU time the engine spends on the traffic, the heap it uses and a digest of
+// the packets it sends, which only changes with its output.
+
+#define REPLAY_DURATION_S       30
+#define REPLAY_RATES            { 100, 1000 }
+#define REPLAY_MAX_PACKETS      200000
+#define REPLAY_QUERIERS         20
+#define REPLAY_OTHER_DEVICES    64
+
+typedef struct {
+    uint64_t at_us;                 // time of the packet since the first one
+    mdns_ip_protocol_t ip_protocol;
+    esp_ip_addr_t src;
+    uint16_t src_port;
+    uint8_t multicast;
+    uint16_t len;
+    uint8_t *data;
+} replay_packet_t;
+
+static replay_packet_t *s_packets;
+static size_t s_count;
+
+//
+// Heap accounting, all allocations are routed here by the linker (-Wl,--wrap=malloc,...)
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static size_t s_heap_in_use;
+static size_t s_heap_peak;
+static uint64_t s_allocs;
+
+static void *replay_account(void *ptr)
+{
+    if (ptr) {
+        s_allocs++;
+        s_heap_in_use += malloc_usable_size(ptr);
+        if (s_heap_in_use > s_heap_peak) {
+            s_heap_peak = s_heap_in_use;
+        }
+    }
+    return ptr;
+}
+
+static void replay_unaccount(void *ptr)
+{
+    size_t size = ptr ? malloc_usable_size(ptr) : 0;
+    s_heap_in_use -= size < s_heap_in_use ? size : s_heap_in_use;
+}
+
+void *__wrap_malloc(size_t size)
+{
+    return replay_account(__real_malloc(size));
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    return replay_account(__real_calloc(nmemb, size));
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    replay_unaccount(ptr);
+    return replay_account(__real_realloc(ptr, size));
+}
+
+void __wrap_free(void *ptr)
+{
+    replay_unaccount(ptr);
+    __real_free(ptr);
+}
+
+char *__wrap_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *copy = __wrap_malloc(len);
+    return copy ? memcpy(copy, s, len) : NULL;
+}
+
+char *__wrap_strndup(const char *s, size_t n)
+{
+    size_t len = strnlen(s, n);
+    char *copy = __wrap_malloc(len + 1);
+    if (copy) {
+        memcpy(copy, s, len);
+        copy[len] = 0;
+    }
+    return copy;
+}
+
+//
+// In-memory networking: the sent packets are only hashed
+static uint64_t s_digest;
+
+size_t mock_udp_pcb_send(void *buf, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * 1099511628211ULL;
+    }
+    s_digest = (s_digest ^ hash) * 1099511628211ULL;
+    g_tx_packets++;
+    g_tx_bytes += len;
+    return len;
+}
+
+static uint64_t replay_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void replay_add(uint64_t at_us, mdns_ip_protocol_t ip_protocol, const uint8_t *src, uint16_t src_port,
+                       bool multicast, const uint8_t *data, size_t len)
+{
+    if (s_count == REPLAY_MAX_PACKETS || len > MDNS_MAX_PACKET_SIZE || len < MDNS_HEAD_LEN) {
+        return;
+    }
+    replay_packet_t *r = &s_packets[s_count];
+    memset(r, 0, sizeof(replay_packet_t));
+    r->data = __real_malloc(len);
+    if (!r->data) {
+        abort();
+    }
+    memcpy(r->data, data, len);
+    r->len = len;
+    r->at_us = at_us;
+    r->ip_protocol = ip_protocol;
+    r->src_port = src_port;
+    r->multicast = multicast;
+    if (ip_protocol == MDNS_IP_PROTOCOL_V4) {
+        r->src.type = ESP_IPADDR_TYPE_V4;
+        memcpy(&r->src.u_addr.ip4.addr, src, 4);
+    } else {
+        r->src.type = ESP_IPADDR_TYPE_V6;
+        memcpy(r->src.u_addr.ip6.addr, src, 16);
+    }
+    s_count++;
+}
+
+//
+// pcap reader
+static uint32_t replay_get32(const uint8_t *p, bool swap)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return swap ? __builtin_bswap32(v) : v;
+}
+
+/**
+ * @brief  Adds the UDP datagram to or from port 5353 in an IP packet
+ */
+static void replay_add_ip(uint64_t at_us, const uint8_t *ip, size_t len)
+{
+    static const uint8_t mdns_v6[16] = { 0xff, 0x02, [15] = 0xfb };
+    mdns_ip_protocol_t ip_protocol;
+    const uint8_t *src, *udp;
+    bool multicast;
+
+    if (len >= 20 && (ip[0] >> 4) == 4 && ip[9] == 17 && len >= (ip[0] & 0xf) * 4 + 8) {
+        ip_protocol = MDNS_IP_PROTOCOL_V4;
+        src = ip + 12;
+        multicast = ip[16] == 224 && ip[17] == 0 && ip[18] == 0 && ip[19] == 251;
+        udp = ip + (ip[0] & 0xf) * 4;
+    } else if (len >= 48 && (ip[0] >> 4) == 6 && ip[6] == 17) {
+        ip_protocol = MDNS_IP_PROTOCOL_V6;
+        src = ip + 8;
+        multicast = !memcmp(ip + 24, mdns_v6, 16);
+        udp = ip + 40;
+    } else {
+        return;
+    }
+    uint16_t src_port = (udp[0] << 8) | udp[1];
+    uint16_t dst_port = (udp[2] << 8) | udp[3];
+    size_t udp_len = (udp[4] << 8) | udp[5];
+    if ((src_port != MDNS_SERVICE_PORT && dst_port != MDNS_SERVICE_PORT) || udp_len < 8 || udp + udp_len > ip + len) {
+        return;
+    }
+    replay_add(at_us, ip_protocol, src, src_port, multicast, udp + 8, udp_len - 8);
+}
+
+/**
+ * @brief  Reads the mDNS packets of a capture (Ethernet, raw IP, Linux cooked or loopback)
+ */
+static bool replay_read_pcap(const char *path)
+{
+    uint8_t hdr[24];
+    FILE *f = fopen(path, "rb");
+    if (!f || fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr)) {
+        printf("Cannot read %s\n", path);
+        return false;
+    }
+    uint32_t magic = replay_get32(hdr, false);
+    bool swap = magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1;
+    bool nsec = magic == 0xa1b23c4d || magic == 0x4d3cb2a1;
+    if (!swap && !nsec && magic != 0xa1b2c3d4) {
+        printf("%s is not a pcap file\n", path);
+        fclose(f);
+        return false;
+    }
+    uint32_t linktype = replay_get32(hdr + 20, swap) & 0xffff;
+    uint64_t first_us = 0;
+    uint8_t rec[16];
+    static uint8_t frame[65536];
+    while (fread(rec, 1, sizeof(rec), f) == sizeof(rec)) {
+        uint32_t caplen = replay_get32(rec + 8, swap);
+        if (caplen > sizeof(frame) || fread(frame, 1, caplen, f) != caplen) {
+            break;
+        }
+        uint64_t at_us = replay_get32(rec, swap) * 1000000ULL + replay_get32(rec + 4, swap) / (nsec ? 1000 : 1);
+        if (!s_count) {
+            first_us = at_us;
+        }
+        at_us -= first_us;
+        const uint8_t *p = frame;
+        size_t len = caplen;
+        size_t skip = linktype == 1 ? 14 : linktype == 113 ? 16 : linktype == 276 ? 20 : linktype == 0 ? 4 : 0;
+        if (linktype == 1 && len >= 18 && p[12] == 0x81 && p[13] == 0x00) {
+            skip += 4;  // 802.1Q tag
+        }
+        if (len > skip) {
+            replay_add_ip(at_us, p + skip, len - skip);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+//
+// Synthetic traffic: queries for the services of the responder and for services of other devices,
+// some listing known answers or asking for a unicast response, and announcements of other devices
+static const struct {
+    const char *instance;
+    const char *service;
+    uint16_t port;
+} s_services[] = {
+    { "Replay Web", "_http", 80 },
+    { "Replay Accessory", "_hap", 8080 },
+    { "Replay Printer", "_ipp", 631 },
+    { "Replay Printer", "_printer", 515 },
+    { "Replay Shell", "_ssh", 22 },
+    { "Replay Files", "_smb", 445 },
+};
+#define REPLAY_SERVICES (sizeof(s_services) / sizeof(s_services[0]))
+
+static const char *s_foreign[] = { "_googlecast", "_airplay", "_spotify-connect", "_companion-link", "_raop", "_sleep-proxy" };
+
+static uint32_t s_rand = 0x2545f491;
+
+static uint32_t replay_rand(uint32_t n)
+{
+    s_rand ^= s_rand << 13;
+    s_rand ^= s_rand >> 17;
+    s_rand ^= s_rand << 5;
+    return s_rand % n;
+}
+
+static size_t replay_name(uint8_t *p, const char *instance, const char *service, const char *proto)
+{
+    const char *labels[] = { instance, service, proto, "local" };
+    size_t len = 0;
+    for (int i = 0; i < 4; i++) {
+        if (labels[i]) {
+            p[len] = strlen(labels[i]);
+            memcpy(p + len + 1, labels[i], p[len]);
+            len += p[len] + 1;
+        }
+    }
+    p[len++] = 0;
+    return len;
+}
+
+static size_t replay_question(uint8_t *p, uint16_t type, uint16_t mdns_class)
+{
+    uint8_t q[4] = { type >> 8, type, mdns_class >> 8, mdns_class };
+    memcpy(p, q, sizeof(q));
+    return sizeof(q);
+}
+
+static size_t replay_rr(uint8_t *p, uint16_t type, uint16_t mdns_class, uint32_t ttl, const uint8_t *rdata, size_t rdlen)
+{
+    uint8_t rr[10] = { type >> 8, type, mdns_class >> 8, mdns_class, ttl >> 24, ttl >> 16, ttl >> 8, ttl, rdlen >> 8, rdlen };
+    memcpy(p, rr, sizeof(rr));
+    memcpy(p + sizeof(rr), rdata, rdlen);
+    return sizeof(rr) + rdlen;
+}
+
+/**
+ * @brief  Builds a random packet, returns its length
+ */
+static size_t replay_generate_packet(uint8_t *p, bool v6)
+{
+    uint8_t rdata[256];
+    size_t len = MDNS_HEAD_LEN;
+    size_t s = replay_rand(REPLAY_SERVICES);
+    uint32_t kind = replay_rand(100);
+    uint16_t qu = replay_rand(10) ? 0 : 0x8000;
+    memset(p, 0, MDNS_HEAD_LEN);
+
+    if (kind < 35) {            // browse for a service of the responder, possibly knowing the answer already
+        p[MDNS_HEAD_QUESTIONS_OFFSET + 1] = 1;
+        len += replay_name(p + len, NULL, s_services[s].service, "_tcp");
+        len += replay_question(p + len, MDNS_TYPE_PTR, 1 | qu);
+        if (replay_rand(3) == 0) {
+            p[MDNS_HEAD_ANSWERS_OFFSET + 1] = 1;
+            len += replay_name(p + len, NULL, s_services[s].service, "_tcp");
+            size_t rdlen = replay_name(rdata, s_services[s].instance, s_services[s].service, "_tcp");
+            len += replay_rr(p + len, MDNS_TYPE_PTR, 1, replay_rand(2) ? MDNS_ANSWER_PTR_TTL : MDNS_ANSWER_PTR_TTL / 4, rdata, rdlen);
+        }
+    } else if (kind < 55) {     // browse for services of other devices
+        p[MDNS_HEAD_QUESTIONS_OFFSET + 1] = 1;
+        len += replay_name(p + len, NULL, s_foreign[replay_rand(6)], "_tcp");
+        len += replay_question(p + len, MDNS_TYPE_PTR, 1 | qu);
+    } else if (kind < 65) {     // resolve an instance of the responder
+        p[MDNS_HEAD_QUESTIONS_OFFSET + 1] = 2;
+        len += replay_name(p + len, s_services[s].instance, s_services[s].service, "_tcp");
+        len += replay_question(p + len, MDNS_TYPE_SRV, 1 | qu);
+        len += replay_name(p + len, s_services[s].instance, s_services[s].service, "_tcp");
+        len += replay_question(p + len, MDNS_TYPE_TXT, 1 | qu);
+    } else if (kind < 75) {     // look up the address of the responder
+        p[MDNS_HEAD_QUESTIONS_OFFSET + 1] = 1;
+        len += replay_name(p + len, "replay", NULL, NULL);
+        len += replay_question(p + len, v6 ? MDNS_TYPE_AAAA : MDNS_TYPE_A, 1 | qu);
+    } else {                    // announcement of another device
+        char instance[24], host[16];
+        uint32_t device = replay_rand(REPLAY_OTHER_DEVICES);
+        const char *service = s_foreign[device % 6];
+        snprintf(instance, sizeof(instance), "Device %" PRIu32, device);
+        snprintf(host, sizeof(host), "device-%" PRIu32, device);
+        p[MDNS_HEAD_FLAGS_OFFSET] = 0x84;
+        p[MDNS_HEAD_ANSWERS_OFFSET + 1] = 4;
+        len += replay_name(p + len, NULL, service, "_tcp");
+        size_t rdlen = replay_name(rdata, instance, service, "_tcp");
+        len += replay_rr(p + len, MDNS_TYPE_PTR, 1, MDNS_ANSWER_PTR_TTL, rdata, rdlen);
+        len += replay_name(p + len, instance, service, "_tcp");
+        rdata[0] = rdata[1] = rdata[2] = rdata[3] = 0;
+        rdata[4] = 0x1f;
+        rdata[5] = 0x49;
+        rdlen = 6 + replay_name(rdata + 6, host, NULL, NULL);
+        len += replay_rr(p + len, MDNS_TYPE_SRV, 0x8001, MDNS_ANSWER_SRV_TTL, rdata, rdlen);
+        len += replay_name(p + len, instance, service, "_tcp");
+        memcpy(rdata, "\x0bmodel=cast1\x08fw=2.1.0", 21);
+        len += replay_rr(p + len, MDNS_TYPE_TXT, 0x8001, MDNS_ANSWER_TXT_TTL, rdata, 21);
+        len += replay_name(p + len, host, NULL, NULL);
+        uint8_t a[4] = { 192, 168, 1, 100 + device };
+        len += replay_rr(p + len, MDNS_TYPE_A, 0x8001, MDNS_ANSWER_A_TTL, a, sizeof(a));
+    }
+    return len;
+}
+
+static void replay_generate(uint32_t rate, uint32_t seconds)
+{
+    uint8_t packet[MDNS_MAX_PACKET_SIZE];
+    uint32_t total = rate * seconds;
+    for (uint32_t i = 0; i < total && i < REPLAY_MAX_PACKETS; i++) {
+        uint32_t querier = replay_rand(REPLAY_QUERIERS);
+        bool v6 = querier % 3 == 0;
+        bool legacy = replay_rand(20) == 0;
+        uint8_t src[16] = { 192, 168, 1, 10 + querier };
+        if (v6) {
+            uint8_t ll[16] = { 0xfe, 0x80, [15] = 10 + querier };
+            memcpy(src, ll, sizeof(src));
+        }
+        size_t len = replay_generate_packet(packet, v6);
+        replay_add(i * 1000000ULL / rate, v6 ? MDNS_IP_PROTOCOL_V6 : MDNS_IP_PROTOCOL_V4, src,
+                   legacy ? 40000 + querier : MDNS_SERVICE_PORT, !legacy, packet, len);
+    }
+}
+
+//
+// Replay
+typedef struct {
+    uint32_t rx;                    // packets replayed
+    uint64_t rx_ns;                 // CPU time handling them
+    uint64_t timer_ns;              // CPU time in timer runs
+    uint32_t *rx_lat;               // handling time of each packet
+    uint32_t *tx_lat;               // time of each timer run sending packets
+    uint32_t tx_runs;
+    uint32_t tx_packets;
+    size_t tx_bytes;
+    size_t heap_base;               // heap used by the responder before the replay
+    size_t heap_peak;               // and at most during the replay
+    size_t heap_leaked;             // heap not freed by mdns_free()
+    uint64_t allocs;
+    uint64_t digest;
+} replay_result_t;
+
+/**
+ * @brief  Runs the timer, if due, as the mdns task would
+ */
+static void replay_timer(replay_result_t *res)
+{
+    uint32_t sent = g_tx_packets;
+    uint64_t start = replay_time_ns();
+    if (!test_run_timer()) {
+        return;
+    }
+    uint64_t ns = replay_time_ns() - start;
+    res->timer_ns += ns;
+    if (g_tx_packets != sent && res->tx_runs < REPLAY_MAX_PACKETS) {
+        res->tx_lat[res->tx_runs++] = ns;
+    }
+}
+
+/**
+ * @brief  Lets the virtual time pass until the given millisecond, running the timer as it gets due
+ */
+static void replay_wait_until(uint32_t until, replay_result_t *res)
+{
+    replay_timer(res);
+    while ((int32_t)(until - g_tick) > 0) {
+        g_tick++;
+        replay_timer(res);
+    }
+}
+
+static void replay_receive(const replay_packet_t *r, replay_result_t *res)
+{
+    mdns_rx_packet_t *packet = malloc(sizeof(mdns_rx_packet_t));
+    struct pbuf *pb = calloc(1, sizeof(struct pbuf));
+    if (!packet || !pb) {
+        abort();
+    }
+    pb->payload = r->data;
+    pb->len = r->len;
+    pb->tot_len = r->len;
+    memset(packet, 0, sizeof(mdns_rx_packet_t));
+    packet->tcpip_if = 0;
+    packet->ip_protocol = r->ip_protocol;
+    packet->pb = pb;
+    packet->src = r->src;
+    packet->src_port = r->src_port;
+    packet->multicast = r->multicast;
+
+    uint64_t start = replay_time_ns();
+    if (_mdns_send_rx_action(packet) == ESP_OK) {
+        test_execute_last_action();
+    } else {
+        free(pb);
+        free(packet);
+    }
+    uint64_t ns = replay_time_ns() - start;
+    res->rx_ns += ns;
+    res->rx_lat[res->rx++] = ns;
+}
+
+static void replay_start(void)
+{
+    mdns_txt_item_t txt[] = { {"path", "/"}, {"model", "replay"}, {"fw", "1.0.0"} };
+    if (mdns_init()) {
+        abort();
+    }
+    if (mdns_hostname_set("replay")) {
+        abort();
+    }
+    test_execute_last_action();
+    if (mdns_instance_name_set("Replay")) {
+        abort();
+    }
+    test_execute_last_action();
+    for (size_t i = 0; i < REPLAY_SERVICES; i++) {
+        if (mdns_service_add(s_services[i].instance, s_services[i].service, "_tcp", s_services[i].port, txt, 3)) {
+            abort();
+        }
+    }
+}
+
+/**
+ * @brief  Replays the packets with their times multiplied by scale, on a responder in its steady state
+ */
+static void replay_run(double scale, replay_result_t *res)
+{
+    memset(res, 0, sizeof(replay_result_t));
+    res->rx_lat = __real_malloc(s_count * sizeof(uint32_t));
+    res->tx_lat = __real_malloc(REPLAY_MAX_PACKETS * sizeof(uint32_t));
+    if (!res->rx_lat || !res->tx_lat) {
+        abort();
+    }
+    size_t heap_before = s_heap_in_use;
+    replay_start();
+    replay_wait_until(g_tick + 5000, res);  // probed and announced
+    res->timer_ns = 0;
+    res->tx_runs = 0;
+
+    uint32_t tx_packets = g_tx_packets;
+    size_t tx_bytes = g_tx_bytes;
+    uint32_t start = g_tick;
+    s_digest = 0;
+    res->heap_base = s_heap_in_use - heap_before;
+    s_heap_peak = s_heap_in_use;
+    uint64_t allocs = s_allocs;
+    for (size_t i = 0; i < s_count; i++) {
+        replay_wait_until(start + (uint32_t)(s_packets[i].at_us * scale / 1000), res);
+        replay_receive(&s_packets[i], res);
+    }
+    replay_wait_until(g_tick + 2000, res);  // the last responses
+    res->tx_packets = g_tx_packets - tx_packets;
+    res->tx_bytes = g_tx_bytes - tx_bytes;
+    res->heap_peak = s_heap_peak - heap_before;
+    res->allocs = s_allocs - allocs;
+    res->digest = s_digest;
+    ForceTaskDelete();
+    mdns_free();
+    g_queue_send_shall_fail = 0;
+    res->heap_leaked = s_heap_in_use - heap_before;
+}
+
+static int replay_cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static double replay_percentile_us(uint32_t *ns, size_t count, int percent)
+{
+    if (!count) {
+        return 0;
+    }
+    qsort(ns, count, sizeof(uint32_t), replay_cmp);
+    return ns[(count - 1) * percent / 100] / 1000.0;
+}
+
+static void replay_report(const char *name, double duration_s, replay_result_t *res)
+{
+    double cpu_s = (res->rx_ns + res->timer_ns) / 1e9;
+    printf("%-12s %7" PRIu32 " packets in %6.1f s: %9.0f packets/s, RX p50 %6.2f us p99 %7.2f us, "
+           "TX p50 %6.2f us p99 %7.2f us\n", name, res->rx, duration_s, res->rx / cpu_s,
+           replay_percentile_us(res->rx_lat, res->rx, 50), replay_percentile_us(res->rx_lat, res->rx, 99),
+           replay_percentile_us(res->tx_lat, res->tx_runs, 50), replay_percentile_us(res->tx_lat, res->tx_runs, 99));
+    printf("%-12s %7" PRIu32 " packets %8zu bytes sent, heap %zu bytes, peak %zu bytes, %.2f allocations/packet, digest %016" PRIx64 "\n",
+           "", res->tx_packets, res->tx_bytes, res->heap_base, res->heap_peak,
+           res->rx ? (double)res->allocs / res->rx : 0, res->digest);
+    if (res->heap_leaked) {
+        printf("%-12s %zu bytes not freed by mdns_free()\n", "", res->heap_leaked);
+    }
+    __real_free(res->rx_lat);
+    __real_free(res->tx_lat);
+}
+
+static void replay_usage(const char *name)
+{
+    printf("Usage: %s [-s speed] [-r packets/s] [capture.pcap]\n"
+           "  replays the mDNS packets of the capture (or %d s of generated traffic at %s packets/s)\n"
+           "  -s  replays the capture faster (2) or slower (0.5) than captured\n"
+           "  -r  replays the packets evenly spaced at the given rate\n", name, REPLAY_DURATION_S, "100 and 1000");
+}
+
+int main(int argc, char **argv)
+{
+    double speed = 1;
+    uint32_t rate = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:r:h")) != -1) {
+        switch (opt) {
+        case 's':
+            speed = atof(optarg);
+            break;
+        case 'r':
+            rate = atoi(optarg);
+            break;
+        default:
+            replay_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (speed <= 0) {
+        replay_usage(argv[0]);
+        return 1;
+    }
+
+    s_packets = __real_malloc(REPLAY_MAX_PACKETS * sizeof(replay_packet_t));
+    if (!s_packets) {
+        abort();
+    }
+    mdns_test_init_di();
+    g_tick_stopped = true;      // the time only passes between the packets, as they were captured
+    printf("Replay on a responder with %zu services, engine CPU time per packet and timer run:\n", REPLAY_SERVICES);
+
+    replay_result_t res;
+    if (optind < argc) {
+        if (!replay_read_pcap(argv[optind]) || !s_count) {
+            printf("No mDNS packets in %s\n", argv[optind]);
+            return 1;
+        }
+        double scale = 1 / speed;
+        if (rate) {
+            for (size_t i = 0; i < s_count; i++) {
+                s_packets[i].at_us = i * 1000000ULL / rate;
+            }
+            scale = 1;
+        }
+        replay_run(scale, &res);
+        replay_report("capture", s_packets[s_count - 1].at_us * scale / 1e6, &res);
+        return 0;
+    }
+
+    const uint32_t rates[] = REPLAY_RATES;
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        char name[16];
+        uint32_t r = rate ? rate : rates[i];
+        s_rand = 0x2545f491;
+        for (size_t j = 0; j < s_count; j++) {
+            __real_free(s_packets[j].data);
+        }
+        s_count = 0;
+        replay_generate(r, REPLAY_DURATION_S);
+        replay_run(1, &res);
+        snprintf(name, sizeof(name), "%" PRIu32 "/s", r);
+        if (!res.tx_packets || res.heap_peak < res.heap_base) {
+            printf("The responder did not answer the generated queries\n");
+            abort();
+        }
+        replay_report(name, REPLAY_DURATION_S, &res);
+        if (rate) {
+            break;
+        }
+    }
+    printf("Replay benchmark passed\n");
+    return 0;
+}
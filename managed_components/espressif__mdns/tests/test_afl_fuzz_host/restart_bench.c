@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test_common.h"
+
+//
+// Restart benchmark: a device with 32 services on 3 interfaces (both IPv4 and IPv6) sets its hostname,
+// which restarts the responder on all PCBs. Measures the time spent sending the goodbye packets,
+// the probes and the announcements, once with every packet encoded for its PCB alone (as each
+// was handled before) and once with the packets of all PCBs sent together from the timer.
+
+#define RESTART_SERVICES        32
+#define RESTART_ROUNDS          20
+#define RESTART_PCBS            (MDNS_MAX_INTERFACES * MDNS_IP_PROTOCOL_MAX)
+
+static uint64_t s_digest;           // sum of the hashes of the sent packets, independent of their order
+
+size_t mock_udp_pcb_send(void *buf, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * 1099511628211ULL;
+    }
+    s_digest += hash;
+    g_tx_packets++;
+    g_tx_bytes += len;
+    return len;
+}
+
+static uint64_t restart_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief  Sends the scheduled packets as they become due, one by one or from the timer
+ */
+static void restart_run(bool one_by_one)
+{
+    for (int i = 0; i < 10000 && _mdns_server->tx_queue_head; i++) {
+        mdns_tx_packet_t *p = _mdns_server->tx_queue_head;
+        if ((int32_t)(p->send_at - g_tick) > 0) {
+            g_tick = p->send_at;
+        }
+        if (one_by_one) {
+            _mdns_server->tx_queue_head = p->next;
+            mdns_test_tx_handle_packet(p);
+        } else if (FireTimer()) {
+            test_execute_last_action();
+        } else {
+            g_tick++;
+        }
+    }
+}
+
+static bool restart_all_running(void)
+{
+    for (int i = 0; i < MDNS_MAX_INTERFACES; i++) {
+        for (int j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
+            if (_mdns_server->interfaces[i].pcbs[j].state != PCB_RUNNING) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    uint64_t ns;
+    uint32_t packets;
+    size_t bytes;
+    uint64_t digest;
+} restart_result_t;
+
+/**
+ * @brief  Restarts the responder on all PCBs and sends everything up to the last announcement
+ */
+static void restart_once(bool one_by_one, restart_result_t *result)
+{
+    uint32_t packets = g_tx_packets;
+    size_t bytes = g_tx_bytes;
+    s_digest = 0;
+
+    uint64_t start = restart_time_ns();
+    if (mdns_hostname_set("bridge")) {
+        abort();
+    }
+    test_execute_last_action();
+    restart_run(one_by_one);
+    result->ns = restart_time_ns() - start;
+    result->packets = g_tx_packets - packets;
+    result->bytes = g_tx_bytes - bytes;
+    result->digest = s_digest;
+    if (!restart_all_running()) {
+        printf("The responder did not restart on all PCBs\n");
+        abort();
+    }
+}
+
+static int restart_cmp(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char **argv)
+{
+    mdns_txt_item_t txt[] = { {"model", "bridge"}, {"fw", "1.4.2"}, {"id", "7A:21:9C:04:55:E0"} };
+    char instance[16];
+    restart_result_t result[2];
+    uint64_t ns[2][RESTART_ROUNDS];
+
+    test_start("bridge");
+    for (int i = 0; i < RESTART_SERVICES; i++) {
+        snprintf(instance, sizeof(instance), "Sensor %d", i);
+        if (mdns_service_add(instance, i % 2 ? "_hap" : "_http", "_tcp", 8000 + i, txt, 3)) {
+            abort();
+        }
+    }
+    restart_run(true);
+
+    for (int r = 0; r < RESTART_ROUNDS; r++) {
+        for (int m = 0; m < 2; m++) {
+            restart_once(m == 0, &result[m]);
+            ns[m][r] = result[m].ns;
+        }
+        if (result[0].packets != result[1].packets || result[0].bytes != result[1].bytes || result[0].digest != result[1].digest) {
+            printf("Both modes must send the same packets\n");
+            abort();
+        }
+    }
+
+    printf("Restart of %d services on %d interfaces (%d PCBs), median of %d restarts:\n",
+           RESTART_SERVICES, MDNS_MAX_INTERFACES, RESTART_PCBS, RESTART_ROUNDS);
+    for (int m = 0; m < 2; m++) {
+        qsort(ns[m], RESTART_ROUNDS, sizeof(uint64_t), restart_cmp);
+        printf("  %-10s %4u packets %7zu bytes %9.1f us\n", m == 0 ? "per PCB" : "fan-out",
+               (unsigned)result[m].packets, result[m].bytes, ns[m][RESTART_ROUNDS / 2] / 1000.0);
+    }
+    printf("  %u packets copied from the encoding for another PCB\n", (unsigned)_mdns_server->coalesced.fanned_out);
+    if (!_mdns_server->coalesced.fanned_out || ns[1][RESTART_ROUNDS / 2] >= ns[0][RESTART_ROUNDS / 2]) {
+        printf("The packets of the PCBs were not encoded once\n");
+        abort();
+    }
+    printf("Restart benchmark passed\n");
+
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
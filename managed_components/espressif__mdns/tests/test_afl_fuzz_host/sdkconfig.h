@@ -288,10 +288,17 @@
 #define CONFIG_MBEDTLS_ECP_DP_BP512R1_ENABLED 1
 #define CONFIG_MBEDTLS_ECP_DP_CURVE25519_ENABLED 1
 #define CONFIG_MBEDTLS_ECP_NIST_OPTIM 1
+#define CONFIG_MDNS_LOOKUP_HASH_BUCKETS 16
+#ifndef CONFIG_MDNS_MAX_SERVICES
 #define CONFIG_MDNS_MAX_SERVICES 25
+#endif
 #define CONFIG_MDNS_MAX_INTERFACES 3
 #define CONFIG_MDNS_TASK_PRIORITY 1
 #define CONFIG_MDNS_ACTION_QUEUE_LEN 16
+#define CONFIG_MDNS_RX_QUEUE_LEN 16
+#ifndef CONFIG_MDNS_CACHE_SIZE
+#define CONFIG_MDNS_CACHE_SIZE 32
+#endif
 #define CONFIG_MDNS_TASK_STACK_SIZE 4096
 #define CONFIG_MDNS_TASK_AFFINITY_CPU0 1
 #define CONFIG_MDNS_TASK_AFFINITY 0x0
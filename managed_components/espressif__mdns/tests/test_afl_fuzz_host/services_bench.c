@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+
+#include "test_common.h"
+
+//
+// Service table benchmark: a gateway registers 32 services of four types, each with six TXT items,
+// eight of them on a delegated host and eight with a subtype, and announces them. Reports the heap
+// the service table takes, then changes TXT items and removes the services, which must give it all back.
+
+#define SERVICES_COUNT          32
+#define SERVICES_TYPES          4
+#define SERVICES_DELEGATED      8
+
+//
+// Heap accounting, all allocations are routed here by the linker (-Wl,--wrap=malloc,...)
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static size_t s_heap_in_use;
+static size_t s_blocks_in_use;
+
+static void *services_account(void *ptr)
+{
+    if (ptr) {
+        s_blocks_in_use++;
+        s_heap_in_use += malloc_usable_size(ptr);
+    }
+    return ptr;
+}
+
+static void services_unaccount(void *ptr)
+{
+    if (ptr) {
+        s_blocks_in_use--;
+        s_heap_in_use -= malloc_usable_size(ptr);
+    }
+}
+
+void *__wrap_malloc(size_t size)
+{
+    return services_account(__real_malloc(size));
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    return services_account(__real_calloc(nmemb, size));
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    services_unaccount(ptr);
+    return services_account(__real_realloc(ptr, size));
+}
+
+void __wrap_free(void *ptr)
+{
+    services_unaccount(ptr);
+    __real_free(ptr);
+}
+
+char *__wrap_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *copy = __wrap_malloc(len);
+    return copy ? memcpy(copy, s, len) : NULL;
+}
+
+char *__wrap_strndup(const char *s, size_t n)
+{
+    size_t len = strnlen(s, n);
+    char *copy = __wrap_malloc(len + 1);
+    if (copy) {
+        memcpy(copy, s, len);
+        copy[len] = 0;
+    }
+    return copy;
+}
+
+static void services_report(const char *what, size_t heap, size_t blocks)
+{
+    printf("  %-22s %6zu bytes in %4zu blocks, %5.1f bytes per service\n", what, heap, blocks, (double)heap / SERVICES_COUNT);
+}
+
+int main(int argc, char **argv)
+{
+    static const char *types[SERVICES_TYPES] = { "_hap", "_airplay", "_raop", "_http" };
+    char instance[SERVICES_COUNT][MDNS_NAME_BUF_LEN];
+    char id[SERVICES_COUNT][18];
+
+    test_start("gateway");
+    mdns_ip_addr_t addr = { .addr = { .type = ESP_IPADDR_TYPE_V4, .u_addr.ip4.addr = 0x0a01a8c0 } };
+    if (mdns_delegate_hostname_add("bridge", &addr)) {
+        abort();
+    }
+    test_execute_last_action();
+    test_wait(10000);
+
+    size_t heap = s_heap_in_use, blocks = s_blocks_in_use;
+    for (int i = 0; i < SERVICES_COUNT; i++) {
+        snprintf(instance[i], sizeof(instance[i]), "Gateway Device %02d", i);
+        snprintf(id[i], sizeof(id[i]), "DE:AD:BE:EF:00:%02X", i);
+        mdns_txt_item_t txt[] = {
+            {"c#", "12"}, {"ff", "0"}, {"id", id[i]}, {"md", "Gateway"}, {"s#", "1"}, {"sf", "1"}
+        };
+        const char *host = i >= SERVICES_COUNT - SERVICES_DELEGATED ? "bridge" : NULL;
+        if (mdns_service_add_for_host(instance[i], types[i % SERVICES_TYPES], "_tcp", host, 5000 + i, txt, sizeof(txt) / sizeof(txt[0]))) {
+            abort();
+        }
+        if (i % SERVICES_TYPES == SERVICES_TYPES - 1
+                && mdns_service_subtype_add_for_host(instance[i], types[i % SERVICES_TYPES], "_tcp", host, "_printer")) {
+            abort();
+        }
+    }
+    // the responder encodes the records of the services while announcing them
+    test_wait(10000);
+    size_t table_heap = s_heap_in_use - heap, table_blocks = s_blocks_in_use - blocks;
+    printf("Service table of %d services with 6 TXT items each:\n", SERVICES_COUNT);
+    services_report("after the announcements", table_heap, table_blocks);
+
+    // changed TXT items take no additional blocks
+    for (int i = 0; i < SERVICES_COUNT; i++) {
+        const char *host = i >= SERVICES_COUNT - SERVICES_DELEGATED ? "bridge" : NULL;
+        if (mdns_service_txt_item_set_for_host(instance[i], types[i % SERVICES_TYPES], "_tcp", host, "c#", "13")
+                || mdns_service_txt_item_remove_for_host(instance[i], types[i % SERVICES_TYPES], "_tcp", host, "sf")) {
+            abort();
+        }
+    }
+    test_wait(10000);
+    services_report("after TXT changes", s_heap_in_use - heap, s_blocks_in_use - blocks);
+
+    // the items are kept in the order they are sent in, the last added first
+    mdns_result_t *results = NULL;
+    if (mdns_lookup_selfhosted_service(instance[0], types[0], "_tcp", 1, &results) || !results || results->txt_count != 5
+            || strcmp(results->txt[4].key, "c#") || strcmp(results->txt[4].value, "13") || results->txt_value_len[4] != 2) {
+        printf("Lookup of a changed service failed\n");
+        abort();
+    }
+    mdns_query_results_free(results);
+
+    if (mdns_service_remove_all()) {
+        abort();
+    }
+    test_wait(1000);
+
+    // an item longer than its length byte allows is an invalid argument, not a memory error, and leaks nothing
+    char long_value[UINT8_MAX];
+    memset(long_value, 'x', sizeof(long_value) - 1);
+    long_value[sizeof(long_value) - 1] = 0;
+    mdns_txt_item_t long_txt[] = { {"id", long_value} };
+    if (mdns_service_add("Long TXT", "_http", "_tcp", 80, long_txt, 1) != ESP_ERR_INVALID_ARG) {
+        printf("Adding a service with a too long TXT item did not fail with ESP_ERR_INVALID_ARG\n");
+        abort();
+    }
+
+    if (s_heap_in_use != heap || s_blocks_in_use != blocks) {
+        printf("Removed services left %zd bytes in %zd blocks\n", (ssize_t)(s_heap_in_use - heap), (ssize_t)(s_blocks_in_use - blocks));
+        abort();
+    }
+    printf("Service table benchmark passed\n");
+
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "test_common.h"
+
+//
+// Query storm test: many queriers ask for the same service within a short time, some of them
+// listing our record as a known answer. The responder has to answer once instead of once per query,
+// and answer again only when asked after the rate limiting interval or with a stale known answer.
+
+#define STORM_QUERIERS          40
+#define STORM_QUERY_SPACING_MS  10
+
+static uint32_t s_received;         // packets and bytes passed to the mdns task
+static size_t s_received_bytes;
+
+/**
+ * @brief  Builds a PTR query for _hap._tcp.local, optionally listing our PTR record as a known answer
+ */
+static size_t storm_build_query(uint8_t *out, bool known_answer, uint32_t ttl)
+{
+    static const uint8_t question[] = {
+        0x04, '_', 'h', 'a', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+        0x00, 0x0C, 0x00, 0x01
+    };
+    static const uint8_t instance[] = { 0x09, 'A', 'c', 'c', 'e', 's', 's', 'o', 'r', 'y', 0xC0, 0x0C };
+    size_t len = MDNS_HEAD_LEN;
+    memset(out, 0, MDNS_HEAD_LEN);
+    out[MDNS_HEAD_QUESTIONS_OFFSET + 1] = 1;
+    memcpy(out + len, question, sizeof(question));
+    len += sizeof(question);
+    if (known_answer) {
+        out[MDNS_HEAD_ANSWERS_OFFSET + 1] = 1;
+        const uint8_t answer[] = { 0xC0, 0x0C, 0x00, 0x0C, 0x00, 0x01, ttl >> 24, ttl >> 16, ttl >> 8, ttl, 0x00, sizeof(instance) };
+        memcpy(out + len, answer, sizeof(answer));
+        len += sizeof(answer);
+        memcpy(out + len, instance, sizeof(instance));
+        len += sizeof(instance);
+    }
+    return len;
+}
+
+/**
+ * @brief  Copies the query into a packet as received by the networking layer
+ */
+static mdns_rx_packet_t *storm_packet(const uint8_t *query, size_t len, uint8_t querier)
+{
+    mdns_rx_packet_t *packet = malloc(sizeof(mdns_rx_packet_t));
+    struct pbuf *pb = calloc(1, sizeof(struct pbuf));
+    if (!packet || !pb) {
+        abort();
+    }
+    pb->payload = (void *)query;
+    pb->len = len;
+    *packet = g_packet;
+    packet->pb = pb;
+    packet->src.u_addr.ip4.addr = 0x0001a8c0 | ((uint32_t)(10 + querier) << 24);
+    return packet;
+}
+
+static void storm_receive(const uint8_t *query, size_t len, uint8_t querier)
+{
+    if (_mdns_send_rx_action(storm_packet(query, len, querier))) {
+        abort();
+    }
+    test_execute_last_action();
+    s_received++;
+    s_received_bytes += len;
+}
+
+static uint32_t storm_histogram_sum(const uint32_t *histogram)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < MDNS_STATS_LATENCY_BUCKETS; i++) {
+        sum += histogram[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief  Checks the engine counters against the packets received and sent by the test
+ */
+static void storm_check_stats(void)
+{
+    mdns_stats_t stats;
+    uint32_t tx_packets = 0;
+    size_t tx_bytes = 0;
+
+    // a packet that cannot be queued for the mdns task is dropped
+    mdns_rx_packet_t *packet = storm_packet((const uint8_t *)"", 0, 0);
+    g_queue_send_shall_fail = 1;
+    if (_mdns_send_rx_action(packet) != ESP_ERR_NO_MEM) {
+        abort();
+    }
+    g_queue_send_shall_fail = 0;
+    free(packet->pb);
+    free(packet);
+
+    if (mdns_stats_get(&stats)) {
+        abort();
+    }
+    for (int i = 0; i < MDNS_MAX_INTERFACES; i++) {
+        for (int j = 0; j < MDNS_IP_PROTOCOL_MAX; j++) {
+            tx_packets += stats.netif[i][j].tx_packets;
+            tx_bytes += stats.netif[i][j].tx_bytes;
+        }
+    }
+    mdns_netif_stats_t *rx = &stats.netif[0][MDNS_IP_PROTOCOL_V4];
+    printf("Engine counters: RX %" PRIu32 " packets %" PRIu32 " bytes %" PRIu32 " dropped, TX %" PRIu32 " packets %zu bytes, "
+           "%" PRIu32 " packets queued at most\n", rx->rx_packets, rx->rx_bytes, rx->rx_dropped, tx_packets, tx_bytes, stats.tx_queue_max);
+    if (rx->rx_packets != s_received || rx->rx_bytes != s_received_bytes || rx->rx_dropped != 1 ||
+            tx_packets != g_tx_packets || tx_bytes != g_tx_bytes || !stats.tx_queue_max || !stats.action_queue_max ||
+            storm_histogram_sum(stats.parse_us) != s_received || !storm_histogram_sum(stats.answer_us) ||
+            stats.alloc_failed || stats.probe_conflicts) {
+        printf("The engine counters do not match the traffic\n");
+        abort();
+    }
+}
+
+/**
+ * @brief  Sends a single query after a quiet period, returns the number of bytes sent in response
+ */
+static size_t storm_single_query(const uint8_t *query, size_t len)
+{
+    test_wait(2 * MDNS_MULTICAST_INTERVAL_MS);
+    size_t sent = g_tx_bytes;
+    storm_receive(query, len, 0);
+    test_wait(MDNS_MULTICAST_INTERVAL_MS);
+    return g_tx_bytes - sent;
+}
+
+static int storm_multicast_records(const mdns_service_t *service)
+{
+    int count = 0;
+    for (int i = 0; i < MDNS_MULTICAST_RECORDS; i++) {
+        count += _mdns_server->multicast_records[i].type && _mdns_server->multicast_records[i].service == service;
+    }
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    mdns_txt_item_t txt[] = { {"c#", "2"}, {"ff", "0"}, {"id", "DE:AD:BE:EF:00:32"}, {"md", "storm"}, {"sf", "1"} };
+    uint8_t query[MDNS_MAX_PACKET_SIZE], known_query[MDNS_MAX_PACKET_SIZE], stale_query[MDNS_MAX_PACKET_SIZE];
+    size_t query_len = storm_build_query(query, false, 0);
+    size_t known_len = storm_build_query(known_query, true, MDNS_ANSWER_PTR_TTL);
+    size_t stale_len = storm_build_query(stale_query, true, MDNS_ANSWER_PTR_TTL / 4);
+    mdns_suppression_stats_t stats;
+
+    test_start("storm");
+    if (mdns_service_add("Accessory", "_hap", "_tcp", 8080, txt, sizeof(txt) / sizeof(txt[0]))) {
+        abort();
+    }
+    test_send(true);
+
+    size_t response = storm_single_query(query, query_len);
+    if (!response) {
+        printf("No response to a single query\n");
+        abort();
+    }
+
+    // every fourth querier knows our record already
+    test_wait(2 * MDNS_MULTICAST_INTERVAL_MS);
+    size_t sent = g_tx_bytes;
+    for (int i = 0; i < STORM_QUERIERS; i++) {
+        if (i % 4 == 3) {
+            storm_receive(known_query, known_len, i);
+        } else {
+            storm_receive(query, query_len, i);
+        }
+        test_wait(STORM_QUERY_SPACING_MS);
+    }
+    test_wait(MDNS_MULTICAST_INTERVAL_MS);
+    size_t storm = g_tx_bytes - sent;
+
+    if (mdns_suppression_stats_get(&stats)) {
+        abort();
+    }
+    printf("Storm of %d queries within %d ms: %zu bytes sent, %zu bytes answering each query\n",
+           STORM_QUERIERS, STORM_QUERIERS * STORM_QUERY_SPACING_MS, storm, STORM_QUERIERS * response);
+    printf("Suppressed answers: %" PRIu32 " known, %" PRIu32 " duplicate, %" PRIu32 " rate limited\n",
+           stats.known_answer, stats.duplicate, stats.rate_limited);
+    if (storm > 2 * response || !stats.known_answer || !stats.duplicate || !stats.rate_limited) {
+        printf("Answers to the storm were not suppressed\n");
+        abort();
+    }
+
+    // a fresh known answer suppresses the response, a stale one does not
+    if (storm_single_query(known_query, known_len)) {
+        printf("Answered a query listing the answer as known\n");
+        abort();
+    }
+    if (!storm_single_query(stale_query, stale_len)) {
+        printf("No response to a query with a stale known answer\n");
+        abort();
+    }
+    storm_check_stats();
+
+    // the records multicast for a removed service are forgotten, another one allocated at its address is not suppressed
+    const mdns_service_t *service = mdns_test_mdns_get_service_item("_hap", "_tcp")->service;
+    if (storm_multicast_records(service) == 0) {
+        abort();
+    }
+    mdns_service_remove_all();
+    test_send(true);
+    if (storm_multicast_records(service)) {
+        printf("Records multicast for a removed service are remembered\n");
+        abort();
+    }
+    printf("Query storm test passed\n");
+
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
@@ -135,7 +135,8 @@ static void mdns_test_query_free(void)
 //
 // function "under test" where afl-mangled packets passed
 //
-void mdns_parse_packet(mdns_rx_packet_t *packet);
+void mdns_parse_packet(mdns_rx_packet_t *packet, mdns_parse_arena_t *arena);
+static mdns_parse_arena_t s_arena;
 
 //
 // Test starts here
@@ -261,7 +262,7 @@ int main(int argc, char **argv)
         mdns_test_query("minifritz", "_fritz", "_tcp", MDNS_TYPE_ANY);
         mdns_test_query(NULL, "_fritz", "_tcp", MDNS_TYPE_PTR);
         mdns_test_query(NULL, "_afpovertcp", "_tcp", MDNS_TYPE_PTR);
-        mdns_parse_packet(&g_packet);
+        mdns_parse_packet(&g_packet, &s_arena);
         free(mypbuf.payload);
     }
 #ifndef MDNS_NO_SERVICES
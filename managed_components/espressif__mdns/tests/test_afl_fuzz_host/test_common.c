@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdlib.h>
+#include "test_common.h"
+
+mdns_rx_packet_t g_packet = {
+    .tcpip_if = (mdns_if_t)0,
+    .ip_protocol = MDNS_IP_PROTOCOL_V4,
+    .src = { .type = ESP_IPADDR_TYPE_V4 },
+    .src_port = MDNS_SERVICE_PORT,
+    .multicast = 1,
+};
+static struct pbuf s_pbuf;
+
+void test_start(const char *hostname)
+{
+    mdns_test_init_di();
+    if (mdns_init()) {
+        abort();
+    }
+    for (int i = 0; i < MDNS_MAX_INTERFACES; i++) {
+        _mdns_server->interfaces[i].pcbs[MDNS_IP_PROTOCOL_V4].state = PCB_RUNNING;
+        _mdns_server->interfaces[i].pcbs[MDNS_IP_PROTOCOL_V6].state = PCB_RUNNING;
+    }
+    if (mdns_hostname_set(hostname)) {
+        abort();
+    }
+    test_execute_last_action();
+}
+
+void test_execute_last_action(void)
+{
+    mdns_action_t *a = NULL;
+    GetLastItem(&a);
+    mdns_test_execute_action(a);
+}
+
+bool test_run_timer(void)
+{
+    if (!FireTimer()) {
+        return false;
+    }
+    mdns_action_t *a = NULL;
+    GetLastItem(&a);
+    if (a && a->type == ACTION_TIMER) {
+        mdns_test_execute_action(a);
+    }
+    return true;
+}
+
+void test_wait(uint32_t ms)
+{
+    uint32_t until = g_tick + ms;
+    while ((int32_t)(until - g_tick) > 0) {
+        g_tick++;
+        test_run_timer();
+    }
+}
+
+void test_send(bool all)
+{
+    for (int i = 0; i < 10000 && _mdns_server->tx_queue_head; i++) {
+        mdns_tx_packet_t *p = _mdns_server->tx_queue_head;
+        if (!all && (int32_t)(p->send_at - g_tick) > 0) {
+            break;
+        }
+        _mdns_server->tx_queue_head = p->next;
+        mdns_test_tx_handle_packet(p);
+    }
+}
+
+void test_receive(const uint8_t *data, size_t len)
+{
+    s_pbuf.payload = (void *)data;
+    s_pbuf.len = len;
+    g_packet.pb = &s_pbuf;
+    mdns_parse_packet(&g_packet, &_mdns_server->parse_arena);
+}
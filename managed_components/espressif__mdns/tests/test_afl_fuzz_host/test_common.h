@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+/*
+ * Fixture of the host tests and benchmarks -- runs the responder in the simulated time of esp32_mock
+ * and plays the part of the mdns task, executing the actions the tests post
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp32_mock.h"
+#include "mdns.h"
+#include "mdns_private.h"
+#include "mdns_di.h"
+
+extern mdns_server_t *_mdns_server;
+void mdns_parse_packet(mdns_rx_packet_t *packet, mdns_parse_arena_t *arena);
+esp_err_t _mdns_send_rx_action(mdns_rx_packet_t *packet);
+esp_err_t _mdns_send_rx_batch_action(mdns_rx_packet_t *packets);
+
+//
+// Packet received by test_receive(), multicast to the mdns port on the first interface over IPv4
+extern mdns_rx_packet_t g_packet;
+
+/**
+ * @brief  Starts the responder with all PCBs running and sets its hostname, aborts on failure
+ */
+void test_start(const char *hostname);
+
+/**
+ * @brief  Executes the action the last API call posted
+ */
+void test_execute_last_action(void);
+
+/**
+ * @brief  Runs the timer callback and the work it hands over to the service thread, if the timer expired
+ *
+ * @return true if the timer expired
+ */
+bool test_run_timer(void);
+
+/**
+ * @brief  Lets the time pass, running the timer as it expires
+ */
+void test_wait(uint32_t ms);
+
+/**
+ * @brief  Sends the scheduled packets without the timer, all of them or only those due by now
+ */
+void test_send(bool all);
+
+/**
+ * @brief  Parses a packet as received from g_packet.src
+ */
+void test_receive(const uint8_t *data, size_t len);
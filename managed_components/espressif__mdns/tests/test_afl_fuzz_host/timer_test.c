@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test_common.h"
+
+//
+// Timer test: counts the timer wakeups of a responder and the CPU time spent in them during a simulated
+// minute, once idle and once busy answering a query every 100 ms while running a search of its own.
+
+#define TIMER_MINUTE_MS         60000
+#define TIMER_QUERY_SPACING_MS  100
+
+static uint32_t s_wakeups;
+static uint64_t s_cpu_ns;
+
+static uint64_t timer_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief  Lets the time pass, running the timer callback and the work it hands over to the service thread
+ */
+static void timer_wait(uint32_t ms)
+{
+    uint32_t until = g_tick + ms;
+    while ((int32_t)(until - g_tick) > 0) {
+        g_tick++;
+        uint64_t start = timer_cpu_ns();
+        if (test_run_timer()) {
+            s_wakeups++;
+            s_cpu_ns += timer_cpu_ns() - start;
+        }
+    }
+}
+
+static void timer_receive_query(uint8_t querier)
+{
+    static const uint8_t query[] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x04, '_', 'h', 'a', 'p', 0x04, '_', 't', 'c', 'p', 0x05, 'l', 'o', 'c', 'a', 'l', 0x00,
+        0x00, 0x0C, 0x00, 0x01
+    };
+    g_packet.src.u_addr.ip4.addr = 0x0001a8c0 | ((uint32_t)(10 + querier) << 24);
+    test_receive(query, sizeof(query));
+}
+
+static void timer_report(const char *workload)
+{
+    printf("  %-6s %5u wakeups/min, %8.1f us CPU/min\n", workload, (unsigned)s_wakeups, s_cpu_ns / 1000.0);
+    s_wakeups = 0;
+    s_cpu_ns = 0;
+}
+
+int main(int argc, char **argv)
+{
+    mdns_txt_item_t txt[] = { {"c#", "2"}, {"ff", "0"}, {"id", "DE:AD:BE:EF:00:33"}, {"md", "timer"}, {"sf", "1"} };
+
+    test_start("timer");
+    if (mdns_service_add("Accessory", "_hap", "_tcp", 8080, txt, sizeof(txt) / sizeof(txt[0]))) {
+        abort();
+    }
+    // let the announcements go out
+    timer_wait(10000);
+    if (_mdns_server->tx_queue_head) {
+        printf("Announcements were not sent\n");
+        abort();
+    }
+
+    s_wakeups = 0;
+    s_cpu_ns = 0;
+    printf("Timer wakeups of the responder (the polling period was %d ms):\n", CONFIG_MDNS_TIMER_PERIOD_MS);
+    timer_wait(TIMER_MINUTE_MS);
+    uint32_t idle = s_wakeups;
+    timer_report("idle");
+
+    mdns_search_once_t *search = mdns_query_async_new(NULL, "_printer", "_tcp", MDNS_TYPE_PTR, 2 * TIMER_MINUTE_MS, 0, NULL);
+    if (!search) {
+        abort();
+    }
+    test_execute_last_action();
+    uint32_t sent = g_tx_packets;
+    for (int i = 0; i < TIMER_MINUTE_MS / TIMER_QUERY_SPACING_MS; i++) {
+        timer_receive_query(i);
+        timer_wait(TIMER_QUERY_SPACING_MS);
+    }
+    uint32_t busy = s_wakeups;
+    timer_report("busy");
+    printf("  %u packets sent while busy\n", (unsigned)(g_tx_packets - sent));
+
+    if (idle) {
+        printf("Idle responder woke up\n");
+        abort();
+    }
+    if (!busy || busy >= TIMER_MINUTE_MS / CONFIG_MDNS_TIMER_PERIOD_MS || g_tx_packets - sent < TIMER_MINUTE_MS / 1000) {
+        printf("Unexpected wakeups of a busy responder\n");
+        abort();
+    }
+    printf("Timer test passed\n");
+
+    mdns_service_remove_all();
+    timer_wait(1000);
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "test_common.h"
+
+//
+// TX test: measures how long the mdns task is busy sending the announcements of a burst of services
+// and how long it takes until all of them are sent. lwIP does not build on the host, so its tcpip thread
+// is emulated by a thread checksumming each packet and occupying it for the time of its transmission
+// at 100 Mbit/s, fed through a mailbox of the default size.
+//  - blocking: the packet is copied into a new buffer and the sender waits until it's sent (tcpip_api_call)
+//  - async:    the packet is serialized into its buffer, which is passed on without waiting (tcpip_callback)
+
+#define TX_SERVICES             16
+#define TX_ROUNDS               20
+#define TX_MBOX_SIZE            32
+#define TX_NS_PER_BYTE          80
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    volatile bool *done;
+} tx_msg_t;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+static tx_msg_t s_mbox[TX_MBOX_SIZE];
+static unsigned s_mbox_head;
+static unsigned s_mbox_tail;
+static unsigned s_sent;
+static bool s_blocking;
+static bool s_stop;
+static uint32_t s_checksum;
+static uint8_t s_packet[MDNS_MAX_PACKET_SIZE];
+
+static uint64_t tx_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief  The emulated tcpip thread, "sends" the packets by computing their UDP checksum
+ */
+static void *tx_tcpip_thread(void *arg)
+{
+    pthread_mutex_lock(&s_lock);
+    for (;;) {
+        while (s_mbox_head == s_mbox_tail && !s_stop) {
+            pthread_cond_wait(&s_cond, &s_lock);
+        }
+        if (s_mbox_head == s_mbox_tail) {
+            break;
+        }
+        tx_msg_t msg = s_mbox[s_mbox_tail % TX_MBOX_SIZE];
+        s_mbox_tail++;
+        pthread_cond_broadcast(&s_cond);
+        pthread_mutex_unlock(&s_lock);
+
+        uint64_t until = tx_time_ns() + msg.len * TX_NS_PER_BYTE;
+        uint32_t sum = 0;
+        for (size_t i = 0; i + 1 < msg.len; i += 2) {
+            sum += (msg.data[i] << 8) | msg.data[i + 1];
+        }
+        free(msg.data);
+        while (tx_time_ns() < until) {
+        }
+
+        pthread_mutex_lock(&s_lock);
+        s_checksum += sum;
+        g_tx_packets++;
+        g_tx_bytes += msg.len;
+        s_sent++;
+        if (msg.done) {
+            *msg.done = true;
+        }
+        pthread_cond_broadcast(&s_cond);
+    }
+    pthread_mutex_unlock(&s_lock);
+    return NULL;
+}
+
+static void tx_post(uint8_t *data, size_t len, volatile bool *done)
+{
+    pthread_mutex_lock(&s_lock);
+    while (s_mbox_head - s_mbox_tail == TX_MBOX_SIZE) {
+        pthread_cond_wait(&s_cond, &s_lock);
+    }
+    s_mbox[s_mbox_head % TX_MBOX_SIZE] = (tx_msg_t) {
+        .data = data, .len = len, .done = done
+    };
+    s_mbox_head++;
+    pthread_cond_broadcast(&s_cond);
+    while (done && !*done) {
+        pthread_cond_wait(&s_cond, &s_lock);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void *mock_udp_pcb_alloc(uint8_t **data)
+{
+    if (s_blocking) {
+        *data = s_packet;
+        return s_packet;
+    }
+    *data = malloc(MDNS_MAX_PACKET_SIZE);
+    return *data;
+}
+
+size_t mock_udp_pcb_send(void *buf, size_t len)
+{
+    if (s_blocking) {
+        volatile bool done = false;
+        uint8_t *copy = malloc(len);
+        memcpy(copy, buf, len);
+        tx_post(copy, len, &done);
+    } else {
+        tx_post(buf, len, NULL);
+    }
+    return len;
+}
+
+static void tx_wait_sent(void)
+{
+    pthread_mutex_lock(&s_lock);
+    while (s_sent != s_mbox_head) {
+        pthread_cond_wait(&s_cond, &s_lock);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief  Adds the services and sends their announcements, returns the time the mdns task was busy and until all were sent
+ */
+static uint32_t tx_burst(bool blocking, uint64_t *busy_ns, uint64_t *done_ns)
+{
+    mdns_txt_item_t txt[] = { {"board", "esp32"}, {"path", "/"} };
+    char instance[16];
+
+    s_blocking = blocking;
+    uint32_t packets = g_tx_packets;
+    for (int i = 0; i < TX_SERVICES; i++) {
+        snprintf(instance, sizeof(instance), "Device %d", i);
+        if (mdns_service_add(instance, "_http", "_tcp", 80 + i, txt, 2)) {
+            abort();
+        }
+    }
+    uint64_t start = tx_time_ns();
+    test_send(true);
+    uint64_t busy = tx_time_ns();
+    tx_wait_sent();
+    uint64_t done = tx_time_ns();
+    *busy_ns = busy - start;
+    *done_ns = done - start;
+    packets = g_tx_packets - packets;
+
+    mdns_service_remove_all();
+    test_send(true);
+    tx_wait_sent();
+    return packets;
+}
+
+static int tx_cmp(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t busy[2][TX_ROUNDS], done[2][TX_ROUNDS];
+    uint32_t packets[2] = { 0 };
+    pthread_t tcpip;
+
+    test_start("tx");
+    pthread_create(&tcpip, NULL, tx_tcpip_thread, NULL);
+    test_send(true);
+    tx_wait_sent();
+
+    for (int r = 0; r < TX_ROUNDS; r++) {
+        for (int m = 0; m < 2; m++) {
+            packets[m] = tx_burst(m == 0, &busy[m][r], &done[m][r]);
+        }
+    }
+    pthread_mutex_lock(&s_lock);
+    s_stop = true;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    pthread_join(tcpip, NULL);
+
+    printf("Announcements of %d services on %d interfaces, median of %d bursts:\n", TX_SERVICES, MDNS_MAX_INTERFACES * MDNS_IP_PROTOCOL_MAX, TX_ROUNDS);
+    for (int m = 0; m < 2; m++) {
+        qsort(busy[m], TX_ROUNDS, sizeof(uint64_t), tx_cmp);
+        qsort(done[m], TX_ROUNDS, sizeof(uint64_t), tx_cmp);
+        printf("  %-8s %4u packets, mdns task busy %8.1f us, all sent after %8.1f us\n", m == 0 ? "blocking" : "async",
+               (unsigned)packets[m], busy[m][TX_ROUNDS / 2] / 1000.0, done[m][TX_ROUNDS / 2] / 1000.0);
+    }
+    if (packets[0] != packets[1] || !packets[0]) {
+        printf("Both modes must send the same packets\n");
+        abort();
+    }
+    if (busy[1][TX_ROUNDS / 2] >= busy[0][TX_ROUNDS / 2]) {
+        printf("The mdns task was not released earlier\n");
+        abort();
+    }
+    printf("TX test passed\n");
+
+    ForceTaskDelete();
+    mdns_free();
+    return 0;
+}